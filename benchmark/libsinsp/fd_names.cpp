@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2026 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <libsinsp/fdinfo.h>
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Naming sockets with tuples that are all different, as short-lived connections do: each name
+// is allocated and freed once, either through the string pool or apart from it.
+static void BM_sinsp_fd_name_socket(benchmark::State& state) {
+	const bool pooled = state.range(0) != 0;
+	sinsp_fdinfo fdinfo;
+	char tuple[64];
+	uint32_t port = state.thread_index() << 16;
+	for(auto _ : state) {
+		snprintf(tuple, sizeof(tuple), "10.0.0.1:%u->10.0.0.2:443", port++);
+		if(pooled) {
+			fdinfo.m_name = tuple;
+		} else {
+			fdinfo.set_socket_name(tuple);
+		}
+		benchmark::DoNotOptimize(fdinfo.m_name.data());
+	}
+}
+// {pooled}
+BENCHMARK(BM_sinsp_fd_name_socket)->Arg(1)->Arg(0)->Threads(1)->Threads(4);
+
+// Naming fds with a few paths opened over and over, as the files of a process are: the names
+// are shared through the string pool.
+static void BM_sinsp_fd_name_file(benchmark::State& state) {
+	std::vector<std::string> paths;
+	for(int i = 0; i < 64; i++) {
+		paths.push_back("/var/lib/data/file-" + std::to_string(i));
+	}
+
+	std::vector<sinsp_fdinfo> fdinfos(1024);
+	size_t i = 0;
+	for(auto _ : state) {
+		fdinfos[i % fdinfos.size()].add_filename(paths[i % paths.size()]);
+		benchmark::DoNotOptimize(fdinfos[i % fdinfos.size()].m_name.data());
+		i++;
+	}
+}
+BENCHMARK(BM_sinsp_fd_name_file)->Threads(1)->Threads(4);
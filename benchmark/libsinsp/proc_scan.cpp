@@ -0,0 +1,43 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2026 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <libsinsp/sinsp.h>
+#include <benchmark/benchmark.h>
+
+#include <memory>
+
+// Startup latency of a live capture, i.e. mostly the time spent on the initial /proc
+// scan. The nodriver engine doesn't need any driver, so the numbers only depend on the
+// number of threads and fds on the machine.
+static void BM_sinsp_nodriver_open(benchmark::State& state) {
+	for(auto _ : state) {
+		state.PauseTiming();
+		auto inspector = std::make_unique<sinsp>();
+		inspector->set_proc_scan_workers(state.range(0));
+		state.ResumeTiming();
+
+		inspector->open_nodriver(true);
+
+		state.PauseTiming();
+		state.counters["threads"] = inspector->m_thread_manager->get_thread_count();
+		inspector.reset();
+		state.ResumeTiming();
+	}
+}
+// {proc scan workers (0 = auto)}
+BENCHMARK(BM_sinsp_nodriver_open)->Arg(1)->Arg(2)->Arg(4)->Arg(0)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2026 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <libsinsp/sinsp.h>
+#include <libscap/engine/test_input/scap_test.h>
+#include <libscap/strl.h>
+#include <benchmark/benchmark.h>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Writes a capture file whose headers contain `nthreads` threads with `nfds` fds
+// each, followed by a single event.
+static std::string write_capture(int64_t nthreads, int64_t nfds) {
+	std::vector<scap_threadinfo> threads(nthreads);
+	std::vector<std::vector<scap_fdinfo>> fds(nthreads);
+	std::vector<scap_test_fdinfo_data> fd_data(nthreads);
+
+	static const char args[] = "/usr/bin/python3\0-m\0http.server\0";
+	static const char env[] = "HOME=/root\0PATH=/usr/local/bin:/usr/bin:/bin\0";
+	for(int64_t i = 0; i < nthreads; i++) {
+		scap_threadinfo& tinfo = threads[i];
+		tinfo = {};
+		tinfo.tid = i + 1;
+		tinfo.pid = i + 1;
+		tinfo.ptid = 1;
+		tinfo.vtid = i + 1;
+		tinfo.vpid = i + 1;
+		tinfo.fdlimit = 1024;
+		strlcpy(tinfo.comm, "python3", sizeof(tinfo.comm));
+		strlcpy(tinfo.exe, "/usr/bin/python3", sizeof(tinfo.exe));
+		strlcpy(tinfo.exepath, "/usr/bin/python3.11", sizeof(tinfo.exepath));
+		strlcpy(tinfo.cwd, "/srv/www/", sizeof(tinfo.cwd));
+		memcpy(tinfo.args, args, sizeof(args));
+		tinfo.args_len = sizeof(args);
+		memcpy(tinfo.env, env, sizeof(env));
+		tinfo.env_len = sizeof(env);
+
+		fds[i].resize(nfds);
+		for(int64_t fd = 0; fd < nfds; fd++) {
+			scap_fdinfo& fdinfo = fds[i][fd];
+			fdinfo = {};
+			fdinfo.fd = fd;
+			fdinfo.ino = 1000 + fd;
+			fdinfo.type = SCAP_FD_FILE_V2;
+			snprintf(fdinfo.info.regularinfo.fname,
+			         sizeof(fdinfo.info.regularinfo.fname),
+			         "/var/lib/data/file-%ld",
+			         (long)fd);
+		}
+		fd_data[i] = {fds[i].data(), fds[i].size()};
+	}
+
+	char error[SCAP_LASTERR_SIZE];
+	std::unique_ptr<scap_evt, decltype(&free)> evt(
+	        scap_create_event(error, 1, 1, PPME_SYSCALL_GETCWD_X, 2, (int64_t)0, "/srv/www"),
+	        free);
+	scap_evt* events[] = {evt.get()};
+
+	scap_test_input_data data = {};
+	data.events = events;
+	data.event_count = 1;
+	data.threads = threads.data();
+	data.thread_count = threads.size();
+	data.fdinfo_data = fd_data.data();
+
+	auto path = std::filesystem::temp_directory_path() /
+	            ("bench_savefile_" + std::to_string(nthreads) + "_" + std::to_string(nfds) + ".scap");
+
+	sinsp inspector;
+	inspector.open_test_input(&data, SINSP_MODE_TEST);
+	sinsp_dumper dumper;
+	dumper.open(&inspector, path.string(), false);
+	sinsp_evt* sevt;
+	while(inspector.next(&sevt) != SCAP_EOF) {
+		dumper.dump(sevt);
+	}
+	dumper.close();
+	inspector.close();
+	return path.string();
+}
+
+// Time from the beginning of open_savefile() to the first event, i.e. mostly the
+// time spent loading the thread and fd tables.
+static void BM_sinsp_savefile_open_to_first_event(benchmark::State& state) {
+	std::string path = write_capture(state.range(0), state.range(1));
+	for(auto _ : state) {
+		state.PauseTiming();
+		auto inspector = std::make_unique<sinsp>();
+		inspector->set_savefile_header_workers(state.range(2));
+		state.ResumeTiming();
+
+		inspector->open_savefile(path);
+		sinsp_evt* evt;
+		benchmark::DoNotOptimize(inspector->next(&evt));
+
+		state.PauseTiming();
+		inspector.reset();
+		state.ResumeTiming();
+	}
+	std::filesystem::remove(path);
+}
+// {threads, fds per thread, header workers (0 = auto)}
+BENCHMARK(BM_sinsp_savefile_open_to_first_event)
+        ->ArgsProduct({{1000, 20000}, {16}, {1, 0}})
+        ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,107 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2026 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <libsinsp/sinsp.h>
+#include <libscap/scap_savefile_api.h>
+#include <benchmark/benchmark.h>
+
+#include <cstdarg>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+using safe_scap_evt_t = std::unique_ptr<scap_evt, decltype(&free)>;
+
+static safe_scap_evt_t create_event(uint64_t ts,
+                                    uint64_t tid,
+                                    ppm_event_code type,
+                                    uint32_t n,
+                                    ...) {
+	char error[SCAP_LASTERR_SIZE];
+	va_list args;
+	va_start(args, n);
+	scap_evt* evt = scap_create_event_v(error, ts, tid, type, nullptr, n, args);
+	va_end(args);
+	if(evt == nullptr) {
+		throw std::runtime_error(error);
+	}
+	return safe_scap_evt_t(evt, free);
+}
+
+// Writes a capture with `nsyscalls` read syscalls spread over a few threads. Legacy captures
+// contain the enter event and the old 2-parameter exit event, which the savefile engine has to
+// convert, while current ones only contain the 4-parameter exit event.
+static std::string write_capture(int64_t nsyscalls, bool legacy) {
+	constexpr uint64_t num_threads = 64;
+	constexpr int64_t fd = 3;
+	constexpr uint32_t size = 64;
+	static const char data[size] = "GET / HTTP/1.1\r\nHost: localhost\r\n";
+
+	auto path = std::filesystem::temp_directory_path() /
+	            ("bench_replay_" + std::string(legacy ? "legacy" : "current") + ".scap");
+	char error[SCAP_LASTERR_SIZE];
+	scap_dumper_t* dumper = scap_dump_open(nullptr, path.c_str(), SCAP_COMPRESSION_NONE, error);
+	if(dumper == nullptr) {
+		throw std::runtime_error(error);
+	}
+
+	uint64_t ts = 1;
+	for(int64_t i = 0; i < nsyscalls; i++) {
+		uint64_t tid = 100 + i % num_threads;
+		scap_const_sized_buffer buf{data, size};
+		if(legacy) {
+			auto enter = create_event(ts++, tid, PPME_SYSCALL_READ_E, 2, fd, size);
+			auto exit = create_event(ts++, tid, PPME_SYSCALL_READ_X, 2, (int64_t)size, buf);
+			scap_dump(dumper, enter.get(), 0, 0);
+			scap_dump(dumper, exit.get(), 0, 0);
+		} else {
+			auto exit =
+			        create_event(ts++, tid, PPME_SYSCALL_READ_X, 4, (int64_t)size, buf, fd, size);
+			scap_dump(dumper, exit.get(), 0, 0);
+		}
+	}
+	scap_dump_close(dumper);
+	return path.string();
+}
+
+// Replay throughput in syscalls per second, for legacy captures (converted on the fly) and
+// current ones.
+static void BM_sinsp_savefile_replay(benchmark::State& state) {
+	const int64_t nsyscalls = state.range(0);
+	std::string path = write_capture(nsyscalls, state.range(1));
+	for(auto _ : state) {
+		sinsp inspector;
+		inspector.open_savefile(path);
+		sinsp_evt* evt;
+		int32_t res;
+		while((res = inspector.next(&evt)) != SCAP_EOF) {
+			if(res != SCAP_SUCCESS && res != SCAP_FILTERED_EVENT && res != SCAP_TIMEOUT) {
+				state.SkipWithError(inspector.getlasterr().c_str());
+				break;
+			}
+		}
+		inspector.close();
+	}
+	state.SetItemsProcessed(state.iterations() * nsyscalls);
+	std::filesystem::remove(path);
+}
+// {syscalls, legacy capture}
+BENCHMARK(BM_sinsp_savefile_replay)
+        ->ArgsProduct({{100000}, {0, 1}})
+        ->Unit(benchmark::kMillisecond);
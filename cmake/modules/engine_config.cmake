@@ -9,6 +9,11 @@ set(HAS_ENGINE_NODRIVER On)
 set(HAS_ENGINE_SAVEFILE On)
 set(HAS_ENGINE_SOURCE_PLUGIN On)
 
+if(NOT EMSCRIPTEN)
+	# Reads each file on its own thread
+	set(HAS_ENGINE_MULTI_SAVEFILE On)
+endif()
+
 if(CMAKE_SYSTEM_NAME MATCHES "Linux")
 	option(ENABLE_ENGINE_KMOD "Enable kernel module engine" ON)
 
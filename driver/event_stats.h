@@ -12,7 +12,7 @@ or GPL2.txt for full copies of the license.
 /* These numbers must be updated when we add new events in the event table */
 #define SYSCALL_EVENTS_NUM 384
 #define TRACEPOINT_EVENTS_NUM 6
-#define METAEVENTS_NUM 18
+#define METAEVENTS_NUM 20
 #define PLUGIN_EVENTS_NUM 1
 #define ITER_EVENTS_NUM 10
-#define UNKNOWN_EVENTS_NUM 35
+#define UNKNOWN_EVENTS_NUM 37
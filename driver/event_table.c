@@ -2952,6 +2952,26 @@ const struct ppm_event_info g_event_info[] = {
                   {"arg3", PT_DYN, PF_DEC, keyctl_dynamic_param, PPM_KEYCTL_IDX_MAX},
                   {"arg4", PT_DYN, PF_DEC, keyctl_dynamic_param, PPM_KEYCTL_IDX_MAX},
                   {"arg5", PT_DYN, PF_DEC, keyctl_dynamic_param, PPM_KEYCTL_IDX_MAX}}},
+        [PPME_IO_AGGREGATE_E] = {"io_aggregate",
+                                 EC_IO_OTHER | EC_METAEVENT,
+                                 EF_USES_FD,
+                                 7,
+                                 {{"fd", PT_FD, PF_DEC},
+                                  {"rcount", PT_UINT64, PF_DEC},
+                                  {"rbytes", PT_UINT64, PF_DEC},
+                                  {"wcount", PT_UINT64, PF_DEC},
+                                  {"wbytes", PT_UINT64, PF_DEC},
+                                  {"first_ts", PT_ABSTIME, PF_DEC},
+                                  {"last_ts", PT_ABSTIME, PF_DEC}}},
+        [PPME_IO_AGGREGATE_X] = {"NA", EC_UNKNOWN, EF_UNUSED, 0},
+        [PPME_RATE_LIMIT_DROPS_E] = {"rate_limit_drops",
+                                     EC_OTHER | EC_METAEVENT,
+                                     EF_NONE,
+                                     3,
+                                     {{"tgid", PT_PID, PF_DEC},
+                                      {"category", PT_UINT8, PF_DEC},
+                                      {"dropped", PT_UINT64, PF_DEC}}},
+        [PPME_RATE_LIMIT_DROPS_X] = {"NA", EC_UNKNOWN, EF_UNUSED, 0},
 };
 #pragma GCC diagnostic pop
 
@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: GPL-2.0-only OR MIT
+/*
+ * Copyright (C) 2026 The Falco Authors.
+ *
+ * This file is dual licensed under either the MIT or GPL 2. See MIT.txt
+ * or GPL2.txt for full copies of the license.
+ */
+
+#pragma once
+
+#include <helpers/base/maps_getters.h>
+
+/* When more processes share the probe, every event is copied to the ring
+ * buffers of the consumers interested in it. The probe collects the event once,
+ * whatever the number of consumers. See the `consumers` map.
+ */
+
+/**
+ * @brief Return true if the probe is shared with other consumers.
+ */
+static __always_inline bool consumers__is_shared() {
+	struct capture_settings *settings = maps__get_capture_settings();
+	return settings != NULL && settings->multi_consumer;
+}
+
+/**
+ * @brief Return true if the consumer in `slot` wants events of `event_type`.
+ * A slot without a consumer only wants them when it is the one of the process
+ * that loaded the probe.
+ *
+ * @param slot consumer slot.
+ * @param event_type event type.
+ */
+static __always_inline bool consumers__is_interesting_event(uint32_t slot, uint16_t event_type) {
+	struct consumer *consumer = maps__get_consumer(slot);
+	if(consumer == NULL) {
+		return slot == 0;
+	}
+	if(event_type >= PPM_EVENT_MAX) {
+		return false;
+	}
+	return consumer->events[event_type / 8] & (1 << (event_type % 8));
+}
+
+/**
+ * @brief Copy an event already collected for slot `0` to the other consumers
+ * interested in it. Drops are accounted in the shared counters.
+ *
+ * @param data event to copy.
+ * @param size size of the event.
+ * @param event_type event type.
+ * @param counter per-CPU counters.
+ */
+static __always_inline void consumers__output_event(void *data,
+                                                    uint64_t size,
+                                                    uint16_t event_type,
+                                                    struct counter_map *counter) {
+	for(uint32_t slot = 1; slot < MAX_CONSUMERS; slot++) {
+		if(!consumers__is_interesting_event(slot, event_type)) {
+			continue;
+		}
+		struct ringbuf_map *rb = maps__get_consumer_ringbuf_map(slot);
+		if(rb == NULL) {
+			/* The consumer has not inserted its ring buffers yet. */
+			continue;
+		}
+		if(bpf_ringbuf_output(rb, data, size, maps__get_ringbuf_wakeup_flags(rb, size, false))) {
+			counter->n_drops_buffer++;
+		}
+	}
+}
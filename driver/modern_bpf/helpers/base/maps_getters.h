@@ -142,6 +142,38 @@ static __always_inline uint8_t maps__64bit_sampling_syscall_table(uint32_t sysca
 
 /*=============================== SAMPLING TABLES ===========================*/
 
+/*=============================== RATE LIMIT MAPS ===========================*/
+
+static __always_inline uint8_t maps__64bit_rate_limit_category(uint32_t syscall_id) {
+	return g_64bit_rate_limit_category_table[syscall_id & (SYSCALL_TABLE_SIZE - 1)];
+}
+
+static __always_inline struct rate_limit *maps__get_rate_limit(uint32_t category) {
+	return bpf_map_lookup_elem(&rate_limits, &category);
+}
+
+static __always_inline struct rate_limit_bucket *maps__get_rate_limit_bucket(
+        struct rate_limit_key *key,
+        struct rate_limit *limit,
+        uint64_t now) {
+	struct rate_limit_bucket *bucket = bpf_map_lookup_elem(&rate_limit_buckets, key);
+	if(bucket != NULL) {
+		return bucket;
+	}
+
+	/* New buckets start full. */
+	struct rate_limit_bucket value = {
+	        .credit = limit->burst * SECOND_TO_NS,
+	        .last_refill_ts = now,
+	        .last_summary_ts = now,
+	};
+	/* If another CPU created the bucket in the meantime we use that one. */
+	bpf_map_update_elem(&rate_limit_buckets, key, &value, BPF_NOEXIST);
+	return bpf_map_lookup_elem(&rate_limit_buckets, key);
+}
+
+/*=============================== RATE LIMIT MAPS ===========================*/
+
 /*=============================== SYSCALL-64 INTERESTING TABLE ===========================*/
 
 static __always_inline bool maps__interesting_syscall_64bit(uint32_t syscall_id) {
@@ -154,6 +186,27 @@ static __always_inline bool maps__interesting_syscall_64bit(uint32_t syscall_id)
 
 /*=============================== SYSCALL-64 INTERESTING TABLE ===========================*/
 
+/*=============================== CGROUP SYSCALLS TABLE ===========================*/
+
+static __always_inline struct cgroup_syscalls *maps__get_cgroup_syscalls(uint64_t cgroup_id) {
+	return bpf_map_lookup_elem(&cgroup_syscalls_table, &cgroup_id);
+}
+
+/*=============================== CGROUP SYSCALLS TABLE ===========================*/
+
+/*=============================== CONSUMERS ===========================*/
+
+static __always_inline struct consumer *maps__get_consumer(uint32_t slot) {
+	return bpf_map_lookup_elem(&consumers, &slot);
+}
+
+static __always_inline struct ringbuf_map *maps__get_consumer_ringbuf_map(uint32_t slot) {
+	uint32_t key = (uint32_t)bpf_get_smp_processor_id() * MAX_CONSUMERS + slot;
+	return (struct ringbuf_map *)bpf_map_lookup_elem(&consumer_ringbuf_maps, &key);
+}
+
+/*=============================== CONSUMERS ===========================*/
+
 /*=============================== IA32 to 64 TABLE ===========================*/
 
 static __always_inline uint32_t maps__ia32_to_64(uint32_t syscall_id) {
@@ -207,6 +260,93 @@ static __always_inline struct iter_counters *maps__get_iter_counters() {
 
 /*=============================== ITER COUNTERS MAP ===========================*/
 
+/*=============================== SUPPRESSION MAPS ===========================*/
+
+static __always_inline bool maps__is_suppressed_tid(uint32_t tid) {
+	return bpf_map_lookup_elem(&suppressed_tids, &tid) != NULL;
+}
+
+static __always_inline void maps__suppress_tid(uint32_t tid) {
+	uint8_t value = 1;
+	/* If the map is full the thread is simply not suppressed in the kernel. */
+	bpf_map_update_elem(&suppressed_tids, &tid, &value, BPF_ANY);
+}
+
+static __always_inline void maps__unsuppress_tid(uint32_t tid) {
+	bpf_map_delete_elem(&suppressed_tids, &tid);
+}
+
+static __always_inline bool maps__is_suppressed_comm(char *comm) {
+	return bpf_map_lookup_elem(&suppressed_comms, comm) != NULL;
+}
+
+static __always_inline bool maps__is_suppressed_cgroup(uint64_t cgroup_id) {
+	return bpf_map_lookup_elem(&suppressed_cgroups, &cgroup_id) != NULL;
+}
+
+/*=============================== SUPPRESSION MAPS ===========================*/
+
+/*=============================== IO AGGREGATION MAP ===========================*/
+
+static __always_inline struct io_aggregation *maps__get_io_aggregation(
+        struct io_aggregation_key *key) {
+	return bpf_map_lookup_elem(&io_aggregation_table, key);
+}
+
+static __always_inline struct io_aggregation *maps__new_io_aggregation(
+        struct io_aggregation_key *key,
+        uint64_t now) {
+	struct io_aggregation value = {.first_ts = now};
+	/* Under memory pressure the syscall is simply sent as a regular event. A stale aggregate left
+	 * by a thread with the same tid is overwritten.
+	 */
+	if(bpf_map_update_elem(&io_aggregation_table, key, &value, BPF_ANY) != 0) {
+		return NULL;
+	}
+	return bpf_map_lookup_elem(&io_aggregation_table, key);
+}
+
+static __always_inline void maps__delete_io_aggregation(struct io_aggregation_key *key) {
+	bpf_map_delete_elem(&io_aggregation_table, key);
+}
+
+static __always_inline struct io_aggregation_thread *maps__get_io_aggregation_thread(
+        uint32_t tid) {
+	return bpf_map_lookup_elem(&io_aggregation_threads, &tid);
+}
+
+static __always_inline struct io_aggregation_thread *maps__new_io_aggregation_thread(
+        uint32_t tid,
+        uint64_t now) {
+	struct io_aggregation_thread value = {.first_ts = now};
+	if(bpf_map_update_elem(&io_aggregation_threads, &tid, &value, BPF_ANY) != 0) {
+		return NULL;
+	}
+	return bpf_map_lookup_elem(&io_aggregation_threads, &tid);
+}
+
+static __always_inline void maps__delete_io_aggregation_thread(uint32_t tid) {
+	bpf_map_delete_elem(&io_aggregation_threads, &tid);
+}
+
+/*=============================== IO AGGREGATION MAP ===========================*/
+
+/*=============================== ARGUMENT FILTER MAPS ===========================*/
+
+static __always_inline uint8_t *maps__get_path_filter(struct path_filter_key *key) {
+	return bpf_map_lookup_elem(&path_filters, key);
+}
+
+static __always_inline bool maps__is_filtered_port(uint16_t port) {
+	return bpf_map_lookup_elem(&port_filters, &port) != NULL;
+}
+
+static __always_inline uint8_t *maps__get_addr_filter(struct addr_filter_key *key) {
+	return bpf_map_lookup_elem(&addr_filters, key);
+}
+
+/*=============================== ARGUMENT FILTER MAPS ===========================*/
+
 /*=============================== AUXILIARY MAPS ===========================*/
 
 static __always_inline struct auxiliary_map *maps__get_auxiliary_map() {
@@ -232,4 +372,29 @@ static __always_inline struct ringbuf_map *maps__get_ringbuf_map() {
 	return (struct ringbuf_map *)bpf_map_lookup_elem(&ringbuf_maps, &cpu_id);
 }
 
+/* Userspace is only notified when a record makes the ring buffer cross the wakeup watermark. A
+ * consumer blocked in `epoll` is woken up once per batch instead of once per event, while the
+ * ones polling the ring buffers are never notified.
+ */
+static __always_inline uint64_t maps__get_ringbuf_wakeup_flags(struct ringbuf_map *rb,
+                                                               uint64_t record_size,
+                                                               bool reserved) {
+	struct capture_settings *settings = maps__get_capture_settings();
+	if(settings == NULL || settings->wakeup_watermark == 0) {
+		return BPF_RB_NO_WAKEUP;
+	}
+
+	/* Reserved records are already accounted in `BPF_RB_AVAIL_DATA`. */
+	uint64_t size = record_size + BPF_RINGBUF_HDR_SZ;
+	uint64_t after = bpf_ringbuf_query(rb, BPF_RB_AVAIL_DATA);
+	if(!reserved) {
+		after += size;
+	}
+	uint64_t before = after > size ? after - size : 0;
+	if(before < settings->wakeup_watermark && after >= settings->wakeup_watermark) {
+		return BPF_RB_FORCE_WAKEUP;
+	}
+	return BPF_RB_NO_WAKEUP;
+}
+
 /*=============================== RINGBUF MAPS ===========================*/
@@ -0,0 +1,124 @@
+// SPDX-License-Identifier: GPL-2.0-only OR MIT
+/*
+ * Copyright (C) 2026 The Falco Authors.
+ *
+ * This file is dual licensed under either the MIT or GPL 2. See MIT.txt
+ * or GPL2.txt for full copies of the license.
+ */
+
+#pragma once
+
+#include <helpers/interfaces/variable_size_event.h>
+
+/* Predicates pushed by userspace to drop, before they reach the ring buffer, the events whose
+ * arguments can't match any rule. Every helper returns:
+ * - true: keep the event.
+ * - false: drop the event.
+ */
+
+/**
+ * @brief Apply the `path_filters` to a path already stored in the auxmap.
+ * Relative paths depend on the working directory or on a dirfd, so they
+ * are always kept, as well as paths that are not normalized.
+ *
+ * @param auxmap pointer to the auxmap holding the event.
+ * @param path_pos position of the path in the auxmap.
+ * @param path_len length of the path, NUL terminator included.
+ */
+static __always_inline bool arg_filters__keep_path(struct auxiliary_map *auxmap,
+                                                   uint64_t path_pos,
+                                                   uint16_t path_len) {
+	struct capture_settings *settings = maps__get_capture_settings();
+	if(settings == NULL || !settings->path_filter) {
+		return true;
+	}
+
+	if(path_len < 2 || auxmap->data[SAFE_ACCESS(path_pos)] != '/') {
+		return true;
+	}
+
+	/* The second half of the auxmap is used as scratch space, the key is too big for the stack.
+	 * Bytes after the path don't matter since the match is limited to `prefixlen`.
+	 */
+	struct path_filter_key *key = (struct path_filter_key *)&auxmap->data[MAX_EVENT_SIZE];
+	/* Longer paths are kept, their tail can't be checked for normalization. */
+	uint32_t len = path_len - 1;
+	if(len > MAX_PATH_FILTER_LEN) {
+		return true;
+	}
+	key->prefixlen = len * 8;
+	if(bpf_probe_read_kernel(key->path,
+	                         MAX_PATH_FILTER_LEN,
+	                         &auxmap->data[SAFE_ACCESS(path_pos)]) != 0) {
+		return true;
+	}
+
+	/* Paths that userspace would normalize, like `/a/../b` or `//b`, could match a prefix
+	 * only after normalization. Components starting with `.` or `/` are kept.
+	 */
+	for(uint32_t i = 0; i < MAX_PATH_FILTER_LEN - 1; i++) {
+		if(i + 1 >= len) {
+			break;
+		}
+		if(key->path[i] == '/' && (key->path[i + 1] == '.' || key->path[i + 1] == '/')) {
+			return true;
+		}
+	}
+
+	uint8_t *action = maps__get_path_filter(key);
+	return action == NULL || *action != ARG_FILTER_DROP;
+}
+
+/**
+ * @brief Apply the `port_filters` and the `addr_filters` to the remote
+ * address of a connection, read from the sockaddr provided by the user.
+ * Families other than IPv4 and IPv6 are always kept.
+ *
+ * @param usrsockaddr pointer to the user sockaddr.
+ */
+static __always_inline bool arg_filters__keep_sockaddr(struct sockaddr *usrsockaddr) {
+	struct capture_settings *settings = maps__get_capture_settings();
+	if(settings == NULL || (!settings->port_filter && !settings->addr_filter)) {
+		return true;
+	}
+
+	uint16_t family = 0;
+	if(usrsockaddr == NULL ||
+	   bpf_probe_read_user(&family, sizeof(family), &usrsockaddr->sa_family) != 0) {
+		return true;
+	}
+
+	struct addr_filter_key key = {.prefixlen = 128};
+	uint16_t port = 0;
+	if(family == AF_INET) {
+		struct sockaddr_in sin;
+		if(bpf_probe_read_user(&sin, sizeof(sin), usrsockaddr) != 0) {
+			return true;
+		}
+		port = ntohs(sin.sin_port);
+		key.addr[10] = 0xff;
+		key.addr[11] = 0xff;
+		__builtin_memcpy(&key.addr[12], &sin.sin_addr.s_addr, 4);
+	} else if(family == AF_INET6) {
+		struct sockaddr_in6 sin6;
+		if(bpf_probe_read_user(&sin6, sizeof(sin6), usrsockaddr) != 0) {
+			return true;
+		}
+		port = ntohs(sin6.sin6_port);
+		__builtin_memcpy(key.addr, sin6.sin6_addr.in6_u.u6_addr8, 16);
+	} else {
+		return true;
+	}
+
+	if(settings->port_filter && !maps__is_filtered_port(port)) {
+		return false;
+	}
+
+	if(settings->addr_filter) {
+		uint8_t *action = maps__get_addr_filter(&key);
+		if(action != NULL && *action == ARG_FILTER_DROP) {
+			return false;
+		}
+	}
+	return true;
+}
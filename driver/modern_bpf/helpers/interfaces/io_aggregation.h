@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: GPL-2.0-only OR MIT
+/*
+ * Copyright (C) 2026 The Falco Authors.
+ *
+ * This file is dual licensed under either the MIT or GPL 2. See MIT.txt
+ * or GPL2.txt for full copies of the license.
+ */
+
+#pragma once
+
+#include <helpers/interfaces/fixed_size_event.h>
+
+/* Pending I/O aggregates are keyed by (tid, fd) in `io_aggregation_table`, while
+ * `io_aggregation_threads` lists the fds of each thread with a pending aggregate, so that all the
+ * aggregates of a thread can be flushed at once.
+ */
+
+#define IO_AGGREGATION_THREAD_FDS_MASK (MAX_IO_AGGREGATION_THREAD_FDS - 1)
+
+/**
+ * @brief Send an aggregate to userspace and forget it. If the ring buffer is
+ * full the aggregate is lost, as any other event. The fd is not removed from
+ * the thread.
+ */
+static __always_inline void io_aggregation__flush(struct io_aggregation_key *key,
+                                                  struct io_aggregation *agg) {
+	struct ringbuf_struct ringbuf;
+	if(ringbuf__reserve_space(&ringbuf, IO_AGGREGATE_E_SIZE, PPME_IO_AGGREGATE_E)) {
+		uint64_t boot_time = maps__get_boot_time();
+
+		ringbuf__store_event_header(&ringbuf);
+
+		/*=============================== COLLECT PARAMETERS ===========================*/
+
+		/* Parameter 1: fd (type: PT_FD) */
+		ringbuf__store_s64(&ringbuf, (int64_t)key->fd);
+
+		/* Parameter 2: rcount (type: PT_UINT64) */
+		ringbuf__store_u64(&ringbuf, agg->read_count);
+
+		/* Parameter 3: rbytes (type: PT_UINT64) */
+		ringbuf__store_u64(&ringbuf, agg->read_bytes);
+
+		/* Parameter 4: wcount (type: PT_UINT64) */
+		ringbuf__store_u64(&ringbuf, agg->write_count);
+
+		/* Parameter 5: wbytes (type: PT_UINT64) */
+		ringbuf__store_u64(&ringbuf, agg->write_bytes);
+
+		/* Parameter 6: first_ts (type: PT_ABSTIME) */
+		ringbuf__store_u64(&ringbuf, boot_time + agg->first_ts);
+
+		/* Parameter 7: last_ts (type: PT_ABSTIME) */
+		ringbuf__store_u64(&ringbuf, boot_time + agg->last_ts);
+
+		/*=============================== COLLECT PARAMETERS ===========================*/
+
+		ringbuf__submit_event(&ringbuf);
+	}
+	maps__delete_io_aggregation(key);
+}
+
+/**
+ * @brief Return the position of `fd` in the fds of `thread`, or
+ * `MAX_IO_AGGREGATION_THREAD_FDS` if it has no pending aggregate.
+ */
+static __always_inline uint32_t io_aggregation__find_fd(struct io_aggregation_thread *thread,
+                                                        int32_t fd) {
+	for(uint32_t i = 0; i < MAX_IO_AGGREGATION_THREAD_FDS; i++) {
+		if(i >= thread->nfds) {
+			break;
+		}
+		if(thread->fds[i] == fd) {
+			return i;
+		}
+	}
+	return MAX_IO_AGGREGATION_THREAD_FDS;
+}
+
+/**
+ * @brief Forget the fd at position `idx` of `thread`. The thread is deleted
+ * with its last fd, `thread` must not be used afterwards.
+ */
+static __always_inline void io_aggregation__remove_fd(uint32_t tid,
+                                                      struct io_aggregation_thread *thread,
+                                                      uint32_t idx) {
+	uint32_t last = thread->nfds - 1;
+	if(last == 0) {
+		maps__delete_io_aggregation_thread(tid);
+		return;
+	}
+	thread->fds[idx & IO_AGGREGATION_THREAD_FDS_MASK] =
+	        thread->fds[last & IO_AGGREGATION_THREAD_FDS_MASK];
+	thread->nfds = last;
+}
+
+/**
+ * @brief Flush all the pending aggregates of a thread and delete it.
+ */
+static __always_inline void io_aggregation__flush_thread(uint32_t tid,
+                                                         struct io_aggregation_thread *thread) {
+	struct io_aggregation_key key = {.tid = tid};
+	for(uint32_t i = 0; i < MAX_IO_AGGREGATION_THREAD_FDS; i++) {
+		if(i >= thread->nfds) {
+			break;
+		}
+		key.fd = thread->fds[i];
+		struct io_aggregation *agg = maps__get_io_aggregation(&key);
+		if(agg != NULL) {
+			io_aggregation__flush(&key, agg);
+		}
+	}
+	maps__delete_io_aggregation_thread(tid);
+}
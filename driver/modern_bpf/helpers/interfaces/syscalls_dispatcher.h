@@ -17,6 +17,89 @@ static __always_inline bool syscalls_dispatcher__64bit_interesting_syscall(uint3
 	return maps__interesting_syscall_64bit(syscall_id);
 }
 
+/**
+ * @brief Check the syscall against the selection of the cgroup of the
+ * current task, if it has one.
+ *
+ * @param syscall_id 64bit syscall id.
+ * @return true if the syscall is interesting for the cgroup.
+ */
+static __always_inline bool syscalls_dispatcher__cgroup_interesting_syscall(uint32_t syscall_id) {
+	struct capture_settings *settings = maps__get_capture_settings();
+	if(settings == NULL || !settings->cgroup_syscalls) {
+		return true;
+	}
+
+	struct cgroup_syscalls *selection = maps__get_cgroup_syscalls(bpf_get_current_cgroup_id());
+	if(selection == NULL) {
+		return true;
+	}
+
+	uint32_t id = syscall_id & (SYSCALL_TABLE_SIZE - 1);
+	return selection->syscalls[id / 8] & (1 << (id % 8));
+}
+
+/**
+ * @brief Check whether the current thread is suppressed by userspace, by
+ * thread id, by `comm` or by cgroup id. Only the maps populated by
+ * userspace are looked up.
+ *
+ * Children of suppressed threads are suppressed on the first syscall exit
+ * they see, the one of `clone`/`fork`, since userspace never receives the
+ * parent event it would otherwise use to suppress them.
+ *
+ * @param syscall_id 64bit syscall id.
+ * @param ret syscall return value.
+ * @return true if the syscall must be dropped.
+ */
+static __always_inline bool syscalls_dispatcher__suppressed_task(uint32_t syscall_id, long ret) {
+	struct capture_settings *settings = maps__get_capture_settings();
+	if(settings == NULL) {
+		return false;
+	}
+
+	/* Threads matching a suppressed comm are added to the suppressed tids, so that their
+	 * descendants stay suppressed after an exec into another comm.
+	 */
+	if(settings->suppress_tids || settings->suppress_comms) {
+		uint64_t pid_tgid = bpf_get_current_pid_tgid();
+		uint32_t tid = (uint32_t)pid_tgid;
+		if(maps__is_suppressed_tid(tid)) {
+			return true;
+		}
+
+		uint16_t ppm_sc = maps__get_ppm_sc(syscall_id);
+		if(ret == 0 && (ppm_sc == PPM_SC_CLONE || ppm_sc == PPM_SC_CLONE3 ||
+		                ppm_sc == PPM_SC_FORK || ppm_sc == PPM_SC_VFORK)) {
+			/* A new thread belongs to the thread group of its creator, while the parent of a
+			 * new process is its `real_parent`.
+			 */
+			uint32_t tgid = (uint32_t)(pid_tgid >> 32);
+			uint32_t parent_tid = tgid != tid ? tgid
+			                                  : (uint32_t)extract__task_ppid_nr(get_current_task());
+			if(maps__is_suppressed_tid(parent_tid)) {
+				maps__suppress_tid(tid);
+				return true;
+			}
+		}
+	}
+
+	if(settings->suppress_comms) {
+		char comm[SUPPRESSED_COMM_LEN] = {0};
+		bpf_get_current_comm(comm, sizeof(comm));
+		if(maps__is_suppressed_comm(comm)) {
+			maps__suppress_tid((uint32_t)bpf_get_current_pid_tgid());
+			return true;
+		}
+	}
+
+	if(settings->suppress_cgroups && maps__is_suppressed_cgroup(bpf_get_current_cgroup_id())) {
+		return true;
+	}
+
+	return false;
+}
+
 /**
  * @brief Check whether the current syscall is a SYS_ACCEPT socketcall routed
  * to the accept4 handler.
@@ -12,6 +12,7 @@
 #include <helpers/base/push_data.h>
 #include <helpers/extract/extract_from_kernel.h>
 #include <helpers/base/stats.h>
+#include <helpers/base/consumers.h>
 
 /* Concept of auxamp (auxiliary map):
  *
@@ -201,10 +202,20 @@ static __always_inline void auxmap__submit_event(struct auxiliary_map *auxmap) {
 		return;
 	}
 
-	/* `BPF_RB_NO_WAKEUP` means that we don't send to userspace a notification
-	 *  when a new event is in the buffer.
+	if(consumers__is_shared()) {
+		consumers__output_event(auxmap->data, auxmap->payload_pos, auxmap->event_type, counter);
+		if(!consumers__is_interesting_event(0, auxmap->event_type)) {
+			return;
+		}
+	}
+
+	/* Unless a wakeup watermark is set we don't send to userspace a notification
+	 * when a new event is in the buffer.
 	 */
-	int err = bpf_ringbuf_output(rb, auxmap->data, auxmap->payload_pos, BPF_RB_NO_WAKEUP);
+	int err = bpf_ringbuf_output(rb,
+	                             auxmap->data,
+	                             auxmap->payload_pos,
+	                             maps__get_ringbuf_wakeup_flags(rb, auxmap->payload_pos, false));
 	if(err) {
 		counter->n_drops_buffer++;
 		compute_event_types_stats(auxmap->event_type, counter);
@@ -12,6 +12,7 @@
 #include <helpers/base/push_data.h>
 #include <helpers/extract/extract_from_kernel.h>
 #include <helpers/base/stats.h>
+#include <helpers/base/consumers.h>
 
 /* `reserved_size - sizeof(uint64_t)` free space is enough because this is the max dimension
  * we put in the ring buffer in one atomic operation.
@@ -170,13 +171,33 @@ static __always_inline void ringbuf__rewrite_header_for_calibration(struct ringb
  * @brief This method states that the collection of the event is
  * terminated.
  *
- * `BPF_RB_NO_WAKEUP` option allow to not notify the userspace
+ * Unless a wakeup watermark is set, userspace is not notified
  * when a new event is submitted.
  *
  * @param ringbuf pointer to the `ringbuf_struct`.
  */
 static __always_inline void ringbuf__submit_event(struct ringbuf_struct *ringbuf) {
-	bpf_ringbuf_submit(ringbuf->data, BPF_RB_NO_WAKEUP);
+	/* The event is reserved in the ring buffer of slot `0`, the other consumers get a copy. */
+	if(consumers__is_shared()) {
+		struct counter_map *counter = maps__get_counter_map();
+		if(counter) {
+			consumers__output_event(ringbuf->data,
+			                        ringbuf->reserved_event_size,
+			                        ringbuf->event_type,
+			                        counter);
+		}
+		if(!consumers__is_interesting_event(0, ringbuf->event_type)) {
+			bpf_ringbuf_discard(ringbuf->data, BPF_RB_NO_WAKEUP);
+			return;
+		}
+	}
+
+	uint64_t flags = BPF_RB_NO_WAKEUP;
+	struct ringbuf_map *rb = maps__get_ringbuf_map();
+	if(rb) {
+		flags = maps__get_ringbuf_wakeup_flags(rb, ringbuf->reserved_event_size, true);
+	}
+	bpf_ringbuf_submit(ringbuf->data, flags);
 }
 
 /////////////////////////////////
@@ -61,6 +61,12 @@ __weak const volatile uint8_t g_64bit_sampling_syscall_table[SYSCALL_TABLE_SIZE]
  */
 __weak const volatile uint32_t g_ia32_to_64_table[SYSCALL_TABLE_SIZE];
 
+/**
+ * @brief Given the syscall id on 64-bit-architectures returns the category of its
+ * exit event, masked with `RATE_LIMIT_CATEGORY_MASK`.
+ */
+__weak const volatile uint8_t g_64bit_rate_limit_category_table[SYSCALL_TABLE_SIZE];
+
 /*=============================== BPF READ-ONLY GLOBAL VARIABLES ===============================*/
 
 /*=============================== BPF GLOBAL VARIABLES ===============================*/
@@ -143,6 +149,16 @@ struct {
 	__type(value, struct capture_settings);
 } capture_settings __weak SEC(".maps");
 
+/**
+ * @brief Token bucket configuration of every event category.
+ */
+struct {
+	__uint(type, BPF_MAP_TYPE_ARRAY);
+	__uint(max_entries, RATE_LIMIT_CATEGORIES);
+	__type(key, uint32_t);
+	__type(value, struct rate_limit);
+} rate_limits __weak SEC(".maps");
+
 #ifdef BPF_ITERATOR_SUPPORT
 
 /**
@@ -205,6 +221,165 @@ struct {
 
 /*=============================== BPF_MAP_TYPE_ARRAY ===============================*/
 
+/*=============================== BPF_MAP_TYPE_HASH ===============================*/
+
+/**
+ * @brief Threads whose syscalls are dropped by the syscall exit dispatcher.
+ * Keys are thread ids seen from the init namespace. Besides userspace,
+ * the dispatcher itself adds the children of suppressed threads, while
+ * the `sched_process_exit` program removes exiting threads.
+ */
+struct {
+	__uint(type, BPF_MAP_TYPE_HASH);
+	__uint(max_entries, MAX_SUPPRESSED_TIDS);
+	__type(key, uint32_t);
+	__type(value, uint8_t);
+} suppressed_tids __weak SEC(".maps");
+
+/**
+ * @brief Process names whose syscalls are dropped by the syscall exit
+ * dispatcher. Keys are NUL-padded `comm` strings.
+ */
+struct {
+	__uint(type, BPF_MAP_TYPE_HASH);
+	__uint(max_entries, MAX_SUPPRESSED_COMMS);
+	__type(key, char[SUPPRESSED_COMM_LEN]);
+	__type(value, uint8_t);
+} suppressed_comms __weak SEC(".maps");
+
+/**
+ * @brief Cgroup v2 ids whose syscalls are dropped by the syscall exit
+ * dispatcher.
+ */
+struct {
+	__uint(type, BPF_MAP_TYPE_HASH);
+	__uint(max_entries, MAX_SUPPRESSED_CGROUPS);
+	__type(key, uint64_t);
+	__type(value, uint8_t);
+} suppressed_cgroups __weak SEC(".maps");
+
+/**
+ * @brief Per-cgroup syscall selection, keyed by cgroup v2 id. Tasks of
+ * cgroups without an entry follow `interesting_syscalls_table_64bit` only.
+ */
+struct {
+	__uint(type, BPF_MAP_TYPE_HASH);
+	__uint(max_entries, MAX_CGROUP_SYSCALLS_ENTRIES);
+	__type(key, uint64_t);
+	__type(value, struct cgroup_syscalls);
+} cgroup_syscalls_table __weak SEC(".maps");
+
+/**
+ * @brief Pending I/O aggregates, keyed by (tid, fd). LRU lists are per-CPU,
+ * an evicted aggregate is lost.
+ */
+struct {
+	__uint(type, BPF_MAP_TYPE_LRU_HASH);
+	__uint(map_flags, BPF_F_NO_COMMON_LRU);
+	__uint(max_entries, MAX_IO_AGGREGATION_ENTRIES);
+	__type(key, struct io_aggregation_key);
+	__type(value, struct io_aggregation);
+} io_aggregation_table __weak SEC(".maps");
+
+/**
+ * @brief The fds with a pending I/O aggregate of each thread, keyed by tid,
+ * so that they can be flushed when the thread exits or after the interval.
+ */
+struct {
+	__uint(type, BPF_MAP_TYPE_LRU_HASH);
+	__uint(max_entries, MAX_IO_AGGREGATION_ENTRIES);
+	__type(key, uint32_t);
+	__type(value, struct io_aggregation_thread);
+} io_aggregation_threads __weak SEC(".maps");
+
+/**
+ * @brief Token buckets of the rate-limited processes, keyed by (tgid,
+ * category). An evicted bucket starts again full.
+ */
+struct {
+	__uint(type, BPF_MAP_TYPE_LRU_HASH);
+	__uint(max_entries, MAX_RATE_LIMIT_ENTRIES);
+	__type(key, struct rate_limit_key);
+	__type(value, struct rate_limit_bucket);
+} rate_limit_buckets __weak SEC(".maps");
+
+/**
+ * @brief Remote ports of interest of connect, when not empty the
+ * connections to other ports are dropped.
+ */
+struct {
+	__uint(type, BPF_MAP_TYPE_HASH);
+	__uint(max_entries, MAX_PORT_FILTER_ENTRIES);
+	__type(key, uint16_t);
+	__type(value, uint8_t);
+} port_filters __weak SEC(".maps");
+
+/**
+ * @brief Processes sharing the probe, keyed by slot. Empty unless userspace
+ * pins the shared maps to let other consumers attach to the probe. Slots are
+ * claimed with `BPF_NOEXIST`, so two consumers can't take the same one.
+ */
+struct {
+	__uint(type, BPF_MAP_TYPE_HASH);
+	__uint(max_entries, MAX_CONSUMERS);
+	__type(key, uint32_t);
+	__type(value, struct consumer);
+} consumers __weak SEC(".maps");
+
+/**
+ * @brief Time at which the threads entered their current syscall, keyed by
+ * tid. Only filled while the syscall latency programs are attached.
+ */
+struct {
+	__uint(type, BPF_MAP_TYPE_LRU_HASH);
+	__uint(max_entries, MAX_SYSCALL_LATENCY_THREADS);
+	__type(key, uint32_t);
+	__type(value, uint64_t);
+} syscall_latency_start __weak SEC(".maps");
+
+/**
+ * @brief Latency histograms keyed by (cgroup, syscall), one copy for each
+ * CPU so that the exit path never contends on them.
+ */
+struct {
+	__uint(type, BPF_MAP_TYPE_PERCPU_HASH);
+	__uint(max_entries, MAX_SYSCALL_LATENCY_ENTRIES);
+	__type(key, struct syscall_latency_key);
+	__type(value, struct syscall_latency_hist);
+} syscall_latency_hists __weak SEC(".maps");
+
+/*=============================== BPF_MAP_TYPE_HASH ===============================*/
+
+/*=============================== BPF_MAP_TYPE_LPM_TRIE ===============================*/
+
+/**
+ * @brief Path prefixes with their `arg_filter_action`, applied to the
+ * absolute paths of the open syscalls. The longest prefix wins, paths
+ * without a match are kept.
+ */
+struct {
+	__uint(type, BPF_MAP_TYPE_LPM_TRIE);
+	__uint(map_flags, BPF_F_NO_PREALLOC);
+	__uint(max_entries, MAX_PATH_FILTER_ENTRIES);
+	__type(key, struct path_filter_key);
+	__type(value, uint8_t);
+} path_filters __weak SEC(".maps");
+
+/**
+ * @brief Address ranges with their `arg_filter_action`, applied to the
+ * remote address of connect. The longest prefix wins, addresses without a
+ * match are kept.
+ */
+struct {
+	__uint(type, BPF_MAP_TYPE_LPM_TRIE);
+	__uint(map_flags, BPF_F_NO_PREALLOC);
+	__uint(max_entries, MAX_ADDR_FILTER_ENTRIES);
+	__type(key, struct addr_filter_key);
+	__type(value, uint8_t);
+} addr_filters __weak SEC(".maps");
+
+/*=============================== BPF_MAP_TYPE_LPM_TRIE ===============================*/
+
 /*=============================== RINGBUF MAP ===============================*/
 
 /**
@@ -227,4 +402,15 @@ struct {
 	__array(values, struct ringbuf_map);
 } ringbuf_maps __weak SEC(".maps");
 
+/**
+ * @brief Ring buffers of the consumers other than the one that loaded the
+ * probe, keyed by `cpu * MAX_CONSUMERS + slot`. Slot `0` uses `ringbuf_maps`.
+ */
+struct {
+	__uint(type, BPF_MAP_TYPE_ARRAY_OF_MAPS);
+	__type(key, uint32_t);
+	__type(value, uint32_t);
+	__array(values, struct ringbuf_map);
+} consumer_ringbuf_maps __weak SEC(".maps");
+
 /*=============================== RINGBUF MAP ===============================*/
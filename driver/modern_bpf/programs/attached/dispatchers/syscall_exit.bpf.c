@@ -9,6 +9,7 @@
 #include <helpers/interfaces/syscalls_dispatcher.h>
 #include <bpf/bpf_helpers.h>
 #include <helpers/interfaces/fixed_size_event.h>
+#include <helpers/interfaces/io_aggregation.h>
 
 SEC("tp_btf/sys_exit")
 int BPF_PROG(t_hotplug) {
@@ -172,6 +173,210 @@ static __always_inline bool sampling_logic_exit(void *ctx, uint32_t id) {
 	return false;
 }
 
+/* Coalesce successful read/write syscalls of the same (tid, fd) into a single
+ * `PPME_IO_AGGREGATE_E` event, sent when one of the thresholds is hit or when the fd is closed.
+ * The aggregates of a thread are also sent on its first syscall after the interval and when it
+ * exits (see `sched_process_exit`).
+ * false: means send the syscall as a regular event
+ * true: means the syscall has been aggregated
+ */
+static __always_inline bool io_aggregation_logic_exit(struct pt_regs *regs,
+                                                      uint32_t syscall_id,
+                                                      long ret) {
+	struct capture_settings *settings = maps__get_capture_settings();
+	if(settings == NULL || !settings->io_aggregation) {
+		return false;
+	}
+
+	uint32_t tid = bpf_get_current_pid_tgid() & 0xffffffff;
+	uint64_t now = bpf_ktime_get_boot_ns();
+	struct io_aggregation_thread *thread = maps__get_io_aggregation_thread(tid);
+	if(thread != NULL && now - thread->first_ts >= settings->io_aggregation_interval_ns) {
+		io_aggregation__flush_thread(tid, thread);
+		thread = NULL;
+	}
+
+	bool is_read = false;
+	bool is_write = false;
+	switch(maps__get_ppm_sc(syscall_id)) {
+	case PPM_SC_READ:
+	case PPM_SC_READV:
+	case PPM_SC_PREAD64:
+	case PPM_SC_PREADV:
+		is_read = true;
+		break;
+	case PPM_SC_WRITE:
+	case PPM_SC_WRITEV:
+	case PPM_SC_PWRITE64:
+	case PPM_SC_PWRITEV:
+		is_write = true;
+		break;
+	case PPM_SC_CLOSE:
+		break;
+	default:
+		return false;
+	}
+
+	struct io_aggregation_key key = {
+	        .tid = tid,
+	        .fd = (int32_t)extract__syscall_argument(regs, 0),
+	};
+	uint32_t idx = MAX_IO_AGGREGATION_THREAD_FDS;
+	if(thread != NULL) {
+		idx = io_aggregation__find_fd(thread, key.fd);
+	}
+
+	/* The pending aggregate precedes the close event. */
+	if(!is_read && !is_write) {
+		if(idx < MAX_IO_AGGREGATION_THREAD_FDS) {
+			struct io_aggregation *agg = maps__get_io_aggregation(&key);
+			if(agg != NULL) {
+				io_aggregation__flush(&key, agg);
+			}
+			io_aggregation__remove_fd(tid, thread, idx);
+		}
+		return false;
+	}
+
+	/* Failures are rare and interesting on their own. */
+	if(ret < 0) {
+		return false;
+	}
+
+	struct io_aggregation *agg = NULL;
+	if(idx < MAX_IO_AGGREGATION_THREAD_FDS) {
+		agg = maps__get_io_aggregation(&key);
+	} else {
+		if(thread == NULL) {
+			thread = maps__new_io_aggregation_thread(tid, now);
+			if(thread == NULL) {
+				return false;
+			}
+		}
+		if(thread->nfds >= MAX_IO_AGGREGATION_THREAD_FDS) {
+			return false;
+		}
+		idx = thread->nfds;
+		thread->fds[idx & IO_AGGREGATION_THREAD_FDS_MASK] = key.fd;
+		thread->nfds++;
+	}
+	if(agg == NULL) {
+		agg = maps__new_io_aggregation(&key, now);
+		if(agg == NULL) {
+			io_aggregation__remove_fd(tid, thread, idx);
+			return false;
+		}
+	}
+
+	if(is_read) {
+		agg->read_count++;
+		agg->read_bytes += ret;
+	} else {
+		agg->write_count++;
+		agg->write_bytes += ret;
+	}
+	agg->last_ts = now;
+
+	if(agg->read_count + agg->write_count >= settings->io_aggregation_max_count ||
+	   agg->read_bytes + agg->write_bytes >= settings->io_aggregation_max_bytes ||
+	   now - agg->first_ts >= settings->io_aggregation_interval_ns) {
+		io_aggregation__flush(&key, agg);
+		io_aggregation__remove_fd(tid, thread, idx);
+	}
+	return true;
+}
+
+/* Tell userspace how many events of a process have been rate limited since the last summary. */
+static __always_inline void rate_limit_flush_summary(struct rate_limit_key *key,
+                                                     struct rate_limit_bucket *bucket,
+                                                     uint64_t now) {
+	struct ringbuf_struct ringbuf;
+	if(!ringbuf__reserve_space(&ringbuf, RATE_LIMIT_DROPS_E_SIZE, PPME_RATE_LIMIT_DROPS_E)) {
+		/* Try again with the next drop. */
+		return;
+	}
+
+	ringbuf__store_event_header(&ringbuf);
+
+	/*=============================== COLLECT PARAMETERS ===========================*/
+
+	/* Parameter 1: tgid (type: PT_PID) */
+	ringbuf__store_s64(&ringbuf, (int64_t)key->tgid);
+
+	/* Parameter 2: category (type: PT_UINT8) */
+	ringbuf__store_u8(&ringbuf, (uint8_t)key->category);
+
+	/* Parameter 3: dropped (type: PT_UINT64) */
+	ringbuf__store_u64(&ringbuf, bucket->dropped);
+
+	/*=============================== COLLECT PARAMETERS ===========================*/
+
+	ringbuf__submit_event(&ringbuf);
+	bucket->dropped = 0;
+	bucket->last_summary_ts = now;
+}
+
+/* Per-process token buckets, one for each event category with a configured rate.
+ * Rate-limited processes get a periodic `PPME_RATE_LIMIT_DROPS_E` summary instead.
+ * false: means don't drop the syscall
+ * true: means drop the syscall
+ */
+static __always_inline bool rate_limit_logic_exit(uint32_t syscall_id) {
+	struct capture_settings *settings = maps__get_capture_settings();
+	if(settings == NULL || !settings->rate_limit) {
+		return false;
+	}
+
+	/* Syscalls needed to keep the userspace state consistent are never limited. */
+	if(maps__64bit_sampling_syscall_table(syscall_id) == UF_NEVER_DROP) {
+		return false;
+	}
+
+	uint32_t category = maps__64bit_rate_limit_category(syscall_id);
+	struct rate_limit *limit = maps__get_rate_limit(category);
+	if(limit == NULL || limit->rate == 0) {
+		return false;
+	}
+
+	uint64_t now = bpf_ktime_get_boot_ns();
+	struct rate_limit_key key = {
+	        .tgid = bpf_get_current_pid_tgid() >> 32,
+	        .category = category,
+	};
+	struct rate_limit_bucket *bucket = maps__get_rate_limit_bucket(&key, limit, now);
+	if(bucket == NULL) {
+		return false;
+	}
+
+	/* Refill, avoiding overflows when the bucket has been idle for long. */
+	uint64_t max_credit = limit->burst * SECOND_TO_NS;
+	uint64_t elapsed = now - bucket->last_refill_ts;
+	bucket->last_refill_ts = now;
+	if(elapsed >= max_credit / limit->rate) {
+		bucket->credit = max_credit;
+	} else {
+		bucket->credit += elapsed * limit->rate;
+		if(bucket->credit > max_credit) {
+			bucket->credit = max_credit;
+		}
+	}
+
+	if(bucket->credit >= SECOND_TO_NS) {
+		bucket->credit -= SECOND_TO_NS;
+		/* The process is back under its rate, report what it lost until now. */
+		if(bucket->dropped != 0) {
+			rate_limit_flush_summary(&key, bucket, now);
+		}
+		return false;
+	}
+
+	bucket->dropped++;
+	if(now - bucket->last_summary_ts >= settings->rate_limit_summary_interval_ns) {
+		rate_limit_flush_summary(&key, bucket, now);
+	}
+	return true;
+}
+
 #define X86_64_NR_EXECVE 59
 #define X86_64_NR_EXECVEAT 322
 
@@ -237,6 +442,14 @@ int BPF_PROG(sys_exit, struct pt_regs *regs, long ret) {
 		return 0;
 	}
 
+	if(!syscalls_dispatcher__cgroup_interesting_syscall(syscall_id)) {
+		return 0;
+	}
+
+	if(syscalls_dispatcher__suppressed_task(syscall_id, ret)) {
+		return 0;
+	}
+
 	if(sampling_logic_exit(ctx, syscall_id)) {
 		return 0;
 	}
@@ -255,6 +468,14 @@ int BPF_PROG(sys_exit, struct pt_regs *regs, long ret) {
 		return 0;
 	}
 
+	if(io_aggregation_logic_exit(regs, syscall_id, ret)) {
+		return 0;
+	}
+
+	if(rate_limit_logic_exit(syscall_id)) {
+		return 0;
+	}
+
 	bpf_tail_call(ctx, &syscall_exit_tail_table, syscall_id);
 
 	return 0;
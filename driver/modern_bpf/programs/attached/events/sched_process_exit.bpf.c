@@ -7,6 +7,7 @@
  */
 
 #include <helpers/interfaces/variable_size_event.h>
+#include <helpers/interfaces/io_aggregation.h>
 #include <driver/systype_compat.h>
 
 /* The instruction limit is 1000000, so we shouldn't have issues */
@@ -139,6 +140,23 @@ static __always_inline pid_t find_new_reaper_pid(struct task_struct *father) {
  */
 SEC("tp_btf/sched_process_exit")
 int BPF_PROG(sched_proc_exit, struct task_struct *task) {
+	/* The tid can be reused by a new thread, it must not inherit the suppression. */
+	struct capture_settings *settings = maps__get_capture_settings();
+	if(settings != NULL && (settings->suppress_tids || settings->suppress_comms)) {
+		maps__unsuppress_tid((uint32_t)READ_TASK_FIELD(task, pid));
+	}
+
+	/* The pending I/O aggregates precede the exit event, and a thread reusing the tid must not
+	 * inherit them.
+	 */
+	if(settings != NULL && settings->io_aggregation) {
+		uint32_t tid = (uint32_t)READ_TASK_FIELD(task, pid);
+		struct io_aggregation_thread *thread = maps__get_io_aggregation_thread(tid);
+		if(thread != NULL) {
+			io_aggregation__flush_thread(tid, thread);
+		}
+	}
+
 	/* NOTE: this is a fixed-size event and so we should use the `ringbuf-approach`.
 	 * Unfortunately we are hitting a sort of complexity limit in some kernel versions (<5.10)
 	 * It seems like the verifier is not able to recognize the `ringbuf` pointer as a real pointer
@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: GPL-2.0-only OR MIT
+/*
+ * Copyright (C) 2026 The Falco Authors.
+ *
+ * This file is dual licensed under either the MIT or GPL 2. See MIT.txt
+ * or GPL2.txt for full copies of the license.
+ */
+
+#include <helpers/base/maps_getters.h>
+#include <helpers/extract/extract_from_kernel.h>
+
+/* These programs are attached only when userspace asks for syscall latency histograms. They never
+ * send events: the enter one records when the thread entered the syscall, the exit one adds the
+ * elapsed time to the histogram of the (cgroup, syscall) pair.
+ */
+
+static __always_inline uint32_t syscall_latency__log2(uint64_t v) {
+	uint32_t r = 0;
+	uint32_t shift;
+
+	shift = (v > 0xFFFFFFFF) << 5;
+	v >>= shift;
+	r |= shift;
+	shift = (v > 0xFFFF) << 4;
+	v >>= shift;
+	r |= shift;
+	shift = (v > 0xFF) << 3;
+	v >>= shift;
+	r |= shift;
+	shift = (v > 0xF) << 2;
+	v >>= shift;
+	r |= shift;
+	shift = (v > 0x3) << 1;
+	v >>= shift;
+	r |= shift;
+	r |= (v >> 1);
+	return r;
+}
+
+/* From linux tree: /include/trace/events/syscall.h
+ * TP_PROTO(struct pt_regs *regs, long id),
+ */
+SEC("tp_btf/sys_enter")
+int BPF_PROG(sys_enter_latency, struct pt_regs *regs, long id) {
+	uint32_t tid = bpf_get_current_pid_tgid() & 0xffffffff;
+	uint64_t ts = bpf_ktime_get_boot_ns();
+	bpf_map_update_elem(&syscall_latency_start, &tid, &ts, BPF_ANY);
+	return 0;
+}
+
+/* From linux tree: /include/trace/events/syscall.h
+ * TP_PROTO(struct pt_regs *regs, long ret),
+ */
+SEC("tp_btf/sys_exit")
+int BPF_PROG(sys_exit_latency, struct pt_regs *regs, long ret) {
+	uint32_t tid = bpf_get_current_pid_tgid() & 0xffffffff;
+	uint64_t *start = bpf_map_lookup_elem(&syscall_latency_start, &tid);
+	/* The thread entered the syscall before the programs were attached. */
+	if(start == NULL) {
+		return 0;
+	}
+	uint64_t delta = bpf_ktime_get_boot_ns() - *start;
+	bpf_map_delete_elem(&syscall_latency_start, &tid);
+
+	uint32_t syscall_id = extract__syscall_id(regs);
+	if(syscall_id == (uint32_t)-1) {
+		return 0;
+	}
+	if(bpf_in_ia32_syscall()) {
+		syscall_id = maps__ia32_to_64(syscall_id);
+		if(syscall_id == (uint32_t)-1) {
+			return 0;
+		}
+	}
+
+	struct syscall_latency_key key = {
+	        .cgroup_id = bpf_get_current_cgroup_id(),
+	        .syscall_id = syscall_id,
+	};
+	struct syscall_latency_hist *hist = bpf_map_lookup_elem(&syscall_latency_hists, &key);
+	if(hist == NULL) {
+		/* When the map is full the new pairs are not measured. */
+		struct syscall_latency_hist zero = {};
+		bpf_map_update_elem(&syscall_latency_hists, &key, &zero, BPF_NOEXIST);
+		hist = bpf_map_lookup_elem(&syscall_latency_hists, &key);
+		if(hist == NULL) {
+			return 0;
+		}
+	}
+
+	uint32_t bucket = syscall_latency__log2(delta);
+	if(bucket >= SYSCALL_LATENCY_BUCKETS) {
+		bucket = SYSCALL_LATENCY_BUCKETS - 1;
+	}
+	/* Per-CPU values, no need for atomic operations. */
+	hist->buckets[bucket & (SYSCALL_LATENCY_BUCKETS - 1)]++;
+	hist->sum_ns += delta;
+	return 0;
+}
@@ -7,6 +7,7 @@
  */
 
 #include <helpers/interfaces/variable_size_event.h>
+#include <helpers/interfaces/arg_filters.h>
 #include <asm-generic/errno.h>
 
 /*=============================== EXIT EVENT ===========================*/
@@ -30,6 +31,9 @@ int BPF_PROG(connect_x, struct pt_regs *regs, long ret) {
 	auxmap__store_s64_param(auxmap, ret);
 
 	struct sockaddr *usrsockaddr = (struct sockaddr *)args[1];
+	if(!arg_filters__keep_sockaddr(usrsockaddr)) {
+		return 0;
+	}
 
 	/* Parameter 2: tuple (type: PT_SOCKTUPLE) */
 	if(ret == 0 || ret == -EINPROGRESS) {
@@ -7,6 +7,7 @@
  */
 
 #include <helpers/interfaces/variable_size_event.h>
+#include <helpers/interfaces/arg_filters.h>
 
 /*=============================== EXIT EVENT ===========================*/
 
@@ -34,7 +35,11 @@ int BPF_PROG(open_x, struct pt_regs *regs, long ret) {
 
 	/* Parameter 2: name (type: PT_FSPATH) */
 	unsigned long name_pointer = extract__syscall_argument(regs, 0);
-	auxmap__store_charbuf_param(auxmap, name_pointer, MAX_PATH, USER);
+	uint64_t path_pos = auxmap->payload_pos;
+	uint16_t path_len = auxmap__store_charbuf_param(auxmap, name_pointer, MAX_PATH, USER);
+	if(!arg_filters__keep_path(auxmap, path_pos, path_len)) {
+		return 0;
+	}
 
 	/* Parameter 3: flags (type: PT_FLAGS32) */
 	uint32_t flags = (uint32_t)extract__syscall_argument(regs, 1);
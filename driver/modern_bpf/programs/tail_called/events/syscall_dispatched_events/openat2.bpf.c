@@ -7,6 +7,7 @@
  */
 
 #include <helpers/interfaces/variable_size_event.h>
+#include <helpers/interfaces/arg_filters.h>
 
 /*=============================== EXIT EVENT ===========================*/
 
@@ -41,7 +42,11 @@ int BPF_PROG(openat2_x, struct pt_regs *regs, long ret) {
 
 	/* Parameter 3: name (type: PT_FSRELPATH) */
 	unsigned long path_pointer = extract__syscall_argument(regs, 1);
-	auxmap__store_charbuf_param(auxmap, path_pointer, MAX_PATH, USER);
+	uint64_t path_pos = auxmap->payload_pos;
+	uint16_t path_len = auxmap__store_charbuf_param(auxmap, path_pointer, MAX_PATH, USER);
+	if(!arg_filters__keep_path(auxmap, path_pos, path_len)) {
+		return 0;
+	}
 
 	/* the `open_how` struct is defined since kernel version 5.6 */
 	unsigned long open_how_pointer = extract__syscall_argument(regs, 2);
@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <driver/ppm_events_public.h>
+
 /* Here we have all definitions required both by
  * BPF programs and `libpman` library.
  */
@@ -18,6 +20,52 @@
  */
 #define AUXILIARY_MAP_SIZE 128 * 1024
 
+/* Maximum number of entries of the in-kernel suppression maps. */
+#define MAX_SUPPRESSED_TIDS 16384
+#define MAX_SUPPRESSED_COMMS 256
+#define MAX_SUPPRESSED_CGROUPS 1024
+
+/* Maximum number of cgroups with their own syscall selection. */
+#define MAX_CGROUP_SYSCALLS_ENTRIES 1024
+
+/* Maximum number of (tid, fd) pairs with a pending I/O aggregate. */
+#define MAX_IO_AGGREGATION_ENTRIES 16384
+
+/* Maximum number of fds with a pending I/O aggregate per thread (a power of 2), I/O on further
+ * fds is sent as regular events.
+ */
+#define MAX_IO_AGGREGATION_THREAD_FDS 8
+
+/* Maximum number of (tgid, category) token buckets. */
+#define MAX_RATE_LIMIT_ENTRIES 16384
+
+/* Rate limits are configured per `ppm_event_category`, masked with `RATE_LIMIT_CATEGORY_MASK`
+ * so that the I/O categories keep their own slot.
+ */
+#define RATE_LIMIT_CATEGORIES 64
+#define RATE_LIMIT_CATEGORY_MASK (RATE_LIMIT_CATEGORIES - 1)
+
+/* Maximum number of entries of the argument filter maps. */
+#define MAX_PATH_FILTER_ENTRIES 1024
+#define MAX_PORT_FILTER_ENTRIES 1024
+#define MAX_ADDR_FILTER_ENTRIES 1024
+
+/* Paths are matched on their first `MAX_PATH_FILTER_LEN` bytes. */
+#define MAX_PATH_FILTER_LEN 256
+
+/* Maximum number of consumers sharing the probe, the one that loaded it included. */
+#define MAX_CONSUMERS 4
+
+/* Maximum number of threads in a syscall and of (cgroup, syscall) latency histograms. */
+#define MAX_SYSCALL_LATENCY_THREADS 16384
+#define MAX_SYSCALL_LATENCY_ENTRIES 8192
+
+/* Bucket `i` counts the syscalls that took [2^i, 2^(i+1)) ns, the last one the slower ones. */
+#define SYSCALL_LATENCY_BUCKETS 32
+
+/* Same as the kernel `TASK_COMM_LEN`, it is the key size of the `suppressed_comms` map. */
+#define SUPPRESSED_COMM_LEN 16
+
 /**
  * @brief General settings shared among all the CPUs.
  *
@@ -33,6 +81,146 @@ struct capture_settings {
 	uint16_t fullcapture_port_range_end;   /* last interesting port */
 	uint16_t statsd_port;                  /* port for statsd metrics */
 	int32_t scap_tid;                      /* tid of the scap process */
+	bool suppress_tids;                    /* `suppressed_tids` map is not empty */
+	bool suppress_comms;                   /* `suppressed_comms` map is not empty */
+	bool suppress_cgroups;                 /* `suppressed_cgroups` map is not empty */
+	bool cgroup_syscalls;                  /* `cgroup_syscalls_table` map is not empty */
+	bool io_aggregation;                   /* coalesce read/write syscalls per (tid, fd) */
+	uint32_t io_aggregation_max_count;     /* flush an aggregate after this many syscalls */
+	uint64_t io_aggregation_max_bytes;     /* flush an aggregate after this many bytes */
+	uint64_t io_aggregation_interval_ns;   /* flush an aggregate older than this */
+	bool rate_limit;                       /* `rate_limits` has at least one limit */
+	bool path_filter;                      /* `path_filters` map is not empty */
+	bool port_filter;                      /* `port_filters` map is not empty */
+	bool addr_filter;                      /* `addr_filters` map is not empty */
+	uint64_t rate_limit_summary_interval_ns; /* minimum time between two drop summaries */
+	uint64_t wakeup_watermark; /* wake userspace up when a ring buffer reaches these bytes */
+	bool multi_consumer;       /* `consumers` map has more than one consumer */
+};
+
+/**
+ * @brief A process reading the events of the probe, stored in the `consumers` map.
+ * Slot `0` is the process that loaded and attached the probe. The interesting
+ * syscalls and the snaplen of the probe are the union and the maximum of the
+ * ones of all the consumers, and the programs are attached for the union of
+ * their ppm_sc.
+ */
+struct consumer {
+	int32_t tgid;                               /* consumer process, to reclaim stale slots */
+	uint32_t snaplen;                           /* snaplen requested by the consumer */
+	uint8_t syscalls[SYSCALL_TABLE_SIZE / 8];   /* interesting 64bit syscalls, one bit each */
+	uint8_t events[PPM_EVENT_MAX / 8 + 1];      /* events sent to the consumer, one bit each */
+	uint8_t ppm_sc[PPM_SC_MAX / 8 + 1];         /* interesting ppm_sc, one bit each */
+};
+
+/**
+ * @brief Syscalls of interest for the tasks of a cgroup, one bit for each
+ * 64bit syscall id. They can only restrict the global selection.
+ */
+struct cgroup_syscalls {
+	uint8_t syscalls[SYSCALL_TABLE_SIZE / 8];
+};
+
+/**
+ * @brief Key of the `io_aggregation_table` map.
+ */
+struct io_aggregation_key {
+	uint32_t tid;
+	int32_t fd;
+};
+
+/**
+ * @brief Read and write syscalls of a thread on an fd, not yet sent to
+ * userspace. Timestamps are monotonic boot times.
+ */
+struct io_aggregation {
+	uint64_t read_count;
+	uint64_t read_bytes;
+	uint64_t write_count;
+	uint64_t write_bytes;
+	uint64_t first_ts;
+	uint64_t last_ts;
+};
+
+/**
+ * @brief The fds of a thread with a pending I/O aggregate, stored in the
+ * `io_aggregation_threads` map. An aggregate whose fd is not listed here is
+ * stale and is overwritten.
+ */
+struct io_aggregation_thread {
+	uint64_t first_ts; /* `first_ts` of the oldest pending aggregate */
+	int32_t fds[MAX_IO_AGGREGATION_THREAD_FDS];
+	uint32_t nfds;
+};
+
+/**
+ * @brief Key of the `syscall_latency_hists` map.
+ */
+struct syscall_latency_key {
+	uint64_t cgroup_id; /* cgroup v2 id of the thread. */
+	uint32_t syscall_id;
+	uint32_t pad;
+};
+
+/**
+ * @brief log2 histogram of the latency of a syscall, one for each CPU.
+ */
+struct syscall_latency_hist {
+	uint64_t buckets[SYSCALL_LATENCY_BUCKETS];
+	uint64_t sum_ns; /* total time spent in the syscall. */
+};
+
+/**
+ * @brief Verdict of an argument filter entry.
+ */
+enum arg_filter_action {
+	ARG_FILTER_KEEP = 1,
+	ARG_FILTER_DROP = 2,
+};
+
+/**
+ * @brief Key of the `path_filters` LPM trie, `prefixlen` is in bits.
+ */
+struct path_filter_key {
+	uint32_t prefixlen;
+	char path[MAX_PATH_FILTER_LEN];
+};
+
+/**
+ * @brief Key of the `addr_filters` LPM trie, `prefixlen` is in bits. IPv4
+ * addresses are mapped into IPv6 ones (`::ffff:a.b.c.d`).
+ */
+struct addr_filter_key {
+	uint32_t prefixlen;
+	uint8_t addr[16];
+};
+
+/**
+ * @brief Token bucket configuration of an event category, `rate == 0`
+ * means no limit.
+ */
+struct rate_limit {
+	uint64_t rate;  /* events per second. */
+	uint64_t burst; /* maximum number of events in a burst. */
+};
+
+/**
+ * @brief Key of the `rate_limit_buckets` map.
+ */
+struct rate_limit_key {
+	uint32_t tgid;
+	uint32_t category;
+};
+
+/**
+ * @brief Token bucket of a process for an event category. Credits are
+ * tokens multiplied by `SECOND_TO_NS`, timestamps are monotonic boot times.
+ */
+struct rate_limit_bucket {
+	uint64_t credit;
+	uint64_t last_refill_ts;
+	uint64_t dropped;         /* events dropped since the last summary. */
+	uint64_t last_summary_ts; /* time of the last summary. */
 };
 
 /**
@@ -1584,7 +1584,11 @@ typedef enum {
 	PPME_SYSCALL_CLOSE_RANGE_X = 451,
 	PPME_SYSCALL_KEYCTL_E = 452,
 	PPME_SYSCALL_KEYCTL_X = 453,
-	PPM_EVENT_MAX = 454
+	PPME_IO_AGGREGATE_E = 454,
+	PPME_IO_AGGREGATE_X = 455, /* This should never be called */
+	PPME_RATE_LIMIT_DROPS_E = 456,
+	PPME_RATE_LIMIT_DROPS_X = 457, /* This should never be called */
+	PPM_EVENT_MAX = 458
 } ppm_event_code;
 /*@}*/
 
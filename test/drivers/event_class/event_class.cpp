@@ -3,6 +3,7 @@
 #include <time.h>
 #include <sys/vfs.h> /* or <sys/statfs.h> */
 #include <linux/magic.h>
+#include <sys/prctl.h>
 
 #define MAX_CHARBUF_NUM 16
 #define CGROUP_NUMBER 5
@@ -192,6 +193,73 @@ void event_test::disable_drop_failed() {
 	scap_set_dropfailed(s_scap_handle, false);
 }
 
+int32_t event_test::suppress_current_tid(bool suppress) {
+	return scap_suppress_tid(s_scap_handle,
+	                         suppress ? SCAP_SUPPRESS_ADD : SCAP_SUPPRESS_REMOVE,
+	                         syscall(__NR_gettid));
+}
+
+int32_t event_test::suppress_current_comm(bool suppress) {
+	char comm[16] = {0};
+	prctl(PR_GET_NAME, comm);
+	return scap_suppress_comm(s_scap_handle,
+	                          suppress ? SCAP_SUPPRESS_ADD : SCAP_SUPPRESS_REMOVE,
+	                          comm);
+}
+
+int32_t event_test::set_cgroup_sc_set(uint64_t cgroup_id, const bool* ppm_sc_set) {
+	return scap_set_cgroup_ppm_sc(s_scap_handle, cgroup_id, ppm_sc_set);
+}
+
+int32_t event_test::set_io_aggregation(uint32_t max_count,
+                                       uint64_t max_bytes,
+                                       uint64_t interval_ns) {
+	scap_io_aggregation_params params = {max_count, max_bytes, interval_ns};
+	return scap_set_io_aggregation(s_scap_handle, max_count != 0 ? &params : NULL);
+}
+
+int32_t event_test::set_rate_limit(uint8_t category,
+                                   uint64_t rate,
+                                   uint64_t burst,
+                                   uint64_t summary_interval_ns) {
+	scap_rate_limit_params params = {category, rate, burst, summary_interval_ns};
+	return scap_set_rate_limit(s_scap_handle, &params);
+}
+
+int32_t event_test::set_path_filter(const char* prefix, scap_arg_filter_action action) {
+	scap_arg_filter_params params = {};
+	params.type = SCAP_ARG_FILTER_PATH;
+	params.action = action;
+	params.path = prefix;
+	return scap_set_arg_filter(s_scap_handle, &params);
+}
+
+int32_t event_test::clear_arg_filters() {
+	scap_arg_filter_params params = {};
+	params.type = SCAP_ARG_FILTER_CLEAR;
+	return scap_set_arg_filter(s_scap_handle, &params);
+}
+
+int32_t event_test::set_syscall_latency(bool enable) {
+	return scap_set_syscall_latency(s_scap_handle, enable);
+}
+
+bool event_test::get_metric_v2(uint32_t flags, const char* name, uint64_t* value) {
+	uint32_t nstats = 0;
+	int32_t rc = 0;
+	const metrics_v2* stats = scap_get_stats_v2(s_scap_handle, flags, &nstats, &rc);
+	if(stats == NULL || rc != SCAP_SUCCESS) {
+		return false;
+	}
+	for(uint32_t i = 0; i < nstats; i++) {
+		if(strcmp(stats[i].name, name) == 0) {
+			*value = stats[i].value.u64;
+			return true;
+		}
+	}
+	return false;
+}
+
 void event_test::set_do_dynamic_snaplen(bool enable) {
 	if(enable) {
 		scap_enable_dynamic_snaplen(s_scap_handle);
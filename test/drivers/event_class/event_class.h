@@ -223,6 +223,76 @@ public:
 	 */
 	void disable_drop_failed();
 
+	/**
+	 * @brief Add or remove the current thread from the threads
+	 * suppressed by the driver.
+	 *
+	 * @return `SCAP_SUCCESS` or a failure code.
+	 */
+	int32_t suppress_current_tid(bool suppress);
+
+	/**
+	 * @brief Add or remove the current process name from the names
+	 * suppressed by the driver.
+	 *
+	 * @return `SCAP_SUCCESS` or a failure code.
+	 */
+	int32_t suppress_current_comm(bool suppress);
+
+	/**
+	 * @brief Restrict the syscalls collected for a cgroup.
+	 *
+	 * @return `SCAP_SUCCESS` or a failure code.
+	 */
+	int32_t set_cgroup_sc_set(uint64_t cgroup_id, const bool* ppm_sc_set);
+
+	/**
+	 * @brief Coalesce read/write syscalls per (tid, fd), `max_count == 0`
+	 * disables the aggregation.
+	 *
+	 * @return `SCAP_SUCCESS` or a failure code.
+	 */
+	int32_t set_io_aggregation(uint32_t max_count, uint64_t max_bytes, uint64_t interval_ns);
+
+	/**
+	 * @brief Rate limit the syscalls of an event category, `rate == 0`
+	 * removes the limit.
+	 *
+	 * @return `SCAP_SUCCESS` or a failure code.
+	 */
+	int32_t set_rate_limit(uint8_t category,
+	                       uint64_t rate,
+	                       uint64_t burst,
+	                       uint64_t summary_interval_ns);
+
+	/**
+	 * @brief Add or remove a path prefix from the argument filters.
+	 *
+	 * @return `SCAP_SUCCESS` or a failure code.
+	 */
+	int32_t set_path_filter(const char* prefix, scap_arg_filter_action action);
+
+	/**
+	 * @brief Remove all the argument filters.
+	 *
+	 * @return `SCAP_SUCCESS` or a failure code.
+	 */
+	int32_t clear_arg_filters();
+
+	/**
+	 * @brief Enable/Disable the syscall latency histograms.
+	 *
+	 * @return `SCAP_SUCCESS` or a failure code.
+	 */
+	int32_t set_syscall_latency(bool enable);
+
+	/**
+	 * @brief Get the value of a `metrics_v2` metric by name.
+	 *
+	 * @return `true` if the metric was found.
+	 */
+	bool get_metric_v2(uint32_t flags, const char* name, uint64_t* value);
+
 	/**
 	 * @brief Enable/Disable dynamic snaplen logic
 	 *
@@ -0,0 +1,62 @@
+#include "../../event_class/event_class.h"
+
+#include <fcntl.h>
+
+#if defined(__NR_openat) && defined(__NR_close)
+TEST(Actions, path_filter) {
+	auto evt_test = get_syscall_event_test(__NR_openat, EXIT_EVENT);
+
+	if(!evt_test->is_modern_bpf_engine()) {
+		GTEST_SKIP() << "argument filters are only supported by the modern ebpf probe";
+	}
+
+	/* `/dev/zero` is carved out of the dropped `/dev/` prefix */
+	ASSERT_EQ(evt_test->set_path_filter("/dev/", SCAP_ARG_FILTER_DROP), SCAP_SUCCESS);
+	ASSERT_EQ(evt_test->set_path_filter("/dev/zero", SCAP_ARG_FILTER_KEEP), SCAP_SUCCESS);
+
+	evt_test->enable_capture();
+
+	int fd = syscall(__NR_openat, AT_FDCWD, "/dev/null", O_RDONLY);
+	assert_syscall_state(SYSCALL_SUCCESS, "openat", fd, NOT_EQUAL, -1);
+	syscall(__NR_close, fd);
+
+	evt_test->disable_capture();
+
+	evt_test->assert_event_absence();
+
+	evt_test->enable_capture();
+
+	fd = syscall(__NR_openat, AT_FDCWD, "/dev/zero", O_RDONLY);
+	assert_syscall_state(SYSCALL_SUCCESS, "openat", fd, NOT_EQUAL, -1);
+	syscall(__NR_close, fd);
+
+	evt_test->disable_capture();
+
+	ASSERT_EQ(evt_test->clear_arg_filters(), SCAP_SUCCESS);
+
+	evt_test->assert_event_presence();
+}
+
+TEST(Actions, path_filter_not_normalized) {
+	auto evt_test = get_syscall_event_test(__NR_openat, EXIT_EVENT);
+
+	if(!evt_test->is_modern_bpf_engine()) {
+		GTEST_SKIP() << "argument filters are only supported by the modern ebpf probe";
+	}
+
+	ASSERT_EQ(evt_test->set_path_filter("/dev/", SCAP_ARG_FILTER_DROP), SCAP_SUCCESS);
+
+	evt_test->enable_capture();
+
+	/* Userspace could normalize it to a path outside of the prefix */
+	int fd = syscall(__NR_openat, AT_FDCWD, "/dev/../dev/null", O_RDONLY);
+	assert_syscall_state(SYSCALL_SUCCESS, "openat", fd, NOT_EQUAL, -1);
+	syscall(__NR_close, fd);
+
+	evt_test->disable_capture();
+
+	ASSERT_EQ(evt_test->clear_arg_filters(), SCAP_SUCCESS);
+
+	evt_test->assert_event_presence();
+}
+#endif
@@ -0,0 +1,60 @@
+#include "../../event_class/event_class.h"
+
+#include <fstream>
+#include <string>
+#include <sys/stat.h>
+
+#if defined(__NR_unshare)
+
+/* On cgroup v2 the cgroup id is the inode number of the cgroup directory. */
+static uint64_t current_cgroup_id() {
+	std::ifstream f("/proc/self/cgroup");
+	std::string line;
+	while(std::getline(f, line)) {
+		if(line.rfind("0::", 0) == 0) {
+			struct stat st;
+			std::string path = "/sys/fs/cgroup" + line.substr(3);
+			if(stat(path.c_str(), &st) == 0) {
+				return st.st_ino;
+			}
+		}
+	}
+	return 0;
+}
+
+TEST(Actions, cgroup_sc_set) {
+	auto evt_test = get_syscall_event_test(__NR_unshare, EXIT_EVENT);
+
+	if(!evt_test->is_modern_bpf_engine()) {
+		GTEST_SKIP() << "per-cgroup syscalls are only supported by the modern ebpf probe";
+	}
+
+	uint64_t cgroup_id = current_cgroup_id();
+	if(cgroup_id == 0) {
+		GTEST_SKIP() << "cgroup v2 is not available";
+	}
+
+	/* Nothing is collected for our cgroup */
+	bool ppm_sc_set[PPM_SC_MAX] = {};
+	ASSERT_EQ(evt_test->set_cgroup_sc_set(cgroup_id, ppm_sc_set), SCAP_SUCCESS);
+
+	evt_test->enable_capture();
+
+	syscall(__NR_unshare, 0);
+
+	evt_test->assert_event_absence();
+
+	evt_test->disable_capture();
+
+	/* The global selection applies again */
+	ASSERT_EQ(evt_test->set_cgroup_sc_set(cgroup_id, nullptr), SCAP_SUCCESS);
+
+	evt_test->enable_capture();
+
+	syscall(__NR_unshare, 0);
+
+	evt_test->assert_event_presence();
+
+	evt_test->disable_capture();
+}
+#endif
@@ -0,0 +1,140 @@
+#include "../../event_class/event_class.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#if defined(__NR_write) && defined(__NR_openat) && defined(__NR_close)
+TEST(Actions, io_aggregation) {
+	auto evt_test = get_syscall_event_test(__NR_write, EXIT_EVENT);
+
+	if(!evt_test->is_modern_bpf_engine()) {
+		GTEST_SKIP() << "the I/O aggregation is only supported by the modern ebpf probe";
+	}
+
+	/* The third write hits the count threshold */
+	ASSERT_EQ(evt_test->set_io_aggregation(3, UINT64_MAX, UINT64_MAX), SCAP_SUCCESS);
+
+	int fd = syscall(__NR_openat, AT_FDCWD, "/dev/null", O_WRONLY);
+	assert_syscall_state(SYSCALL_SUCCESS, "openat", fd, NOT_EQUAL, -1);
+
+	evt_test->enable_capture();
+
+	const char buf[] = "aggregated";
+	for(int i = 0; i < 3; i++) {
+		assert_syscall_state(SYSCALL_SUCCESS,
+		                     "write",
+		                     syscall(__NR_write, fd, buf, sizeof(buf)),
+		                     EQUAL,
+		                     sizeof(buf));
+	}
+
+	evt_test->disable_capture();
+
+	syscall(__NR_close, fd);
+
+	ASSERT_EQ(evt_test->set_io_aggregation(0, 0, 0), SCAP_SUCCESS);
+
+	evt_test->assert_event_presence(CURRENT_PID, PPME_IO_AGGREGATE_E);
+
+	if(HasFatalFailure()) {
+		return;
+	}
+
+	evt_test->parse_event();
+
+	evt_test->assert_header();
+
+	/*=============================== ASSERT PARAMETERS  ===========================*/
+
+	/* Parameter 1: fd (type: PT_FD) */
+	evt_test->assert_numeric_param(1, (int64_t)fd);
+
+	/* Parameter 2: rcount (type: PT_UINT64) */
+	evt_test->assert_numeric_param(2, (uint64_t)0);
+
+	/* Parameter 3: rbytes (type: PT_UINT64) */
+	evt_test->assert_numeric_param(3, (uint64_t)0);
+
+	/* Parameter 4: wcount (type: PT_UINT64) */
+	evt_test->assert_numeric_param(4, (uint64_t)3);
+
+	/* Parameter 5: wbytes (type: PT_UINT64) */
+	evt_test->assert_numeric_param(5, (uint64_t)(3 * sizeof(buf)));
+
+	/* Parameter 6: first_ts (type: PT_ABSTIME) */
+	evt_test->assert_numeric_param(6, (uint64_t)0, GREATER);
+
+	/* Parameter 7: last_ts (type: PT_ABSTIME) */
+	evt_test->assert_numeric_param(7, (uint64_t)0, GREATER);
+
+	/*=============================== ASSERT PARAMETERS  ===========================*/
+
+	evt_test->assert_num_params_pushed(7);
+}
+#endif
+
+#if defined(__NR_write) && defined(__NR_openat) && defined(__NR_close)
+TEST(Actions, io_aggregation_thread_interval) {
+	auto evt_test = get_syscall_event_test(__NR_write, EXIT_EVENT);
+
+	if(!evt_test->is_modern_bpf_engine()) {
+		GTEST_SKIP() << "the I/O aggregation is only supported by the modern ebpf probe";
+	}
+
+	/* Only the interval can flush, after 1 ms */
+	ASSERT_EQ(evt_test->set_io_aggregation(UINT32_MAX, UINT64_MAX, 1000000), SCAP_SUCCESS);
+
+	int idle_fd = syscall(__NR_openat, AT_FDCWD, "/dev/null", O_WRONLY);
+	assert_syscall_state(SYSCALL_SUCCESS, "openat", idle_fd, NOT_EQUAL, -1);
+	int busy_fd = syscall(__NR_openat, AT_FDCWD, "/dev/null", O_WRONLY);
+	assert_syscall_state(SYSCALL_SUCCESS, "openat", busy_fd, NOT_EQUAL, -1);
+
+	evt_test->enable_capture();
+
+	const char buf[] = "aggregated";
+	assert_syscall_state(SYSCALL_SUCCESS,
+	                     "write",
+	                     syscall(__NR_write, idle_fd, buf, sizeof(buf)),
+	                     EQUAL,
+	                     sizeof(buf));
+
+	usleep(10000);
+
+	/* The first syscall of the thread after the interval flushes the aggregate of the idle fd */
+	assert_syscall_state(SYSCALL_SUCCESS,
+	                     "write",
+	                     syscall(__NR_write, busy_fd, buf, sizeof(buf)),
+	                     EQUAL,
+	                     sizeof(buf));
+
+	evt_test->disable_capture();
+
+	syscall(__NR_close, idle_fd);
+	syscall(__NR_close, busy_fd);
+
+	ASSERT_EQ(evt_test->set_io_aggregation(0, 0, 0), SCAP_SUCCESS);
+
+	evt_test->assert_event_presence(CURRENT_PID, PPME_IO_AGGREGATE_E);
+
+	if(HasFatalFailure()) {
+		return;
+	}
+
+	evt_test->parse_event();
+
+	evt_test->assert_header();
+
+	/*=============================== ASSERT PARAMETERS  ===========================*/
+
+	/* Parameter 1: fd (type: PT_FD) */
+	evt_test->assert_numeric_param(1, (int64_t)idle_fd);
+
+	/* Parameter 4: wcount (type: PT_UINT64) */
+	evt_test->assert_numeric_param(4, (uint64_t)1);
+
+	/* Parameter 5: wbytes (type: PT_UINT64) */
+	evt_test->assert_numeric_param(5, (uint64_t)sizeof(buf));
+
+	/*=============================== ASSERT PARAMETERS  ===========================*/
+}
+#endif
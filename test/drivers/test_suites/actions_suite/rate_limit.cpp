@@ -0,0 +1,61 @@
+#include "../../event_class/event_class.h"
+
+#include <fcntl.h>
+
+#if defined(__NR_write) && defined(__NR_openat) && defined(__NR_close)
+TEST(Actions, rate_limit) {
+	auto evt_test = get_syscall_event_test(__NR_write, EXIT_EVENT);
+
+	if(!evt_test->is_modern_bpf_engine()) {
+		GTEST_SKIP() << "the rate limit is only supported by the modern ebpf probe";
+	}
+
+	/* Only the first write fits the bucket, every drop is reported right away */
+	ASSERT_EQ(evt_test->set_rate_limit(EC_IO_WRITE, 1, 1, 1), SCAP_SUCCESS);
+
+	int fd = syscall(__NR_openat, AT_FDCWD, "/dev/null", O_WRONLY);
+	assert_syscall_state(SYSCALL_SUCCESS, "openat", fd, NOT_EQUAL, -1);
+
+	evt_test->enable_capture();
+
+	const char buf[] = "limited";
+	for(int i = 0; i < 2; i++) {
+		assert_syscall_state(SYSCALL_SUCCESS,
+		                     "write",
+		                     syscall(__NR_write, fd, buf, sizeof(buf)),
+		                     EQUAL,
+		                     sizeof(buf));
+	}
+
+	evt_test->disable_capture();
+
+	syscall(__NR_close, fd);
+
+	ASSERT_EQ(evt_test->set_rate_limit(EC_IO_WRITE, 0, 0, 0), SCAP_SUCCESS);
+
+	evt_test->assert_event_presence(CURRENT_PID, PPME_RATE_LIMIT_DROPS_E);
+
+	if(HasFatalFailure()) {
+		return;
+	}
+
+	evt_test->parse_event();
+
+	evt_test->assert_header();
+
+	/*=============================== ASSERT PARAMETERS  ===========================*/
+
+	/* Parameter 1: tgid (type: PT_PID) */
+	evt_test->assert_numeric_param(1, (int64_t)::getpid());
+
+	/* Parameter 2: category (type: PT_UINT8) */
+	evt_test->assert_numeric_param(2, (uint8_t)EC_IO_WRITE);
+
+	/* Parameter 3: dropped (type: PT_UINT64) */
+	evt_test->assert_numeric_param(3, (uint64_t)1);
+
+	/*=============================== ASSERT PARAMETERS  ===========================*/
+
+	evt_test->assert_num_params_pushed(3);
+}
+#endif
@@ -0,0 +1,106 @@
+#include "../../event_class/event_class.h"
+
+#if defined(__NR_unshare)
+TEST(Actions, suppress_tid) {
+	auto evt_test = get_syscall_event_test(__NR_unshare, EXIT_EVENT);
+
+	if(!evt_test->is_modern_bpf_engine()) {
+		GTEST_SKIP() << "in-kernel suppression is only supported by the modern ebpf probe";
+	}
+
+	ASSERT_EQ(evt_test->suppress_current_tid(true), SCAP_SUCCESS);
+
+	evt_test->enable_capture();
+
+	syscall(__NR_unshare, 0);
+
+	/* The syscall is dropped by the dispatcher */
+	evt_test->assert_event_absence();
+
+	evt_test->disable_capture();
+
+	ASSERT_EQ(evt_test->suppress_current_tid(false), SCAP_SUCCESS);
+
+	evt_test->enable_capture();
+
+	syscall(__NR_unshare, 0);
+
+	evt_test->assert_event_presence();
+
+	evt_test->disable_capture();
+}
+
+TEST(Actions, suppress_comm) {
+	auto evt_test = get_syscall_event_test(__NR_unshare, EXIT_EVENT);
+
+	if(!evt_test->is_modern_bpf_engine()) {
+		GTEST_SKIP() << "in-kernel suppression is only supported by the modern ebpf probe";
+	}
+
+	ASSERT_EQ(evt_test->suppress_current_comm(true), SCAP_SUCCESS);
+
+	evt_test->enable_capture();
+
+	syscall(__NR_unshare, 0);
+
+	evt_test->assert_event_absence();
+
+	evt_test->disable_capture();
+
+	ASSERT_EQ(evt_test->suppress_current_comm(false), SCAP_SUCCESS);
+	/* The threads matching the comm stay suppressed by tid */
+	ASSERT_EQ(evt_test->suppress_current_tid(false), SCAP_SUCCESS);
+}
+#endif
+
+#if defined(__NR_execve) && defined(__NR_clone3) && defined(__NR_wait4)
+
+#include <linux/sched.h>
+
+TEST(Actions, suppress_comm_children) {
+	auto evt_test = get_syscall_event_test(__NR_execve, EXIT_EVENT);
+
+	if(!evt_test->is_modern_bpf_engine()) {
+		GTEST_SKIP() << "in-kernel suppression is only supported by the modern ebpf probe";
+	}
+
+	ASSERT_EQ(evt_test->suppress_current_comm(true), SCAP_SUCCESS);
+
+	evt_test->enable_capture();
+
+	/* The child inherits the suppressed comm, then it execs into another one. */
+	clone_args cl_args = {};
+	cl_args.exit_signal = SIGCHLD;
+	pid_t ret_pid = syscall(__NR_clone3, &cl_args, sizeof(cl_args));
+
+	if(ret_pid == 0) {
+		char pathname[] = "/bin/true";
+		char* const argv[] = {pathname, NULL};
+		char* const envp[] = {NULL};
+		syscall(__NR_execve, pathname, argv, envp);
+		exit(EXIT_FAILURE);
+	}
+
+	assert_syscall_state(SYSCALL_SUCCESS, "clone3", ret_pid, NOT_EQUAL, -1);
+	int status = 0;
+	int options = 0;
+	assert_syscall_state(SYSCALL_SUCCESS,
+	                     "wait4",
+	                     syscall(__NR_wait4, ret_pid, &status, options, NULL),
+	                     NOT_EQUAL,
+	                     -1);
+
+	if(__WEXITSTATUS(status) == EXIT_FAILURE || __WIFSIGNALED(status) != 0) {
+		FAIL() << "The execve call fails while it should succeed..." << std::endl;
+	}
+
+	evt_test->disable_capture();
+
+	/* The child is still suppressed under its new comm */
+	evt_test->assert_event_absence(ret_pid);
+
+	ASSERT_EQ(evt_test->suppress_current_comm(false), SCAP_SUCCESS);
+	/* The threads matching the comm stay suppressed by tid */
+	ASSERT_EQ(evt_test->suppress_current_tid(false), SCAP_SUCCESS);
+}
+#endif
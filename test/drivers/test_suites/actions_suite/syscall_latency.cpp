@@ -0,0 +1,65 @@
+#include "../../event_class/event_class.h"
+
+#include <fstream>
+#include <string>
+#include <sys/stat.h>
+
+#if defined(__NR_getppid)
+
+/* On cgroup v2 the cgroup id is the inode number of the cgroup directory. */
+static uint64_t current_cgroup_id() {
+	std::ifstream f("/proc/self/cgroup");
+	std::string line;
+	while(std::getline(f, line)) {
+		if(line.rfind("0::", 0) == 0) {
+			struct stat st;
+			std::string path = "/sys/fs/cgroup" + line.substr(3);
+			if(stat(path.c_str(), &st) == 0) {
+				return st.st_ino;
+			}
+		}
+	}
+	return 0;
+}
+
+TEST(Actions, syscall_latency) {
+	auto evt_test = get_syscall_event_test(__NR_getppid, EXIT_EVENT);
+
+	if(!evt_test->is_modern_bpf_engine()) {
+		GTEST_SKIP() << "syscall latency histograms are only supported by the modern ebpf probe";
+	}
+
+	uint64_t cgroup_id = current_cgroup_id();
+	if(cgroup_id == 0) {
+		GTEST_SKIP() << "cgroup v2 is not available";
+	}
+
+	const std::string prefix =
+	        SYSCALL_LATENCY_PREFIX "getppid." + std::to_string(cgroup_id) + ".";
+	uint64_t count = 0;
+
+	ASSERT_EQ(evt_test->set_syscall_latency(true), SCAP_SUCCESS);
+
+	/* The histograms don't need the capture to be enabled. */
+	for(int i = 0; i < 10; i++) {
+		syscall(__NR_getppid);
+	}
+
+	ASSERT_TRUE(evt_test->get_metric_v2(METRICS_V2_KERNEL_SYSCALL_LATENCY,
+	                                    (prefix + "count").c_str(),
+	                                    &count));
+	ASSERT_GE(count, 10);
+
+	uint64_t sum_ns = 0;
+	ASSERT_TRUE(evt_test->get_metric_v2(METRICS_V2_KERNEL_SYSCALL_LATENCY,
+	                                    (prefix + "sum_ns").c_str(),
+	                                    &sum_ns));
+	ASSERT_GT(sum_ns, 0);
+
+	/* Disabling discards the histograms. */
+	ASSERT_EQ(evt_test->set_syscall_latency(false), SCAP_SUCCESS);
+	ASSERT_FALSE(evt_test->get_metric_v2(METRICS_V2_KERNEL_SYSCALL_LATENCY,
+	                                     (prefix + "count").c_str(),
+	                                     &count));
+}
+#endif
@@ -4,6 +4,8 @@
 #include <gtest/gtest.h>
 #include <unordered_set>
 #include <syscall.h>
+#include <unistd.h>
+#include <sys/wait.h>
 #include <helpers/engines.h>
 
 static falcosecurity_log_severity severity_level = FALCOSECURITY_LOG_SEV_WARNING;
@@ -26,7 +28,9 @@ scap_t* open_modern_bpf_engine(char* error_buf,
                                unsigned long buffer_dim,
                                uint16_t cpus_for_each_buffer,
                                bool online_only,
-                               std::unordered_set<uint32_t> ppm_sc_set = {}) {
+                               std::unordered_set<uint32_t> ppm_sc_set = {},
+                               uint64_t wakeup_watermark = 0,
+                               const char* shared_probe_path = nullptr) {
 	struct scap_open_args oargs {};
 
 	/* If empty we fill with all syscalls */
@@ -46,6 +50,8 @@ scap_t* open_modern_bpf_engine(char* error_buf,
 	        .buffer_bytes_dim = buffer_dim,
 	        .disable_iterators = false,
 	};
+	modern_bpf_params.wakeup_watermark = wakeup_watermark;
+	modern_bpf_params.shared_probe_path = shared_probe_path;
 	oargs.engine_params = &modern_bpf_params;
 	oargs.log_fn = test_open_log_fn;
 
@@ -220,6 +226,183 @@ TEST(modern_bpf, read_in_order_one_buffer_shared_between_all_possible_CPUs) {
 	scap_close(h);
 }
 
+TEST(modern_bpf, read_in_order_with_wakeup_watermark) {
+	char error_buffer[FILENAME_MAX]{};
+	int ret = 0;
+	/* The consumer blocks in `epoll` and it is woken up after the first page of events */
+	scap_t* h = open_modern_bpf_engine(error_buffer, &ret, 1 * 1024 * 1024, 1, true, {}, 4096);
+	ASSERT_FALSE(!h || ret != SCAP_SUCCESS)
+	        << "unable to open modern bpf engine with a wakeup watermark: " << error_buffer
+	        << std::endl;
+
+	check_event_order(h);
+	scap_close(h);
+}
+
+TEST(modern_bpf, wakeup_watermark_bigger_than_buffer) {
+	char error_buffer[FILENAME_MAX]{};
+	int ret = 0;
+	scap_t* h = open_modern_bpf_engine(error_buffer, &ret, 4 * 4096, 1, true, {}, 4 * 4096);
+	ASSERT_TRUE(!h || ret != SCAP_SUCCESS)
+	        << "the wakeup watermark can never be reached, we should fail: " << error_buffer
+	        << std::endl;
+}
+
+TEST(modern_bpf, read_in_order_with_shared_probe) {
+	char error_buffer[FILENAME_MAX]{};
+	int ret = 0;
+	const char* shared_probe_path = "/sys/fs/bpf/modern_bpf_test";
+	const std::string consumers_pin = std::string(shared_probe_path) + "/consumers";
+	/* The first consumer loads the probe and pins the shared maps */
+	scap_t* h = open_modern_bpf_engine(error_buffer,
+	                                   &ret,
+	                                   1 * 1024 * 1024,
+	                                   1,
+	                                   true,
+	                                   {},
+	                                   0,
+	                                   shared_probe_path);
+	ASSERT_FALSE(!h || ret != SCAP_SUCCESS)
+	        << "unable to open modern bpf engine with a shared probe: " << error_buffer
+	        << std::endl;
+	ASSERT_EQ(access(consumers_pin.c_str(), F_OK), 0);
+
+	check_event_order(h);
+	scap_close(h);
+	ASSERT_NE(access(consumers_pin.c_str(), F_OK), 0);
+}
+
+/* Run `/bin/true` in a new process and look for its `execve` exit event. */
+static bool find_execve_exit(scap_t* h) {
+	pid_t pid = fork();
+	if(pid == 0) {
+		execl("/bin/true", "true", (char*)NULL);
+		_exit(EXIT_FAILURE);
+	}
+	if(pid < 0 || waitpid(pid, NULL, 0) != pid) {
+		return false;
+	}
+
+	scap_evt* evt = NULL;
+	uint16_t buffer_id = 0;
+	uint32_t flags = 0;
+	/* if we hit 5 consecutive timeouts it means that all buffers are empty (approximation) */
+	uint16_t timeouts = 0;
+	while(timeouts < 5) {
+		int32_t ret = scap_next(h, &evt, &buffer_id, &flags);
+		if(ret == SCAP_SUCCESS) {
+			timeouts = 0;
+			if(scap_event_get_tid(evt) == (uint64_t)pid &&
+			   scap_event_get_type(evt) == PPME_SYSCALL_EXECVE_19_X) {
+				return true;
+			}
+		} else if(ret == SCAP_TIMEOUT) {
+			timeouts++;
+		}
+	}
+	return false;
+}
+
+/* Drain the buffers of `h` so that the programs of the shared probe are synced. */
+static void drain_buffers(scap_t* h) {
+	scap_evt* evt = NULL;
+	uint16_t buffer_id = 0;
+	uint32_t flags = 0;
+	uint16_t timeouts = 0;
+	while(timeouts < 5) {
+		if(scap_next(h, &evt, &buffer_id, &flags) == SCAP_TIMEOUT) {
+			timeouts++;
+		}
+	}
+}
+
+TEST(modern_bpf, shared_probe_attaches_programs_for_all_consumers) {
+	const char* shared_probe_path = "/sys/fs/bpf/modern_bpf_test";
+	int to_child[2];
+	int to_parent[2];
+	ASSERT_EQ(pipe(to_child), 0);
+	ASSERT_EQ(pipe(to_parent), 0);
+	char msg = 0;
+
+	/* The secondary consumer only wants `execve`, which needs the programs that the primary
+	 * doesn't. It reports through the pipe whether it sees the `execve` exit events before and
+	 * after the primary stops capturing. The child is forked before the probe is loaded, libpman
+	 * state is per process.
+	 */
+	pid_t child = fork();
+	ASSERT_GE(child, 0);
+	if(child == 0) {
+		char error_buffer[FILENAME_MAX]{};
+		int ret = 0;
+		if(read(to_child[0], &msg, 1) != 1) {
+			_exit(EXIT_FAILURE);
+		}
+		scap_t* h = open_modern_bpf_engine(error_buffer,
+		                                   &ret,
+		                                   1 * 1024 * 1024,
+		                                   1,
+		                                   true,
+		                                   {PPM_SC_EXECVE},
+		                                   0,
+		                                   shared_probe_path);
+		msg = (h && ret == SCAP_SUCCESS) ? 1 : 0;
+		if(write(to_parent[1], &msg, 1) != 1 || !msg) {
+			_exit(EXIT_FAILURE);
+		}
+		for(int i = 0; i < 2; i++) {
+			if(read(to_child[0], &msg, 1) != 1) {
+				_exit(EXIT_FAILURE);
+			}
+			msg = find_execve_exit(h) ? 1 : 0;
+			if(write(to_parent[1], &msg, 1) != 1) {
+				_exit(EXIT_FAILURE);
+			}
+		}
+		scap_close(h);
+		_exit(EXIT_SUCCESS);
+	}
+
+	char error_buffer[FILENAME_MAX]{};
+	int ret = 0;
+	scap_t* h = open_modern_bpf_engine(error_buffer,
+	                                   &ret,
+	                                   1 * 1024 * 1024,
+	                                   1,
+	                                   true,
+	                                   {PPM_SC_OPENAT},
+	                                   0,
+	                                   shared_probe_path);
+	msg = (h && ret == SCAP_SUCCESS) ? 1 : 0;
+	ASSERT_EQ(write(to_child[1], &msg, 1), 1);
+	if(!msg) {
+		waitpid(child, NULL, 0);
+		FAIL() << "unable to open modern bpf engine with a shared probe: " << error_buffer
+		       << std::endl;
+	}
+
+	/* The secondary is attached */
+	ASSERT_EQ(read(to_parent[0], &msg, 1), 1);
+	ASSERT_EQ(msg, 1) << "unable to open the secondary consumer" << std::endl;
+
+	/* The primary syncs the programs with the secondary's syscalls */
+	drain_buffers(h);
+	ASSERT_EQ(write(to_child[1], &msg, 1), 1);
+	ASSERT_EQ(read(to_parent[0], &msg, 1), 1);
+	EXPECT_EQ(msg, 1) << "the secondary didn't get the execve events" << std::endl;
+
+	/* The programs stay attached while the secondary captures */
+	ASSERT_EQ(scap_stop_capture(h), SCAP_SUCCESS);
+	ASSERT_EQ(write(to_child[1], &msg, 1), 1);
+	ASSERT_EQ(read(to_parent[0], &msg, 1), 1);
+	EXPECT_EQ(msg, 1) << "the secondary lost the execve events when the primary stopped"
+	                  << std::endl;
+
+	int status = 0;
+	ASSERT_EQ(waitpid(child, &status, 0), child);
+	EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS);
+	scap_close(h);
+}
+
 TEST(modern_bpf, scap_stats_check) {
 	char error_buffer[FILENAME_MAX]{};
 	int ret = 0;
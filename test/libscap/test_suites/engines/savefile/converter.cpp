@@ -84,6 +84,50 @@ TEST_F(convert_event_test, PPME_GENERIC_X_1_to_2_params_with_enter) {
 	        create_safe_scap_event(ts, tid, PPME_GENERIC_X, 2, id, native_id));
 }
 
+// Enter events of different sizes stored for the same threads must not overwrite each other.
+TEST_F(convert_event_test, enter_event_storage_reuse) {
+	constexpr uint64_t ts = 12;
+	constexpr int64_t tid1 = 25;
+	constexpr int64_t tid2 = 26;
+
+	constexpr uint16_t id = 10;
+	constexpr uint16_t native_id = 11;
+	const std::string oldpath(600, 'a');
+	const std::string newpath(600, 'b');
+
+	const auto big_evt1 = create_safe_scap_event(ts,
+	                                             tid1,
+	                                             PPME_SYSCALL_LINK_E,
+	                                             2,
+	                                             oldpath.c_str(),
+	                                             newpath.c_str());
+	assert_single_conversion_drop(big_evt1);
+	assert_event_storage_presence(big_evt1);
+
+	// A smaller event replaces the previous one.
+	const auto small_evt1 = create_safe_scap_event(ts, tid1, PPME_GENERIC_E, 2, id, native_id);
+	assert_single_conversion_drop(small_evt1);
+	assert_event_storage_presence(small_evt1);
+
+	const auto big_evt2 = create_safe_scap_event(ts,
+	                                             tid2,
+	                                             PPME_SYSCALL_LINK_E,
+	                                             2,
+	                                             newpath.c_str(),
+	                                             oldpath.c_str());
+	assert_single_conversion_drop(big_evt2);
+	assert_event_storage_presence(big_evt2);
+	assert_event_storage_presence(small_evt1);
+
+	// The exit event consumes the enter event of its own thread only.
+	assert_single_conversion_success(
+	        CONVERSION_PASS,
+	        create_safe_scap_event(ts, tid1, PPME_GENERIC_X, 1, id),
+	        create_safe_scap_event(ts, tid1, PPME_GENERIC_X, 2, id, native_id));
+	assert_event_storage_absence(small_evt1);
+	assert_event_storage_presence(big_evt2);
+}
+
 ////////////////////////////
 // OPEN
 ////////////////////////////
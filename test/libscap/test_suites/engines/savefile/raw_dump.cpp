@@ -0,0 +1,136 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2026 The Falco Authors.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include <libscap/scap.h>
+#include <libscap/scap_engines.h>
+#include <libscap/scap_platform.h>
+#include <libscap/scap_savefile_api.h>
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <string>
+
+#ifdef HAS_ENGINE_SAVEFILE
+
+namespace {
+
+scap_t* open_capture(const std::string& path, scap_platform** platform) {
+	scap_proc_callbacks callbacks = {default_refresh_start_end_callback,
+	                                  default_refresh_start_end_callback,
+	                                  NULL,
+	                                  NULL};
+	*platform = scap_savefile_alloc_platform(callbacks);
+	scap_open_args oargs = {};
+	scap_savefile_engine_params params = {};
+	params.fname = path.c_str();
+	params.platform = *platform;
+	oargs.engine_params = &params;
+	char error[SCAP_LASTERR_SIZE] = {0};
+	int32_t rc = SCAP_FAILURE;
+	scap_t* h = scap_open(&oargs, &scap_savefile_engine, error, &rc);
+	EXPECT_EQ(rc, SCAP_SUCCESS) << error;
+	return h;
+}
+
+void write_event(scap_dumper_t* d, scap_evt* evt) {
+	ASSERT_NE(evt, nullptr);
+	ASSERT_EQ(scap_dump(d, evt, 0, 0), SCAP_SUCCESS);
+	free(evt);
+}
+
+}  // namespace
+
+TEST(scap_raw_dump, filter_and_truncate) {
+	auto tmp = std::filesystem::temp_directory_path();
+	std::string in_path = (tmp / "scap_raw_dump_in.scap").string();
+	std::string out_path = (tmp / "scap_raw_dump_out.scap").string();
+	char error[SCAP_LASTERR_SIZE] = {0};
+
+	const std::string payload(100, 'x');
+	scap_const_sized_buffer buf{payload.data(), payload.size()};
+	scap_dumper_t* d = scap_dump_open(nullptr, in_path.c_str(), SCAP_COMPRESSION_NONE, error);
+	ASSERT_NE(d, nullptr) << error;
+	write_event(d,
+	            scap_create_event(error,
+	                              1,
+	                              10,
+	                              PPME_SYSCALL_READ_X,
+	                              4,
+	                              (int64_t)100,
+	                              buf,
+	                              (int64_t)3,
+	                              (uint32_t)100));
+	write_event(d,
+	            scap_create_event(error,
+	                              2,
+	                              11,
+	                              PPME_SYSCALL_READ_X,
+	                              4,
+	                              (int64_t)100,
+	                              buf,
+	                              (int64_t)3,
+	                              (uint32_t)100));
+	write_event(d, scap_create_event(error, 3, 10, PPME_SYSCALL_GETCWD_X, 2, (int64_t)0, "/"));
+	scap_dump_close(d);
+
+	// Keep only the reads of tid 10, truncated to 16 bytes.
+	bool event_types[PPM_EVENT_MAX] = {};
+	event_types[PPME_SYSCALL_READ_X] = true;
+	int64_t tids[] = {10};
+	scap_raw_dump_params params = {};
+	params.event_types = event_types;
+	params.tids = tids;
+	params.tids_count = 1;
+	params.snaplen = 16;
+
+	scap_platform* platform = nullptr;
+	scap_t* h = open_capture(in_path, &platform);
+	ASSERT_NE(h, nullptr);
+	scap_raw_dumper_t* rd = scap_raw_dump_open(h, platform, out_path.c_str(), &params, error);
+	ASSERT_NE(rd, nullptr) << error;
+	int32_t res;
+	while((res = scap_raw_dump_next(rd)) != SCAP_EOF) {
+		ASSERT_TRUE(res == SCAP_SUCCESS || res == SCAP_FILTERED_EVENT)
+		        << scap_raw_dump_getlasterr(rd);
+	}
+	scap_raw_dump_stats stats;
+	scap_raw_dump_get_stats(rd, &stats);
+	EXPECT_EQ(stats.n_evts, 3);
+	EXPECT_EQ(stats.n_written, 1);
+	EXPECT_EQ(stats.n_filtered, 2);
+	EXPECT_EQ(stats.n_truncated, 1);
+	scap_raw_dump_close(rd);
+	scap_close(h);
+	scap_platform_free(platform);
+
+	h = open_capture(out_path, &platform);
+	ASSERT_NE(h, nullptr);
+	scap_evt* evt;
+	uint16_t devid;
+	uint32_t flags;
+	ASSERT_EQ(scap_next(h, &evt, &devid, &flags), SCAP_SUCCESS);
+	EXPECT_EQ(evt->type, PPME_SYSCALL_READ_X);
+	EXPECT_EQ(evt->tid, 10);
+	scap_sized_buffer decoded[PPM_MAX_EVENT_PARAMS];
+	ASSERT_EQ(scap_event_decode_params(evt, decoded), 4);
+	ASSERT_EQ(decoded[1].size, 16);
+	EXPECT_EQ(std::string((const char*)decoded[1].buf, decoded[1].size), payload.substr(0, 16));
+	EXPECT_EQ(decoded[3].size, sizeof(uint32_t));
+	ASSERT_EQ(scap_next(h, &evt, &devid, &flags), SCAP_EOF);
+	scap_close(h);
+	scap_platform_free(platform);
+
+	std::filesystem::remove(in_path);
+	std::filesystem::remove(out_path);
+}
+
+#endif
@@ -20,6 +20,9 @@ limitations under the License.
 #include <libscap/linux/scap_cgroup.h>
 #include <libscap/linux/scap_cgroup.c>
 
+#include <memory>
+#include <string>
+
 TEST(cgroups, path_relative) {
 	char final_path[4096];
 	const char* prefix = "/1/2/3";
@@ -91,3 +94,90 @@ TEST(cgroups, path_empty) {
 	         path + path_strip_len);
 	ASSERT_STREQ(final_path, "/1/2/3");
 }
+
+static void write_controllers(const std::string& dir, const char* controllers) {
+	FILE* f = fopen((dir + "/cgroup.controllers").c_str(), "w");
+	ASSERT_NE(f, nullptr);
+	fputs(controllers, f);
+	fclose(f);
+}
+
+static std::string cgroup_set_str(const struct scap_cgroup_set* cg) {
+	std::string res;
+	FOR_EACH_SUBSYS(cg, subsys) {
+		res += res.empty() ? "" : ",";
+		res += subsys;
+	}
+	return res;
+}
+
+TEST(cgroups, resolve_v2_id_cache) {
+	char root_template[] = "/tmp/scap_cgroup_XXXXXX";
+	ASSERT_NE(mkdtemp(root_template), nullptr);
+	const std::string root = root_template;
+	const std::string leaf = root + "/a";
+	ASSERT_EQ(mkdir(leaf.c_str(), 0755), 0);
+	write_controllers(root, "cpu memory\n");
+	write_controllers(leaf, "memory\n");
+
+	auto cgi = std::make_unique<scap_cgroup_interface>();
+	memset(cgi.get(), 0, sizeof(*cgi));
+	snprintf(cgi->m_mount_v2, sizeof(cgi->m_mount_v2), "%s", root.c_str());
+	scap_cgroup_printf(&cgi->m_subsystems_v2, "cpu");
+	scap_cgroup_printf(&cgi->m_subsystems_v2, "memory");
+	scap_cgroup_id_cache_init(cgi.get());
+
+	struct scap_cgroup_set cg = {};
+	ASSERT_EQ(scap_cgroup_resolve_v2(cgi.get(), "/a", &cg), SCAP_SUCCESS);
+	ASSERT_EQ(cgroup_set_str(&cg), "memory=/a,cpu=/");
+	ASSERT_EQ(cgi->m_id_cache_size, 1);
+
+	// The second thread of the cgroup doesn't read cgroup.controllers anymore
+	write_controllers(leaf, "\n");
+	cg.len = 0;
+	scap_cgroup_printf(&cg, "pids=/v1");
+	ASSERT_EQ(scap_cgroup_resolve_v2(cgi.get(), "/a", &cg), SCAP_SUCCESS);
+	ASSERT_EQ(cgroup_set_str(&cg), "pids=/v1,memory=/a,cpu=/");
+
+	cg.len = 0;
+	ASSERT_EQ(scap_cgroup_resolve_v2(cgi.get(), "/", &cg), SCAP_SUCCESS);
+	ASSERT_EQ(cgroup_set_str(&cg), "cpu=/,memory=/");
+	ASSERT_EQ(cgi->m_id_cache_size, 2);
+
+	scap_cgroup_interface_close(cgi.get());
+	ASSERT_EQ(cgi->m_id_cache, nullptr);
+	unlink((leaf + "/cgroup.controllers").c_str());
+	rmdir(leaf.c_str());
+	unlink((root + "/cgroup.controllers").c_str());
+	rmdir(root.c_str());
+}
+
+TEST(cgroups, id_cache_lru) {
+	auto cgi = std::make_unique<scap_cgroup_interface>();
+	memset(cgi.get(), 0, sizeof(*cgi));
+	scap_cgroup_id_cache_init(cgi.get());
+
+	struct scap_cgroup_set cgroups = {};
+	scap_cgroup_printf(&cgroups, "memory=/a");
+	for(uint64_t id = 1; id <= SCAP_CGROUP_ID_CACHE_MAX; id++) {
+		scap_cgroup_id_cache_put(cgi.get(), id, &cgroups);
+	}
+	ASSERT_EQ(cgi->m_id_cache_size, SCAP_CGROUP_ID_CACHE_MAX);
+
+	// A lookup makes the entry the most recently used one
+	struct scap_cgroup_set cg = {};
+	ASSERT_TRUE(scap_cgroup_id_cache_get(cgi.get(), 1, &cg));
+	ASSERT_EQ(cgroup_set_str(&cg), "memory=/a");
+
+	// Only the least recently used entry is dropped to make room for a new one
+	scap_cgroup_id_cache_put(cgi.get(), SCAP_CGROUP_ID_CACHE_MAX + 1, &cgroups);
+	ASSERT_EQ(cgi->m_id_cache_size, SCAP_CGROUP_ID_CACHE_MAX);
+	cg.len = 0;
+	ASSERT_FALSE(scap_cgroup_id_cache_get(cgi.get(), 2, &cg));
+	ASSERT_TRUE(scap_cgroup_id_cache_get(cgi.get(), 1, &cg));
+	ASSERT_TRUE(scap_cgroup_id_cache_get(cgi.get(), 3, &cg));
+	ASSERT_TRUE(scap_cgroup_id_cache_get(cgi.get(), SCAP_CGROUP_ID_CACHE_MAX + 1, &cg));
+
+	scap_cgroup_interface_close(cgi.get());
+	ASSERT_EQ(cgi->m_id_cache, nullptr);
+}
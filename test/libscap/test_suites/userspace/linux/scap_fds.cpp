@@ -3,6 +3,7 @@
 
 extern "C" {
 int32_t test_time_wait_socket_at_buffer_end(void);
+int32_t test_sock_diag_matches_socket_table(void);
 }
 
 TEST(scap_fds, buffer_overflow_test) {
@@ -10,3 +11,12 @@ TEST(scap_fds, buffer_overflow_test) {
 	ASSERT_EQ(res, SCAP_SUCCESS)
 	        << "Expected SCAP_SUCCESS when parsing TIME_WAIT socket at buffer end";
 }
+
+TEST(scap_fds, sock_diag_matches_socket_table) {
+	int32_t res = test_sock_diag_matches_socket_table();
+	if(res == SCAP_NOT_SUPPORTED) {
+		GTEST_SKIP() << "NETLINK_SOCK_DIAG is not available";
+	}
+	ASSERT_EQ(res, SCAP_SUCCESS) << "Expected sock_diag and /proc/net/tcp to agree on a listening "
+	                                "socket";
+}
@@ -45,3 +45,69 @@ int32_t test_time_wait_socket_at_buffer_end(void) {
 
 	return result;
 }
+
+// Look up a listening TCP socket on the loopback through both sock_diag and /proc/net/tcp, and
+// check that both backends return the same record. Return `SCAP_NOT_SUPPORTED` if sock_diag is not
+// available.
+int32_t test_sock_diag_matches_socket_table(void) {
+	static char error[SCAP_LASTERR_SIZE];
+	scap_fdinfo* diag_sockets = NULL;
+	scap_fdinfo* text_sockets = NULL;
+	int32_t result = SCAP_FAILURE;
+
+	const int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+	struct sockaddr_in addr = {.sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK)};
+	socklen_t addr_len = sizeof(addr);
+	struct stat sb;
+	if(listen_fd < 0 || bind(listen_fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 ||
+	   listen(listen_fd, 1) != 0 ||
+	   getsockname(listen_fd, (struct sockaddr*)&addr, &addr_len) != 0 ||
+	   fstat(listen_fd, &sb) != 0) {
+		goto out;
+	}
+
+	const int diag_fd = sock_diag_open("", 0);
+	if(diag_fd < 0) {
+		result = SCAP_NOT_SUPPORTED;
+		goto out;
+	}
+	result = sock_diag_dump_inet(diag_fd, AF_INET, SCAP_L4_TCP, &diag_sockets, error);
+	close(diag_fd);
+	if(result != SCAP_SUCCESS) {
+		goto out;
+	}
+
+	char filepath[PATH_MAX];
+	snprintf(filepath, sizeof(filepath), "%s/proc/net/tcp", scap_get_host_root());
+	if(parse_procfs_proc_pid_socket_table_file(filepath,
+	                                           AF_INET,
+	                                           SCAP_L4_TCP,
+	                                           &text_sockets,
+	                                           error) != SCAP_SUCCESS) {
+		result = SCAP_FAILURE;
+		goto out;
+	}
+
+	uint64_t ino = sb.st_ino;
+	scap_fdinfo* diag_fdinfo;
+	scap_fdinfo* text_fdinfo;
+	HASH_FIND_INT64(diag_sockets, &ino, diag_fdinfo);
+	HASH_FIND_INT64(text_sockets, &ino, text_fdinfo);
+	if(diag_fdinfo == NULL || text_fdinfo == NULL ||
+	   diag_fdinfo->type != SCAP_FD_IPV4_SERVSOCK || text_fdinfo->type != SCAP_FD_IPV4_SERVSOCK ||
+	   diag_fdinfo->info.ipv4serverinfo.ip != addr.sin_addr.s_addr ||
+	   diag_fdinfo->info.ipv4serverinfo.port != ntohs(addr.sin_port) ||
+	   memcmp(&diag_fdinfo->info.ipv4serverinfo,
+	          &text_fdinfo->info.ipv4serverinfo,
+	          sizeof(diag_fdinfo->info.ipv4serverinfo)) != 0) {
+		result = SCAP_FAILURE;
+	}
+
+out:
+	if(listen_fd >= 0) {
+		close(listen_fd);
+	}
+	scap_fd_free_table(&diag_sockets);
+	scap_fd_free_table(&text_sockets);
+	return result;
+}
@@ -46,9 +46,12 @@ limitations under the License.
 #include <sys/types.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <list>
 #include <memory>
+#include <thread>
 
 TEST_F(sys_call_test, process_signalfd_kill) {
 	int callnum = 0;
@@ -386,6 +389,91 @@ TEST(procinfo, process_not_existent) {
 	inspector.close();
 }
 
+TEST(procinfo, parallel_proc_scan) {
+	// Keep a second task alive while /proc is scanned.
+	std::atomic<int64_t> task_tid{0};
+	std::atomic<bool> stop{false};
+	std::thread task([&] {
+		task_tid = syscall(SYS_gettid);
+		while(!stop) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+	});
+	while(task_tid == 0) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	sinsp serial;
+	serial.set_proc_scan_workers(1);
+	serial.open_nodriver(true);
+	sinsp parallel;
+	parallel.set_proc_scan_workers(4);
+	parallel.open_nodriver(true);
+
+	for(int64_t tid : {(int64_t)getpid(), task_tid.load()}) {
+		auto serial_tinfo = serial.m_thread_manager->find_thread(tid, true);
+		auto parallel_tinfo = parallel.m_thread_manager->find_thread(tid, true);
+		ASSERT_NE(serial_tinfo, nullptr);
+		ASSERT_NE(parallel_tinfo, nullptr);
+		EXPECT_EQ(serial_tinfo->m_pid, parallel_tinfo->m_pid);
+		EXPECT_EQ(serial_tinfo->m_ptid, parallel_tinfo->m_ptid);
+		EXPECT_EQ(serial_tinfo->m_comm, parallel_tinfo->m_comm);
+		EXPECT_EQ(serial_tinfo->m_exepath, parallel_tinfo->m_exepath);
+		EXPECT_EQ(serial_tinfo->m_args, parallel_tinfo->m_args);
+		EXPECT_EQ(serial_tinfo->cgroups(), parallel_tinfo->cgroups());
+	}
+	EXPECT_EQ(parallel.m_thread_manager->find_thread(task_tid, true)->m_pid, getpid());
+
+	stop = true;
+	task.join();
+	serial.close();
+	parallel.close();
+}
+
+TEST(procinfo, state_snapshot) {
+	char snapshot_path[] = "/tmp/sinsp_state_snapshotXXXXXX";
+	int snapshot_fd = mkstemp(snapshot_path);
+	ASSERT_GE(snapshot_fd, 0);
+	close(snapshot_fd);
+	unlink(snapshot_path);
+
+	sinsp first;
+	first.set_state_snapshot(snapshot_path, 0);
+	first.open_nodriver(true);
+	first.save_state_snapshot();
+	first.close();
+
+	// The files of a process reused from the snapshot are read again if they changed since.
+	int fd = open("/dev/null", O_RDONLY);
+	ASSERT_GE(fd, 0);
+
+	sinsp cold;
+	cold.open_nodriver(true);
+	sinsp warm;
+	warm.set_state_snapshot(snapshot_path, 0);
+	warm.open_nodriver(true);
+
+	auto cold_tinfo = cold.m_thread_manager->find_thread(getpid(), true);
+	auto warm_tinfo = warm.m_thread_manager->find_thread(getpid(), true);
+	ASSERT_NE(cold_tinfo, nullptr);
+	ASSERT_NE(warm_tinfo, nullptr);
+	EXPECT_EQ(cold_tinfo->m_ptid, warm_tinfo->m_ptid);
+	EXPECT_EQ(cold_tinfo->m_comm, warm_tinfo->m_comm);
+	EXPECT_EQ(cold_tinfo->m_exepath, warm_tinfo->m_exepath);
+	EXPECT_EQ(cold_tinfo->m_args, warm_tinfo->m_args);
+	EXPECT_EQ(cold_tinfo->cgroups(), warm_tinfo->cgroups());
+	EXPECT_NE(cold_tinfo->get_fd(fd), nullptr);
+	EXPECT_NE(warm_tinfo->get_fd(fd), nullptr);
+	// The tables match also when the snapshot is ignored, check that it was used.
+	EXPECT_EQ(cold.get_startup_stats().m_n_snapshot_threads, 0);
+	EXPECT_GT(warm.get_startup_stats().m_n_snapshot_threads, 0);
+
+	close(fd);
+	cold.close();
+	warm.close();
+	unlink(snapshot_path);
+}
+
 TEST_F(sys_call_test, process_rlimit) {
 	int callnum = 0;
 	struct rlimit curr_rl;
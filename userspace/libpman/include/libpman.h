@@ -71,6 +71,52 @@ int pman_init_state(falcosecurity_log_fn log_fn,
  */
 int pman_get_required_buffers(void);
 
+/**
+ * @brief How CPUs are grouped to share a ring buffer.
+ */
+enum pman_ringbuf_topology {
+	PMAN_RINGBUF_TOPOLOGY_FLAT = 0, /* `cpus_for_each_buffer` consecutive CPUs. */
+	PMAN_RINGBUF_TOPOLOGY_NUMA = 1, /* same as flat, without crossing NUMA nodes. */
+	PMAN_RINGBUF_TOPOLOGY_LLC = 2,  /* same as flat, without crossing last level caches. */
+};
+
+/**
+ * @brief Group CPUs into ring buffers according to the machine topology and,
+ * optionally, size every ring buffer according to the drops its CPUs
+ * experienced in a previous capture. Ring buffers of CPUs dropping more than
+ * the average are enlarged, up to `PMAN_MAX_RINGBUF_SCALE` times the
+ * configured dimension.
+ *
+ * With the NUMA topology ring buffers are also allocated on the node of their
+ * CPUs. Must be called after `pman_init_state` and before the loading phase.
+ *
+ * @param topology one of `pman_ringbuf_topology`.
+ * @param cpu_drops per-CPU drops of a previous capture, indexed by CPU id. Can be `NULL`.
+ * @param n_cpu_drops number of entries of `cpu_drops`.
+ * @return `0` on success, `errno` in case of error.
+ */
+int pman_set_ringbuf_topology(enum pman_ringbuf_topology topology,
+                              const uint64_t* cpu_drops,
+                              uint16_t n_cpu_drops);
+
+/**
+ * @brief Return the NUMA node a ring buffer is allocated on.
+ *
+ * @param ring_id ring buffer index, as returned by `pman_consume_first_event`.
+ * @return node id, `-1` if unknown.
+ */
+int pman_get_ringbuf_numa_node(int16_t ring_id);
+
+/**
+ * @brief Restrict the calling thread to the CPUs of a NUMA node, so that it
+ * consumes ring buffers allocated on that node without crossing the
+ * interconnect.
+ *
+ * @param numa_node node id.
+ * @return `0` on success, `errno` in case of error.
+ */
+int pman_pin_thread_to_numa_node(int numa_node);
+
 /**
  * @brief Return whether modern bpf is supported by running kernel.
  *
@@ -98,6 +144,51 @@ int pman_open_probe(void);
  */
 int pman_prepare_progs_before_loading(void);
 
+/**
+ * @brief Share the probe between more processes. The first one loads and
+ * attaches the programs, the following ones only add their ring buffers and
+ * receive a copy of the events they are interested in, without running the
+ * programs again. Consumers find each other through the maps pinned in
+ * `pin_path`, a bpffs directory, and must share the PID namespace.
+ *
+ * Programs, the interesting syscalls and the snaplen are shared: the probe
+ * captures the union of the syscalls and the maximum snaplen of all the
+ * consumers, every consumer receives only the events of its own syscalls.
+ * The consumer that loaded the probe attaches the programs for the union, see
+ * `pman_sync_consumers_programs`. Other settings can only be changed by the
+ * consumer that loaded the probe.
+ *
+ * `pin_path` stays locked until the consumer has claimed its slot, after the
+ * loading phase, so that concurrent consumers agree on which one loads the
+ * probe. Must be called after `pman_open_probe` and before the loading phase.
+ *
+ * @param pin_path bpffs directory shared by the consumers.
+ * @return `0` on success, `errno` in case of error.
+ */
+int pman_share_probe(const char* pin_path);
+
+/**
+ * @brief Return true if the probe is shared with other consumers, see
+ * `pman_share_probe`.
+ */
+bool pman_is_probe_shared(void);
+
+/**
+ * @brief Return true if the probe was loaded by another consumer, see
+ * `pman_share_probe`.
+ */
+bool pman_is_secondary_consumer(void);
+
+/**
+ * @brief Attach the programs of a shared probe for the syscalls of all the
+ * consumers, if the other consumers changed them since the last time. Only the
+ * consumer that loaded the probe can attach them, so it must call this
+ * periodically while the probe is shared. Does nothing for the other consumers.
+ *
+ * @return `0` on success, `errno` in case of error.
+ */
+int pman_sync_consumers_programs(void);
+
 /**
  * @brief Load into the kernel all the programs and maps
  * contained into the skeleton.
@@ -150,6 +241,36 @@ int pman_finalize_ringbuf_array_after_loading(void);
  */
 void pman_consume_first_event(void** event_ptr, int16_t* buffer_id);
 
+/**
+ * @brief Set how many bytes a ring buffer must hold before the probe wakes
+ * up the consumers blocked in `pman_wait_for_events`. Without a watermark the
+ * probe never notifies userspace and ring buffers must be polled.
+ *
+ * @param watermark bytes, `0` disables the notifications. It must be lower
+ * than the dimension of a single ring buffer.
+ * @return `0` on success, `errno` in case of error.
+ */
+int pman_set_wakeup_watermark(uint64_t watermark);
+
+/**
+ * @brief Block until one of the ring buffers holds some data or the timeout
+ * expires. Empty ring buffers only become ready when the probe crosses the
+ * wakeup watermark, see `pman_set_wakeup_watermark`.
+ *
+ * @param timeout_ms maximum time to wait, `-1` waits forever.
+ * @return number of ready ring buffers, `0` on timeout or on signals,
+ * `-errno` in case of error.
+ */
+int pman_wait_for_events(int timeout_ms);
+
+/**
+ * @brief Return the `epoll` file descriptor watching all the ring buffers,
+ * so that consumers can wait for the events in their own event loop.
+ *
+ * @return the file descriptor, `-1` if the ring buffers are not allocated.
+ */
+int pman_get_wait_fd(void);
+
 /////////////////////////////
 // CAPTURE (EXCHANGE VALUES WITH BPF SIDE)
 /////////////////////////////
@@ -254,6 +375,107 @@ void pman_set_statsd_port(uint16_t statsd_port);
  */
 void pman_set_scap_tid(int32_t scap_tid);
 
+/**
+ * @brief Coalesce successful read/write syscalls per (tid, fd) into
+ * `PPME_IO_AGGREGATE_E` events. An aggregate is sent when one of the
+ * thresholds is hit, when its fd is closed, when its thread exits, or on
+ * the first syscall of its thread once the oldest aggregate of the thread
+ * is older than the interval.
+ *
+ * @param max_count syscalls per aggregate, `0` disables the aggregation
+ * and discards the pending aggregates.
+ * @param max_bytes bytes per aggregate.
+ * @param interval_ns maximum age of an aggregate.
+ *
+ * @return `0` on success, `errno` in case of error.
+ */
+int pman_set_io_aggregation(uint32_t max_count, uint64_t max_bytes, uint64_t interval_ns);
+
+/**
+ * @brief Limit the events of every process in a category with a token
+ * bucket. Dropped events are reported by periodic `PPME_RATE_LIMIT_DROPS_E`
+ * summaries. Syscalls that are never dropped by the sampling logic are
+ * never limited.
+ *
+ * @param category `ppm_event_category` of the exit events, masked with
+ * `RATE_LIMIT_CATEGORY_MASK`.
+ * @param rate events per second, `0` removes the limit.
+ * @param burst maximum number of events in a burst, at least `1`.
+ *
+ * @return `0` on success, `errno` in case of error.
+ */
+int pman_set_rate_limit(uint8_t category, uint64_t rate, uint64_t burst);
+
+/**
+ * @brief Set the minimum time between two drop summaries of a rate-limited
+ * process. Defaults to one second.
+ *
+ * @param interval_ns interval in nanoseconds.
+ */
+void pman_set_rate_limit_summary_interval(uint64_t interval_ns);
+
+/**
+ * @brief Called for every rate-limited process with events dropped since
+ * its last summary.
+ *
+ * @param tgid the rate-limited process.
+ * @param category event category of the bucket.
+ * @param dropped events dropped since the last summary.
+ * @param ctx pointer passed to `pman_flush_rate_limit_drops`.
+ */
+typedef void (*pman_rate_limit_drops_cb)(uint32_t tgid,
+                                         uint8_t category,
+                                         uint64_t dropped,
+                                         void* ctx);
+
+/**
+ * @brief Pass to `cb` the drops not yet reported by a summary and reset
+ * them, so that they can be reported when the capture stops.
+ *
+ * @param cb called once for every bucket with dropped events.
+ * @param ctx passed to `cb`.
+ *
+ * @return `0` on success, `errno` in case of error.
+ */
+int pman_flush_rate_limit_drops(pman_rate_limit_drops_cb cb, void* ctx);
+
+/**
+ * @brief Attach or detach the programs that compute, in kernel, a log2
+ * latency histogram for every (cgroup, syscall) pair. They don't send
+ * events. The histograms are discarded when the programs are detached.
+ *
+ * @param enable whether to collect the histograms.
+ *
+ * @return `0` on success, `errno` in case of error.
+ */
+int pman_enable_syscall_latency(bool enable);
+
+/**
+ * @brief Called for every syscall latency histogram.
+ *
+ * @param cgroup_id cgroup v2 id of the threads.
+ * @param syscall_id 64bit syscall id.
+ * @param buckets `SYSCALL_LATENCY_BUCKETS` counters, bucket `i` counts
+ * the syscalls that took [2^i, 2^(i+1)) ns and the last one the slower ones.
+ * @param sum_ns total time spent in the syscall.
+ * @param ctx pointer passed to `pman_get_syscall_latency`.
+ */
+typedef void (*pman_syscall_latency_cb)(uint64_t cgroup_id,
+                                        uint32_t syscall_id,
+                                        const uint64_t* buckets,
+                                        uint64_t sum_ns,
+                                        void* ctx);
+
+/**
+ * @brief Sum the per-CPU syscall latency histograms and pass them to `cb`.
+ *
+ * @param cb called once for every (cgroup, syscall) pair.
+ * @param ctx passed to `cb`.
+ *
+ * @return `0` on success, `errno` in case of error.
+ */
+int pman_get_syscall_latency(pman_syscall_latency_cb cb, void* ctx);
+
 /**
  * @brief Get API version to check it a runtime.
  *
@@ -298,10 +520,141 @@ int pman_finalize_maps_after_loading(void);
  */
 int pman_mark_single_64bit_syscall(int syscall_id, bool interesting);
 
+/**
+ * @brief Add or remove a thread from the threads whose syscalls are
+ * dropped in the kernel. Children of suppressed threads are suppressed
+ * automatically.
+ *
+ * @param tid thread id seen from the init namespace.
+ * @param suppress true to suppress the thread, false to stop suppressing it.
+ *
+ * @return `0` on success, `errno` in case of error.
+ */
+int pman_suppress_tid(uint32_t tid, bool suppress);
+
+/**
+ * @brief Add or remove a process name from the names whose syscalls are
+ * dropped in the kernel. Names longer than the kernel `comm` are truncated.
+ *
+ * @param comm process name.
+ * @param suppress true to suppress the name, false to stop suppressing it.
+ *
+ * @return `0` on success, `errno` in case of error.
+ */
+int pman_suppress_comm(const char* comm, bool suppress);
+
+/**
+ * @brief Add or remove a cgroup v2 id from the cgroups whose syscalls are
+ * dropped in the kernel.
+ *
+ * @param cgroup_id cgroup id.
+ * @param suppress true to suppress the cgroup, false to stop suppressing it.
+ *
+ * @return `0` on success, `errno` in case of error.
+ */
+int pman_suppress_cgroup(uint64_t cgroup_id, bool suppress);
+
+/**
+ * @brief Remove all the entries of the in-kernel suppression maps.
+ *
+ * @return `0` on success, `errno` in case of error.
+ */
+int pman_clear_suppressed_tids(void);
+int pman_clear_suppressed_comms(void);
+int pman_clear_suppressed_cgroups(void);
+
+/**
+ * @brief Restrict the syscalls collected for the tasks of a cgroup. Only
+ * syscalls in both the global set and the cgroup set are collected.
+ *
+ * @param cgroup_id cgroup v2 id.
+ * @param sc_set array of `PPM_SC_MAX` entries, `NULL` to remove the cgroup
+ * selection.
+ *
+ * @return `0` on success, `errno` in case of error.
+ */
+int pman_set_cgroup_sc_set(uint64_t cgroup_id, const bool* sc_set);
+
+/**
+ * @brief Remove the syscall selection of all the cgroups.
+ *
+ * @return `0` on success, `errno` in case of error.
+ */
+int pman_clear_cgroup_sc_sets(void);
+
+/**
+ * @brief What to do with the events whose argument matches an argument filter.
+ * The values match the ones of `enum arg_filter_action` in the kernel.
+ */
+enum pman_arg_filter_action {
+	PMAN_ARG_FILTER_REMOVE = 0, /* remove the filter */
+	PMAN_ARG_FILTER_KEEP = 1,
+	PMAN_ARG_FILTER_DROP = 2,
+};
+
+/**
+ * @brief Add or remove an absolute path prefix from the filters applied to
+ * the `open` family of syscalls. The longest matching prefix wins, so a `KEEP`
+ * prefix can carve an exception out of a shorter `DROP` one. Relative paths
+ * are never filtered.
+ *
+ * @param prefix absolute path prefix, truncated to `MAX_PATH_FILTER_LEN` bytes.
+ * @param action one of `pman_arg_filter_action`.
+ *
+ * @return `0` on success, `errno` in case of error.
+ */
+int pman_set_path_filter(const char* prefix, enum pman_arg_filter_action action);
+
+/**
+ * @brief Add or remove a remote port from the ports of interest of
+ * `connect`. When at least one port is set, connections to the other
+ * IPv4/IPv6 ports are dropped in the kernel.
+ *
+ * @param port remote port, host byte order.
+ * @param interesting true to add the port, false to remove it.
+ *
+ * @return `0` on success, `errno` in case of error.
+ */
+int pman_set_port_filter(uint16_t port, bool interesting);
+
+/**
+ * @brief Add or remove a remote network from the filters applied to
+ * `connect`. The longest matching network wins. IPv4 networks are expressed
+ * as IPv4-mapped IPv6 ones (`::ffff:a.b.c.d`, prefix length + 96).
+ *
+ * @param addr 16 bytes IPv6 address, network byte order.
+ * @param prefixlen prefix length in bits, up to 128.
+ * @param action one of `pman_arg_filter_action`.
+ *
+ * @return `0` on success, `errno` in case of error.
+ */
+int pman_set_addr_filter(const uint8_t* addr,
+                          uint32_t prefixlen,
+                          enum pman_arg_filter_action action);
+
+/**
+ * @brief Remove all the path, port and address filters.
+ *
+ * @return `0` on success, `errno` in case of error.
+ */
+int pman_clear_arg_filters(void);
+
 /////////////////////////////
 // ITERATORS
 /////////////////////////////
 
+/**
+ * @brief Load only the BPF iterator programs, so that the `pman_iter_fetch_*` APIs can be used
+ * without capturing events, e.g. to collect the initial state for another engine. It replaces
+ * `pman_init_state`, `pman_open_probe` and `pman_load_probe`: nothing is attached and the probe is
+ * released by `pman_close_probe`. Only one probe can be loaded per process.
+ *
+ * @param log_fn logging callback
+ * @param boot_time boot time in nanoseconds, used to compute the start time of the tasks.
+ * @return `0` on success, `ENOTSUP` if no iterator program is supported, `errno` in case of error.
+ */
+int pman_load_iterators(falcosecurity_log_fn log_fn, uint64_t boot_time);
+
 int32_t pman_iter_fetch_task(const struct scap_fetch_callbacks* callbacks,
                              uint32_t tid,
                              scap_threadinfo* tinfo,
@@ -87,8 +87,18 @@ static void clear_state() {
 	g_state.prod_pos = NULL;
 	g_state.inner_ringbuf_map_fd = -1;
 	g_state.buffer_bytes_dim = 0;
+	g_state.cpu_to_ringbuf = NULL;
+	g_state.ringbufs_bytes_dim = NULL;
+	g_state.ringbufs_numa_node = NULL;
+	g_state.numa_placement = false;
 	g_state.last_ring_read = -1;
 	g_state.last_event_size = 0;
+	free(g_state.consumers_pin_path);
+	g_state.consumers_pin_path = NULL;
+	g_state.consumer_slot = -1;
+	g_state.consumers_lock_fd = -1;
+	g_state.secondary_consumer = false;
+	memset(g_state.consumers_sc_set, 0, sizeof(g_state.consumers_sc_set));
 
 	for(int j = 0; j < MODERN_BPF_PROG_ATTACHED_MAX; j++) {
 		g_state.attached_progs_fds[j] = -1;
@@ -0,0 +1,307 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2026 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <fcntl.h>
+#include <limits.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+
+#include <libpman.h>
+#include <libscap/scap.h>
+#include <driver/capture_macro.h>
+#include "state.h"
+
+/* Maps pinned in the bpffs directory, every consumer has its own copy of the other ones. */
+#define N_SHARED_MAPS 5
+
+static void get_shared_maps(struct bpf_map* maps[N_SHARED_MAPS]) {
+	maps[0] = g_state.skel->maps.consumers;
+	maps[1] = g_state.skel->maps.consumer_ringbuf_maps;
+	maps[2] = g_state.skel->maps.capture_settings;
+	maps[3] = g_state.skel->maps.interesting_syscalls_table_64bit;
+	maps[4] = g_state.skel->maps.counter_maps;
+}
+
+static bool is_tgid_alive(int32_t tgid) {
+	return tgid > 0 && (kill(tgid, 0) == 0 || errno == EPERM);
+}
+
+/* The probe is already loaded if the pinned `consumers` map has a live consumer in slot `0`. */
+static bool is_probe_loaded(const char* consumers_path) {
+	const int fd = bpf_obj_get(consumers_path);
+	if(fd < 0) {
+		return false;
+	}
+	uint32_t slot = 0;
+	struct consumer consumer;
+	const bool loaded =
+	        bpf_map_lookup_elem(fd, &slot, &consumer) == 0 && is_tgid_alive(consumer.tgid);
+	close(fd);
+	return loaded;
+}
+
+/* Consumers lock the pin directory while they decide whether to load the probe, pin its maps and
+ * claim their slot, and while they remove the pins, so that two of them never both load the probe
+ * or find it half pinned. Return the locked directory fd or `-1`.
+ */
+static int lock_pin_path(const char* pin_path) {
+	const int fd = open(pin_path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if(fd < 0) {
+		return -1;
+	}
+	int res;
+	do {
+		res = flock(fd, LOCK_EX);
+	} while(res != 0 && errno == EINTR);
+	if(res != 0) {
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+static void unlock_pin_path() {
+	if(g_state.consumers_lock_fd != -1) {
+		close(g_state.consumers_lock_fd);
+		g_state.consumers_lock_fd = -1;
+	}
+}
+
+int pman_share_probe(const char* pin_path) {
+	if(g_state.skel == NULL || pin_path == NULL) {
+		log_errorf("the probe must be opened before being shared");
+		return EINVAL;
+	}
+
+	/* Released once the slot is claimed, or when the probe is closed. */
+	g_state.consumers_lock_fd = lock_pin_path(pin_path);
+	if(g_state.consumers_lock_fd == -1) {
+		const int last_errno = errno;
+		log_errorf("unable to lock '%s'", pin_path);
+		return last_errno;
+	}
+
+	char path[PATH_MAX];
+	snprintf(path, sizeof(path), "%s/consumers", pin_path);
+	g_state.secondary_consumer = is_probe_loaded(path);
+
+	struct bpf_map* maps[N_SHARED_MAPS];
+	get_shared_maps(maps);
+	for(int i = 0; i < N_SHARED_MAPS; i++) {
+		snprintf(path, sizeof(path), "%s/%s", pin_path, bpf_map__name(maps[i]));
+		/* Pins left by a consumer that didn't exit cleanly are replaced. */
+		if(!g_state.secondary_consumer && unlink(path) != 0 && errno != ENOENT) {
+			const int last_errno = errno;
+			log_errorf("unable to remove the stale pin '%s'", path);
+			return last_errno;
+		}
+		if(bpf_map__set_pin_path(maps[i], path)) {
+			const int last_errno = errno;
+			log_errorf("unable to pin '%s' in '%s'", bpf_map__name(maps[i]), path);
+			return last_errno;
+		}
+	}
+
+	/* Secondary consumers never attach the programs, they only need to load the iterators. */
+	if(g_state.secondary_consumer) {
+		struct bpf_program* prog;
+		bpf_object__for_each_program(prog, g_state.skel->obj) {
+			if(bpf_program__expected_attach_type(prog) != BPF_TRACE_ITER) {
+				bpf_program__set_autoload(prog, false);
+			}
+		}
+	}
+
+	g_state.consumers_pin_path = strdup(pin_path);
+	if(g_state.consumers_pin_path == NULL) {
+		log_errorf("unable to allocate the pin path");
+		return ENOMEM;
+	}
+	log_msgf(FALCOSECURITY_LOG_SEV_INFO,
+	         "sharing the probe in '%s' as %s consumer",
+	         pin_path,
+	         g_state.secondary_consumer ? "a secondary" : "the primary");
+	return 0;
+}
+
+bool pman_is_probe_shared() {
+	return g_state.consumers_pin_path != NULL;
+}
+
+bool pman_is_secondary_consumer() {
+	return g_state.secondary_consumer;
+}
+
+/* Remove a consumer and its ring buffers. */
+static void clear_consumer_slot(uint32_t slot) {
+	const int ringbuf_array_fd = bpf_map__fd(g_state.skel->maps.consumer_ringbuf_maps);
+	for(uint32_t cpu = 0; cpu < g_state.n_possible_cpus; cpu++) {
+		uint32_t key = cpu * MAX_CONSUMERS + slot;
+		bpf_map_delete_elem(ringbuf_array_fd, &key);
+	}
+	bpf_map_delete_elem(bpf_map__fd(g_state.skel->maps.consumers), &slot);
+}
+
+static int claim_free_consumer_slot() {
+	const int fd = bpf_map__fd(g_state.skel->maps.consumers);
+	/* Until its first `pman_enforce_sc_set` the consumer wants no events. */
+	struct consumer consumer = {.tgid = getpid(), .snaplen = SNAPLEN};
+	const uint32_t first = g_state.secondary_consumer ? 1 : 0;
+	const uint32_t last = g_state.secondary_consumer ? MAX_CONSUMERS : 1;
+	for(uint32_t slot = first; slot < last; slot++) {
+		struct consumer current;
+		if(bpf_map_lookup_elem(fd, &slot, &current) == 0) {
+			if(is_tgid_alive(current.tgid)) {
+				continue;
+			}
+			clear_consumer_slot(slot);
+		}
+		if(bpf_map_update_elem(fd, &slot, &consumer, BPF_NOEXIST) == 0) {
+			g_state.consumer_slot = (int32_t)slot;
+			log_msgf(FALCOSECURITY_LOG_SEV_DEBUG, "claimed consumer slot %u", slot);
+			return refresh_consumers_settings();
+		}
+	}
+	log_errorf("no free consumer slot, the probe can be shared by at most %d consumers",
+	           MAX_CONSUMERS);
+	return EBUSY;
+}
+
+int claim_consumer_slot() {
+	const int err = claim_free_consumer_slot();
+	/* From now on the other consumers find the probe pinned and our slot claimed. */
+	unlock_pin_path();
+	return err;
+}
+
+void release_consumer_slot() {
+	unlock_pin_path();
+	if(g_state.skel == NULL || g_state.consumers_pin_path == NULL) {
+		return;
+	}
+	const int lock_fd = lock_pin_path(g_state.consumers_pin_path);
+
+	if(g_state.consumer_slot != -1) {
+		clear_consumer_slot(g_state.consumer_slot);
+		refresh_consumers_settings();
+		g_state.consumer_slot = -1;
+	}
+
+	/* Consumers already sharing the probe keep the maps open, the pins only let new ones find
+	 * it.
+	 */
+	if(!g_state.secondary_consumer) {
+		struct bpf_map* maps[N_SHARED_MAPS];
+		get_shared_maps(maps);
+		for(int i = 0; i < N_SHARED_MAPS; i++) {
+			bpf_map__unpin(maps[i], NULL);
+		}
+	}
+	if(lock_fd != -1) {
+		close(lock_fd);
+	}
+}
+
+static int update_consumer(const struct consumer* consumer) {
+	const uint32_t slot = g_state.consumer_slot;
+	if(bpf_map_update_elem(bpf_map__fd(g_state.skel->maps.consumers),
+	                       &slot,
+	                       consumer,
+	                       BPF_EXIST) < 0) {
+		const int last_errno = errno;
+		log_errorf("unable to update consumer slot %u", slot);
+		return last_errno;
+	}
+	return refresh_consumers_settings();
+}
+
+static int get_consumer(struct consumer* consumer) {
+	const uint32_t slot = g_state.consumer_slot;
+	if(bpf_map_lookup_elem(bpf_map__fd(g_state.skel->maps.consumers), &slot, consumer) < 0) {
+		const int last_errno = errno;
+		log_errorf("unable to get consumer slot %u", slot);
+		return last_errno;
+	}
+	return 0;
+}
+
+int update_consumer_sc_set(const bool* sc_set) {
+	struct consumer consumer;
+	int err = get_consumer(&consumer);
+	if(err != 0) {
+		return err;
+	}
+
+	uint8_t ppm_sc[PPM_SC_MAX];
+	memset(consumer.syscalls, 0, sizeof(consumer.syscalls));
+	memset(consumer.ppm_sc, 0, sizeof(consumer.ppm_sc));
+	for(int sc = 0; sc < PPM_SC_MAX; sc++) {
+		ppm_sc[sc] = sc_set[sc];
+		if(sc_set[sc]) {
+			consumer.ppm_sc[sc / 8] |= 1 << (sc % 8);
+		}
+		const int syscall_id = scap_ppm_sc_to_native_id(sc);
+		if(sc_set[sc] && syscall_id != -1) {
+			consumer.syscalls[syscall_id / 8] |= 1 << (syscall_id % 8);
+		}
+	}
+
+	/* Events not tied to a ppm_sc, like the generic ones, can't be told apart and are always
+	 * sent.
+	 */
+	uint8_t events[PPM_EVENT_MAX];
+	uint8_t tied_events[PPM_EVENT_MAX];
+	scap_get_events_from_ppm_sc(ppm_sc, events);
+	memset(ppm_sc, 1, sizeof(ppm_sc));
+	scap_get_events_from_ppm_sc(ppm_sc, tied_events);
+	memset(consumer.events, 0, sizeof(consumer.events));
+	for(int ev = 0; ev < PPM_EVENT_MAX; ev++) {
+		if(events[ev] || !tied_events[ev]) {
+			consumer.events[ev / 8] |= 1 << (ev % 8);
+		}
+	}
+	return update_consumer(&consumer);
+}
+
+/* Consumers whose slot can't be read are left out. */
+void get_consumers_sc_set(bool* sc_set) {
+	memset(sc_set, 0, PPM_SC_MAX * sizeof(bool));
+	const int fd = bpf_map__fd(g_state.skel->maps.consumers);
+	struct consumer consumer;
+	for(uint32_t slot = 0; slot < MAX_CONSUMERS; slot++) {
+		if(bpf_map_lookup_elem(fd, &slot, &consumer) != 0) {
+			continue;
+		}
+		for(int sc = 0; sc < PPM_SC_MAX; sc++) {
+			sc_set[sc] |= (consumer.ppm_sc[sc / 8] & (1 << (sc % 8))) != 0;
+		}
+	}
+}
+
+int update_consumer_snaplen(uint32_t snaplen) {
+	struct consumer consumer;
+	int err = get_consumer(&consumer);
+	if(err != 0) {
+		return err;
+	}
+	consumer.snaplen = snaplen;
+	return update_consumer(&consumer);
+}
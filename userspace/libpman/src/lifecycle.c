@@ -20,6 +20,7 @@ limitations under the License.
 #include <driver/feature_gates.h>
 #include "events_prog_table.h"
 #include "support_probing.h"
+#include <libpman.h>
 
 int pman_open_probe() {
 	g_state.skel = bpf_probe__open();
@@ -233,6 +234,8 @@ static void save_attached_progs() {
 	g_state.attached_progs_fds[23] = bpf_prog_fd_or_default(g_state.skel->progs.dump_task);
 	g_state.attached_progs_fds[24] = bpf_prog_fd_or_default(g_state.skel->progs.dump_task_file);
 #endif
+	g_state.attached_progs_fds[25] = bpf_prog_fd_or_default(g_state.skel->progs.sys_enter_latency);
+	g_state.attached_progs_fds[26] = bpf_prog_fd_or_default(g_state.skel->progs.sys_exit_latency);
 }
 
 int pman_load_probe() {
@@ -250,6 +253,64 @@ int pman_load_probe() {
 	return 0;
 }
 
+int pman_load_iterators(falcosecurity_log_fn log_fn, uint64_t boot_time) {
+#ifndef BPF_ITERATOR_SUPPORT
+	return ENOTSUP;
+#else
+	if(g_state.skel) {
+		return EBUSY;
+	}
+
+	// Nothing is ever written into the ring buffer: a single one of a page is enough.
+	const unsigned long page_size = sysconf(_SC_PAGESIZE);
+	errno = 0;
+	if(pman_init_state(log_fn, page_size, 0, false, false) != 0) {
+		return errno ?: EINVAL;
+	}
+
+	int err = pman_open_probe();
+	if(err) {
+		pman_close_probe();
+		return err;
+	}
+
+	// Keep only the supported iterator programs. The tail-called ones that cannot be disabled
+	// are loaded as well, but never attached.
+	iter_support_probing__disable_all_progs(g_state.skel);
+	for(int i = 0; i < ITER_PROG_MAX; i++) {
+		struct bpf_program *p =
+		        bpf_object__find_program_by_name(g_state.skel->obj, iter_progs_table[i].name);
+		if(p) {
+			bpf_program__set_autoload(p, true);
+		}
+	}
+	prepare_iter_progs_before_loading();
+	if(!g_state.is_tasks_dumping_supported && !g_state.is_task_files_dumping_supported) {
+		pman_close_probe();
+		return ENOTSUP;
+	}
+
+	struct iter_support_probing_ctx ctx = {.probe = g_state.skel, .inner_ringbuf_map_fd = -1};
+	err = iter_support_probing__prepare_ringbuf_array_before_loading(&ctx);
+	// Closed by `pman_close_probe()`.
+	g_state.inner_ringbuf_map_fd = ctx.inner_ringbuf_map_fd;
+	err = err ?: iter_support_probing__prepare_maps_before_loading(&ctx);
+	err = err ?: pman_load_probe();
+	if(err) {
+		log_errorf("failed to load the BPF iterators");
+		pman_close_probe();
+		return err;
+	}
+
+	pman_set_boot_time(boot_time);
+	log_msgf(FALCOSECURITY_LOG_SEV_DEBUG,
+	         "loaded the BPF iterators (tasks: %s, task files: %s)",
+	         g_state.is_tasks_dumping_supported ? "yes" : "no",
+	         g_state.is_task_files_dumping_supported ? "yes" : "no");
+	return 0;
+#endif
+}
+
 void pman_close_probe() {
 	if(g_state.stats) {
 		free(g_state.stats);
@@ -275,6 +336,13 @@ void pman_close_probe() {
 		g_state.prod_pos = NULL;
 	}
 
+	free_ringbuf_topology();
+
+	release_consumer_slot();
+	free(g_state.consumers_pin_path);
+	g_state.consumers_pin_path = NULL;
+	g_state.secondary_consumer = false;
+
 	if(g_state.skel) {
 		bpf_probe__detach(g_state.skel);
 		bpf_probe__destroy(g_state.skel);
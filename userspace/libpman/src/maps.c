@@ -18,10 +18,14 @@ limitations under the License.
 
 #include "state.h"
 
+#include <inttypes.h>
 #include <stdint.h>
+#include <string.h>
 #include "events_prog_table.h"
+#include "programs.h"
 #include "support_probing.h"
 #include <libscap/scap.h>
+#include <libpman.h>
 
 /* Some exit events can require more than one bpf program to collect all the data. */
 static const char* sys_exit_extra_event_names[SYS_EXIT_EXTRA_CODE_MAX] = {
@@ -119,6 +123,12 @@ static int update_capture_settings(struct capture_settings* settings) {
 }
 
 void pman_set_snaplen(uint32_t desired_snaplen) {
+	/* Shared probes use the maximum snaplen of the consumers. */
+	if(g_state.consumer_slot != -1) {
+		update_consumer_snaplen(desired_snaplen);
+		return;
+	}
+
 	struct capture_settings settings;
 	if(get_capture_settings(&settings) != 0) {
 		return;
@@ -200,6 +210,24 @@ void pman_set_scap_tid(int32_t scap_tid) {
 	update_capture_settings(&settings);
 }
 
+int pman_set_wakeup_watermark(uint64_t watermark) {
+	if(watermark >= g_state.buffer_bytes_dim) {
+		log_errorf("the wakeup watermark (%" PRIu64
+		           ") must be lower than the ring buffer dimension (%lu)",
+		           watermark,
+		           g_state.buffer_bytes_dim);
+		return EINVAL;
+	}
+
+	struct capture_settings settings;
+	int err = get_capture_settings(&settings);
+	if(err != 0) {
+		return err;
+	}
+	settings.wakeup_watermark = watermark;
+	return update_capture_settings(&settings);
+}
+
 static void fill_syscall_sampling_table() {
 	for(int syscall_id = 0; syscall_id < SYSCALL_TABLE_SIZE; syscall_id++) {
 		if(g_syscall_table[syscall_id].flags & UF_NEVER_DROP) {
@@ -221,6 +249,14 @@ static void fill_syscall_sampling_table() {
 	}
 }
 
+static void fill_rate_limit_category_table() {
+	for(int syscall_id = 0; syscall_id < SYSCALL_TABLE_SIZE; syscall_id++) {
+		const int exit_event_type = g_syscall_table[syscall_id].exit_event_type;
+		g_state.skel->rodata->g_64bit_rate_limit_category_table[syscall_id] =
+		        (uint8_t)(g_event_info[exit_event_type].category & RATE_LIMIT_CATEGORY_MASK);
+	}
+}
+
 static void fill_ia32_to_64_table() {
 	for(int syscall_id = 0; syscall_id < SYSCALL_TABLE_SIZE; syscall_id++) {
 		// Note: we will map all syscalls from the upper limit of the ia32 table
@@ -376,6 +412,45 @@ int pman_mark_single_64bit_syscall(int syscall_id, bool interesting) {
 	return 0;
 }
 
+/* Shared probes capture the union of the syscalls and the maximum snaplen of the consumers. */
+int refresh_consumers_settings() {
+	struct capture_settings settings;
+	int err = get_capture_settings(&settings);
+	if(err != 0) {
+		return err;
+	}
+
+	const int fd = bpf_map__fd(g_state.skel->maps.consumers);
+	uint8_t syscalls[SYSCALL_TABLE_SIZE / 8] = {0};
+	uint32_t n_consumers = 0;
+	uint32_t snaplen = 0;
+	struct consumer consumer;
+	for(uint32_t slot = 0; slot < MAX_CONSUMERS; slot++) {
+		if(bpf_map_lookup_elem(fd, &slot, &consumer) != 0) {
+			continue;
+		}
+		n_consumers++;
+		snaplen = consumer.snaplen > snaplen ? consumer.snaplen : snaplen;
+		for(int i = 0; i < SYSCALL_TABLE_SIZE / 8; i++) {
+			syscalls[i] |= consumer.syscalls[i];
+		}
+	}
+	if(n_consumers == 0) {
+		return 0;
+	}
+
+	for(int syscall_id = 0; syscall_id < SYSCALL_TABLE_SIZE; syscall_id++) {
+		err = pman_mark_single_64bit_syscall(syscall_id,
+		                                     syscalls[syscall_id / 8] & (1 << (syscall_id % 8)));
+		if(err != 0) {
+			return err;
+		}
+	}
+	settings.snaplen = snaplen;
+	settings.multi_consumer = n_consumers > 1;
+	return update_capture_settings(&settings);
+}
+
 static int size_auxiliary_maps(const struct bpf_probe* probe, const uint32_t max_entries) {
 	if(bpf_map__set_max_entries(probe->maps.auxiliary_maps, max_entries)) {
 		const int last_errno = errno;
@@ -395,6 +470,356 @@ static int size_counter_maps(const struct bpf_probe* probe, const uint32_t max_e
 
 /*=============================== BPF_MAP_TYPE_ARRAY ===============================*/
 
+/*=============================== BPF_MAP_TYPE_HASH ===============================*/
+
+/* Large enough for the key of every hash map, the path filter one is the largest. */
+#define HASH_MAP_KEY_MAX_SIZE sizeof(struct path_filter_key)
+
+static bool is_map_empty(int fd) {
+	char key[HASH_MAP_KEY_MAX_SIZE];
+	return bpf_map_get_next_key(fd, NULL, key) != 0;
+}
+
+/* The dispatcher only looks up the hash maps that are not empty. */
+static int refresh_hash_map_settings() {
+	struct capture_settings settings;
+	int err = get_capture_settings(&settings);
+	if(err != 0) {
+		return err;
+	}
+	settings.suppress_tids = !is_map_empty(bpf_map__fd(g_state.skel->maps.suppressed_tids));
+	settings.suppress_comms = !is_map_empty(bpf_map__fd(g_state.skel->maps.suppressed_comms));
+	settings.suppress_cgroups = !is_map_empty(bpf_map__fd(g_state.skel->maps.suppressed_cgroups));
+	settings.cgroup_syscalls = !is_map_empty(bpf_map__fd(g_state.skel->maps.cgroup_syscalls_table));
+	settings.path_filter = !is_map_empty(bpf_map__fd(g_state.skel->maps.path_filters));
+	settings.port_filter = !is_map_empty(bpf_map__fd(g_state.skel->maps.port_filters));
+	settings.addr_filter = !is_map_empty(bpf_map__fd(g_state.skel->maps.addr_filters));
+	return update_capture_settings(&settings);
+}
+
+static int update_suppression_map(struct bpf_map* map, const void* key, bool suppress) {
+	const int fd = bpf_map__fd(map);
+	if(fd < 0) {
+		const int last_errno = errno;
+		log_errorf("unable to get '%s' map fd!", bpf_map__name(map));
+		return last_errno;
+	}
+
+	if(suppress) {
+		const uint8_t value = 1;
+		if(bpf_map_update_elem(fd, key, &value, BPF_ANY) < 0) {
+			const int last_errno = errno;
+			log_errorf("unable to add an entry to '%s'!", bpf_map__name(map));
+			return last_errno;
+		}
+	} else if(bpf_map_delete_elem(fd, key) < 0 && errno != ENOENT) {
+		const int last_errno = errno;
+		log_errorf("unable to remove an entry from '%s'!", bpf_map__name(map));
+		return last_errno;
+	}
+
+	return refresh_hash_map_settings();
+}
+
+static int clear_hash_map(struct bpf_map* map) {
+	const int fd = bpf_map__fd(map);
+	if(fd < 0) {
+		const int last_errno = errno;
+		log_errorf("unable to get '%s' map fd!", bpf_map__name(map));
+		return last_errno;
+	}
+
+	/* Deleting the first key every time avoids iterating over a changing map. */
+	char key[HASH_MAP_KEY_MAX_SIZE];
+	while(bpf_map_get_next_key(fd, NULL, key) == 0) {
+		if(bpf_map_delete_elem(fd, key) < 0 && errno != ENOENT) {
+			const int last_errno = errno;
+			log_errorf("unable to clear '%s'!", bpf_map__name(map));
+			return last_errno;
+		}
+	}
+
+	return refresh_hash_map_settings();
+}
+
+int pman_suppress_tid(uint32_t tid, bool suppress) {
+	return update_suppression_map(g_state.skel->maps.suppressed_tids, &tid, suppress);
+}
+
+int pman_suppress_comm(const char* comm, bool suppress) {
+	/* Keys are compared byte by byte so they must be NUL-padded. */
+	char key[SUPPRESSED_COMM_LEN] = {0};
+	strncpy(key, comm, SUPPRESSED_COMM_LEN - 1);
+	return update_suppression_map(g_state.skel->maps.suppressed_comms, key, suppress);
+}
+
+int pman_suppress_cgroup(uint64_t cgroup_id, bool suppress) {
+	return update_suppression_map(g_state.skel->maps.suppressed_cgroups, &cgroup_id, suppress);
+}
+
+int pman_clear_suppressed_tids() {
+	return clear_hash_map(g_state.skel->maps.suppressed_tids);
+}
+
+int pman_clear_suppressed_comms() {
+	return clear_hash_map(g_state.skel->maps.suppressed_comms);
+}
+
+int pman_clear_suppressed_cgroups() {
+	return clear_hash_map(g_state.skel->maps.suppressed_cgroups);
+}
+
+int pman_set_cgroup_sc_set(uint64_t cgroup_id, const bool* sc_set) {
+	const int fd = bpf_map__fd(g_state.skel->maps.cgroup_syscalls_table);
+	if(fd < 0) {
+		const int last_errno = errno;
+		log_errorf("unable to get cgroup_syscalls_table map fd!");
+		return last_errno;
+	}
+
+	if(sc_set == NULL) {
+		if(bpf_map_delete_elem(fd, &cgroup_id) < 0 && errno != ENOENT) {
+			const int last_errno = errno;
+			log_errorf("unable to remove the syscalls of cgroup %" PRIu64 "!", cgroup_id);
+			return last_errno;
+		}
+		return refresh_hash_map_settings();
+	}
+
+	struct cgroup_syscalls selection = {};
+	for(int sc = 0; sc < PPM_SC_MAX; sc++) {
+		const int syscall_id = scap_ppm_sc_to_native_id(sc);
+		/* if `syscall_id` is -1 this is not a syscall */
+		if(syscall_id == -1 || !sc_set[sc]) {
+			continue;
+		}
+		selection.syscalls[syscall_id / 8] |= 1 << (syscall_id % 8);
+	}
+
+	if(bpf_map_update_elem(fd, &cgroup_id, &selection, BPF_ANY) < 0) {
+		const int last_errno = errno;
+		log_errorf("unable to set the syscalls of cgroup %" PRIu64 "!", cgroup_id);
+		return last_errno;
+	}
+	return refresh_hash_map_settings();
+}
+
+int pman_clear_cgroup_sc_sets() {
+	return clear_hash_map(g_state.skel->maps.cgroup_syscalls_table);
+}
+
+static int update_arg_filter_map(struct bpf_map* map, const void* key, uint8_t action) {
+	if(action != PMAN_ARG_FILTER_REMOVE && action != PMAN_ARG_FILTER_KEEP &&
+	   action != PMAN_ARG_FILTER_DROP) {
+		log_errorf("invalid action %u for '%s'!", action, bpf_map__name(map));
+		return EINVAL;
+	}
+
+	const int fd = bpf_map__fd(map);
+	if(fd < 0) {
+		const int last_errno = errno;
+		log_errorf("unable to get '%s' map fd!", bpf_map__name(map));
+		return last_errno;
+	}
+
+	if(action != PMAN_ARG_FILTER_REMOVE) {
+		if(bpf_map_update_elem(fd, key, &action, BPF_ANY) < 0) {
+			const int last_errno = errno;
+			log_errorf("unable to add an entry to '%s'!", bpf_map__name(map));
+			return last_errno;
+		}
+	} else if(bpf_map_delete_elem(fd, key) < 0 && errno != ENOENT) {
+		const int last_errno = errno;
+		log_errorf("unable to remove an entry from '%s'!", bpf_map__name(map));
+		return last_errno;
+	}
+
+	return refresh_hash_map_settings();
+}
+
+int pman_set_path_filter(const char* prefix, enum pman_arg_filter_action action) {
+	if(prefix == NULL || prefix[0] != '/') {
+		log_errorf("path filters only support absolute paths!");
+		return EINVAL;
+	}
+
+	/* Longer prefixes are truncated, the kernel never looks past `MAX_PATH_FILTER_LEN`. */
+	struct path_filter_key key = {};
+	strncpy(key.path, prefix, MAX_PATH_FILTER_LEN);
+	key.prefixlen = strnlen(key.path, MAX_PATH_FILTER_LEN) * 8;
+	return update_arg_filter_map(g_state.skel->maps.path_filters, &key, action);
+}
+
+int pman_set_port_filter(uint16_t port, bool interesting) {
+	return update_suppression_map(g_state.skel->maps.port_filters, &port, interesting);
+}
+
+int pman_set_addr_filter(const uint8_t* addr,
+                          uint32_t prefixlen,
+                          enum pman_arg_filter_action action) {
+	if(prefixlen > 128) {
+		log_errorf("invalid address filter prefix length %u!", prefixlen);
+		return EINVAL;
+	}
+
+	struct addr_filter_key key = {.prefixlen = prefixlen};
+	memcpy(key.addr, addr, sizeof(key.addr));
+	return update_arg_filter_map(g_state.skel->maps.addr_filters, &key, action);
+}
+
+int pman_clear_arg_filters() {
+	int err = clear_hash_map(g_state.skel->maps.path_filters);
+	err = err ?: clear_hash_map(g_state.skel->maps.port_filters);
+	return err ?: clear_hash_map(g_state.skel->maps.addr_filters);
+}
+
+int pman_set_io_aggregation(uint32_t max_count, uint64_t max_bytes, uint64_t interval_ns) {
+	struct capture_settings settings;
+	int err = get_capture_settings(&settings);
+	if(err != 0) {
+		return err;
+	}
+	settings.io_aggregation = max_count != 0;
+	settings.io_aggregation_max_count = max_count;
+	settings.io_aggregation_max_bytes = max_bytes;
+	settings.io_aggregation_interval_ns = interval_ns;
+	err = update_capture_settings(&settings);
+	if(err != 0 || settings.io_aggregation) {
+		return err;
+	}
+	err = clear_hash_map(g_state.skel->maps.io_aggregation_table);
+	return err ?: clear_hash_map(g_state.skel->maps.io_aggregation_threads);
+}
+
+int pman_set_rate_limit(uint8_t category, uint64_t rate, uint64_t burst) {
+	if(category >= RATE_LIMIT_CATEGORIES || (rate != 0 && burst == 0)) {
+		log_errorf("invalid rate limit for category %u", category);
+		return EINVAL;
+	}
+
+	const int fd = bpf_map__fd(g_state.skel->maps.rate_limits);
+	if(fd < 0) {
+		const int last_errno = errno;
+		log_errorf("unable to get rate_limits map fd!");
+		return last_errno;
+	}
+
+	uint32_t key = category;
+	struct rate_limit limit = {.rate = rate, .burst = burst};
+	if(bpf_map_update_elem(fd, &key, &limit, BPF_ANY) < 0) {
+		const int last_errno = errno;
+		log_errorf("unable to set the rate limit of category %u!", category);
+		return last_errno;
+	}
+
+	/* The dispatcher only looks up the buckets when at least one category is limited. */
+	bool rate_limit = false;
+	for(key = 0; key < RATE_LIMIT_CATEGORIES && !rate_limit; key++) {
+		if(bpf_map_lookup_elem(fd, &key, &limit) == 0 && limit.rate != 0) {
+			rate_limit = true;
+		}
+	}
+
+	struct capture_settings settings;
+	int err = get_capture_settings(&settings);
+	if(err != 0) {
+		return err;
+	}
+	settings.rate_limit = rate_limit;
+	err = update_capture_settings(&settings);
+	if(err != 0 || rate_limit) {
+		return err;
+	}
+	return clear_hash_map(g_state.skel->maps.rate_limit_buckets);
+}
+
+void pman_set_rate_limit_summary_interval(uint64_t interval_ns) {
+	struct capture_settings settings;
+	if(get_capture_settings(&settings) != 0) {
+		return;
+	}
+	settings.rate_limit_summary_interval_ns = interval_ns;
+	update_capture_settings(&settings);
+}
+
+int pman_flush_rate_limit_drops(pman_rate_limit_drops_cb cb, void* ctx) {
+	const int fd = bpf_map__fd(g_state.skel->maps.rate_limit_buckets);
+	if(fd < 0) {
+		const int last_errno = errno;
+		log_errorf("unable to get rate_limit_buckets map fd!");
+		return last_errno;
+	}
+
+	struct rate_limit_key key;
+	struct rate_limit_key* prev = NULL;
+	while(bpf_map_get_next_key(fd, prev, &key) == 0) {
+		prev = &key;
+		struct rate_limit_bucket bucket;
+		/* The bucket may have been evicted in the meantime. */
+		if(bpf_map_lookup_elem(fd, &key, &bucket) < 0 || bucket.dropped == 0) {
+			continue;
+		}
+		cb(key.tgid, (uint8_t)key.category, bucket.dropped, ctx);
+		bucket.dropped = 0;
+		bpf_map_update_elem(fd, &key, &bucket, BPF_EXIST);
+	}
+	return 0;
+}
+
+int pman_enable_syscall_latency(bool enable) {
+	if(g_state.secondary_consumer) {
+		log_errorf("syscall latency can only be enabled by the consumer that loaded the probe");
+		return EPERM;
+	}
+
+	if(enable) {
+		return attach_syscall_latency();
+	}
+
+	int err = detach_syscall_latency();
+	err = err ?: clear_hash_map(g_state.skel->maps.syscall_latency_start);
+	return err ?: clear_hash_map(g_state.skel->maps.syscall_latency_hists);
+}
+
+int pman_get_syscall_latency(pman_syscall_latency_cb cb, void* ctx) {
+	const int fd = bpf_map__fd(g_state.skel->maps.syscall_latency_hists);
+	if(fd < 0) {
+		const int last_errno = errno;
+		log_errorf("unable to get syscall_latency_hists map fd!");
+		return last_errno;
+	}
+
+	struct syscall_latency_hist* per_cpu = (struct syscall_latency_hist*)calloc(
+	        g_state.n_possible_cpus,
+	        sizeof(struct syscall_latency_hist));
+	if(per_cpu == NULL) {
+		log_errorf("unable to allocate the syscall latency histograms");
+		return ENOMEM;
+	}
+
+	struct syscall_latency_key key;
+	struct syscall_latency_key* prev = NULL;
+	while(bpf_map_get_next_key(fd, prev, &key) == 0) {
+		prev = &key;
+		/* The pair may have been removed in the meantime. */
+		if(bpf_map_lookup_elem(fd, &key, per_cpu) < 0) {
+			continue;
+		}
+		struct syscall_latency_hist hist = {};
+		for(int cpu = 0; cpu < g_state.n_possible_cpus; cpu++) {
+			for(int bucket = 0; bucket < SYSCALL_LATENCY_BUCKETS; bucket++) {
+				hist.buckets[bucket] += per_cpu[cpu].buckets[bucket];
+			}
+			hist.sum_ns += per_cpu[cpu].sum_ns;
+		}
+		cb(key.cgroup_id, key.syscall_id, hist.buckets, hist.sum_ns, ctx);
+	}
+	free(per_cpu);
+	return 0;
+}
+
+/*=============================== BPF_MAP_TYPE_HASH ===============================*/
+
 /* Here we split maps operations, before and after the loading phase.
  */
 
@@ -404,6 +829,7 @@ int pman_prepare_maps_before_loading() {
 	fill_ppm_sc_table();
 	fill_ia32_to_64_table();
 	fill_syscall_sampling_table();
+	fill_rate_limit_category_table();
 
 	/* We need to set the entries number for every BPF_MAP_TYPE_ARRAY. The number of entries will be
 	 * always equal to the CPUs number, even if some of them are not online.
@@ -423,6 +849,11 @@ int iter_support_probing__prepare_maps_before_loading(struct iter_support_probin
 #endif  // BPF_ITERATOR_SUPPORT
 
 int pman_finalize_maps_after_loading() {
+	/* The settings and the tail tables are the ones of the consumer that loaded the probe. */
+	if(g_state.secondary_consumer) {
+		return claim_consumer_slot();
+	}
+
 	int err;
 	struct capture_settings settings = {};
 	err = update_capture_settings(&settings);
@@ -438,10 +869,14 @@ int pman_finalize_maps_after_loading() {
 	pman_set_do_dynamic_snaplen(false);
 	pman_set_fullcapture_port_range(0, 0);
 	pman_set_statsd_port(PPM_PORT_STATSD);
+	pman_set_rate_limit_summary_interval(1000000000ULL); /* 1 second */
 
 	/* We have to fill all ours tail tables. */
 	fill_interesting_syscalls_table_64bit();
 	err = fill_syscalls_tail_table();
 	err = err ?: fill_syscall_exit_extra_tail_table();
+	if(err == 0 && g_state.consumers_pin_path != NULL) {
+		err = claim_consumer_slot();
+	}
 	return err;
 }
@@ -144,6 +144,30 @@ int attach_signal_deliver() {
 	return 0;
 }
 
+int attach_syscall_latency() {
+	/* The programs are already attached. */
+	if(g_state.skel->links.sys_exit_latency != NULL) {
+		return 0;
+	}
+
+	g_state.skel->links.sys_exit_latency =
+	        bpf_program__attach(g_state.skel->progs.sys_exit_latency);
+	if(!g_state.skel->links.sys_exit_latency) {
+		log_errorf("failed to attach the 'sys_exit_latency' program");
+		return errno;
+	}
+	g_state.skel->links.sys_enter_latency =
+	        bpf_program__attach(g_state.skel->progs.sys_enter_latency);
+	if(!g_state.skel->links.sys_enter_latency) {
+		const int last_errno = errno;
+		log_errorf("failed to attach the 'sys_enter_latency' program");
+		bpf_link__destroy(g_state.skel->links.sys_exit_latency);
+		g_state.skel->links.sys_exit_latency = NULL;
+		return last_errno;
+	}
+	return 0;
+}
+
 static int attach_64bit_toctou_prog(const struct bpf_program* prog, struct bpf_link** prog_link) {
 	if(*prog_link != NULL) {
 		return 0;
@@ -323,6 +347,22 @@ int detach_signal_deliver() {
 	return 0;
 }
 
+int detach_syscall_latency() {
+	if(g_state.skel->links.sys_enter_latency &&
+	   bpf_link__destroy(g_state.skel->links.sys_enter_latency)) {
+		log_errorf("failed to detach the 'sys_enter_latency' program");
+		return errno;
+	}
+	g_state.skel->links.sys_enter_latency = NULL;
+	if(g_state.skel->links.sys_exit_latency &&
+	   bpf_link__destroy(g_state.skel->links.sys_exit_latency)) {
+		log_errorf("failed to detach the 'sys_exit_latency' program");
+		return errno;
+	}
+	g_state.skel->links.sys_exit_latency = NULL;
+	return 0;
+}
+
 static void print_prog_detachment_failure_error(const struct bpf_program* prog) {
 	const char* prog_name = bpf_program__name(prog);
 	log_errorf("failed to detach the '%s' program", prog_name);
@@ -114,6 +114,18 @@ int attach_signal_deliver();
  */
 int detach_signal_deliver();
 
+/**
+ * @brief Attaches the syscall latency programs.
+ * @return `0` on success, `errno` in case of error.
+ */
+int attach_syscall_latency();
+
+/**
+ * @brief Detach the syscall latency programs.
+ * @return `0` on success, `errno` in case of error.
+ */
+int detach_syscall_latency();
+
 /*
  * @brief Attaches only the connect TOCTOU mitigation programs.
  * @return `0` on success, `errno` in case of error.
@@ -21,6 +21,7 @@ limitations under the License.
 #include <unistd.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <sys/epoll.h>
 #include <sys/mman.h>
 #include <ringbuffer_debug_macro.h>
 #include <driver/ppm_events_public.h>
@@ -35,17 +36,19 @@ limitations under the License.
  */
 static int ringbuf_array_set_inner_map(const struct bpf_probe *probe,
                                        const unsigned long buffer_bytes_dim,
+                                       const struct bpf_map_create_opts *opts,
                                        int32_t *inner_ringbuf_map_fd) {
 	const int inner_map_fd =
-	        bpf_map_create(BPF_MAP_TYPE_RINGBUF, NULL, 0, 0, buffer_bytes_dim, NULL);
+	        bpf_map_create(BPF_MAP_TYPE_RINGBUF, NULL, 0, 0, buffer_bytes_dim, opts);
 	if(inner_map_fd < 0) {
 		log_errorf("failed to create the dummy inner map with buffer bytes dim %lu",
 		           buffer_bytes_dim);
 		return errno;
 	}
 
-	/* Set the inner map file descriptor into the outer map. */
-	const int err = bpf_map__set_inner_map_fd(probe->maps.ringbuf_maps, inner_map_fd);
+	/* Set the inner map file descriptor into the outer maps. */
+	const int err = bpf_map__set_inner_map_fd(probe->maps.ringbuf_maps, inner_map_fd) ?:
+	                bpf_map__set_inner_map_fd(probe->maps.consumer_ringbuf_maps, inner_map_fd);
 	if(err) {
 		log_errorf("failed to set the dummy inner map inside the ringbuf array");
 		close(inner_map_fd);
@@ -63,9 +66,32 @@ static int ringbuf_array_set_max_entries(const struct bpf_probe *probe,
 		log_errorf("unable to set max entries to %u for the ringbuf_array", max_entries);
 		return errno;
 	}
+	/* Only shared probes fill the ring buffers of the other consumers. */
+	const uint32_t consumer_max_entries =
+	        g_state.consumers_pin_path != NULL ? max_entries * MAX_CONSUMERS : 1;
+	if(bpf_map__set_max_entries(probe->maps.consumer_ringbuf_maps, consumer_max_entries)) {
+		log_errorf("unable to set max entries to %u for the consumer ringbuf_array",
+		           consumer_max_entries);
+		return errno;
+	}
 	return 0;
 }
 
+/* Secondary consumers of a shared probe put their ring buffers in `consumer_ringbuf_maps`. */
+static int ringbuf_array_get_fd() {
+	if(g_state.secondary_consumer) {
+		return bpf_map__fd(g_state.skel->maps.consumer_ringbuf_maps);
+	}
+	return bpf_map__fd(g_state.skel->maps.ringbuf_maps);
+}
+
+static uint32_t ringbuf_array_key(int cpu) {
+	if(g_state.secondary_consumer) {
+		return cpu * MAX_CONSUMERS + g_state.consumer_slot;
+	}
+	return cpu;
+}
+
 static int allocate_consumer_producer_positions() {
 	g_state.ringbuf_pos = 0;
 	g_state.cons_pos = (unsigned long *)calloc(g_state.n_required_buffers, sizeof(unsigned long));
@@ -77,10 +103,27 @@ static int allocate_consumer_producer_positions() {
 	return 0;
 }
 
+/* Ring buffers allocated on a NUMA node carry `BPF_F_NUMA_NODE`, and inner maps must have the same
+ * flags of the template map.
+ */
+static void ringbuf_create_opts(int ring, struct bpf_map_create_opts *opts) {
+	if(g_state.numa_placement) {
+		opts->map_flags = BPF_F_NUMA_NODE;
+		opts->numa_node = g_state.ringbufs_numa_node[ring];
+	}
+}
+
+static unsigned long ringbuf_bytes_dim(int ring) {
+	return g_state.ringbufs_bytes_dim ? g_state.ringbufs_bytes_dim[ring] : g_state.buffer_bytes_dim;
+}
+
 /* Before loading */
 int pman_prepare_ringbuf_array_before_loading() {
+	LIBBPF_OPTS(bpf_map_create_opts, opts);
+	ringbuf_create_opts(0, &opts);
 	int err = ringbuf_array_set_inner_map(g_state.skel,
 	                                      g_state.buffer_bytes_dim,
+	                                      &opts,
 	                                      &g_state.inner_ringbuf_map_fd);
 	/* We always allocate a number of entries equal to the available CPUs. This doesn't mean that we
 	 * allocate a ring buffer for every available CPU, it means only that every CPU will have an
@@ -98,13 +141,13 @@ int pman_prepare_ringbuf_array_before_loading() {
 int iter_support_probing__prepare_ringbuf_array_before_loading(
         struct iter_support_probing_ctx *ctx) {
 	const unsigned long page_size = sysconf(_SC_PAGESIZE);
-	int err = ringbuf_array_set_inner_map(ctx->probe, page_size, &ctx->inner_ringbuf_map_fd);
+	int err = ringbuf_array_set_inner_map(ctx->probe, page_size, NULL, &ctx->inner_ringbuf_map_fd);
 	err = err ?: ringbuf_array_set_max_entries(ctx->probe, 1);
 	return err;
 }
 #endif  // BPF_ITERATOR_SUPPORT
 
-static bool is_cpu_online(uint16_t cpu_id) {
+bool is_cpu_online(uint16_t cpu_id) {
 	/* CPU 0 is always online */
 	if(cpu_id == 0) {
 		return true;
@@ -135,6 +178,46 @@ static bool is_cpu_online(uint16_t cpu_id) {
 	return online == 1;
 }
 
+/* Kernels older than 5.10 require all the maps inside an array of maps to have the same size as
+ * the template one. Try to store a larger ring buffer in the entry of CPU 0, which is always
+ * assigned, and fall back to the configured dimension if the kernel refuses it.
+ */
+static void ringbuf_array_probe_mixed_sizes(int ringbuf_array_fd) {
+	if(g_state.ringbufs_bytes_dim == NULL) {
+		return;
+	}
+
+	unsigned long max_bytes_dim = g_state.buffer_bytes_dim;
+	for(int i = 0; i < g_state.n_required_buffers; i++) {
+		if(g_state.ringbufs_bytes_dim[i] > max_bytes_dim) {
+			max_bytes_dim = g_state.ringbufs_bytes_dim[i];
+		}
+	}
+	if(max_bytes_dim == g_state.buffer_bytes_dim) {
+		return;
+	}
+
+	LIBBPF_OPTS(bpf_map_create_opts, opts);
+	ringbuf_create_opts(0, &opts);
+	int probe_fd = bpf_map_create(BPF_MAP_TYPE_RINGBUF, NULL, 0, 0, max_bytes_dim, &opts);
+	uint32_t key = ringbuf_array_key(0);
+	if(probe_fd >= 0 && bpf_map_update_elem(ringbuf_array_fd, &key, &probe_fd, BPF_ANY) == 0) {
+		close(probe_fd);
+		return;
+	}
+	if(probe_fd >= 0) {
+		close(probe_fd);
+	}
+
+	log_msgf(FALCOSECURITY_LOG_SEV_WARNING,
+	         "ring buffers of different sizes are not supported by the running kernel, every "
+	         "ring buffer will be %lu bytes",
+	         g_state.buffer_bytes_dim);
+	for(int i = 0; i < g_state.n_required_buffers; i++) {
+		g_state.ringbufs_bytes_dim[i] = g_state.buffer_bytes_dim;
+	}
+}
+
 /* After loading */
 int pman_finalize_ringbuf_array_after_loading() {
 	int last_errno = EINVAL;
@@ -156,10 +239,22 @@ int pman_finalize_ringbuf_array_after_loading() {
 	close(g_state.inner_ringbuf_map_fd);
 	g_state.inner_ringbuf_map_fd = -1;
 
+	/* `ringbuf_array` is a maps array, every map inside it is a `BPF_MAP_TYPE_RINGBUF`. */
+	ringbuf_array_fd = ringbuf_array_get_fd();
+	if(ringbuf_array_fd < 0) {
+		last_errno = errno;
+		log_errorf("failed to get the ringbuf_array");
+		goto clean_percpu_ring_buffers;
+	}
+
+	ringbuf_array_probe_mixed_sizes(ringbuf_array_fd);
+
 	/* Create ring buffer maps. */
 	for(int i = 0; i < g_state.n_required_buffers; i++) {
+		LIBBPF_OPTS(bpf_map_create_opts, opts);
+		ringbuf_create_opts(i, &opts);
 		ringbufs_fds[i] =
-		        bpf_map_create(BPF_MAP_TYPE_RINGBUF, NULL, 0, 0, g_state.buffer_bytes_dim, NULL);
+		        bpf_map_create(BPF_MAP_TYPE_RINGBUF, NULL, 0, 0, ringbuf_bytes_dim(i), &opts);
 		if(ringbufs_fds[i] < 0) {
 			last_errno = errno;
 			log_errorf(
@@ -190,11 +285,23 @@ int pman_finalize_ringbuf_array_after_loading() {
 		}
 	}
 
-	/* `ringbuf_array` is a maps array, every map inside it is a `BPF_MAP_TYPE_RINGBUF`. */
-	ringbuf_array_fd = bpf_map__fd(g_state.skel->maps.ringbuf_maps);
-	if(ringbuf_array_fd < 0) {
-		last_errno = errno;
-		log_errorf("failed to get the ringbuf_array");
+	/* With a topology every CPU already knows its ring buffer. */
+	if(g_state.cpu_to_ringbuf != NULL) {
+		for(int i = 0; i < g_state.n_possible_cpus; i++) {
+			int ringbuf_id = g_state.cpu_to_ringbuf[i];
+			if(ringbuf_id == -1) {
+				continue;
+			}
+			uint32_t key = ringbuf_array_key(i);
+			if(bpf_map_update_elem(ringbuf_array_fd, &key, &ringbufs_fds[ringbuf_id], BPF_ANY)) {
+				last_errno = errno;
+				log_errorf("failed to add the ringbuf map for CPU '%d' to ringbuf '%d'",
+				           i,
+				           ringbuf_id);
+				goto clean_percpu_ring_buffers;
+			}
+		}
+		success = true;
 		goto clean_percpu_ring_buffers;
 	}
 
@@ -218,7 +325,8 @@ int pman_finalize_ringbuf_array_after_loading() {
 			goto clean_percpu_ring_buffers;
 		}
 
-		if(bpf_map_update_elem(ringbuf_array_fd, &i, &ringbufs_fds[ringbuf_id], BPF_ANY)) {
+		uint32_t key = ringbuf_array_key(i);
+		if(bpf_map_update_elem(ringbuf_array_fd, &key, &ringbufs_fds[ringbuf_id], BPF_ANY)) {
 			last_errno = errno;
 			log_errorf("failed to add the ringbuf map for CPU '%d' to ringbuf '%d'", i, ringbuf_id);
 			goto clean_percpu_ring_buffers;
@@ -334,3 +442,17 @@ static void ringbuf__consume_first_event(struct ring_buffer *rb,
 void pman_consume_first_event(void **event_ptr, int16_t *buffer_id) {
 	ringbuf__consume_first_event(g_state.rb_manager, (struct ppm_evt_hdr **)event_ptr, buffer_id);
 }
+
+/* `libbpf` already registered all the ring buffers in the `epoll` instance of the manager. */
+int pman_wait_for_events(int timeout_ms) {
+	struct ring_buffer *rb = g_state.rb_manager;
+	int n_ready = epoll_wait(rb->epoll_fd, rb->events, rb->ring_cnt, timeout_ms);
+	if(n_ready < 0) {
+		return errno == EINTR ? 0 : -errno;
+	}
+	return n_ready;
+}
+
+int pman_get_wait_fd() {
+	return g_state.rb_manager != NULL ? g_state.rb_manager->epoll_fd : -1;
+}
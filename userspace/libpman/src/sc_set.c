@@ -20,6 +20,7 @@ limitations under the License.
 #include "programs.h"
 #include <libpman.h>
 #include <libscap/scap.h>
+#include <string.h>
 
 /* If the provided error is ENOENT, logs a message and returns 0. Otherwise, simply returns the
  * provided error. */
@@ -35,21 +36,8 @@ static int ignore_and_log_enoent(const char* sc_name, const int err) {
 	return 0;
 }
 
-/* This function should be idempotent, every time it is called it should enforce again the state */
-int pman_enforce_sc_set(bool* sc_set) {
-	/* If we fail at initialization time the BPF skeleton
-	 * is not initialized when we stop the capture for example
-	 */
-	if(!g_state.skel) {
-		return SCAP_FAILURE;
-	}
-
-	/* When we want to disable the capture we receive a NULL pointer here */
-	bool empty_sc_set[PPM_SC_MAX] = {0};
-	if(!sc_set) {
-		sc_set = empty_sc_set;
-	}
-
+/* Attach the programs needed by `sc_set` and detach the other ones. */
+static int enforce_programs(const bool* sc_set) {
 	/* Special tracepoints, their attachment depends on interesting syscalls */
 	bool sys_exit = false;
 	bool sched_prog_fork = false;
@@ -72,11 +60,11 @@ int pman_enforce_sc_set(bool* sc_set) {
 			continue;
 		}
 
-		if(!sc_set[sc]) {
-			ret = ret ?: pman_mark_single_64bit_syscall(syscall_id, false);
-		} else {
+		if(sc_set[sc]) {
 			sys_exit = true;
-			ret = ret ?: pman_mark_single_64bit_syscall(syscall_id, true);
+		}
+		if(g_state.consumer_slot == -1) {
+			ret = ret ?: pman_mark_single_64bit_syscall(syscall_id, sc_set[sc]);
 		}
 	}
 
@@ -191,3 +179,48 @@ int pman_enforce_sc_set(bool* sc_set) {
 
 	return ret;
 }
+
+/* This function should be idempotent, every time it is called it should enforce again the state */
+int pman_enforce_sc_set(bool* sc_set) {
+	/* If we fail at initialization time the BPF skeleton
+	 * is not initialized when we stop the capture for example
+	 */
+	if(!g_state.skel) {
+		return SCAP_FAILURE;
+	}
+
+	/* When we want to disable the capture we receive a NULL pointer here */
+	bool empty_sc_set[PPM_SC_MAX] = {0};
+	if(!sc_set) {
+		sc_set = empty_sc_set;
+	}
+
+	/* Shared probes capture the union of the syscalls of all the consumers, and the consumer that
+	 * loaded the probe attaches the programs for the union too: they stay attached while any
+	 * consumer needs them.
+	 */
+	if(g_state.consumer_slot != -1) {
+		int err = update_consumer_sc_set(sc_set);
+		if(err != 0 || g_state.secondary_consumer) {
+			return err;
+		}
+		get_consumers_sc_set(g_state.consumers_sc_set);
+		return enforce_programs(g_state.consumers_sc_set);
+	}
+
+	return enforce_programs(sc_set);
+}
+
+int pman_sync_consumers_programs() {
+	if(!g_state.skel || g_state.consumer_slot == -1 || g_state.secondary_consumer) {
+		return 0;
+	}
+
+	bool sc_set[PPM_SC_MAX];
+	get_consumers_sc_set(sc_set);
+	if(memcmp(sc_set, g_state.consumers_sc_set, sizeof(sc_set)) == 0) {
+		return 0;
+	}
+	memcpy(g_state.consumers_sc_set, sc_set, sizeof(sc_set));
+	return enforce_programs(g_state.consumers_sc_set);
+}
@@ -32,7 +32,7 @@ limitations under the License.
 
 /* Pay attention this need to be bumped every time we add a new bpf program that is directly
  * attached into the kernel */
-#define MODERN_BPF_PROG_ATTACHED_MAX 25
+#define MODERN_BPF_PROG_ATTACHED_MAX 27
 
 #define BPF_LOG_BIG_BUF_SIZE \
 	(UINT32_MAX >> 8) /* Recommended log buffer size, taken from libbpf. Used for verifier logs */
@@ -71,10 +71,24 @@ struct internal_state {
 	int32_t inner_ringbuf_map_fd;   /* inner map used to configure the ringbuf array before loading
 	                                   phase. */
 	unsigned long buffer_bytes_dim; /* dimension of a single per-CPU ringbuffer in bytes. */
+	int16_t* cpu_to_ringbuf; /* ring buffer of every possible CPU, `-1` if the CPU has none. `NULL`
+	                            when CPUs are simply assigned `cpus_for_each_buffer` at a time. */
+	unsigned long* ringbufs_bytes_dim; /* dimension of every ring buffer, `NULL` if they are all
+	                                      `buffer_bytes_dim` bytes. */
+	int* ringbufs_numa_node;           /* NUMA node of every ring buffer, `-1` if unknown. */
+	bool numa_placement; /* ring buffers are allocated on the NUMA node of their CPUs. */
 	int last_ring_read; /* Last ring from which we have correctly read an event. Could be `-1` if
 	               there were no successful reads. */
 	unsigned long last_event_size; /* Last event correctly read. Could be `0` if there were no
 	                                  successful reads. */
+	char* consumers_pin_path; /* bpffs directory of the maps shared with the other consumers,
+	                             `NULL` if the probe is not shared. */
+	int32_t consumer_slot;    /* our slot in the `consumers` map, `-1` if not claimed. */
+	int consumers_lock_fd;    /* `consumers_pin_path` locked until the consumer slot is claimed,
+	                             `-1` if not locked. */
+	bool secondary_consumer;  /* the probe is loaded and attached by another consumer. */
+	bool consumers_sc_set[PPM_SC_MAX]; /* union of the ppm_sc of the consumers, the programs of a
+	                                      shared probe are attached for it. */
 
 	/* Stats v2 utilities */
 	int32_t attached_progs_fds[MODERN_BPF_PROG_ATTACHED_MAX]; /* file descriptors of attached
@@ -113,3 +127,11 @@ extern struct internal_state g_state;
 extern void log_errorf(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
 extern void log_msgf(enum falcosecurity_log_severity level, const char* fmt, ...)
         __attribute__((format(printf, 2, 3)));
+extern bool is_cpu_online(uint16_t cpu_id);
+extern void free_ringbuf_topology(void);
+extern int refresh_consumers_settings(void);
+extern int claim_consumer_slot(void);
+extern void release_consumer_slot(void);
+extern int update_consumer_sc_set(const bool* sc_set);
+extern void get_consumers_sc_set(bool* sc_set);
+extern int update_consumer_snaplen(uint32_t snaplen);
@@ -20,6 +20,8 @@ limitations under the License.
 #include <libscap/scap_assert.h>
 #include <libscap/scap.h>
 #include <libscap/strl.h>
+#include <libpman.h>
+#include <inttypes.h>
 
 typedef enum modern_bpf_kernel_counters_stats {
 	MODERN_BPF_N_EVTS = 0,
@@ -448,6 +450,109 @@ static int collect_kernel_iter_counter_stats(const int counters_map_fd, const in
 
 #endif /* BPF_ITERATOR_SUPPORT */
 
+typedef struct syscall_latency_ctx {
+	uint32_t offset;
+	bool failed;
+} syscall_latency_ctx;
+
+// The number of histograms is not known in advance, the array grows as they are collected.
+static bool reserve_metrics_v2(uint32_t n_stats) {
+	if(n_stats <= g_state.nstats) {
+		return true;
+	}
+	uint32_t new_nstats = g_state.nstats * 2;
+	if(new_nstats < n_stats) {
+		new_nstats = n_stats;
+	}
+	struct metrics_v2 *stats =
+	        (metrics_v2 *)realloc(g_state.stats, new_nstats * sizeof(metrics_v2));
+	if(!stats) {
+		log_errorf("unable to allocate memory for 'metrics_v2' array");
+		return false;
+	}
+	memset(&stats[g_state.nstats], 0, (new_nstats - g_state.nstats) * sizeof(metrics_v2));
+	g_state.stats = stats;
+	g_state.nstats = new_nstats;
+	return true;
+}
+
+static void set_syscall_latency_metric(uint32_t pos,
+                                       const char *prefix,
+                                       const char *suffix,
+                                       uint64_t val,
+                                       metrics_v2_value_unit unit) {
+	set_u64_monotonic_kernel_counter(pos, val, METRICS_V2_KERNEL_SYSCALL_LATENCY);
+	g_state.stats[pos].unit = unit;
+	snprintf(g_state.stats[pos].name, METRIC_NAME_MAX, "%s%s", prefix, suffix);
+}
+
+// Every histogram becomes its count, its sum and one metric for each non-empty bucket.
+static void collect_syscall_latency_hist(uint64_t cgroup_id,
+                                         uint32_t syscall_id,
+                                         const uint64_t *buckets,
+                                         uint64_t sum_ns,
+                                         void *ctx) {
+	syscall_latency_ctx *latency_ctx = (syscall_latency_ctx *)ctx;
+	if(latency_ctx->failed) {
+		return;
+	}
+
+	uint64_t count = 0;
+	uint32_t n_buckets = 0;
+	for(int bucket = 0; bucket < SYSCALL_LATENCY_BUCKETS; bucket++) {
+		count += buckets[bucket];
+		n_buckets += buckets[bucket] != 0;
+	}
+	if(!reserve_metrics_v2(latency_ctx->offset + 2 + n_buckets)) {
+		latency_ctx->failed = true;
+		return;
+	}
+
+	char prefix[METRIC_NAME_MAX];
+	const ppm_sc_code sc = scap_native_id_to_ppm_sc((int)syscall_id);
+	if(sc != PPM_SC_UNKNOWN) {
+		snprintf(prefix,
+		         sizeof(prefix),
+		         SYSCALL_LATENCY_PREFIX "%s.%" PRIu64 ".",
+		         scap_get_ppm_sc_name(sc),
+		         cgroup_id);
+	} else {
+		snprintf(prefix,
+		         sizeof(prefix),
+		         SYSCALL_LATENCY_PREFIX "%u.%" PRIu64 ".",
+		         syscall_id,
+		         cgroup_id);
+	}
+
+	uint32_t pos = latency_ctx->offset;
+	set_syscall_latency_metric(pos++, prefix, "count", count, METRIC_VALUE_UNIT_COUNT);
+	set_syscall_latency_metric(pos++, prefix, "sum_ns", sum_ns, METRIC_VALUE_UNIT_TIME_NS_COUNT);
+	char suffix[32];
+	for(int bucket = 0; bucket < SYSCALL_LATENCY_BUCKETS; bucket++) {
+		if(buckets[bucket] == 0) {
+			continue;
+		}
+		if(bucket == SYSCALL_LATENCY_BUCKETS - 1) {
+			strlcpy(suffix, "lt_inf", sizeof(suffix));
+		} else {
+			snprintf(suffix, sizeof(suffix), "lt_%" PRIu64 "ns", (uint64_t)1 << (bucket + 1));
+		}
+		set_syscall_latency_metric(pos++, prefix, suffix, buckets[bucket], METRIC_VALUE_UNIT_COUNT);
+	}
+	latency_ctx->offset = pos;
+}
+
+// Collects stats for `METRICS_V2_KERNEL_SYSCALL_LATENCY`. `base_offset` is the first free position
+// in the global v2 metrics array to push the histograms to. Returns the number of collected stats
+// on success, -1 otherwise.
+static int collect_syscall_latency_stats(const int base_offset) {
+	syscall_latency_ctx ctx = {.offset = base_offset, .failed = false};
+	if(pman_get_syscall_latency(collect_syscall_latency_hist, &ctx) != 0 || ctx.failed) {
+		return -1;
+	}
+	return ctx.offset - base_offset;
+}
+
 struct metrics_v2 *pman_get_metrics_v2(uint32_t flags, uint32_t *nstats, int32_t *rc) {
 	*rc = SCAP_FAILURE;
 	*nstats = 0;
@@ -509,6 +614,15 @@ struct metrics_v2 *pman_get_metrics_v2(uint32_t flags, uint32_t *nstats, int32_t
 	}
 #endif /* BPF_ITERATOR_SUPPORT */
 
+	/* SYSCALL LATENCY HISTOGRAMS */
+	if(flags & METRICS_V2_KERNEL_SYSCALL_LATENCY && !g_state.secondary_consumer) {
+		const int collected_stats = collect_syscall_latency_stats(offset);
+		if(collected_stats < 0) {
+			return NULL;
+		}
+		offset += collected_stats;
+	}
+
 	/* Update with the real number of stats collected */
 	*nstats = offset;
 	*rc = SCAP_SUCCESS;
@@ -52,7 +52,7 @@ static void destroy_iter_ctx(struct iter_support_probing_ctx *ctx) {
 	}
 }
 
-static void disable_all_progs(struct bpf_probe *probe) {
+void iter_support_probing__disable_all_progs(struct bpf_probe *probe) {
 	// Disable ALL programs.
 	struct bpf_program *cur_prog;
 	bpf_object__for_each_program(cur_prog, probe->obj) {
@@ -89,7 +89,7 @@ int iter_support_probing__probe(const char *prog_name) {
 	}
 
 	// Disable all programs except the one we are probing support for.
-	disable_all_progs(ctx.probe);
+	iter_support_probing__disable_all_progs(ctx.probe);
 	bpf_program__set_autoload(prog_to_test, true);
 
 	// Initialize every required piece before trying to load the probe.
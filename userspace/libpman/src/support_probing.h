@@ -40,7 +40,11 @@ void iter_support_probing__probe_bpf_iter_link_info_support(
 bool iter_support_probing__is_in_root_pid_namespace(void);
 
 // The following declarations are here just to avoid creating a separate header file. They are
-// called by `iter_support_probing__probe()`. Don't use them directly.
+// called by `iter_support_probing__probe()` and `pman_load_iterators()`. Don't use them directly.
+
+// Disable the autoloading of all programs, except the ones that cannot be disabled without making
+// the loading fail.
+void iter_support_probing__disable_all_progs(struct bpf_probe *probe);
 
 // Context created while probing for support of a single BPF iterator program.
 struct iter_support_probing_ctx {
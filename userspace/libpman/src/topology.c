@@ -0,0 +1,286 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2026 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* sched_setaffinity */
+#endif
+
+#include <dirent.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <libpman.h>
+#include "state.h"
+
+/* Upper bound of the ring buffer enlargement driven by the drops of a previous capture. */
+#define PMAN_MAX_RINGBUF_SCALE 4
+
+#define CPU_SYSFS_PATH "/sys/devices/system/cpu"
+#define NODE_SYSFS_PATH "/sys/devices/system/node"
+
+void free_ringbuf_topology() {
+	free(g_state.cpu_to_ringbuf);
+	g_state.cpu_to_ringbuf = NULL;
+	free(g_state.ringbufs_bytes_dim);
+	g_state.ringbufs_bytes_dim = NULL;
+	free(g_state.ringbufs_numa_node);
+	g_state.ringbufs_numa_node = NULL;
+	g_state.numa_placement = false;
+}
+
+/* Call `cb` for every CPU of a sysfs cpulist like "0-3,8,10-11". */
+static bool for_each_cpu_in_list(const char *path, void (*cb)(int cpu, void *ctx), void *ctx) {
+	FILE *f = fopen(path, "r");
+	if(f == NULL) {
+		return false;
+	}
+
+	int first;
+	int last;
+	char sep;
+	bool found = false;
+	while(fscanf(f, "%d", &first) == 1) {
+		last = first;
+		if(fscanf(f, "%c", &sep) == 1 && sep == '-') {
+			if(fscanf(f, "%d", &last) != 1) {
+				break;
+			}
+			if(fscanf(f, "%c", &sep) != 1) {
+				sep = '\n';
+			}
+		}
+		for(int cpu = first; cpu <= last; cpu++) {
+			cb(cpu, ctx);
+		}
+		found = true;
+		if(sep != ',') {
+			break;
+		}
+	}
+	fclose(f);
+	return found;
+}
+
+static int cpu_numa_node(int cpu) {
+	char path[FILENAME_MAX];
+	snprintf(path, sizeof(path), CPU_SYSFS_PATH "/cpu%d", cpu);
+	DIR *dir = opendir(path);
+	if(dir == NULL) {
+		return -1;
+	}
+
+	int node = -1;
+	struct dirent *entry;
+	while((entry = readdir(dir)) != NULL) {
+		if(sscanf(entry->d_name, "node%d", &node) == 1) {
+			break;
+		}
+	}
+	closedir(dir);
+	return node;
+}
+
+static void keep_min_cpu(int cpu, void *ctx) {
+	int *min = (int *)ctx;
+	if(*min == -1 || cpu < *min) {
+		*min = cpu;
+	}
+}
+
+/* Last level caches are identified by the lowest CPU sharing them. */
+static int cpu_llc_domain(int cpu) {
+	char path[FILENAME_MAX];
+	int max_level = 0;
+	int llc_index = -1;
+	for(int index = 0;; index++) {
+		snprintf(path, sizeof(path), CPU_SYSFS_PATH "/cpu%d/cache/index%d/level", cpu, index);
+		FILE *f = fopen(path, "r");
+		if(f == NULL) {
+			break;
+		}
+		int level = 0;
+		if(fscanf(f, "%d", &level) == 1 && level > max_level) {
+			max_level = level;
+			llc_index = index;
+		}
+		fclose(f);
+	}
+	if(llc_index == -1) {
+		return -1;
+	}
+
+	int domain = -1;
+	snprintf(path,
+	         sizeof(path),
+	         CPU_SYSFS_PATH "/cpu%d/cache/index%d/shared_cpu_list",
+	         cpu,
+	         llc_index);
+	for_each_cpu_in_list(path, keep_min_cpu, &domain);
+	return domain;
+}
+
+/* Enlarge the ring buffers of the CPUs that dropped more than the average. */
+static void size_ringbufs(const uint64_t *cpu_drops, uint16_t n_cpu_drops) {
+	uint64_t total_drops = 0;
+	int n_cpus = 0;
+	for(int cpu = 0; cpu < g_state.n_possible_cpus; cpu++) {
+		if(g_state.cpu_to_ringbuf[cpu] == -1) {
+			continue;
+		}
+		n_cpus++;
+		if(cpu < n_cpu_drops) {
+			total_drops += cpu_drops[cpu];
+		}
+	}
+	if(total_drops == 0) {
+		return;
+	}
+
+	for(uint32_t ring = 0; ring < g_state.n_required_buffers; ring++) {
+		uint64_t ring_drops = 0;
+		int ring_cpus = 0;
+		for(int cpu = 0; cpu < g_state.n_possible_cpus; cpu++) {
+			if(g_state.cpu_to_ringbuf[cpu] != (int16_t)ring) {
+				continue;
+			}
+			ring_cpus++;
+			if(cpu < n_cpu_drops) {
+				ring_drops += cpu_drops[cpu];
+			}
+		}
+
+		/* Share of the drops compared to the share of the CPUs. */
+		double share = ((double)ring_drops * n_cpus) / ((double)total_drops * ring_cpus);
+		unsigned long scale = 1;
+		while(scale < PMAN_MAX_RINGBUF_SCALE && scale < share) {
+			scale *= 2;
+		}
+		g_state.ringbufs_bytes_dim[ring] = g_state.buffer_bytes_dim * scale;
+	}
+}
+
+int pman_set_ringbuf_topology(enum pman_ringbuf_topology topology,
+                              const uint64_t *cpu_drops,
+                              uint16_t n_cpu_drops) {
+	free_ringbuf_topology();
+	if(topology == PMAN_RINGBUF_TOPOLOGY_FLAT && cpu_drops == NULL) {
+		return 0;
+	}
+
+	const int n_cpus = g_state.n_possible_cpus;
+	int *domains = (int *)malloc(n_cpus * sizeof(int));
+	g_state.cpu_to_ringbuf = (int16_t *)malloc(n_cpus * sizeof(int16_t));
+	/* There can't be more ring buffers than CPUs. */
+	g_state.ringbufs_bytes_dim = (unsigned long *)malloc(n_cpus * sizeof(unsigned long));
+	g_state.ringbufs_numa_node = (int *)malloc(n_cpus * sizeof(int));
+	if(domains == NULL || g_state.cpu_to_ringbuf == NULL || g_state.ringbufs_bytes_dim == NULL ||
+	   g_state.ringbufs_numa_node == NULL) {
+		free(domains);
+		free_ringbuf_topology();
+		log_errorf("failed to allocate the ring buffer topology");
+		return ENOMEM;
+	}
+
+	for(int cpu = 0; cpu < n_cpus; cpu++) {
+		g_state.cpu_to_ringbuf[cpu] = -1;
+		if(g_state.allocate_online_only && !is_cpu_online(cpu)) {
+			domains[cpu] = -1;
+			continue;
+		}
+		int domain = 0;
+		if(topology == PMAN_RINGBUF_TOPOLOGY_NUMA) {
+			domain = cpu_numa_node(cpu);
+		} else if(topology == PMAN_RINGBUF_TOPOLOGY_LLC) {
+			domain = cpu_llc_domain(cpu);
+		}
+		/* CPUs of unknown placement are grouped together. */
+		domains[cpu] = domain < 0 ? 0 : domain;
+	}
+
+	/* Every ring buffer takes up to `cpus_for_each_buffer` CPUs of the same domain. */
+	uint32_t n_rings = 0;
+	g_state.numa_placement = topology == PMAN_RINGBUF_TOPOLOGY_NUMA;
+	for(int cpu = 0; cpu < n_cpus; cpu++) {
+		if(domains[cpu] == -1 || g_state.cpu_to_ringbuf[cpu] != -1) {
+			continue;
+		}
+		uint16_t assigned = 0;
+		for(int other = cpu; other < n_cpus && assigned < g_state.cpus_for_each_buffer; other++) {
+			if(domains[other] == domains[cpu] && g_state.cpu_to_ringbuf[other] == -1) {
+				g_state.cpu_to_ringbuf[other] = (int16_t)n_rings;
+				assigned++;
+			}
+		}
+		g_state.ringbufs_bytes_dim[n_rings] = g_state.buffer_bytes_dim;
+		g_state.ringbufs_numa_node[n_rings] = cpu_numa_node(cpu);
+		if(g_state.ringbufs_numa_node[n_rings] < 0) {
+			g_state.numa_placement = false;
+		}
+		n_rings++;
+	}
+	free(domains);
+	g_state.n_required_buffers = n_rings;
+
+	if(cpu_drops != NULL) {
+		size_ringbufs(cpu_drops, n_cpu_drops);
+	}
+
+	for(uint32_t ring = 0; ring < n_rings; ring++) {
+		log_msgf(FALCOSECURITY_LOG_SEV_DEBUG,
+		         "ring buffer %u: %lu bytes, NUMA node %d",
+		         ring,
+		         g_state.ringbufs_bytes_dim[ring],
+		         g_state.ringbufs_numa_node[ring]);
+	}
+	return 0;
+}
+
+int pman_get_ringbuf_numa_node(int16_t ring_id) {
+	if(g_state.ringbufs_numa_node == NULL || ring_id < 0 ||
+	   (uint32_t)ring_id >= g_state.n_required_buffers) {
+		return -1;
+	}
+	return g_state.ringbufs_numa_node[ring_id];
+}
+
+static void add_cpu_to_set(int cpu, void *ctx) {
+	if(cpu < CPU_SETSIZE) {
+		CPU_SET(cpu, (cpu_set_t *)ctx);
+	}
+}
+
+int pman_pin_thread_to_numa_node(int numa_node) {
+	char path[FILENAME_MAX];
+	snprintf(path, sizeof(path), NODE_SYSFS_PATH "/node%d/cpulist", numa_node);
+
+	cpu_set_t cpus;
+	CPU_ZERO(&cpus);
+	if(!for_each_cpu_in_list(path, add_cpu_to_set, &cpus)) {
+		log_errorf("unable to read the CPUs of NUMA node %d", numa_node);
+		return ENOENT;
+	}
+
+	if(sched_setaffinity(0, sizeof(cpus), &cpus) != 0) {
+		const int last_errno = errno;
+		log_errorf("unable to pin the thread to NUMA node %d", numa_node);
+		return last_errno;
+	}
+	return 0;
+}
@@ -18,6 +18,9 @@ limitations under the License.
 #ifndef __CLOCK_HELPERS_H
 #define __CLOCK_HELPERS_H
 
+#include <stdint.h>
+#include <time.h>
+
 #define SCAP_GET_CUR_TS_MS_CONTEXT_INIT ((uint64_t)0)
 #define SCAP_GET_CUR_TS_MS_CONTEXT_ERROR_FLAG ((uint64_t)0x8000000000000000)
 #define SCAP_GET_CUR_TS_MS_CONTEXT_PREV_VALUE_MASK ((uint64_t)0x7fffffffffffffff)
@@ -29,6 +32,18 @@ limitations under the License.
 #define __always_inline inline
 #endif
 
+/**
+ * Return the current CLOCK_MONOTONIC time in ns, or 0 if it can't be read.
+ * Meant for measuring durations, without the checks done by scap_get_monotonic_ts_ms().
+ */
+static __always_inline uint64_t scap_get_monotonic_ts_ns(void) {
+	struct timespec ts;
+	if(clock_gettime(CLOCK_MONOTONIC, &ts)) {
+		return 0;
+	}
+	return ((uint64_t)ts.tv_sec) * (uint64_t)1000000000 + (uint64_t)ts.tv_nsec;
+}
+
 /**
  * Return monotonically increasing time in ms.
  * Caller initializes context to SCAP_GET_CUR_TS_MS_CONTEXT_INIT,
@@ -16,6 +16,8 @@ limitations under the License.
 
 #include <stdint.h>
 
+#include <libscap/scap_log.h>
+
 #define MODERN_BPF_ENGINE "modern_bpf"
 #define DEFAULT_CPU_FOR_EACH_BUFFER 1
 
@@ -23,6 +25,13 @@ limitations under the License.
 extern "C" {
 #endif
 
+enum scap_modern_bpf_ringbuf_topology {
+	SCAP_MODERN_BPF_RINGBUF_TOPOLOGY_FLAT = 0,  ///< `cpus_for_each_buffer` consecutive CPUs.
+	SCAP_MODERN_BPF_RINGBUF_TOPOLOGY_NUMA = 1,  ///< CPUs of the same NUMA node, with the ring
+	                                            ///< buffer allocated on that node.
+	SCAP_MODERN_BPF_RINGBUF_TOPOLOGY_LLC = 2,   ///< CPUs sharing the last level cache.
+};
+
 struct scap_modern_bpf_engine_params {
 	uint16_t cpus_for_each_buffer;  ///< [EXPERIMENTAL] We will allocate a ring buffer every
 	                                ///< `cpus_for_each_buffer` CPUs. `0` is a special value and
@@ -40,10 +49,51 @@ struct scap_modern_bpf_engine_params {
 	bool disable_iterators;    ///< If true, disable the BPF iterator support for synchronous
 	                           ///< information fetching, letting scap falling back to the procfs
 	                           ///< lookups.
+	enum scap_modern_bpf_ringbuf_topology
+	        ringbuf_topology;  ///< [EXPERIMENTAL] How CPUs are grouped, at most
+	                           ///< `cpus_for_each_buffer` at a time, to share a ring buffer.
+	const uint64_t* cpu_drops_hint;  ///< [EXPERIMENTAL] Per-CPU drops of a previous capture,
+	                                 ///< indexed by CPU id. Ring buffers of the CPUs that dropped
+	                                 ///< more than the average are enlarged, up to 4 times
+	                                 ///< `buffer_bytes_dim`. Can be `NULL`.
+	uint16_t cpu_drops_hint_len;     ///< Number of entries of `cpu_drops_hint`.
+	bool pin_consumer;       ///< [EXPERIMENTAL] Pin the thread opening the engine, which is the
+	                         ///< one consuming the ring buffers, to the CPUs of
+	                         ///< `consumer_numa_node`.
+	int consumer_numa_node;  ///< NUMA node of the consumer when `pin_consumer` is set.
+	uint64_t wakeup_watermark;  ///< [EXPERIMENTAL] When a ring buffer reaches this many bytes
+	                            ///< the probe wakes up the consumer, which blocks in `epoll`
+	                            ///< instead of sleeping with a backoff when all the ring
+	                            ///< buffers are empty. `0` keeps the backoff. It must be lower
+	                            ///< than `buffer_bytes_dim`.
+	const char* shared_probe_path;  ///< [EXPERIMENTAL] bpffs directory used to share the probe
+	                                ///< between processes. The first one loads the probe, the
+	                                ///< following ones only add their ring buffers and receive the
+	                                ///< events of their own syscalls. They can only change the
+	                                ///< interesting syscalls and the snaplen. `NULL` doesn't share
+	                                ///< the probe.
 };
 
 extern const struct scap_linux_vtable scap_modern_bpf_linux_vtable;
 
+/**
+ * @brief Load only the BPF iterators of the modern probe, without capturing events, so that
+ * another engine can use them to fetch the initial state instead of scanning /proc.
+ * The modern_bpf engine cannot be opened until they are unloaded.
+ * @param log_fn logging callback
+ * @param base the hooks of the engine, whose fetch ones are replaced. Can be NULL.
+ * @param error a SCAP_LASTERR_SIZE buffer for error messages
+ * @return the vtable to use for the Linux platform, or NULL if the iterators are not supported
+ */
+const struct scap_linux_vtable* scap_modern_bpf_load_iterators(falcosecurity_log_fn log_fn,
+                                                               const struct scap_linux_vtable* base,
+                                                               char* error);
+
+/**
+ * @brief Unload the BPF iterators loaded by scap_modern_bpf_load_iterators().
+ */
+void scap_modern_bpf_unload_iterators(void);
+
 #ifdef __cplusplus
 };
 #endif
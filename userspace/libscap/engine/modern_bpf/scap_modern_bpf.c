@@ -16,12 +16,17 @@ limitations under the License.
 */
 
 #include <errno.h>
+#include <inttypes.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 #include <sys/socket.h>
 
 #define HANDLE(engine) ((struct modern_bpf_engine*)(engine.m_handle))
 
+/* Events read between two `pman_sync_consumers_programs()` while the ring buffers are not empty. */
+#define CONSUMERS_SYNC_EVENTS (64 * 1024)
+
 #include <libscap/engine/modern_bpf/scap_modern_bpf.h>
 #include <libpman.h>
 #include <libscap/scap.h>
@@ -32,6 +37,8 @@ limitations under the License.
 #include <sys/utsname.h>
 #include <libscap/ringbuffer/ringbuffer.h>
 #include <libscap/scap_engine_util.h>
+#include <libscap/clock_helpers.h>
+#include <libscap/scap_gettimeofday.h>
 #include <libscap/strerror.h>
 #include <driver/syscall_compat.h>
 
@@ -44,9 +51,27 @@ static void* scap_modern_bpf__alloc_engine(scap_t* main_handle, char* lasterr_pt
 }
 
 static void scap_modern_bpf__free_engine(struct scap_engine_handle engine) {
+	if(engine.m_handle) {
+		free(HANDLE(engine)->m_final_evts);
+	}
 	free(engine.m_handle);
 }
 
+static void reset_final_events(struct modern_bpf_engine* handle) {
+	handle->m_final_evts_len = 0;
+	handle->m_final_evts_offset = 0;
+}
+
+/* Return the next event synthesized by `scap_modern_bpf__stop_capture`, if any. */
+static scap_evt* next_final_event(struct modern_bpf_engine* handle) {
+	if(handle->m_final_evts_offset >= handle->m_final_evts_len) {
+		return NULL;
+	}
+	scap_evt* evt = (scap_evt*)(handle->m_final_evts + handle->m_final_evts_offset);
+	handle->m_final_evts_offset += evt->len;
+	return evt;
+}
+
 /* The third parameter is not the CPU number from which we extract the event but the ring buffer
  * number. For the old BPF probe and the kernel module the number of CPUs is equal to the number of
  * buffers since we always use a per-CPU approach.
@@ -57,7 +82,34 @@ static int32_t scap_modern_bpf__next(struct scap_engine_handle engine,
                                      uint32_t* pflags) {
 	pman_consume_first_event((void**)pevent, (int16_t*)buffer_id);
 
+	if((*pevent) == NULL && !HANDLE(engine)->capturing) {
+		/* The ring buffers are drained, now return the final summaries. */
+		*pevent = next_final_event(HANDLE(engine));
+		*buffer_id = 0;
+	}
+
+	/* The other consumers of a shared probe may have changed their syscalls meanwhile, the
+	 * programs are synced when the ring buffers are empty or every `CONSUMERS_SYNC_EVENTS` events.
+	 */
+	if((*pevent) == NULL || ++HANDLE(engine)->m_n_evts_since_sync == CONSUMERS_SYNC_EVENTS) {
+		HANDLE(engine)->m_n_evts_since_sync = 0;
+		pman_sync_consumers_programs();
+	}
+
 	if((*pevent) == NULL) {
+		/* The probe wakes us up once a ring buffer crosses the watermark, the timeout bounds the
+		 * latency of the events that don't reach it.
+		 */
+		if(HANDLE(engine)->m_wait_for_wakeup) {
+			int res = pman_wait_for_events(BUFFER_EMPTY_WAIT_TIME_US_MAX / 1000);
+			if(res < 0) {
+				return scap_errprintf(HANDLE(engine)->m_lasterr,
+				                      -res,
+				                      "unable to wait for the ring buffers");
+			}
+			return SCAP_TIMEOUT;
+		}
+
 		/* The first time we sleep 500 us, if we have consecutive timeouts we can reach also 30 ms.
 		 */
 		usleep(HANDLE(engine)->m_retry_us);
@@ -96,10 +148,90 @@ static int32_t scap_modern_bpf_handle_sc(struct scap_engine_handle engine,
 	return SCAP_SUCCESS;
 }
 
+static int32_t scap_modern_bpf_handle_suppress(struct scap_engine_handle engine,
+                                               enum scap_setting setting,
+                                               unsigned long op,
+                                               unsigned long arg) {
+	int err = 0;
+	switch(op) {
+	case SCAP_SUPPRESS_ADD:
+	case SCAP_SUPPRESS_REMOVE: {
+		bool suppress = op == SCAP_SUPPRESS_ADD;
+		if(setting == SCAP_SUPPRESS_TID) {
+			err = pman_suppress_tid((uint32_t)arg, suppress);
+		} else if(setting == SCAP_SUPPRESS_COMM) {
+			err = pman_suppress_comm((const char*)arg, suppress);
+		} else {
+			err = pman_suppress_cgroup((uint64_t)arg, suppress);
+		}
+		break;
+	}
+	case SCAP_SUPPRESS_CLEAR:
+		if(setting == SCAP_SUPPRESS_TID) {
+			err = pman_clear_suppressed_tids();
+		} else if(setting == SCAP_SUPPRESS_COMM) {
+			err = pman_clear_suppressed_comms();
+		} else {
+			err = pman_clear_suppressed_cgroups();
+		}
+		break;
+	default:
+		return scap_errprintf(HANDLE(engine)->m_lasterr, 0, "invalid suppress op %lu", op);
+	}
+
+	if(err != 0) {
+		return scap_errprintf(HANDLE(engine)->m_lasterr, err, "unable to update suppressed set");
+	}
+	return SCAP_SUCCESS;
+}
+
+static int32_t scap_modern_bpf_handle_arg_filter(struct scap_engine_handle engine,
+                                                 const scap_arg_filter_params* params) {
+	int err = 0;
+	switch(params->type) {
+	case SCAP_ARG_FILTER_PATH:
+		err = pman_set_path_filter(params->path, (enum pman_arg_filter_action)params->action);
+		break;
+	case SCAP_ARG_FILTER_PORT:
+		if(params->action == SCAP_ARG_FILTER_DROP) {
+			return scap_errprintf(HANDLE(engine)->m_lasterr,
+			                      0,
+			                      "port filters only support an allow-list");
+		}
+		err = pman_set_port_filter(params->port, params->action == SCAP_ARG_FILTER_KEEP);
+		break;
+	case SCAP_ARG_FILTER_ADDR:
+		err = pman_set_addr_filter(params->addr,
+		                           params->prefixlen,
+		                           (enum pman_arg_filter_action)params->action);
+		break;
+	case SCAP_ARG_FILTER_CLEAR:
+		err = pman_clear_arg_filters();
+		break;
+	default:
+		return scap_errprintf(HANDLE(engine)->m_lasterr,
+		                      0,
+		                      "unknown argument filter type %d",
+		                      params->type);
+	}
+	if(err != 0) {
+		return scap_errprintf(HANDLE(engine)->m_lasterr, err, "unable to update argument filters");
+	}
+	return SCAP_SUCCESS;
+}
+
 static int32_t scap_modern_bpf__configure(struct scap_engine_handle engine,
                                           enum scap_setting setting,
                                           unsigned long arg1,
                                           unsigned long arg2) {
+	/* The other settings are shared with the consumer that loaded the probe. */
+	if(pman_is_secondary_consumer() && setting != SCAP_SNAPLEN && setting != SCAP_PPM_SC_MASK) {
+		return scap_errprintf(HANDLE(engine)->m_lasterr,
+		                      0,
+		                      "setting %d is not supported by a secondary consumer of a shared probe",
+		                      setting);
+	}
+
 	switch(setting) {
 	case SCAP_SAMPLING_RATIO:
 		if(arg2 == 0) {
@@ -124,6 +256,59 @@ static int32_t scap_modern_bpf__configure(struct scap_engine_handle engine,
 	case SCAP_STATSD_PORT:
 		pman_set_statsd_port(arg1);
 		break;
+	case SCAP_SUPPRESS_TID:
+	case SCAP_SUPPRESS_COMM:
+	case SCAP_SUPPRESS_CGROUP:
+		return scap_modern_bpf_handle_suppress(engine, setting, arg1, arg2);
+	case SCAP_CGROUP_PPM_SC_MASK: {
+		int err = pman_set_cgroup_sc_set(arg1, (const bool*)arg2);
+		if(err != 0) {
+			return scap_errprintf(HANDLE(engine)->m_lasterr,
+			                      err,
+			                      "unable to set the syscalls of cgroup %lu",
+			                      arg1);
+		}
+		break;
+	}
+	case SCAP_IO_AGGREGATION: {
+		const scap_io_aggregation_params* params = (const scap_io_aggregation_params*)arg1;
+		int err = params != NULL ? pman_set_io_aggregation(params->max_count,
+		                                                   params->max_bytes,
+		                                                   params->interval_ns)
+		                         : pman_set_io_aggregation(0, 0, 0);
+		if(err != 0) {
+			return scap_errprintf(HANDLE(engine)->m_lasterr,
+			                      err,
+			                      "unable to configure the I/O aggregation");
+		}
+		break;
+	}
+	case SCAP_RATE_LIMIT: {
+		const scap_rate_limit_params* params = (const scap_rate_limit_params*)arg1;
+		int err = pman_set_rate_limit(params->category, params->rate, params->burst);
+		if(err != 0) {
+			return scap_errprintf(HANDLE(engine)->m_lasterr,
+			                      err,
+			                      "unable to configure the rate limit of category %u",
+			                      params->category);
+		}
+		if(params->summary_interval_ns != 0) {
+			pman_set_rate_limit_summary_interval(params->summary_interval_ns);
+		}
+		break;
+	}
+	case SCAP_ARG_FILTER:
+		return scap_modern_bpf_handle_arg_filter(engine, (const scap_arg_filter_params*)arg1);
+	case SCAP_SYSCALL_LATENCY: {
+		int err = pman_enable_syscall_latency(arg1);
+		if(err != 0) {
+			return scap_errprintf(HANDLE(engine)->m_lasterr,
+			                      err,
+			                      "unable to %s the syscall latency histograms",
+			                      arg1 ? "enable" : "disable");
+		}
+		break;
+	}
 	default: {
 		return scap_err_unsupported_setting(HANDLE(engine)->m_lasterr, setting, arg1, arg2);
 	}
@@ -141,18 +326,73 @@ int32_t scap_modern_bpf__start_capture(struct scap_engine_handle engine) {
 	 * "right" place to do it. We need to move it, if `scap_start_capture` will be called frequently
 	 * in our flow, right now in live mode, it should be called only once...
 	 */
-	for(int i = 0; i < SYSCALL_TABLE_SIZE; i++) {
-		pman_mark_single_64bit_syscall(i, false);
+	if(!pman_is_probe_shared()) {
+		for(int i = 0; i < SYSCALL_TABLE_SIZE; i++) {
+			pman_mark_single_64bit_syscall(i, false);
+		}
 	}
 	handle->capturing = true;
+	reset_final_events(handle);
 	return pman_enforce_sc_set(handle->curr_sc_set.ppm_sc);
 }
 
+/* Append a `PPME_RATE_LIMIT_DROPS_E` event for the drops the probe didn't report yet. */
+static void add_rate_limit_drops_event(uint32_t tgid,
+                                       uint8_t category,
+                                       uint64_t dropped,
+                                       void* ctx) {
+	struct modern_bpf_engine* handle = ctx;
+	char error[SCAP_LASTERR_SIZE];
+	size_t evt_size = 0;
+
+	for(int attempt = 0; attempt < 2; attempt++) {
+		struct scap_sized_buffer buf = {
+		        .buf = handle->m_final_evts + handle->m_final_evts_len,
+		        .size = handle->m_final_evts_size - handle->m_final_evts_len,
+		};
+		int32_t res = scap_event_encode_params(buf,
+		                                       &evt_size,
+		                                       error,
+		                                       PPME_RATE_LIMIT_DROPS_E,
+		                                       3,
+		                                       (int64_t)tgid,
+		                                       category,
+		                                       dropped);
+		if(res == SCAP_SUCCESS) {
+			scap_evt* evt = buf.buf;
+			evt->ts = get_timestamp_ns();
+			evt->tid = tgid;
+			handle->m_final_evts_len += evt_size;
+			return;
+		}
+		if(res != SCAP_INPUT_TOO_SMALL) {
+			return;
+		}
+
+		size_t new_size = MAX(2 * handle->m_final_evts_size, handle->m_final_evts_len + evt_size);
+		char* new_evts = realloc(handle->m_final_evts, new_size);
+		if(new_evts == NULL) {
+			return;
+		}
+		handle->m_final_evts = new_evts;
+		handle->m_final_evts_size = new_size;
+	}
+}
+
 int32_t scap_modern_bpf__stop_capture(struct scap_engine_handle engine) {
 	struct modern_bpf_engine* handle = engine.m_handle;
 	handle->capturing = false;
 	/* NULL is equivalent to an empty array */
-	return pman_enforce_sc_set(NULL);
+	int32_t res = pman_enforce_sc_set(NULL);
+
+	/* Drops below the summary interval would otherwise never be reported. The buckets are shared
+	 * with the other consumers of a shared probe, so only the owner of the probe reports them.
+	 */
+	reset_final_events(handle);
+	if(!pman_is_secondary_consumer()) {
+		pman_flush_rate_limit_drops(add_rate_limit_drops_event, handle);
+	}
+	return res;
 }
 
 static int32_t calibrate_socket_file_ops(struct scap_engine_handle engine) {
@@ -251,31 +491,77 @@ int32_t scap_modern_bpf__init(scap_t* handle, scap_open_args* oargs) {
 		return scap_errprintf(handle->m_lasterr, 0, "unable to configure the libpman state.");
 	}
 
+	if(pman_set_ringbuf_topology((enum pman_ringbuf_topology)params->ringbuf_topology,
+	                             params->cpu_drops_hint,
+	                             params->cpu_drops_hint_len)) {
+		return scap_errprintf(handle->m_lasterr, 0, "unable to configure the ring buffer topology.");
+	}
+
+	if(params->pin_consumer && pman_pin_thread_to_numa_node(params->consumer_numa_node)) {
+		return scap_errprintf(handle->m_lasterr,
+		                      0,
+		                      "unable to pin the consumer to NUMA node %d.",
+		                      params->consumer_numa_node);
+	}
+
 	/* Set an initial sleep time in case of timeouts. */
 	HANDLE(engine)->m_retry_us = BUFFER_EMPTY_WAIT_TIME_US_START;
 
 	/* Load and attach */
 	ret = pman_open_probe();
+	if(params->shared_probe_path != NULL) {
+		ret = ret ?: pman_share_probe(params->shared_probe_path);
+	}
 	ret = ret ?: pman_prepare_ringbuf_array_before_loading();
 	ret = ret ?: pman_prepare_maps_before_loading();
 	ret = ret ?: pman_prepare_progs_before_loading();
-	ret = ret ?: pman_load_probe();
+	if(ret == SCAP_SUCCESS) {
+		/* Loading is where the verifier runs, by far the slowest part of the init. */
+		uint64_t load_start_ns = scap_get_monotonic_ts_ns();
+		ret = pman_load_probe();
+		if(oargs->startup_stats) {
+			oargs->startup_stats->bpf_load_ns = scap_get_monotonic_ts_ns() - load_start_ns;
+		}
+	}
 	ret = ret ?: pman_finalize_maps_after_loading();
 	ret = ret ?: pman_finalize_ringbuf_array_after_loading();
 	if(ret != SCAP_SUCCESS) {
 		return ret;
 	}
 
-	/* Set the boot time */
-	uint64_t boot_time = 0;
-	if(scap_get_precise_boot_time(handle->m_lasterr, &boot_time) != SCAP_SUCCESS) {
-		return SCAP_FAILURE;
+	HANDLE(engine)->m_wait_for_wakeup = false;
+	if(pman_is_secondary_consumer()) {
+		/* The boot time, the socket calibration and the watermark are the ones of the consumer
+		 * that loaded the probe.
+		 */
+		if(params->wakeup_watermark != 0) {
+			return scap_errprintf(handle->m_lasterr,
+			                      0,
+			                      "the wakeup watermark is not supported by a secondary consumer "
+			                      "of a shared probe");
+		}
+	} else {
+		/* Set the boot time */
+		uint64_t boot_time = 0;
+		if(scap_get_precise_boot_time(handle->m_lasterr, &boot_time) != SCAP_SUCCESS) {
+			return SCAP_FAILURE;
+		}
+		pman_set_boot_time(boot_time);
+
+		/* Calibrate the socket at init time */
+		if(calibrate_socket_file_ops(engine) != SCAP_SUCCESS) {
+			return SCAP_FAILURE;
+		}
 	}
-	pman_set_boot_time(boot_time);
 
-	/* Calibrate the socket at init time */
-	if(calibrate_socket_file_ops(engine) != SCAP_SUCCESS) {
-		return SCAP_FAILURE;
+	if(params->wakeup_watermark != 0) {
+		if(pman_set_wakeup_watermark(params->wakeup_watermark)) {
+			return scap_errprintf(handle->m_lasterr,
+			                      0,
+			                      "unable to set the wakeup watermark to %" PRIu64,
+			                      params->wakeup_watermark);
+		}
+		HANDLE(engine)->m_wait_for_wakeup = true;
 	}
 
 	/* Store interesting sc codes */
@@ -386,6 +672,42 @@ const struct scap_linux_vtable scap_modern_bpf_linux_vtable = {
         .fetch_procs_files = scap_modern_bpf__fetch_procs_files,
 };
 
+// Vtable returned by scap_modern_bpf_load_iterators(): the hooks of another engine, with the
+// fetch ones replaced by the BPF iterators.
+static struct scap_linux_vtable s_iterators_linux_vtable;
+
+const struct scap_linux_vtable* scap_modern_bpf_load_iterators(
+        falcosecurity_log_fn log_fn,
+        const struct scap_linux_vtable* base,
+        char* error) {
+	uint64_t boot_time = 0;
+	if(scap_get_precise_boot_time(error, &boot_time) != SCAP_SUCCESS) {
+		return NULL;
+	}
+
+	int err = pman_load_iterators(log_fn, boot_time);
+	if(err) {
+		scap_errprintf(error, err, "unable to load the BPF iterators");
+		return NULL;
+	}
+
+	if(base) {
+		s_iterators_linux_vtable = *base;
+	} else {
+		memset(&s_iterators_linux_vtable, 0, sizeof(s_iterators_linux_vtable));
+	}
+	s_iterators_linux_vtable.fetch_thread = scap_modern_bpf__fetch_task;
+	s_iterators_linux_vtable.fetch_threads = scap_modern_bpf__fetch_tasks;
+	s_iterators_linux_vtable.fetch_proc_file = scap_modern_bpf__fetch_proc_file;
+	s_iterators_linux_vtable.fetch_proc_files = scap_modern_bpf__fetch_proc_files;
+	s_iterators_linux_vtable.fetch_procs_files = scap_modern_bpf__fetch_procs_files;
+	return &s_iterators_linux_vtable;
+}
+
+void scap_modern_bpf_unload_iterators(void) {
+	pman_close_probe();
+}
+
 struct scap_vtable scap_modern_bpf_engine = {
         .name = MODERN_BPF_ENGINE,
         .savefile_ops = NULL,
@@ -28,10 +28,16 @@ struct scap;
 
 struct modern_bpf_engine {
 	unsigned long m_retry_us;           /* Microseconds to wait if all ring buffers are empty */
+	bool m_wait_for_wakeup;             /* Block until the probe wakes us up instead of sleeping */
 	char* m_lasterr;                    /* Last error caught by the engine */
 	interesting_ppm_sc_set curr_sc_set; /* current ppm_sc */
 	uint64_t m_api_version;
 	uint64_t m_schema_version;
 	bool capturing;
 	uint64_t m_flags;
+	char* m_final_evts;           /* Events synthesized when the capture stops */
+	size_t m_final_evts_len;      /* Bytes used in `m_final_evts` */
+	size_t m_final_evts_size;     /* Bytes allocated for `m_final_evts` */
+	size_t m_final_evts_offset;   /* Offset of the next event to return */
+	uint32_t m_n_evts_since_sync; /* Events read since the programs were last synced */
 };
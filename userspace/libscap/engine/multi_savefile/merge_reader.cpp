@@ -0,0 +1,411 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2026 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <libscap/engine/multi_savefile/merge_reader.h>
+#include <libscap/scap.h>
+#include <libscap/strerror.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Each event copied into a chunk is preceded by this header. Records are padded
+// so that every event header starts on an 8-byte boundary.
+struct record_header {
+	uint32_t size;  // size of the whole record, header and padding included
+	uint32_t flags;
+	uint16_t devid;
+	uint16_t reserved[3];
+};
+
+constexpr size_t RECORD_ALIGNMENT = 8;
+static_assert(sizeof(record_header) % RECORD_ALIGNMENT == 0, "record_header must be aligned");
+
+inline size_t record_size(uint32_t evt_len) {
+	return (sizeof(record_header) + evt_len + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1);
+}
+
+struct chunk {
+	explicit chunk(size_t size): capacity(size), data(new char[size]) {}
+
+	void grow(size_t size) {
+		data.reset(new char[size]);
+		capacity = size;
+	}
+
+	size_t capacity;
+	size_t used = 0;
+	std::unique_ptr<char[]> data;
+};
+
+//
+// A single capture file, drained by its own thread.
+//
+// The worker fills chunks and publishes them in `m_ready`; the consumer takes
+// them one at a time and gives them back through `m_free` once all of its events
+// have been returned. At most `m_depth` chunks exist at any time, which bounds the
+// memory used by each source and throttles the worker when the consumer lags.
+//
+class source {
+public:
+	source(scap_t* handle, std::string name, size_t chunk_size, uint32_t depth):
+	        m_handle(handle),
+	        m_name(std::move(name)),
+	        m_chunk_size(chunk_size),
+	        m_depth(depth) {}
+
+	~source() {
+		stop();
+		scap_close(m_handle);
+	}
+
+	source(const source&) = delete;
+	source& operator=(const source&) = delete;
+
+	void start() { m_worker = std::thread(&source::run, this); }
+
+	void stop() {
+		{
+			std::lock_guard<std::mutex> lock(m_mtx);
+			m_stop = true;
+		}
+		m_cv.notify_all();
+		if(m_worker.joinable()) {
+			m_worker.join();
+		}
+	}
+
+	//
+	// Consumer side
+	//
+
+	// Gives back the current chunk (if any) and waits for the next one.
+	// Returns false once the worker is done and no chunk is left.
+	bool next_chunk() {
+		std::unique_lock<std::mutex> lock(m_mtx);
+		if(m_cur) {
+			m_cur->used = 0;
+			m_free.push_back(std::move(m_cur));
+			m_cv.notify_all();
+		}
+		m_cv.wait(lock, [this] { return !m_ready.empty() || m_done; });
+		if(m_ready.empty()) {
+			return false;
+		}
+		m_cur = std::move(m_ready.front());
+		m_ready.pop_front();
+		m_off = 0;
+		return true;
+	}
+
+	bool has_head() const { return m_cur && m_off < m_cur->used; }
+
+	const record_header* head() const {
+		return reinterpret_cast<const record_header*>(m_cur->data.get() + m_off);
+	}
+
+	const scap_evt* head_evt() const { return reinterpret_cast<const scap_evt*>(head() + 1); }
+
+	void pop_head() { m_off += head()->size; }
+
+	// Only meaningful once next_chunk() returned false.
+	int32_t status() const { return m_status; }
+	const std::string& error() const { return m_error; }
+	const std::string& name() const { return m_name; }
+	int64_t offset() const { return m_offset.load(std::memory_order_relaxed); }
+
+private:
+	std::unique_ptr<chunk> acquire_chunk() {
+		std::unique_lock<std::mutex> lock(m_mtx);
+		m_cv.wait(lock, [this] { return m_stop || !m_free.empty() || m_allocated < m_depth; });
+		if(m_stop) {
+			return nullptr;
+		}
+		if(!m_free.empty()) {
+			auto c = std::move(m_free.back());
+			m_free.pop_back();
+			return c;
+		}
+		m_allocated++;
+		lock.unlock();
+		return std::make_unique<chunk>(m_chunk_size);
+	}
+
+	void publish(std::unique_ptr<chunk> c) {
+		m_offset.store(scap_get_readfile_offset(m_handle), std::memory_order_relaxed);
+		{
+			std::lock_guard<std::mutex> lock(m_mtx);
+			m_ready.push_back(std::move(c));
+		}
+		m_cv.notify_all();
+	}
+
+	void finish(std::unique_ptr<chunk> c, int32_t status, std::string error) {
+		if(c && c->used > 0) {
+			publish(std::move(c));
+		}
+		{
+			std::lock_guard<std::mutex> lock(m_mtx);
+			m_status = status;
+			m_error = std::move(error);
+			m_done = true;
+		}
+		m_cv.notify_all();
+	}
+
+	void run() {
+		std::unique_ptr<chunk> c;
+		scap_evt* evt = nullptr;
+		uint16_t devid = 0;
+		uint32_t flags = 0;
+		bool pending = false;
+
+		try {
+			while(true) {
+				if(!c) {
+					c = acquire_chunk();
+					if(!c) {
+						finish(nullptr, SCAP_EOF, "");
+						return;
+					}
+				}
+
+				if(!pending) {
+					int32_t res = scap_next(m_handle, &evt, &devid, &flags);
+					if(res == SCAP_FILTERED_EVENT || res == SCAP_TIMEOUT) {
+						continue;
+					}
+					if(res == SCAP_EOF) {
+						finish(std::move(c), SCAP_EOF, "");
+						return;
+					}
+					if(res == SCAP_UNEXPECTED_BLOCK) {
+						// Restarting a capture rebuilds the shared platform state, which can't
+						// happen while the other files are being read.
+						finish(std::move(c),
+						       SCAP_FAILURE,
+						       "concatenated capture files are not supported, open each of them "
+						       "separately");
+						return;
+					}
+					if(res != SCAP_SUCCESS) {
+						finish(std::move(c), SCAP_FAILURE, scap_getlasterr(m_handle));
+						return;
+					}
+					pending = true;
+				}
+
+				size_t size = record_size(evt->len);
+				if(c->used + size > c->capacity) {
+					if(c->used > 0) {
+						publish(std::move(c));
+						continue;
+					}
+					// A single event larger than a whole chunk.
+					c->grow(size);
+				}
+
+				auto* hdr = reinterpret_cast<record_header*>(c->data.get() + c->used);
+				hdr->size = (uint32_t)size;
+				hdr->flags = flags;
+				hdr->devid = devid;
+				memcpy(hdr + 1, evt, evt->len);
+				c->used += size;
+				pending = false;
+			}
+		} catch(const std::exception& e) {
+			finish(nullptr, SCAP_FAILURE, e.what());
+		}
+	}
+
+	scap_t* m_handle;
+	std::string m_name;
+	size_t m_chunk_size;
+	uint32_t m_depth;
+	std::thread m_worker;
+
+	// Shared state, protected by `m_mtx`.
+	std::mutex m_mtx;
+	std::condition_variable m_cv;
+	std::deque<std::unique_ptr<chunk>> m_ready;
+	std::vector<std::unique_ptr<chunk>> m_free;
+	uint32_t m_allocated = 0;
+	bool m_stop = false;
+	bool m_done = false;
+	int32_t m_status = SCAP_SUCCESS;
+	std::string m_error;
+	std::atomic<int64_t> m_offset{0};
+
+	// Consumer state.
+	std::unique_ptr<chunk> m_cur;
+	size_t m_off = 0;
+};
+
+struct heap_entry {
+	uint64_t ts;
+	uint32_t src;
+
+	// Ties are broken by file order, so that the merged stream is deterministic.
+	bool operator>(const heap_entry& other) const {
+		return ts != other.ts ? ts > other.ts : src > other.src;
+	}
+};
+
+}  // namespace
+
+struct scap_merge_reader {
+	size_t m_chunk_size;
+	uint32_t m_depth;
+	std::vector<std::unique_ptr<source>> m_sources;
+	std::priority_queue<heap_entry, std::vector<heap_entry>, std::greater<heap_entry>> m_heap;
+	bool m_started = false;
+	bool m_primed = false;
+	// Source of the event returned by the last next() call, whose head has
+	// to be popped before picking the next event.
+	int64_t m_last = -1;
+	uint64_t m_nevts = 0;
+
+	// Pushes the head of the given source in the heap, fetching a new chunk if needed.
+	int32_t push_head(uint32_t idx, char* error) {
+		source& s = *m_sources[idx];
+		if(!s.has_head() && !s.next_chunk()) {
+			if(s.status() != SCAP_EOF) {
+				return scap_errprintf(error,
+				                      0,
+				                      "error reading '%s': %s",
+				                      s.name().c_str(),
+				                      s.error().c_str());
+			}
+			return SCAP_SUCCESS;
+		}
+		m_heap.push({s.head_evt()->ts, idx});
+		return SCAP_SUCCESS;
+	}
+};
+
+extern "C" {
+
+struct scap_merge_reader* scap_merge_reader_alloc(uint32_t chunk_size, uint32_t queue_depth) {
+	auto* r = new(std::nothrow) scap_merge_reader;
+	if(r == nullptr) {
+		return nullptr;
+	}
+	r->m_chunk_size = chunk_size ? chunk_size : MULTI_SAVEFILE_DEFAULT_CHUNK_SIZE;
+	// With a single chunk the reader thread could never run ahead of the consumer.
+	r->m_depth = queue_depth >= 2 ? queue_depth : 2;
+	return r;
+}
+
+int32_t scap_merge_reader_add(struct scap_merge_reader* r,
+                              scap_t* handle,
+                              const char* name,
+                              char* error) {
+	if(r->m_started) {
+		scap_close(handle);
+		return scap_errprintf(error, 0, "cannot add a file to a started merge reader");
+	}
+	try {
+		r->m_sources.push_back(
+		        std::make_unique<source>(handle, name, r->m_chunk_size, r->m_depth));
+	} catch(const std::exception& e) {
+		scap_close(handle);
+		return scap_errprintf(error, 0, "cannot add '%s' to the merge reader: %s", name, e.what());
+	}
+	return SCAP_SUCCESS;
+}
+
+int32_t scap_merge_reader_start(struct scap_merge_reader* r, char* error) {
+	if(r->m_sources.empty()) {
+		return scap_errprintf(error, 0, "no capture files to read");
+	}
+	try {
+		for(auto& s : r->m_sources) {
+			s->start();
+		}
+	} catch(const std::exception& e) {
+		return scap_errprintf(error, 0, "cannot start the file reader threads: %s", e.what());
+	}
+	r->m_started = true;
+	return SCAP_SUCCESS;
+}
+
+int32_t scap_merge_reader_next(struct scap_merge_reader* r,
+                               scap_evt** pevent,
+                               uint16_t* pdevid,
+                               uint32_t* pflags,
+                               char* error) {
+	int32_t res;
+	if(!r->m_primed) {
+		for(uint32_t i = 0; i < r->m_sources.size(); i++) {
+			if((res = r->push_head(i, error)) != SCAP_SUCCESS) {
+				return res;
+			}
+		}
+		r->m_primed = true;
+	} else if(r->m_last >= 0) {
+		uint32_t last = (uint32_t)r->m_last;
+		r->m_last = -1;
+		r->m_sources[last]->pop_head();
+		if((res = r->push_head(last, error)) != SCAP_SUCCESS) {
+			return res;
+		}
+	}
+
+	if(r->m_heap.empty()) {
+		return SCAP_EOF;
+	}
+
+	uint32_t idx = r->m_heap.top().src;
+	r->m_heap.pop();
+
+	const source& s = *r->m_sources[idx];
+	*pevent = const_cast<scap_evt*>(s.head_evt());
+	*pdevid = s.head()->devid;
+	*pflags = s.head()->flags;
+	r->m_last = idx;
+	r->m_nevts++;
+	return SCAP_SUCCESS;
+}
+
+int64_t scap_merge_reader_offset(struct scap_merge_reader* r) {
+	int64_t offset = 0;
+	for(const auto& s : r->m_sources) {
+		offset += s->offset();
+	}
+	return offset;
+}
+
+uint64_t scap_merge_reader_nevts(struct scap_merge_reader* r) {
+	return r->m_nevts;
+}
+
+void scap_merge_reader_free(struct scap_merge_reader* r) {
+	delete r;
+}
+
+}  // extern "C"
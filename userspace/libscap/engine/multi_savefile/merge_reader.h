@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2026 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct scap scap_t;
+typedef struct ppm_evt_hdr scap_evt;
+
+#define MULTI_SAVEFILE_DEFAULT_CHUNK_SIZE (1 << 20)
+#define MULTI_SAVEFILE_DEFAULT_QUEUE_DEPTH 4
+
+//
+// A merge reader owns a set of already opened scap handles (one per capture
+// file). Once started, each handle is drained by a dedicated thread that
+// decodes (and converts, if needed) events into batches of `chunk_size` bytes.
+// The consumer side merges the per-file streams by timestamp.
+//
+struct scap_merge_reader;
+
+struct scap_merge_reader* scap_merge_reader_alloc(uint32_t chunk_size, uint32_t queue_depth);
+
+// Takes ownership of `handle`, which is closed when the reader is freed (or right
+// away on failure). `name` is only used in error messages.
+int32_t scap_merge_reader_add(struct scap_merge_reader* r,
+                              scap_t* handle,
+                              const char* name,
+                              char* error);
+
+int32_t scap_merge_reader_start(struct scap_merge_reader* r, char* error);
+
+// Returns the event with the lowest timestamp among all the sources.
+// The returned event remains valid until the next call.
+int32_t scap_merge_reader_next(struct scap_merge_reader* r,
+                               scap_evt** pevent,
+                               uint16_t* pdevid,
+                               uint32_t* pflags,
+                               char* error);
+
+// Sum of the (compressed) read offsets of all the sources.
+int64_t scap_merge_reader_offset(struct scap_merge_reader* r);
+
+// Number of events returned so far.
+uint64_t scap_merge_reader_nevts(struct scap_merge_reader* r);
+
+// Stops the reader threads and closes all the owned scap handles.
+void scap_merge_reader_free(struct scap_merge_reader* r);
+
+#ifdef __cplusplus
+};
+#endif
@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2026 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#define MULTI_SAVEFILE_ENGINE "multi_savefile"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+struct scap_platform;
+
+struct scap_multi_savefile_engine_params {
+	const char** fnames;    ///< The names of the files to open.
+	uint32_t num_fnames;    ///< The number of entries in `fnames`.
+	uint32_t fbuffer_size;  ///< If non-zero, each file will be read using a buffer of this size.
+	uint32_t chunk_size;    ///< Size in bytes of the event batches handed over by each reader
+	                        ///< thread. If zero, `MULTI_SAVEFILE_DEFAULT_CHUNK_SIZE` is used.
+	uint32_t queue_depth;   ///< Number of batches each reader thread can prefetch. If zero,
+	                        ///< `MULTI_SAVEFILE_DEFAULT_QUEUE_DEPTH` is used.
+
+	struct scap_platform* platform;
+};
+
+#ifdef __cplusplus
+};
+#endif
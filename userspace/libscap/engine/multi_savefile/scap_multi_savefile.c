@@ -0,0 +1,174 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2026 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <libscap/engine/multi_savefile/multi_savefile_public.h>
+#include <libscap/engine/multi_savefile/merge_reader.h>
+#include <libscap/engine/savefile/savefile_public.h>
+#include <libscap/engine/noop/noop.h>
+#include <libscap/scap.h>
+#include <libscap/scap-int.h>
+#include <libscap/scap_engines.h>
+#include <libscap/strerror.h>
+
+struct multi_savefile_engine {
+	char* m_lasterr;
+	struct scap_merge_reader* m_reader;
+};
+
+#define HANDLE(engine) ((struct multi_savefile_engine*)(engine.m_handle))
+
+static void* alloc_handle(struct scap* main_handle, char* lasterr_ptr) {
+	struct multi_savefile_engine* engine = calloc(1, sizeof(struct multi_savefile_engine));
+	if(engine) {
+		engine->m_lasterr = lasterr_ptr;
+	}
+	return engine;
+}
+
+//
+// Every file is opened through a regular savefile engine handle. All of them
+// share the caller's platform, so that the proclist/fdlist blocks of each file
+// are delivered through the same callbacks, one file after another: thread and
+// fd tables end up merged, while for the machine info, interface and user lists
+// the last file containing them wins.
+// Reading the headers is intentionally serial (it updates the shared state), only
+// the event blocks are then decoded in parallel.
+//
+static int32_t init(struct scap* main_handle, struct scap_open_args* oargs) {
+	struct multi_savefile_engine* handle = main_handle->m_engine.m_handle;
+	struct scap_multi_savefile_engine_params* params = oargs->engine_params;
+	int32_t rc;
+
+	if(params->num_fnames == 0 || params->fnames == NULL) {
+		return scap_errprintf(main_handle->m_lasterr, 0, "no capture files to open");
+	}
+
+	handle->m_reader = scap_merge_reader_alloc(params->chunk_size, params->queue_depth);
+	if(handle->m_reader == NULL) {
+		return scap_errprintf(main_handle->m_lasterr, 0, "error allocating the merge reader");
+	}
+
+	for(uint32_t i = 0; i < params->num_fnames; i++) {
+		struct scap_savefile_engine_params file_params = {0};
+		file_params.fname = params->fnames[i];
+		file_params.fbuffer_size = params->fbuffer_size;
+		file_params.platform = params->platform;
+
+		struct scap_open_args file_oargs = {0};
+		file_oargs.import_users = oargs->import_users;
+		file_oargs.log_fn = oargs->log_fn;
+		file_oargs.engine_params = &file_params;
+
+		char error[SCAP_LASTERR_SIZE];
+		scap_t* file_handle = scap_open(&file_oargs, &scap_savefile_engine, error, &rc);
+		if(file_handle == NULL) {
+			return scap_errprintf(main_handle->m_lasterr,
+			                      0,
+			                      "cannot open '%s': %s",
+			                      params->fnames[i],
+			                      error);
+		}
+
+		rc = scap_merge_reader_add(handle->m_reader,
+		                           file_handle,
+		                           params->fnames[i],
+		                           main_handle->m_lasterr);
+		if(rc != SCAP_SUCCESS) {
+			return rc;
+		}
+	}
+
+	return scap_merge_reader_start(handle->m_reader, main_handle->m_lasterr);
+}
+
+static void free_handle(struct scap_engine_handle engine) {
+	free(engine.m_handle);
+}
+
+static int32_t close_engine(struct scap_engine_handle engine) {
+	struct multi_savefile_engine* handle = HANDLE(engine);
+	if(handle->m_reader) {
+		scap_merge_reader_free(handle->m_reader);
+		handle->m_reader = NULL;
+	}
+	return SCAP_SUCCESS;
+}
+
+static int32_t next(struct scap_engine_handle engine,
+                    scap_evt** pevent,
+                    uint16_t* pdevid,
+                    uint32_t* pflags) {
+	struct multi_savefile_engine* handle = HANDLE(engine);
+	return scap_merge_reader_next(handle->m_reader, pevent, pdevid, pflags, handle->m_lasterr);
+}
+
+static int32_t get_stats(struct scap_engine_handle engine, scap_stats* stats) {
+	stats->n_evts = scap_merge_reader_nevts(HANDLE(engine)->m_reader);
+	return SCAP_SUCCESS;
+}
+
+static int64_t get_readfile_offset(struct scap_engine_handle engine) {
+	return scap_merge_reader_offset(HANDLE(engine)->m_reader);
+}
+
+static uint64_t ftell_capture(struct scap_engine_handle engine) {
+	return (uint64_t)scap_merge_reader_offset(HANDLE(engine)->m_reader);
+}
+
+static void fseek_capture(struct scap_engine_handle engine, uint64_t off) {
+	// Seeking makes no sense on a merged stream.
+}
+
+static int32_t restart_capture(scap_t* handle) {
+	return scap_errprintf(handle->m_lasterr,
+	                      0,
+	                      "capture restart is not supported by the %s engine",
+	                      MULTI_SAVEFILE_ENGINE);
+}
+
+static struct scap_savefile_vtable multi_savefile_ops = {
+        .ftell_capture = ftell_capture,
+        .fseek_capture = fseek_capture,
+
+        .restart_capture = restart_capture,
+        .get_readfile_offset = get_readfile_offset,
+};
+
+const struct scap_vtable scap_multi_savefile_engine = {
+        .name = MULTI_SAVEFILE_ENGINE,
+        .savefile_ops = &multi_savefile_ops,
+
+        .alloc_handle = alloc_handle,
+        .init = init,
+        .free_handle = free_handle,
+        .close = close_engine,
+        .next = next,
+        .start_capture = noop_start_capture,
+        .stop_capture = noop_stop_capture,
+        .configure = noop_configure,
+        .get_stats = get_stats,
+        .get_stats_v2 = noop_get_stats_v2,
+        .get_n_tracepoint_hit = noop_get_n_tracepoint_hit,
+        .get_n_devs = noop_get_n_devs,
+        .get_max_buf_used = noop_get_max_buf_used,
+        .get_api_version = NULL,
+        .get_schema_version = NULL,
+};
@@ -29,17 +29,90 @@ limitations under the License.
 #include <string>
 #include <stdexcept>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 #include <libscap/scap-int.h>
 #include <libscap/strerror.h>
 
-typedef std::shared_ptr<scap_evt> safe_scap_evt_t;
+// Enter events are stored until the corresponding exit event is converted. Since this happens
+// for almost every syscall of old captures, the storage must not allocate on the hot path: each
+// tid owns a slot pointing to a region of a chunked arena. Regions are recycled through
+// per-size-class free lists, so the memory in use is bounded by the number of threads with a
+// pending enter event.
+class evt_slot_arena {
+public:
+	// Return a region of at least `len` bytes, storing its real size in `capacity`.
+	char *acquire(uint32_t len, uint32_t *capacity) {
+		const size_t size_class = get_size_class(len);
+		*capacity = MIN_REGION_SIZE << size_class;
+		if(size_class < m_free.size() && !m_free[size_class].empty()) {
+			char *region = m_free[size_class].back();
+			m_free[size_class].pop_back();
+			return region;
+		}
 
-static inline safe_scap_evt_t safe_scap_evt(scap_evt *evt) {
-	return safe_scap_evt_t{evt, free};
-}
+		// Big regions are rare, don't waste chunk space for them.
+		if(*capacity > CHUNK_SIZE / 4) {
+			m_chunks.emplace_back(new char[*capacity]);
+			return m_chunks.back().get();
+		}
+
+		if(m_chunk_left < *capacity) {
+			m_chunks.emplace_back(new char[CHUNK_SIZE]);
+			m_chunk_pos = m_chunks.back().get();
+			m_chunk_left = CHUNK_SIZE;
+		}
+		char *region = m_chunk_pos;
+		m_chunk_pos += *capacity;
+		m_chunk_left -= *capacity;
+		return region;
+	}
+
+	void release(char *region, uint32_t capacity) {
+		const size_t size_class = get_size_class(capacity);
+		if(size_class >= m_free.size()) {
+			m_free.resize(size_class + 1);
+		}
+		m_free[size_class].push_back(region);
+	}
+
+	void clear() {
+		m_free.clear();
+		m_chunks.clear();
+		m_chunk_pos = nullptr;
+		m_chunk_left = 0;
+	}
+
+private:
+	// Regions are powers of 2 starting from here, big enough for the most common enter events.
+	static constexpr uint32_t MIN_REGION_SIZE = 128;
+	static constexpr uint32_t CHUNK_SIZE = 64 * 1024;
+
+	static size_t get_size_class(uint32_t len) {
+		size_t size_class = 0;
+		while((MIN_REGION_SIZE << size_class) < len) {
+			size_class++;
+		}
+		return size_class;
+	}
+
+	std::vector<std::vector<char *>> m_free;
+	std::vector<std::unique_ptr<char[]>> m_chunks;
+	char *m_chunk_pos = nullptr;
+	uint32_t m_chunk_left = 0;
+};
+
+struct evt_slot {
+	// Stored enter event, nullptr if there is no pending event for the tid.
+	scap_evt *evt = nullptr;
+	uint32_t capacity = 0;
+};
 
 struct scap_convert_buffer {
-	std::unordered_map<uint64_t, safe_scap_evt_t> evt_storage = {};
+	// Slots are never removed, so that storing the next enter event of a thread doesn't touch the
+	// map structure.
+	std::unordered_map<uint64_t, evt_slot> evt_storage = {};
+	evt_slot_arena arena;
 };
 
 static const char *get_event_name(ppm_event_code event_type) {
@@ -55,16 +128,17 @@ static char get_direction_char(ppm_event_code event_type) {
 	}
 }
 
-static void clear_evt(std::unordered_map<uint64_t, safe_scap_evt_t> &evt_storage, uint64_t tid) {
-	if(evt_storage.find(tid) != evt_storage.end()) {
-		evt_storage[tid].reset();
+static void clear_evt(scap_convert_buffer &buf, uint64_t tid) {
+	auto it = buf.evt_storage.find(tid);
+	if(it != buf.evt_storage.end() && it->second.evt) {
+		buf.arena.release(reinterpret_cast<char *>(it->second.evt), it->second.capacity);
+		it->second.evt = nullptr;
+		it->second.capacity = 0;
 	}
 }
 
-static void store_evt(std::unordered_map<uint64_t, safe_scap_evt_t> &evt_storage,
-                      uint64_t tid,
-                      scap_evt *evt) {
-	// if there was a previous event for this tid, we can overwrite the pointer because it means we
+static void store_evt(scap_convert_buffer &buf, uint64_t tid, const scap_evt *evt) {
+	// if there was a previous event for this tid, we can overwrite it because it means we
 	// don't need it anymore. We need to keep the enter event until we retrieve it in the
 	// corresponding exit event, but if the same thread is doing another enter event it means the
 	// previous syscall is already completed.
@@ -77,20 +151,21 @@ static void store_evt(std::unordered_map<uint64_t, safe_scap_evt_t> &evt_storage
 	        evt->len,
 	        evt->nparams);
 
-	clear_evt(evt_storage, tid);
-
-	scap_evt *tmp_evt = (scap_evt *)malloc(evt->len);
-	if(!tmp_evt) {
-		throw std::runtime_error("Cannot allocate memory for the enter event.");
+	evt_slot &slot = buf.evt_storage[tid];
+	if(slot.evt && slot.capacity < evt->len) {
+		buf.arena.release(reinterpret_cast<char *>(slot.evt), slot.capacity);
+		slot.evt = nullptr;
 	}
-	memcpy(tmp_evt, evt, evt->len);
-	evt_storage[tid] = safe_scap_evt(tmp_evt);
+	if(!slot.evt) {
+		slot.evt = reinterpret_cast<scap_evt *>(buf.arena.acquire(evt->len, &slot.capacity));
+	}
+	memcpy(slot.evt, evt, evt->len);
 }
 
-static scap_evt *retrieve_evt(std::unordered_map<uint64_t, safe_scap_evt_t> &evt_storage,
-                              uint64_t tid) {
-	if(evt_storage.find(tid) != evt_storage.end()) {
-		return evt_storage[tid].get();
+static scap_evt *retrieve_evt(scap_convert_buffer &buf, uint64_t tid) {
+	auto it = buf.evt_storage.find(tid);
+	if(it != buf.evt_storage.end()) {
+		return it->second.evt;
 	}
 	return nullptr;
 }
@@ -433,15 +508,14 @@ extern "C" conversion_result test_event_convertibility(const scap_evt *evt_to_co
 	return CONVERSION_PASS;
 }
 
-extern "C" scap_evt *scap_retrieve_evt_from_converter_storage(
-        std::unordered_map<uint64_t, safe_scap_evt_t> &evt_storage,
-        uint64_t tid) {
-	return retrieve_evt(evt_storage, tid);
+extern "C" scap_evt *scap_retrieve_evt_from_converter_storage(struct scap_convert_buffer *buf,
+                                                               uint64_t tid) {
+	return retrieve_evt(*buf, tid);
 }
 
-extern "C" void scap_clear_converter_storage(
-        std::unordered_map<uint64_t, safe_scap_evt_t> &evt_storage) {
-	evt_storage.clear();
+extern "C" void scap_clear_converter_storage(struct scap_convert_buffer *buf) {
+	buf->evt_storage.clear();
+	buf->arena.clear();
 }
 
 scap_evt_param_reader::scap_evt_param_reader(const scap_evt &evt): m_evt{evt} {}
@@ -540,9 +614,9 @@ int push_parameter_from_callback(scap_evt *new_evt,
 	return 0;
 }
 
-static conversion_result convert_event(std::unordered_map<uint64_t, safe_scap_evt_t> &evt_storage,
+static conversion_result convert_event(scap_convert_buffer &buf,
                                        scap_evt *new_evt,
-                                       scap_evt *evt_to_convert,
+                                       const scap_evt *evt_to_convert,
                                        const conversion_info &ci,
                                        char *error) {
 	/////////////////////////////
@@ -552,20 +626,25 @@ static conversion_result convert_event(std::unordered_map<uint64_t, safe_scap_ev
 	size_t params_offset = 0;
 	int param_to_populate = 0;
 
-	// We copy the entire event in any case so that we are ready to handle `CONVERSION_PASS` cases
-	// without further actions.
-	memcpy(new_evt, evt_to_convert, evt_to_convert->len);
-
-	switch(ci.m_action) {
-	case C_ACTION_STORE:
-		store_evt(evt_storage, evt_to_convert->tid, evt_to_convert);
+	// Dropped events don't need to be copied at all.
+	if(ci.m_action == C_ACTION_STORE) {
+		store_evt(buf, evt_to_convert->tid, evt_to_convert);
 		return CONVERSION_DROP;
+	}
+
+	// Events changing type are rebuilt from scratch, so only their header is needed. In the other
+	// cases we copy the entire event so that we are ready to handle `CONVERSION_PASS` cases without
+	// further actions.
+	memcpy(new_evt,
+	       evt_to_convert,
+	       ci.m_action == C_ACTION_CHANGE_TYPE ? sizeof(scap_evt) : evt_to_convert->len);
 
+	switch(ci.m_action) {
 	case C_ACTION_PASS:
 		return CONVERSION_PASS;
 
 	case C_ACTION_STORE_AND_PASS:
-		store_evt(evt_storage, evt_to_convert->tid, evt_to_convert);
+		store_evt(buf, evt_to_convert->tid, evt_to_convert);
 		return CONVERSION_PASS;
 
 	case C_ACTION_ADD_PARAMS:
@@ -597,7 +676,7 @@ static conversion_result convert_event(std::unordered_map<uint64_t, safe_scap_ev
 	PRINT_MESSAGE("New event header (the len is still the old one):\n");
 	PRINT_EVENT(new_evt, PRINT_HEADER);
 
-	scap_evt *tmp_evt = nullptr;
+	const scap_evt *tmp_evt = nullptr;
 	// If this is true at the end of the for loop we will free its memory.
 	bool used_enter_event = false;
 
@@ -626,7 +705,7 @@ static conversion_result convert_event(std::unordered_map<uint64_t, safe_scap_ev
 			continue;
 
 		case C_INSTR_FROM_ENTER:
-			tmp_evt = retrieve_evt(evt_storage, evt_to_convert->tid);
+			tmp_evt = retrieve_evt(buf, evt_to_convert->tid);
 			if(!tmp_evt) {
 				// It could be due to different reasons:
 				// - we dropped the enter event in the capture
@@ -716,7 +795,7 @@ static conversion_result convert_event(std::unordered_map<uint64_t, safe_scap_ev
 
 	if(used_enter_event) {
 		// We can free the enter event for this thread because we don't need it anymore.
-		clear_evt(evt_storage, evt_to_convert->tid);
+		clear_evt(buf, evt_to_convert->tid);
 	}
 	new_evt->len = params_offset;
 
@@ -753,8 +832,9 @@ extern "C" conversion_result scap_convert_event(struct scap_convert_buffer *buf,
 	}
 
 	// If we need a conversion but we don't have an entry in the table we have an error.
-	auto conv_key = conversion_key{evt_to_convert->type, (uint8_t)evt_to_convert->nparams};
-	if(g_conversion_table.find(conv_key) == g_conversion_table.end()) {
+	const auto conv_it = g_conversion_table.find(
+	        conversion_key{evt_to_convert->type, (uint8_t)evt_to_convert->nparams});
+	if(conv_it == g_conversion_table.end()) {
 		scap_errprintf(error,
 		               0,
 		               "Required conversion for event (type: %d, nparams: %d), but we don't handle "
@@ -765,11 +845,7 @@ extern "C" conversion_result scap_convert_event(struct scap_convert_buffer *buf,
 	}
 
 	// If we reached this point we have for sure an entry in the conversion table.
-	return convert_event(buf->evt_storage,
-	                     new_evt,
-	                     evt_to_convert,
-	                     g_conversion_table.at(conv_key),
-	                     error);
+	return convert_event(*buf, new_evt, evt_to_convert, conv_it->second, error);
 }
 
 extern "C" void scap_convert_free_buffer(struct scap_convert_buffer *buf) {
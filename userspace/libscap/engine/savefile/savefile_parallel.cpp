@@ -0,0 +1,150 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2026 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <libscap/engine/savefile/savefile_parallel.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+struct savefile_workers {
+	std::mutex mtx;
+	std::condition_variable start_cv;
+	std::condition_variable done_cv;
+	std::vector<std::thread> threads;
+
+	// Current batch, replaced under `mtx` once the previous one is complete
+	uint64_t generation = 0;
+	bool stop = false;
+	uint32_t busy = 0;
+	uint32_t ntasks = 0;
+	savefile_task_fn fn = nullptr;
+	void* ctx = nullptr;
+	std::atomic<uint32_t> next{0};
+
+	void drain(uint32_t n, savefile_task_fn f, void* c) {
+		uint32_t idx;
+		while((idx = next.fetch_add(1, std::memory_order_relaxed)) < n) {
+			f(c, idx);
+		}
+	}
+
+	void loop() {
+		uint64_t seen = 0;
+		std::unique_lock<std::mutex> lock(mtx);
+		while(true) {
+			start_cv.wait(lock, [&] { return stop || generation != seen; });
+			if(stop) {
+				return;
+			}
+			seen = generation;
+			busy++;
+			uint32_t n = ntasks;
+			savefile_task_fn f = fn;
+			void* c = ctx;
+			lock.unlock();
+			drain(n, f, c);
+			lock.lock();
+			if(--busy == 0) {
+				done_cv.notify_one();
+			}
+		}
+	}
+};
+
+extern "C" {
+
+uint32_t savefile_default_workers(void) {
+#ifdef __EMSCRIPTEN__
+	return 1;
+#else
+	uint32_t ncpus = std::thread::hardware_concurrency();
+	return std::clamp<uint32_t>(ncpus, 1, SAVEFILE_MAX_DEFAULT_HEADER_WORKERS);
+#endif
+}
+
+savefile_workers* savefile_workers_start(uint32_t workers) {
+#ifdef __EMSCRIPTEN__
+	return nullptr;
+#else
+	if(workers <= 1) {
+		return nullptr;
+	}
+
+	auto* w = new(std::nothrow) savefile_workers();
+	if(w == nullptr) {
+		return nullptr;
+	}
+	try {
+		for(uint32_t i = 1; i < workers; i++) {
+			w->threads.emplace_back(&savefile_workers::loop, w);
+		}
+	} catch(...) {
+		// Whatever couldn't be started is picked up by the threads we have.
+	}
+	return w;
+#endif
+}
+
+void savefile_workers_run(savefile_workers* w, uint32_t ntasks, savefile_task_fn fn, void* ctx) {
+	if(w == nullptr || w->threads.empty()) {
+		for(uint32_t i = 0; i < ntasks; i++) {
+			fn(ctx, i);
+		}
+		return;
+	}
+
+	{
+		// A worker that woke up late for the previous batch may still be looking at it.
+		std::unique_lock<std::mutex> lock(w->mtx);
+		w->done_cv.wait(lock, [&] { return w->busy == 0; });
+		w->ntasks = ntasks;
+		w->fn = fn;
+		w->ctx = ctx;
+		w->next.store(0, std::memory_order_relaxed);
+		w->generation++;
+	}
+	w->start_cv.notify_all();
+
+	w->drain(ntasks, fn, ctx);
+
+	std::unique_lock<std::mutex> lock(w->mtx);
+	w->done_cv.wait(lock, [&] { return w->busy == 0; });
+}
+
+void savefile_workers_stop(savefile_workers* w) {
+	if(w == nullptr) {
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(w->mtx);
+		w->stop = true;
+	}
+	w->start_cv.notify_all();
+	for(auto& t : w->threads) {
+		t.join();
+	}
+	delete w;
+}
+
+}  // extern "C"
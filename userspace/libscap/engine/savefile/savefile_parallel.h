@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2026 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Upper bound for the automatically picked number of header workers.
+#define SAVEFILE_MAX_DEFAULT_HEADER_WORKERS 8
+
+typedef void (*savefile_task_fn)(void* ctx, uint32_t idx);
+
+// Number of workers used when the caller doesn't ask for a specific one:
+// one per CPU, capped to SAVEFILE_MAX_DEFAULT_HEADER_WORKERS.
+uint32_t savefile_default_workers(void);
+
+typedef struct savefile_workers savefile_workers;
+
+// Starts `workers` - 1 threads which, with the calling one, run the tasks of
+// savefile_workers_run() until savefile_workers_stop(). Returns NULL if there's
+// nothing to start, in which case the tasks simply run on the calling thread.
+savefile_workers* savefile_workers_start(uint32_t workers);
+
+// Calls fn(ctx, i) for every i in [0, ntasks) on the workers and the calling
+// thread, and returns once all of them are done. Tasks are picked in order but
+// can complete in any order. `w` can be NULL.
+void savefile_workers_run(savefile_workers* w, uint32_t ntasks, savefile_task_fn fn, void* ctx);
+
+// Stops and joins the threads. `w` can be NULL.
+void savefile_workers_stop(savefile_workers* w);
+
+#ifdef __cplusplus
+}
+#endif
@@ -25,12 +25,15 @@ extern "C" {
 struct scap_platform;
 
 struct scap_savefile_engine_params {
-	int fd;                 ///< If non-zero, will be used instead of fname.
-	const char* fname;      ///< The name of the file to open.
-	uint64_t start_offset;  ///< Used to start reading a capture file from an arbitrary offset. This
-	                        ///< is leveraged when opening merged files.
-	uint32_t fbuffer_size;  ///< If non-zero, offline captures will read from file using a buffer of
-	                        ///< this size.
+	int fd;                   ///< If non-zero, will be used instead of fname.
+	const char* fname;        ///< The name of the file to open.
+	uint64_t start_offset;    ///< Used to start reading a capture file from an arbitrary offset.
+	                          ///< This is leveraged when opening merged files.
+	uint32_t fbuffer_size;    ///< If non-zero, offline captures will read from file using a buffer
+	                          ///< of this size.
+	uint32_t header_workers;  ///< Number of threads decoding the thread and fd tables stored in the
+	                          ///< file headers. 0 picks a default based on the number of CPUs and
+	                          ///< on the size of the tables, 1 decodes them on the calling thread.
 
 	struct scap_platform* platform;
 };
@@ -97,6 +97,12 @@ scap_reader_t *scap_reader_open_gzfile(gzFile file);
  */
 scap_reader_t *scap_reader_open_buffered(scap_reader_t *reader, uint32_t bufsize, bool own_reader);
 
+/**
+ * @brief Opens a reader over an in-memory buffer of len bytes. The buffer
+ * is not copied and must outlive the reader.
+ */
+scap_reader_t *scap_reader_open_memory(const void *buf, uint32_t len);
+
 #ifdef __cplusplus
 }
 #endif
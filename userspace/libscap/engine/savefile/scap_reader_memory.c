@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2026 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <libscap/engine/savefile/scap_reader.h>
+#include <string.h>
+
+typedef struct reader_handle {
+	const uint8_t* m_buffer;  ///< The data to read from (not owned)
+	uint32_t m_len;           ///< The size of the data
+	uint32_t m_off;           ///< The cursor position in the data
+} reader_handle_t;
+
+static int memory_read(scap_reader_t* r, void* buf, uint32_t len) {
+	ASSERT(r != NULL);
+	reader_handle_t* h = (reader_handle_t*)r->handle;
+	uint32_t avail = h->m_len - h->m_off;
+	uint32_t size = len < avail ? len : avail;
+	memcpy(buf, h->m_buffer + h->m_off, size);
+	h->m_off += size;
+	return (int)size;
+}
+
+static int64_t memory_tell(scap_reader_t* r) {
+	ASSERT(r != NULL);
+	return ((reader_handle_t*)r->handle)->m_off;
+}
+
+static int64_t memory_seek(scap_reader_t* r, int64_t offset, int whence) {
+	ASSERT(r != NULL);
+	reader_handle_t* h = (reader_handle_t*)r->handle;
+	int64_t pos;
+	switch(whence) {
+	case SEEK_SET:
+		pos = offset;
+		break;
+	case SEEK_CUR:
+		pos = (int64_t)h->m_off + offset;
+		break;
+	case SEEK_END:
+		pos = (int64_t)h->m_len + offset;
+		break;
+	default:
+		return -1;
+	}
+	if(pos < 0 || pos > (int64_t)h->m_len) {
+		return -1;
+	}
+	h->m_off = (uint32_t)pos;
+	return pos;
+}
+
+static const char* memory_error(scap_reader_t* r, int* errnum) {
+	ASSERT(r != NULL);
+	*errnum = 0;
+	return "";
+}
+
+static int memory_close(scap_reader_t* r) {
+	ASSERT(r != NULL);
+	free(r->handle);
+	free(r);
+	return 0;
+}
+
+scap_reader_t* scap_reader_open_memory(const void* buf, uint32_t len) {
+	if(buf == NULL && len > 0) {
+		return NULL;
+	}
+
+	reader_handle_t* h = (reader_handle_t*)calloc(1, sizeof(reader_handle_t));
+	if(h == NULL) {
+		return NULL;
+	}
+	h->m_buffer = (const uint8_t*)buf;
+	h->m_len = len;
+
+	scap_reader_t* r = (scap_reader_t*)malloc(sizeof(scap_reader_t));
+	if(r == NULL) {
+		free(h);
+		return NULL;
+	}
+	r->handle = h;
+	r->read = &memory_read;
+	r->offset = &memory_tell;
+	r->tell = &memory_tell;
+	r->seek = &memory_seek;
+	r->error = &memory_error;
+	r->close = &memory_close;
+	return r;
+}
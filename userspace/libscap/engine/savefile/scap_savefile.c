@@ -40,6 +40,7 @@ struct iovec {
 #include <libscap/strerror.h>
 #include <libscap/engine/savefile/savefile_platform.h>
 #include <libscap/engine/savefile/scap_reader.h>
+#include <libscap/engine/savefile/savefile_parallel.h>
 #include <libscap/engine/noop/noop.h>
 #include <libscap/strl.h>
 #include <libscap/engine/savefile/converter/converter.h>
@@ -1579,6 +1580,345 @@ static int32_t scap_read_fdlist(scap_reader_t *r,
 	return SCAP_SUCCESS;
 }
 
+//
+// Parallel load of the thread and fd tables
+//
+// When more than one header worker is available, process and fd list blocks
+// are not decoded while scanning the file headers: their payload is copied to
+// memory and split in tasks of at most HEADER_TASK_ENTRIES entries (entries
+// can only be located without decoding them in the formats storing their
+// length, i.e. PL_BLOCK_TYPE_V9 and FDL_BLOCK_TYPE_V2; older blocks become a
+// single task). Once all the headers are read, the tasks are decoded in
+// parallel, a round at a time, into staging arrays which are then handed over
+// to the proc callbacks in file order, so the callbacks see exactly the same
+// sequence as with a serial read.
+//
+#define HEADER_TASK_ENTRIES 64
+#define HEADER_ROUND_TASKS_PER_WORKER 2
+// When the number of workers is picked automatically, smaller headers use fewer threads, and
+// headers smaller than HEADER_MIN_PARALLEL_BYTES are decoded on the calling thread only, as
+// starting the threads would cost more than it saves.
+#define HEADER_MIN_BYTES_PER_WORKER (256 * 1024)
+#define HEADER_MIN_PARALLEL_BYTES (1024 * 1024)
+
+struct header_block {
+	uint32_t type;
+	uint32_t len;
+	uint8_t *data;
+};
+
+struct header_task {
+	uint32_t block;  ///< Index in header_staging.blocks
+	uint32_t off;    ///< Offset of the first entry in the block payload
+	uint32_t len;
+	uint64_t tid;  ///< Owner of the fds, only for fd list blocks
+
+	// Filled by the worker
+	int32_t res;
+	char error[SCAP_LASTERR_SIZE];
+	scap_threadinfo *tinfos;
+	scap_fdinfo *fdinfos;
+	uint32_t nentries;
+	uint32_t capacity;
+};
+
+struct header_staging {
+	struct header_block *blocks;
+	uint32_t nblocks;
+	uint32_t blocks_capacity;
+	struct header_task *tasks;
+	uint32_t ntasks;
+	uint32_t tasks_capacity;
+	uint64_t total_len;
+};
+
+static bool is_fdlist_block(uint32_t block_type) {
+	return block_type == FDL_BLOCK_TYPE || block_type == FDL_BLOCK_TYPE_INT ||
+	       block_type == FDL_BLOCK_TYPE_V2;
+}
+
+static void free_header_staging(struct header_staging *staging) {
+	for(uint32_t i = 0; i < staging->nblocks; i++) {
+		free(staging->blocks[i].data);
+	}
+	for(uint32_t i = 0; i < staging->ntasks; i++) {
+		free(staging->tasks[i].tinfos);
+		free(staging->tasks[i].fdinfos);
+	}
+	free(staging->blocks);
+	free(staging->tasks);
+	memset(staging, 0, sizeof(*staging));
+}
+
+static int32_t add_header_task(struct header_staging *staging,
+                               uint32_t block,
+                               uint32_t off,
+                               uint32_t len,
+                               uint64_t tid,
+                               char *error) {
+	if(staging->ntasks == staging->tasks_capacity) {
+		uint32_t capacity = staging->tasks_capacity ? staging->tasks_capacity * 2 : 64;
+		struct header_task *tasks = realloc(staging->tasks, capacity * sizeof(*tasks));
+		if(tasks == NULL) {
+			return scap_errprintf(error, 0, "error allocating the header tasks");
+		}
+		staging->tasks = tasks;
+		staging->tasks_capacity = capacity;
+	}
+
+	struct header_task *task = &staging->tasks[staging->ntasks++];
+	memset(task, 0, sizeof(*task));
+	task->block = block;
+	task->off = off;
+	task->len = len;
+	task->tid = tid;
+	return SCAP_SUCCESS;
+}
+
+//
+// Read a process or fd list block in memory and split it in tasks
+//
+static int32_t scap_stage_list_block(scap_reader_t *r,
+                                     uint32_t block_length,
+                                     uint32_t block_type,
+                                     struct header_staging *staging,
+                                     char *error) {
+	size_t readsize;
+	uint32_t off = 0;
+	uint64_t tid = 0;
+	bool has_sub_len = block_type == PL_BLOCK_TYPE_V9 || block_type == FDL_BLOCK_TYPE_V2;
+
+	if(staging->nblocks == staging->blocks_capacity) {
+		uint32_t capacity = staging->blocks_capacity ? staging->blocks_capacity * 2 : 64;
+		struct header_block *blocks = realloc(staging->blocks, capacity * sizeof(*blocks));
+		if(blocks == NULL) {
+			return scap_errprintf(error, 0, "error allocating the header blocks");
+		}
+		staging->blocks = blocks;
+		staging->blocks_capacity = capacity;
+	}
+
+	uint8_t *data = malloc(block_length ? block_length : 1);
+	if(data == NULL) {
+		return scap_errprintf(error, 0, "error allocating a block of %u bytes", block_length);
+	}
+
+	readsize = r->read(r, data, block_length);
+	CHECK_READ_SIZE_WITH_FREE_ERR(data, readsize, block_length, error);
+
+	uint32_t block = staging->nblocks++;
+	staging->blocks[block].type = block_type;
+	staging->blocks[block].len = block_length;
+	staging->blocks[block].data = data;
+	staging->total_len += block_length;
+
+	if(is_fdlist_block(block_type)) {
+		if(block_length < sizeof(tid)) {
+			return scap_errprintf(error, 0, "fdlist block too short (%u bytes)", block_length);
+		}
+		memcpy(&tid, data, sizeof(tid));
+		off = sizeof(tid);
+	}
+
+	if(!has_sub_len) {
+		return add_header_task(staging, block, off, block_length - off, tid, error);
+	}
+
+	while(off < block_length) {
+		uint32_t start = off;
+		uint32_t nentries = 0;
+		while(nentries < HEADER_TASK_ENTRIES && block_length - off >= sizeof(uint32_t)) {
+			uint32_t sub_len;
+			memcpy(&sub_len, data + off, sizeof(sub_len));
+			if(sub_len < sizeof(uint32_t) || sub_len > block_length - off) {
+				// Leave the rest to the decoder, which reports the exact error.
+				off = block_length;
+				break;
+			}
+			off += sub_len;
+			nentries++;
+		}
+		if(block_length - off < sizeof(uint32_t)) {
+			// Only the padding is left, keep it with the last task.
+			off = block_length;
+		}
+
+		int32_t res = add_header_task(staging, block, start, off - start, tid, error);
+		if(res != SCAP_SUCCESS) {
+			return res;
+		}
+	}
+
+	return SCAP_SUCCESS;
+}
+
+static int32_t header_task_grow(struct header_task *task, bool fdlist) {
+	if(task->nentries < task->capacity) {
+		return SCAP_SUCCESS;
+	}
+
+	uint32_t capacity = task->capacity ? task->capacity * 2 : HEADER_TASK_ENTRIES;
+	if(fdlist) {
+		scap_fdinfo *fdinfos = realloc(task->fdinfos, capacity * sizeof(*fdinfos));
+		if(fdinfos == NULL) {
+			return scap_errprintf(task->error, 0, "error allocating the staged fds");
+		}
+		task->fdinfos = fdinfos;
+	} else {
+		scap_threadinfo *tinfos = realloc(task->tinfos, capacity * sizeof(*tinfos));
+		if(tinfos == NULL) {
+			return scap_errprintf(task->error, 0, "error allocating the staged threads");
+		}
+		task->tinfos = tinfos;
+	}
+	task->capacity = capacity;
+	return SCAP_SUCCESS;
+}
+
+static int32_t stage_proc_entry(void *context,
+                                char *error,
+                                int64_t tid,
+                                scap_threadinfo *tinfo,
+                                scap_fdinfo *fdinfo,
+                                scap_threadinfo **new_tinfo) {
+	struct header_task *task = (struct header_task *)context;
+	if(task->res != SCAP_SUCCESS) {
+		return task->res;
+	}
+	if((task->res = header_task_grow(task, false)) != SCAP_SUCCESS) {
+		return task->res;
+	}
+	task->tinfos[task->nentries++] = *tinfo;
+	return SCAP_SUCCESS;
+}
+
+static int32_t decode_fdlist_task(scap_reader_t *r,
+                                  struct header_task *task,
+                                  uint32_t block_type) {
+	size_t readsize;
+	size_t totreadsize = 0;
+
+	while(((int32_t)task->len - (int32_t)totreadsize) >= 4) {
+		if(header_task_grow(task, true) != SCAP_SUCCESS) {
+			return SCAP_FAILURE;
+		}
+		if(scap_fd_read_from_disk(&task->fdinfos[task->nentries],
+		                          &readsize,
+		                          block_type,
+		                          r,
+		                          task->error) != SCAP_SUCCESS) {
+			return SCAP_FAILURE;
+		}
+		totreadsize += readsize;
+		task->nentries++;
+	}
+
+	if(totreadsize > task->len) {
+		return scap_errprintf(task->error,
+		                      0,
+		                      "scap_read_fdlist read more %lu than a block %u",
+		                      totreadsize,
+		                      task->len);
+	}
+	return SCAP_SUCCESS;
+}
+
+static void decode_header_task(void *ctx, uint32_t idx) {
+	struct header_staging *staging = (struct header_staging *)ctx;
+	struct header_task *task = &staging->tasks[idx];
+	struct header_block *block = &staging->blocks[task->block];
+
+	scap_reader_t *r = scap_reader_open_memory(block->data + task->off, task->len);
+	if(r == NULL) {
+		task->res = scap_errprintf(task->error, 0, "error allocating the block reader");
+		return;
+	}
+
+	if(is_fdlist_block(block->type)) {
+		task->res = decode_fdlist_task(r, task, block->type);
+	} else {
+		struct scap_proclist staged = {0};
+		staged.m_callbacks.m_proc_entry_cb = stage_proc_entry;
+		staged.m_callbacks.m_callback_context = task;
+		int32_t res = scap_read_proclist(r, task->len, block->type, &staged, task->error);
+		if(task->res == SCAP_SUCCESS) {
+			task->res = res;
+		}
+	}
+
+	r->close(r);
+}
+
+//
+// Decode the staged blocks and feed their entries to the proc callbacks
+//
+static int32_t scap_load_staged_lists(struct header_staging *staging,
+                                      uint32_t workers,
+                                      bool auto_workers,
+                                      struct scap_proclist *proclist,
+                                      char *error) {
+	if(auto_workers) {
+		uint64_t max_workers = staging->total_len < HEADER_MIN_PARALLEL_BYTES
+		                               ? 1
+		                               : staging->total_len / HEADER_MIN_BYTES_PER_WORKER + 1;
+		if(workers > max_workers) {
+			workers = (uint32_t)max_workers;
+		}
+	}
+
+	// The same threads decode all the rounds.
+	savefile_workers *pool = savefile_workers_start(workers);
+	int32_t res = SCAP_SUCCESS;
+	uint32_t round_tasks = workers * HEADER_ROUND_TASKS_PER_WORKER;
+	for(uint32_t first = 0; first < staging->ntasks; first += round_tasks) {
+		struct header_staging round = *staging;
+		uint32_t ntasks = staging->ntasks - first;
+		if(ntasks > round_tasks) {
+			ntasks = round_tasks;
+		}
+		round.tasks = staging->tasks + first;
+		round.ntasks = ntasks;
+
+		savefile_workers_run(pool, ntasks, decode_header_task, &round);
+
+		for(uint32_t i = first; i < first + ntasks; i++) {
+			struct header_task *task = &staging->tasks[i];
+			for(uint32_t j = 0; j < task->nentries; j++) {
+				if(task->fdinfos) {
+					proclist->m_callbacks.m_proc_entry_cb(proclist->m_callbacks.m_callback_context,
+					                                      error,
+					                                      task->tid,
+					                                      NULL,
+					                                      &task->fdinfos[j],
+					                                      NULL);
+				} else {
+					proclist->m_callbacks.m_proc_entry_cb(proclist->m_callbacks.m_callback_context,
+					                                      error,
+					                                      task->tinfos[j].tid,
+					                                      &task->tinfos[j],
+					                                      NULL,
+					                                      NULL);
+				}
+			}
+
+			free(task->tinfos);
+			free(task->fdinfos);
+			task->tinfos = NULL;
+			task->fdinfos = NULL;
+
+			if(task->res != SCAP_SUCCESS) {
+				strlcpy(error, task->error, SCAP_LASTERR_SIZE);
+				res = task->res;
+				goto out;
+			}
+		}
+	}
+
+out:
+	savefile_workers_stop(pool);
+	return res;
+}
+
 #define MIN_BLOCK_SIZE ((sizeof(block_header) + sizeof(uint32_t)))
 #define MIN_SECTION_HEADER_SIZE (MIN_BLOCK_SIZE + sizeof(section_header_block))
 
@@ -1643,6 +1983,7 @@ static int32_t _scap_read_init(struct savefile_engine *handle,
                                struct scap_proclist *proclist_p,
                                scap_addrlist **addrlist_p,
                                scap_userlist **userlist_p,
+                               struct header_staging *staging,
                                char *error) {
 	block_header bh;
 	uint32_t bt;
@@ -1708,11 +2049,19 @@ static int32_t _scap_read_init(struct savefile_engine *handle,
 		case PL_BLOCK_TYPE_V2_INT:
 		case PL_BLOCK_TYPE_V3_INT:
 
-			if(scap_read_proclist(r,
-			                      bh.block_total_length - sizeof(block_header) - 4,
-			                      bh.block_type,
-			                      proclist_p,
-			                      error) != SCAP_SUCCESS) {
+			if(staging != NULL) {
+				if(scap_stage_list_block(r,
+				                         bh.block_total_length - sizeof(block_header) - 4,
+				                         bh.block_type,
+				                         staging,
+				                         error) != SCAP_SUCCESS) {
+					return SCAP_FAILURE;
+				}
+			} else if(scap_read_proclist(r,
+			                             bh.block_total_length - sizeof(block_header) - 4,
+			                             bh.block_type,
+			                             proclist_p,
+			                             error) != SCAP_SUCCESS) {
 				return SCAP_FAILURE;
 			}
 			break;
@@ -1720,11 +2069,19 @@ static int32_t _scap_read_init(struct savefile_engine *handle,
 		case FDL_BLOCK_TYPE_INT:
 		case FDL_BLOCK_TYPE_V2:
 
-			if(scap_read_fdlist(r,
-			                    bh.block_total_length - sizeof(block_header) - 4,
-			                    bh.block_type,
-			                    proclist_p,
-			                    error) != SCAP_SUCCESS) {
+			if(staging != NULL) {
+				if(scap_stage_list_block(r,
+				                         bh.block_total_length - sizeof(block_header) - 4,
+				                         bh.block_type,
+				                         staging,
+				                         error) != SCAP_SUCCESS) {
+					return SCAP_FAILURE;
+				}
+			} else if(scap_read_fdlist(r,
+			                           bh.block_total_length - sizeof(block_header) - 4,
+			                           bh.block_type,
+			                           proclist_p,
+			                           error) != SCAP_SUCCESS) {
 				return SCAP_FAILURE;
 			}
 			break;
@@ -1820,9 +2177,27 @@ static int32_t scap_read_init(struct savefile_engine *handle,
                               scap_addrlist **addrlist_p,
                               scap_userlist **userlist_p,
                               char *error) {
+	struct header_staging staging = {0};
+	uint32_t workers =
+	        handle->m_header_workers ? handle->m_header_workers : savefile_default_workers();
+
 	proclist_p->m_callbacks.m_refresh_start_cb(proclist_p->m_callbacks.m_callback_context);
-	int32_t rc =
-	        _scap_read_init(handle, r, machine_info_p, proclist_p, addrlist_p, userlist_p, error);
+	int32_t rc = _scap_read_init(handle,
+	                             r,
+	                             machine_info_p,
+	                             proclist_p,
+	                             addrlist_p,
+	                             userlist_p,
+	                             workers > 1 ? &staging : NULL,
+	                             error);
+	if(rc == SCAP_SUCCESS && staging.ntasks > 0) {
+		rc = scap_load_staged_lists(&staging,
+		                            workers,
+		                            handle->m_header_workers == 0,
+		                            proclist_p,
+		                            error);
+	}
+	free_header_staging(&staging);
 	proclist_p->m_callbacks.m_refresh_end_cb(proclist_p->m_callbacks.m_callback_context);
 	return rc;
 }
@@ -2081,19 +2456,21 @@ static int32_t next(struct scap_engine_handle engine,
 		handle->m_to_convert_evt = calloc(1, MAX_EVENT_SIZE);
 	}
 
-	// Start the conversion loop.
+	// Start the conversion loop. The first conversion reads the event straight from the read
+	// buffer, then the two conversion buffers are swapped at each step, so that the output of a
+	// conversion becomes the input of the next one without copying it.
 	int conv_num = 0;
+	char *out_evt = handle->m_new_evt;
 	conv_res = CONVERSION_CONTINUE;
 	for(conv_num = 0; conv_num < MAX_CONVERSION_BOUNDARY && conv_res == CONVERSION_CONTINUE;
 	    conv_num++) {
-		// Before each conversion we move the current event into the storage.
-		memcpy(handle->m_to_convert_evt, *pevent, (*pevent)->len);
 		conv_res = scap_convert_event(handle->m_converter_buf,
-		                              (scap_evt *)handle->m_new_evt,
-		                              (scap_evt *)handle->m_to_convert_evt,
+		                              (scap_evt *)out_evt,
+		                              *pevent,
 		                              handle->m_lasterr);
 		// At the end of the conversion in any case we switch to the new event pointer.
-		*pevent = (scap_evt *)handle->m_new_evt;
+		*pevent = (scap_evt *)out_evt;
+		out_evt = out_evt == handle->m_new_evt ? handle->m_to_convert_evt : handle->m_new_evt;
 	}
 
 	if(conv_res == CONVERSION_ERROR) {
@@ -2237,6 +2614,7 @@ static int32_t init(struct scap *main_handle, struct scap_open_args *oargs) {
 
 	struct scap_platform *platform = params->platform;
 	handle->m_platform = params->platform;
+	handle->m_header_workers = params->header_workers;
 
 	if(fd != 0) {
 		gzfile = gzdopen(fd, "rb");
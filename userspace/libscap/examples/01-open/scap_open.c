@@ -42,6 +42,7 @@ limitations under the License.
 #define SIMPLE_SET_OPTION "--simple_set"
 #define CPUS_FOR_EACH_BUFFER_MODE "--cpus_for_buf"
 #define ALL_AVAILABLE_CPUS_MODE "--available_cpus"
+#define SHARED_PROBE_OPTION "--shared_probe"
 #define DROP_FAILED "--drop-failed"
 #define VERBOSE_OPTION "--verbose"
 
@@ -288,6 +289,8 @@ void print_help() {
 	printf("'%s': allocate ring buffers for all available CPUs. Default: allocate ring buffers for "
 	       "online CPUs only.\n",
 	       ALL_AVAILABLE_CPUS_MODE);
+	printf("'%s <bpffs_dir>': share the probe with the other instances using the same directory.\n",
+	       SHARED_PROBE_OPTION);
 	printf("'%s': instrument drivers to drop failed syscalls (exit) events.\n", DROP_FAILED);
 	printf("'%s <level>': print all available logs. Default level is WARNING (4)\n",
 	       VERBOSE_OPTION);
@@ -445,6 +448,14 @@ void parse_CLI_options(int argc, char** argv) {
 		if(!strcmp(argv[i], ALL_AVAILABLE_CPUS_MODE)) {
 			modern_bpf_params.allocate_online_only = false;
 		}
+		/* This should be used only with the modern probe */
+		if(!strcmp(argv[i], SHARED_PROBE_OPTION)) {
+			if(!(i + 1 < argc)) {
+				printf("\nYou need to specify also the bpffs directory. Bye!\n");
+				exit(EXIT_FAILURE);
+			}
+			modern_bpf_params.shared_probe_path = argv[++i];
+		}
 
 		if(!strcmp(argv[i], DROP_FAILED)) {
 			drop_failed = true;
@@ -29,6 +29,7 @@ limitations under the License.
 #include <mntent.h>
 #include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
 #include <unistd.h>
@@ -40,6 +41,17 @@ struct scap_cgroup_cache {
 	UT_hash_handle hh;
 };
 
+// Upper bound of the cgroup id cache: when it's full, the least recently used entry is dropped.
+#define SCAP_CGROUP_ID_CACHE_MAX 1024
+
+// The entries are kept in the hash table in least recently used first order
+struct scap_cgroup_id_cache {
+	uint64_t id;
+	struct scap_cgroup_set cgroups;
+
+	UT_hash_handle hh;
+};
+
 static int32_t __attribute__((format(printf, 2, 3)))
 scap_cgroup_printf(struct scap_cgroup_set* cgset, const char* fmt, ...) {
 	va_list va;
@@ -63,6 +75,110 @@ scap_cgroup_printf(struct scap_cgroup_set* cgset, const char* fmt, ...) {
 	return SCAP_SUCCESS;
 }
 
+// Append all the entries of `src` to `dst`
+static int32_t scap_cgroup_set_append(struct scap_cgroup_set* dst,
+                                      const struct scap_cgroup_set* src) {
+	if(dst->len + src->len > SCAP_MAX_CGROUPS_SIZE) {
+		return SCAP_FAILURE;
+	}
+
+	memcpy(dst->path + dst->len, src->path, src->len);
+	dst->len += src->len;
+	return SCAP_SUCCESS;
+}
+
+static void scap_cgroup_id_cache_init(struct scap_cgroup_interface* cgi) {
+	cgi->m_id_cache = NULL;
+	cgi->m_id_cache_size = 0;
+	pthread_mutex_init(&cgi->m_id_cache_mutex, NULL);
+	cgi->m_use_id_cache = true;
+}
+
+static void scap_cgroup_id_cache_del(struct scap_cgroup_interface* cgi,
+                                     struct scap_cgroup_id_cache* cached) {
+	HASH_DEL(cgi->m_id_cache, cached);
+	free(cached);
+	cgi->m_id_cache_size--;
+}
+
+// Drop the least recently used entries until there's room for a new one. Cgroup ids are never
+// reused, so the entries of the removed cgroups are the first to go once they stop being used.
+//
+// Must be called with `m_id_cache_mutex` held
+static void scap_cgroup_id_cache_evict(struct scap_cgroup_interface* cgi) {
+	while(cgi->m_id_cache != NULL && cgi->m_id_cache_size >= SCAP_CGROUP_ID_CACHE_MAX) {
+		scap_cgroup_id_cache_del(cgi, cgi->m_id_cache);
+	}
+}
+
+// Move `cached` to the end of the hash table, i.e. make it the most recently used entry
+//
+// Must be called with `m_id_cache_mutex` held
+static void scap_cgroup_id_cache_touch(struct scap_cgroup_interface* cgi,
+                                       struct scap_cgroup_id_cache* cached) {
+	if(cached->hh.next == NULL) {
+		return;
+	}
+
+	HASH_DEL(cgi->m_id_cache, cached);
+	int uth_status = SCAP_SUCCESS;
+	HASH_ADD_INT64(cgi->m_id_cache, id, cached);
+	if(uth_status != SCAP_SUCCESS) {
+		free(cached);
+		cgi->m_id_cache_size--;
+	}
+}
+
+static bool scap_cgroup_id_cache_get(struct scap_cgroup_interface* cgi,
+                                     uint64_t id,
+                                     struct scap_cgroup_set* cg) {
+	bool found = false;
+
+	pthread_mutex_lock(&cgi->m_id_cache_mutex);
+	struct scap_cgroup_id_cache* cached;
+	HASH_FIND_INT64(cgi->m_id_cache, &id, cached);
+	if(cached != NULL) {
+		found = scap_cgroup_set_append(cg, &cached->cgroups) == SCAP_SUCCESS;
+		scap_cgroup_id_cache_touch(cgi, cached);
+	}
+	pthread_mutex_unlock(&cgi->m_id_cache_mutex);
+
+	return found;
+}
+
+static void scap_cgroup_id_cache_put(struct scap_cgroup_interface* cgi,
+                                     uint64_t id,
+                                     const struct scap_cgroup_set* cgroups) {
+	struct scap_cgroup_id_cache* cached = (struct scap_cgroup_id_cache*)malloc(sizeof(*cached));
+	if(cached == NULL) {
+		return;
+	}
+
+	cached->id = id;
+	memcpy(&cached->cgroups, cgroups, sizeof(cached->cgroups));
+
+	pthread_mutex_lock(&cgi->m_id_cache_mutex);
+	struct scap_cgroup_id_cache* existing;
+	HASH_FIND_INT64(cgi->m_id_cache, &id, existing);
+	if(existing != NULL) {
+		// another thread resolved the same cgroup in the meantime
+		pthread_mutex_unlock(&cgi->m_id_cache_mutex);
+		free(cached);
+		return;
+	}
+
+	scap_cgroup_id_cache_evict(cgi);
+
+	int uth_status = SCAP_SUCCESS;
+	HASH_ADD_INT64(cgi->m_id_cache, id, cached);
+	if(uth_status == SCAP_SUCCESS) {
+		cgi->m_id_cache_size++;
+	} else {
+		free(cached);
+	}
+	pthread_mutex_unlock(&cgi->m_id_cache_mutex);
+}
+
 static int32_t scap_grep_cgroups(char* path, char* path_end, const char* pid_str) {
 	char line[SCAP_MAX_PATH_SIZE];
 
@@ -604,6 +720,7 @@ int32_t scap_cgroup_interface_init(struct scap_cgroup_interface* cgi,
 
 	cgi->m_use_cache = true;
 	cgi->m_cache = NULL;
+	scap_cgroup_id_cache_init(cgi);
 	cgi->m_subsystems_v1.len = 0;
 	cgi->m_subsystems_v2.len = 0;
 	cgi->m_mounts_v1.len = 0;
@@ -755,6 +872,9 @@ static bool scap_cgroup_set_contains_all(const struct scap_cgroup_set* larger,
 //
 // We walk the tree upwards until we either reach the cgroup mount point, or we find all the
 // subsystems
+//
+// As all the threads of a cgroup share the result, it's kept in the id cache, so that only the
+// first thread of each cgroup pays for the walk
 static int32_t scap_cgroup_resolve_v2(struct scap_cgroup_interface* cgi,
                                       const char* cgroup,
                                       struct scap_cgroup_set* cg) {
@@ -789,6 +909,20 @@ static int32_t scap_cgroup_resolve_v2(struct scap_cgroup_interface* cgi,
 		return SCAP_FAILURE;
 	}
 
+	uint64_t cgroup_id = 0;
+	if(cgi->m_use_id_cache) {
+		struct stat s;
+		if(stat(cgroup_path, &s) == 0) {
+			cgroup_id = s.st_ino;
+		}
+
+		if(cgroup_id != 0 && scap_cgroup_id_cache_get(cgi, cgroup_id, cg)) {
+			return SCAP_SUCCESS;
+		}
+	}
+
+	// the entries are collected apart, to be cached without the v1 ones already in `cg`
+	struct scap_cgroup_set resolved = {.len = 0, .path = {'\0'}};
 	struct scap_cgroup_set found_subsystems = {.len = 0, .path = {'\0'}};
 	while(1)  // not reached cgroup mountpoint yet
 	{
@@ -799,7 +933,8 @@ static int32_t scap_cgroup_resolve_v2(struct scap_cgroup_interface* cgi,
 
 		FOR_EACH_SUBSYS(&current_subsystems, cgset_subsys) {
 			if(!scap_cgroup_find_subsys(&found_subsystems, cgset_subsys)) {
-				if(scap_cgroup_printf(cg, "%s=%s", cgset_subsys, full_cgroup) != SCAP_SUCCESS) {
+				if(scap_cgroup_printf(&resolved, "%s=%s", cgset_subsys, full_cgroup) !=
+				   SCAP_SUCCESS) {
 					return SCAP_FAILURE;
 				}
 				if(scap_cgroup_printf(&found_subsystems, "%s", cgset_subsys) != SCAP_SUCCESS) {
@@ -834,7 +969,11 @@ static int32_t scap_cgroup_resolve_v2(struct scap_cgroup_interface* cgi,
 		ASSERT(q);
 		*q = 0;
 	}
-	return SCAP_SUCCESS;
+
+	if(cgroup_id != 0) {
+		scap_cgroup_id_cache_put(cgi, cgroup_id, &resolved);
+	}
+	return scap_cgroup_set_append(cg, &resolved);
 }
 
 // Get all cgroups (v1 and v2) for a thread whose /proc directory is `procdirname`
@@ -1025,3 +1164,20 @@ void scap_cgroup_enable_cache(struct scap_cgroup_interface* cgi) {
 	scap_cgroup_clear_cache(cgi);
 	cgi->m_use_cache = true;
 }
+
+void scap_cgroup_interface_close(struct scap_cgroup_interface* cgi) {
+	scap_cgroup_clear_cache(cgi);
+
+	if(!cgi->m_use_id_cache) {
+		return;
+	}
+
+	struct scap_cgroup_id_cache* cached;
+	struct scap_cgroup_id_cache* tcached;
+	HASH_ITER(hh, cgi->m_id_cache, cached, tcached) {
+		scap_cgroup_id_cache_del(cgi, cached);
+	}
+
+	pthread_mutex_destroy(&cgi->m_id_cache_mutex);
+	cgi->m_use_id_cache = false;
+}
@@ -18,6 +18,7 @@ limitations under the License.
 
 #pragma once
 
+#include <pthread.h>
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -32,6 +33,7 @@ limitations under the License.
 extern "C" {
 #endif
 struct scap_cgroup_cache;
+struct scap_cgroup_id_cache;
 struct scap_threadinfo;
 
 struct scap_cgroup_interface {
@@ -46,6 +48,13 @@ struct scap_cgroup_interface {
 	bool m_use_cache;
 	struct scap_cgroup_cache* m_cache;
 
+	// resolved v2 cgroups, keyed by cgroup id (i.e. the inode of the cgroup directory),
+	// kept for the whole life of the interface and shared by all the threads reading /proc
+	bool m_use_id_cache;
+	struct scap_cgroup_id_cache* m_id_cache;
+	uint32_t m_id_cache_size;
+	pthread_mutex_t m_id_cache_mutex;
+
 	// the cgroups of the current process, as seen from the host cgroupns
 	// empty if:
 	// - we're not running in a cgroupns
@@ -76,6 +85,8 @@ const char* scap_cgroup_get_subsys_mount(const struct scap_cgroup_interface* cgi
 void scap_cgroup_enable_cache(struct scap_cgroup_interface* cgi);
 
 void scap_cgroup_clear_cache(struct scap_cgroup_interface* cgi);
+
+void scap_cgroup_interface_close(struct scap_cgroup_interface* cgi);
 #ifdef __cplusplus
 };
 #endif
@@ -42,6 +42,8 @@ limitations under the License.
 #include <string.h>
 
 #include <errno.h>
+#include <pthread.h>
+#include <sched.h>
 #include <netinet/tcp.h>
 #if HAVE_SYS_MKDEV_H
 #include <sys/mkdev.h>
@@ -51,8 +53,9 @@ limitations under the License.
 #endif
 #include <linux/netlink.h>
 #include <linux/rtnetlink.h>
-// #include <linux/sock_diag.h>
-// #include <linux/unix_diag.h>
+#include <linux/sock_diag.h>
+#include <linux/inet_diag.h>
+#include <linux/netlink_diag.h>
 #include <libscap/linux/str_helpers.h>
 #include <libscap/linux/read_helpers.h>
 
@@ -619,6 +622,47 @@ static bool scan_ipv4_socket_table_address(char **str, uint32_t *ip_out, uint16_
 	return true;
 }
 
+// Insert into `sockets` an IPv4 socket, either connected or listening depending on `dip`. Addresses
+// are in network byte order, ports in host byte order.
+static int32_t add_ipv4_socket(scap_fdinfo **sockets,
+                               const uint64_t ino,
+                               const uint32_t sip,
+                               const uint16_t sport,
+                               const uint32_t dip,
+                               const uint16_t dport,
+                               const int l4proto,
+                               char *error) {
+	// Allocate fdinfo and populate its fields.
+	scap_fdinfo *fdinfo = malloc(sizeof(scap_fdinfo));
+	if(fdinfo == NULL) {
+		return scap_errprintf(error, errno, "memory allocation error in add_ipv4_socket()");
+	}
+
+	fdinfo->ino = ino;
+	if(dip != 0) {
+		fdinfo->type = SCAP_FD_IPV4_SOCK;
+		fdinfo->info.ipv4info.sip = sip;
+		fdinfo->info.ipv4info.dip = dip;
+		fdinfo->info.ipv4info.sport = sport;
+		fdinfo->info.ipv4info.dport = dport;
+		fdinfo->info.ipv4info.l4proto = l4proto;
+	} else {
+		fdinfo->type = SCAP_FD_IPV4_SERVSOCK;
+		fdinfo->info.ipv4serverinfo.ip = sip;
+		fdinfo->info.ipv4serverinfo.port = sport;
+		fdinfo->info.ipv4serverinfo.l4proto = l4proto;
+	}
+
+	// Add to the table.
+	int32_t uth_status = SCAP_SUCCESS;
+	HASH_ADD_INT64((*sockets), ino, fdinfo);
+	if(uth_status != SCAP_SUCCESS) {
+		free(fdinfo);
+		return scap_errprintf(error, 0, "IPv4 socket allocation error");
+	}
+	return SCAP_SUCCESS;
+}
+
 // Parse a single IPv4 socket table line and insert the obtained fdinfo into `sockets`. Return
 // `SCAP_SUCCESS` if it can correctly parse the line or encounters a recoverable error (e.g.: the
 // line could be simply skipped); return `SCAP_FAILURE` otherwise.
@@ -657,37 +701,7 @@ static int32_t parse_ipv4_socket_table_line(const char *const line_start,
 		return SCAP_SUCCESS;
 	}
 
-	// Allocate fdinfo and populate its fields.
-	scap_fdinfo *fdinfo = malloc(sizeof(scap_fdinfo));
-	if(fdinfo == NULL) {
-		return scap_errprintf(error,
-		                      errno,
-		                      "memory allocation error in parse_ipv4_socket_table_line()");
-	}
-
-	fdinfo->ino = ino;
-	if(dip != 0) {
-		fdinfo->type = SCAP_FD_IPV4_SOCK;
-		fdinfo->info.ipv4info.sip = sip;
-		fdinfo->info.ipv4info.dip = dip;
-		fdinfo->info.ipv4info.sport = sport;
-		fdinfo->info.ipv4info.dport = dport;
-		fdinfo->info.ipv4info.l4proto = l4proto;
-	} else {
-		fdinfo->type = SCAP_FD_IPV4_SERVSOCK;
-		fdinfo->info.ipv4serverinfo.ip = sip;
-		fdinfo->info.ipv4serverinfo.port = sport;
-		fdinfo->info.ipv4serverinfo.l4proto = l4proto;
-	}
-
-	// Add to the table.
-	int32_t uth_status = SCAP_SUCCESS;
-	HASH_ADD_INT64((*sockets), ino, fdinfo);
-	if(uth_status != SCAP_SUCCESS) {
-		free(fdinfo);
-		return scap_errprintf(error, 0, "IPv4 socket allocation error");
-	}
-	return SCAP_SUCCESS;
+	return add_ipv4_socket(sockets, ino, sip, sport, dip, dport, l4proto, error);
 }
 
 // Convert a single hex char to 0-15. `c` must be a valid hex char (i.e.: '0'-'9','a'-'f','A'-'F').
@@ -742,6 +756,47 @@ int32_t scap_fd_is_ipv6_server_socket(uint32_t ip6_addr[4]) {
 	return 0 == ip6_addr[0] && 0 == ip6_addr[1] && 0 == ip6_addr[2] && 0 == ip6_addr[3];
 }
 
+// Insert into `sockets` an IPv6 socket, either connected or listening depending on `dip`. Addresses
+// are in network byte order, ports in host byte order.
+static int32_t add_ipv6_socket(scap_fdinfo **sockets,
+                               const uint64_t ino,
+                               const uint32_t sip[4],
+                               const uint16_t sport,
+                               const uint32_t dip[4],
+                               const uint16_t dport,
+                               const int l4proto,
+                               char *error) {
+	// Allocate fdinfo and populate its fields.
+	scap_fdinfo *fdinfo = malloc(sizeof(scap_fdinfo));
+	if(fdinfo == NULL) {
+		return scap_errprintf(error, errno, "memory allocation error in add_ipv6_socket()");
+	}
+
+	fdinfo->ino = ino;
+	if(!scap_fd_is_ipv6_server_socket((uint32_t *)dip)) {
+		fdinfo->type = SCAP_FD_IPV6_SOCK;
+		memcpy(&fdinfo->info.ipv6info.sip, sip, sizeof(fdinfo->info.ipv6info.sip));
+		memcpy(&fdinfo->info.ipv6info.dip, dip, sizeof(fdinfo->info.ipv6info.dip));
+		fdinfo->info.ipv6info.sport = sport;
+		fdinfo->info.ipv6info.dport = dport;
+		fdinfo->info.ipv6info.l4proto = l4proto;
+	} else {
+		fdinfo->type = SCAP_FD_IPV6_SERVSOCK;
+		memcpy(fdinfo->info.ipv6serverinfo.ip, sip, sizeof(fdinfo->info.ipv6serverinfo.ip));
+		fdinfo->info.ipv6serverinfo.port = sport;
+		fdinfo->info.ipv6serverinfo.l4proto = l4proto;
+	}
+
+	// Add to the table.
+	int32_t uth_status = SCAP_SUCCESS;
+	HASH_ADD_INT64((*sockets), ino, fdinfo);
+	if(uth_status != SCAP_SUCCESS) {
+		free(fdinfo);
+		return scap_errprintf(error, 0, "IPv6 socket allocation error");
+	}
+	return SCAP_SUCCESS;
+}
+
 // Parse a single IPv6 socket table line and insert the obtained fdinfo into `sockets`. Return
 // `SCAP_SUCCESS` if it can correctly parse the line or encounters a recoverable error (e.g.: the
 // line could be simply skipped); return `SCAP_FAILURE` otherwise.
@@ -780,37 +835,7 @@ static int32_t parse_ipv6_socket_table_line(const char *const line_start,
 		return SCAP_SUCCESS;
 	}
 
-	// Allocate fdinfo and populate its fields.
-	scap_fdinfo *fdinfo = malloc(sizeof(scap_fdinfo));
-	if(fdinfo == NULL) {
-		return scap_errprintf(error,
-		                      errno,
-		                      "memory allocation error in parse_ipv6_socket_table_line()");
-	}
-
-	fdinfo->ino = ino;
-	if(!scap_fd_is_ipv6_server_socket(dip)) {
-		fdinfo->type = SCAP_FD_IPV6_SOCK;
-		memcpy(&fdinfo->info.ipv6info.sip, sip, sizeof(fdinfo->info.ipv6info.sip));
-		memcpy(&fdinfo->info.ipv6info.dip, dip, sizeof(fdinfo->info.ipv6info.dip));
-		fdinfo->info.ipv6info.sport = sport;
-		fdinfo->info.ipv6info.dport = dport;
-		fdinfo->info.ipv6info.l4proto = l4proto;
-	} else {
-		fdinfo->type = SCAP_FD_IPV6_SERVSOCK;
-		memcpy(fdinfo->info.ipv6serverinfo.ip, sip, sizeof(fdinfo->info.ipv6serverinfo.ip));
-		fdinfo->info.ipv6serverinfo.port = sport;
-		fdinfo->info.ipv6serverinfo.l4proto = l4proto;
-	}
-
-	// Add to the table.
-	int32_t uth_status = SCAP_SUCCESS;
-	HASH_ADD_INT64((*sockets), ino, fdinfo);
-	if(uth_status != SCAP_SUCCESS) {
-		free(fdinfo);
-		return scap_errprintf(error, 0, "IPv6 socket allocation error");
-	}
-	return SCAP_SUCCESS;
+	return add_ipv6_socket(sockets, ino, sip, sport, dip, dport, l4proto, error);
 }
 
 // Parse a single unix socket table line and insert the obtained fdinfo into `sockets`. Return
@@ -877,6 +902,29 @@ static int32_t parse_unix_socket_table_line(const char *const line_start,
 	return SCAP_SUCCESS;
 }
 
+// Insert into `sockets` a netlink socket.
+static int32_t add_netlink_socket(scap_fdinfo **sockets, const uint64_t ino, char *error) {
+	// Allocate fdinfo and populate its fields.
+	// note(ekoops): not sure why, but the original caller called memset on the fdinfo, so I'm gonna
+	// call `calloc()` instead of `malloc()` here.
+	scap_fdinfo *fdinfo = calloc(1, sizeof(scap_fdinfo));
+	if(fdinfo == NULL) {
+		return scap_errprintf(error, errno, "memory allocation error in add_netlink_socket()");
+	}
+
+	fdinfo->type = SCAP_FD_NETLINK;
+	fdinfo->ino = ino;
+
+	// Add to the table.
+	int32_t uth_status = SCAP_SUCCESS;
+	HASH_ADD_INT64((*sockets), ino, fdinfo);
+	if(uth_status != SCAP_SUCCESS) {
+		free(fdinfo);
+		return scap_errprintf(error, 0, "netlink socket allocation error");
+	}
+	return SCAP_SUCCESS;
+}
+
 // Parse a single netlink socket table line and insert the obtained fdinfo into `sockets`. Return
 // `SCAP_SUCCESS` if it can correctly parse the line or encounters a recoverable error (e.g.: the
 // line could be simply skipped); return `SCAP_FAILURE` otherwise.
@@ -906,27 +954,7 @@ static int32_t parse_netlink_socket_table_line(const char *const line_start,
 		return SCAP_SUCCESS;
 	}
 
-	// Allocate fdinfo and populate its fields.
-	// note(ekoops): not sure why, but the original caller called memset on the fdinfo, so I'm gonna
-	// call `calloc()` instead of `malloc()` here.
-	scap_fdinfo *fdinfo = calloc(1, sizeof(scap_fdinfo));
-	if(fdinfo == NULL) {
-		return scap_errprintf(error,
-		                      errno,
-		                      "memory allocation error in parse_netlink_socket_table_line()");
-	}
-
-	fdinfo->type = SCAP_FD_NETLINK;
-	fdinfo->ino = ino;
-
-	// Add to the table.
-	int32_t uth_status = SCAP_SUCCESS;
-	HASH_ADD_INT64((*sockets), ino, fdinfo);
-	if(uth_status != SCAP_SUCCESS) {
-		free(fdinfo);
-		return scap_errprintf(error, 0, "netlink socket allocation error");
-	}
-	return SCAP_SUCCESS;
+	return add_netlink_socket(sockets, ino, error);
 }
 
 static int32_t parse_procfs_proc_pid_socket_table_file_impl(const int fd,
@@ -1073,34 +1101,261 @@ static int32_t parse_procfs_proc_pid_socket_table_file(const char *filename,
 	return res;
 }
 
-int32_t scap_fd_read_sockets_impl(char *procdir, struct scap_ns_socket_list *sockets, char *error) {
-	char filename[SCAP_MAX_PATH_SIZE];
-	char netroot[SCAP_MAX_PATH_SIZE];
-	char err_buf[SCAP_LASTERR_SIZE];
+struct sock_diag_open_args {
+	int target_ns;
+	int fd;
+};
 
-	if(sockets->net_ns) {
-		// Namespace support, look in /proc/PID/net/.
-		snprintf(netroot, sizeof(netroot), "%snet/", procdir);
-	} else {
-		// No namespace support, look in the base /proc/net/.
-		snprintf(netroot, sizeof(netroot), "%s/proc/net/", scap_get_host_root());
+// Runs on a helper thread: the namespace a thread enters with setns() is left behind when the
+// thread exits, so the scanning thread never has to switch back, which could fail.
+static void *sock_diag_open_in_ns(void *arg) {
+	struct sock_diag_open_args *args = arg;
+	// A socket stays in the namespace it was created in.
+	if(setns(args->target_ns, CLONE_NEWNET) == 0) {
+		args->fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_SOCK_DIAG);
+	}
+	return NULL;
+}
+
+// Open a NETLINK_SOCK_DIAG socket in the network namespace of the process at `procdir`, or in the
+// current one if `net_ns` is 0. Return -1 if the socket can't be opened, e.g. because we are not
+// allowed to enter the namespace.
+static int sock_diag_open(const char *procdir, const uint64_t net_ns) {
+	struct stat self_sb;
+	if(net_ns == 0 ||
+	   (stat("/proc/thread-self/ns/net", &self_sb) == 0 && self_sb.st_ino == net_ns)) {
+		return socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_SOCK_DIAG);
+	}
+
+	char ns_path[SCAP_MAX_PATH_SIZE];
+	snprintf(ns_path, sizeof(ns_path), "%sns/net", procdir);
+	struct sock_diag_open_args args = {
+	        .target_ns = open(ns_path, O_RDONLY | O_CLOEXEC),
+	        .fd = -1,
+	};
+	if(args.target_ns < 0) {
+		return -1;
 	}
 
+	pthread_t helper;
+	if(pthread_create(&helper, NULL, sock_diag_open_in_ns, &args) == 0) {
+		pthread_join(helper, NULL);
+	}
+	close(args.target_ns);
+	return args.fd;
+}
+
+typedef int32_t (*sock_diag_parse_fn)(const struct nlmsghdr *msg,
+                                      scap_fdinfo **sockets,
+                                      const int l4proto,
+                                      char *error);
+
+static int32_t parse_inet_diag_msg(const struct nlmsghdr *msg,
+                                   scap_fdinfo **sockets,
+                                   const int l4proto,
+                                   char *error) {
+	if(msg->nlmsg_len < NLMSG_LENGTH(sizeof(struct inet_diag_msg))) {
+		return SCAP_SUCCESS;
+	}
+
+	const struct inet_diag_msg *diag = NLMSG_DATA(msg);
+	// Time-wait and request sockets don't have an inode, so no fd can refer to them.
+	if(diag->idiag_inode == 0) {
+		return SCAP_SUCCESS;
+	}
+
+	const uint16_t sport = ntohs(diag->id.idiag_sport);
+	const uint16_t dport = ntohs(diag->id.idiag_dport);
+	if(diag->idiag_family == AF_INET) {
+		return add_ipv4_socket(sockets,
+		                       diag->idiag_inode,
+		                       diag->id.idiag_src[0],
+		                       sport,
+		                       diag->id.idiag_dst[0],
+		                       dport,
+		                       l4proto,
+		                       error);
+	}
+	return add_ipv6_socket(sockets,
+	                       diag->idiag_inode,
+	                       diag->id.idiag_src,
+	                       sport,
+	                       diag->id.idiag_dst,
+	                       dport,
+	                       l4proto,
+	                       error);
+}
+
+static int32_t parse_netlink_diag_msg(const struct nlmsghdr *msg,
+                                      scap_fdinfo **sockets,
+                                      const int l4proto,
+                                      char *error) {
+	if(msg->nlmsg_len < NLMSG_LENGTH(sizeof(struct netlink_diag_msg))) {
+		return SCAP_SUCCESS;
+	}
+
+	const struct netlink_diag_msg *diag = NLMSG_DATA(msg);
+	return add_netlink_socket(sockets, diag->ndiag_ino, error);
+}
+
+// Send the dump request `req` on the sock_diag socket `fd` and insert into `sockets` every socket
+// returned by the kernel. Return `SCAP_NOT_SUPPORTED` if the kernel refuses the request before
+// sending any socket (e.g.: the diag module of the protocol is not available), so that the caller
+// can fall back to the socket table files.
+static int32_t sock_diag_dump(const int fd,
+                              const struct nlmsghdr *req,
+                              const sock_diag_parse_fn parse,
+                              scap_fdinfo **sockets,
+                              const int l4proto,
+                              char *error) {
+	struct sockaddr_nl kernel = {.nl_family = AF_NETLINK};
+	if(sendto(fd, req, req->nlmsg_len, 0, (struct sockaddr *)&kernel, sizeof(kernel)) < 0) {
+		return SCAP_NOT_SUPPORTED;
+	}
+
+	// note: every reply carries tens of sockets, the buffer has the same size used for reading
+	// the socket table files.
+	uint64_t buff[32 * 1024 / sizeof(uint64_t)];
+	bool received = false;
+	while(1) {
+		ssize_t len = recv(fd, buff, sizeof(buff), 0);
+		if(len < 0) {
+			if(errno == EINTR) {  // Re-attempt upon signal.
+				continue;
+			}
+			if(!received) {
+				return SCAP_NOT_SUPPORTED;
+			}
+			return scap_errprintf(error, errno, "can't receive the sock_diag dump");
+		}
+		if(len == 0) {
+			return SCAP_SUCCESS;
+		}
+
+		for(const struct nlmsghdr *msg = (struct nlmsghdr *)buff; NLMSG_OK(msg, len);
+		    msg = NLMSG_NEXT(msg, len)) {
+			if(msg->nlmsg_type == NLMSG_DONE) {
+				return SCAP_SUCCESS;
+			}
+			if(msg->nlmsg_type == NLMSG_ERROR) {
+				if(!received) {
+					return SCAP_NOT_SUPPORTED;
+				}
+				const struct nlmsgerr *err = NLMSG_DATA(msg);
+				return scap_errprintf(error, -err->error, "sock_diag dump interrupted");
+			}
+			received = true;
+			if(msg->nlmsg_type != SOCK_DIAG_BY_FAMILY) {
+				continue;
+			}
+			const int32_t res = parse(msg, sockets, l4proto, error);
+			if(res != SCAP_SUCCESS) {
+				return res;
+			}
+		}
+	}
+}
+
+static int32_t sock_diag_dump_inet(const int fd,
+                                   const int socket_domain,
+                                   const int l4proto,
+                                   scap_fdinfo **sockets,
+                                   char *error) {
+	struct {
+		struct nlmsghdr nlh;
+		struct inet_diag_req_v2 req;
+	} req = {
+	        .nlh =
+	                {
+	                        .nlmsg_len = sizeof(req),
+	                        .nlmsg_type = SOCK_DIAG_BY_FAMILY,
+	                        .nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP,
+	                },
+	        .req =
+	                {
+	                        .sdiag_family = socket_domain,
+	                        .sdiag_protocol = l4proto == SCAP_L4_TCP ? IPPROTO_TCP : IPPROTO_UDP,
+	                        // Same as the socket table files, which list sockets in any state.
+	                        .idiag_states = ~0U,
+	                },
+	};
+	return sock_diag_dump(fd, &req.nlh, parse_inet_diag_msg, sockets, l4proto, error);
+}
+
+static int32_t sock_diag_dump_netlink(const int fd, scap_fdinfo **sockets, char *error) {
+	struct {
+		struct nlmsghdr nlh;
+		struct netlink_diag_req req;
+	} req = {
+	        .nlh =
+	                {
+	                        .nlmsg_len = sizeof(req),
+	                        .nlmsg_type = SOCK_DIAG_BY_FAMILY,
+	                        .nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP,
+	                },
+	        .req =
+	                {
+	                        .sdiag_family = AF_NETLINK,
+	                        .sdiag_protocol = NDIAG_PROTO_ALL,
+	                },
+	};
+	return sock_diag_dump(fd, &req.nlh, parse_netlink_diag_msg, sockets, SCAP_L4_NA, error);
+}
+
+// Read a TCP, UDP or netlink socket table, through sock_diag if `diag_fd` is a valid
+// NETLINK_SOCK_DIAG socket, or by parsing the socket table file `filename` otherwise. Dumping
+// through sock_diag is way cheaper than formatting and parsing the text tables on hosts with
+// many sockets.
+static int32_t read_socket_table(const int diag_fd,
+                                 const char *filename,
+                                 const int socket_domain,
+                                 const int l4proto,
+                                 scap_fdinfo **sockets,
+                                 char *const error) {
+	if(diag_fd >= 0) {
+		const int32_t res = socket_domain == AF_NETLINK
+		                            ? sock_diag_dump_netlink(diag_fd, sockets, error)
+		                            : sock_diag_dump_inet(diag_fd,
+		                                                  socket_domain,
+		                                                  l4proto,
+		                                                  sockets,
+		                                                  error);
+		if(res != SCAP_NOT_SUPPORTED) {
+			return res;
+		}
+	}
+
+	return parse_procfs_proc_pid_socket_table_file(filename,
+	                                               socket_domain,
+	                                               l4proto,
+	                                               sockets,
+	                                               error);
+}
+
+static int32_t read_sockets(const int diag_fd,
+                            const char *netroot,
+                            struct scap_ns_socket_list *sockets,
+                            char *error) {
+	char filename[SCAP_MAX_PATH_SIZE];
+	char err_buf[SCAP_LASTERR_SIZE];
+
 	snprintf(filename, sizeof(filename), "%stcp", netroot);
-	if(parse_procfs_proc_pid_socket_table_file(filename,
-	                                           AF_INET,
-	                                           SCAP_L4_TCP,
-	                                           &sockets->sockets,
-	                                           err_buf) == SCAP_FAILURE) {
+	if(read_socket_table(diag_fd,
+	                     filename,
+	                     AF_INET,
+	                     SCAP_L4_TCP,
+	                     &sockets->sockets,
+	                     err_buf) == SCAP_FAILURE) {
 		return scap_errprintf(error, 0, "can't read IPv4 TCP sockets: %s", err_buf);
 	}
 
 	snprintf(filename, sizeof(filename), "%sudp", netroot);
-	if(parse_procfs_proc_pid_socket_table_file(filename,
-	                                           AF_INET,
-	                                           SCAP_L4_UDP,
-	                                           &sockets->sockets,
-	                                           err_buf) == SCAP_FAILURE) {
+	if(read_socket_table(diag_fd,
+	                     filename,
+	                     AF_INET,
+	                     SCAP_L4_UDP,
+	                     &sockets->sockets,
+	                     err_buf) == SCAP_FAILURE) {
 		return scap_errprintf(error, 0, "can't read IPv4 UDP sockets: %s", err_buf);
 	}
 
@@ -1123,11 +1378,12 @@ int32_t scap_fd_read_sockets_impl(char *procdir, struct scap_ns_socket_list *soc
 	}
 
 	snprintf(filename, sizeof(filename), "%snetlink", netroot);
-	if(parse_procfs_proc_pid_socket_table_file(filename,
-	                                           AF_NETLINK,
-	                                           SCAP_L4_NA,
-	                                           &sockets->sockets,
-	                                           err_buf) == SCAP_FAILURE) {
+	if(read_socket_table(diag_fd,
+	                     filename,
+	                     AF_NETLINK,
+	                     SCAP_L4_NA,
+	                     &sockets->sockets,
+	                     err_buf) == SCAP_FAILURE) {
 		return scap_errprintf(error, 0, "can't read netlink sockets: %s", err_buf);
 	}
 
@@ -1137,20 +1393,22 @@ int32_t scap_fd_read_sockets_impl(char *procdir, struct scap_ns_socket_list *soc
 		return SCAP_SUCCESS;
 	}
 
-	if(parse_procfs_proc_pid_socket_table_file(filename,
-	                                           AF_INET6,
-	                                           SCAP_L4_TCP,
-	                                           &sockets->sockets,
-	                                           err_buf) == SCAP_FAILURE) {
+	if(read_socket_table(diag_fd,
+	                     filename,
+	                     AF_INET6,
+	                     SCAP_L4_TCP,
+	                     &sockets->sockets,
+	                     err_buf) == SCAP_FAILURE) {
 		return scap_errprintf(error, 0, "can't read IPv6 TCP sockets: %s", err_buf);
 	}
 
 	snprintf(filename, sizeof(filename), "%sudp6", netroot);
-	if(parse_procfs_proc_pid_socket_table_file(filename,
-	                                           AF_INET6,
-	                                           SCAP_L4_UDP,
-	                                           &sockets->sockets,
-	                                           err_buf) == SCAP_FAILURE) {
+	if(read_socket_table(diag_fd,
+	                     filename,
+	                     AF_INET6,
+	                     SCAP_L4_UDP,
+	                     &sockets->sockets,
+	                     err_buf) == SCAP_FAILURE) {
 		return scap_errprintf(error, 0, "can't read IPv6 UDP sockets: %s", err_buf);
 	}
 
@@ -1166,6 +1424,26 @@ int32_t scap_fd_read_sockets_impl(char *procdir, struct scap_ns_socket_list *soc
 	return SCAP_SUCCESS;
 }
 
+int32_t scap_fd_read_sockets_impl(char *procdir, struct scap_ns_socket_list *sockets, char *error) {
+	char netroot[SCAP_MAX_PATH_SIZE];
+
+	if(sockets->net_ns) {
+		// Namespace support, look in /proc/PID/net/.
+		snprintf(netroot, sizeof(netroot), "%snet/", procdir);
+	} else {
+		// No namespace support, look in the base /proc/net/.
+		snprintf(netroot, sizeof(netroot), "%s/proc/net/", scap_get_host_root());
+	}
+
+	// The sock_diag socket is bound to the namespace, so it's opened once for all the tables.
+	const int diag_fd = sock_diag_open(procdir, sockets->net_ns);
+	const int32_t res = read_sockets(diag_fd, netroot, sockets, error);
+	if(diag_fd >= 0) {
+		close(diag_fd);
+	}
+	return res;
+}
+
 int32_t scap_fd_read_sockets(char *procdir, struct scap_ns_socket_list *sockets, char *error) {
 	const int32_t res = scap_fd_read_sockets_impl(procdir, sockets, error);
 	if(res != SCAP_SUCCESS) {
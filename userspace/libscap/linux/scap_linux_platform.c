@@ -24,7 +24,9 @@ limitations under the License.
 #include <libscap/linux/scap_linux_int.h>
 
 #include <libscap/compat/misc.h>
+#include <libscap/clock_helpers.h>
 
+#include <errno.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <sys/stat.h>
@@ -42,7 +44,10 @@ static int32_t scap_linux_close_platform(struct scap_platform* platform) {
 		linux_platform->m_dev_list = NULL;
 	}
 
-	scap_cgroup_clear_cache(&linux_platform->m_cgroups);
+	scap_cgroup_interface_close(&linux_platform->m_cgroups);
+
+	// Free the snapshot threads, if the platform is closed before the /proc scan
+	scap_proc_free_table(&linux_platform->m_proc_snapshot);
 
 	return SCAP_SUCCESS;
 }
@@ -61,6 +66,7 @@ int32_t scap_linux_init_platform(struct scap_platform* platform,
 	linux_platform->m_engine = engine;
 	linux_platform->m_proc_scan_timeout_ms = oargs->proc_scan_timeout_ms;
 	linux_platform->m_proc_scan_log_interval_ms = oargs->proc_scan_log_interval_ms;
+	linux_platform->m_proc_scan_workers = oargs->proc_scan_workers;
 	linux_platform->m_log_fn = oargs->log_fn;
 	linux_platform->m_cgroups.m_log_fn = oargs->log_fn;
 
@@ -70,16 +76,25 @@ int32_t scap_linux_init_platform(struct scap_platform* platform,
 
 	scap_os_get_agent_info(&platform->m_agent_info);
 
+	struct scap_startup_stats* stats = oargs->startup_stats;
+	uint64_t start_ns = scap_get_monotonic_ts_ns();
 	rc = scap_linux_create_iflist(platform);
 	if(rc != SCAP_SUCCESS) {
 		return rc;
 	}
+	if(stats) {
+		stats->iflist_ns = scap_get_monotonic_ts_ns() - start_ns;
+	}
 
 	if(oargs->import_users) {
+		start_ns = scap_get_monotonic_ts_ns();
 		rc = scap_linux_create_userlist(platform);
 		if(rc != SCAP_SUCCESS) {
 			return rc;
 		}
+		if(stats) {
+			stats->userlist_ns = scap_get_monotonic_ts_ns() - start_ns;
+		}
 	}
 
 	rc = scap_cgroup_interface_init(&linux_platform->m_cgroups,
@@ -92,7 +107,9 @@ int32_t scap_linux_init_platform(struct scap_platform* platform,
 
 	linux_platform->m_lasterr[0] = '\0';
 	char proc_scan_err[SCAP_LASTERR_SIZE];
+	linux_platform->m_startup_stats = stats;
 	rc = scap_linux_refresh_proc_table(platform, &platform->m_proclist);
+	linux_platform->m_startup_stats = NULL;
 	if(rc != SCAP_SUCCESS) {
 		scap_errprintf(
 		        linux_platform->m_lasterr,
@@ -136,3 +153,41 @@ struct scap_platform* scap_linux_alloc_platform(scap_proc_callbacks callbacks) {
 
 	return generic;
 }
+
+struct scap_linux_platform* scap_linux_get_platform(struct scap_platform* platform) {
+	if(platform == NULL || platform->m_vtable != &scap_linux_platform_vtable) {
+		return NULL;
+	}
+	return (struct scap_linux_platform*)platform;
+}
+
+struct scap_linux_platform* scap_linux_alloc_proc_reader(
+        const struct scap_linux_platform* linux_platform,
+        char* error) {
+	// The error buffer of the reader lives right after it.
+	struct scap_linux_platform* reader = calloc(1, sizeof(*reader) + SCAP_LASTERR_SIZE);
+	if(reader == NULL) {
+		scap_errprintf(error, ENOMEM, "can't allocate the /proc reader");
+		return NULL;
+	}
+
+	reader->m_lasterr = (char*)(reader + 1);
+	reader->m_fd_lookup_limit = linux_platform->m_fd_lookup_limit;
+	reader->m_minimal_scan = linux_platform->m_minimal_scan;
+	reader->m_log_fn = linux_platform->m_log_fn;
+	reader->m_cgroups.m_log_fn = linux_platform->m_log_fn;
+	if(scap_cgroup_interface_init(&reader->m_cgroups, scap_get_host_root(), error, true) !=
+	   SCAP_SUCCESS) {
+		free(reader);
+		return NULL;
+	}
+	return reader;
+}
+
+void scap_linux_free_proc_reader(struct scap_linux_platform* reader) {
+	if(reader == NULL) {
+		return;
+	}
+	scap_cgroup_interface_close(&reader->m_cgroups);
+	free(reader);
+}
@@ -175,6 +175,15 @@ struct scap_linux_platform {
 	// /proc scan parameters
 	uint64_t m_proc_scan_timeout_ms;
 	uint64_t m_proc_scan_log_interval_ms;
+	uint32_t m_proc_scan_workers;
+
+	// Threads saved by a previous run (see `sinsp::set_state_snapshot()`). The /proc scan reuses
+	// the ones that still have the same start time instead of reading them again, the rest is
+	// freed once the scan is over.
+	struct scap_proclist m_proc_snapshot;
+
+	// Set only while scap_linux_init_platform() runs, so that later refreshes aren't accounted
+	struct scap_startup_stats* m_startup_stats;
 
 	falcosecurity_log_fn m_log_fn;
 
@@ -184,6 +193,48 @@ struct scap_linux_platform {
 
 struct scap_platform* scap_linux_alloc_platform(scap_proc_callbacks proc_callbacks);
 
+/**
+ * @brief Return the Linux platform behind `platform`, or NULL if `platform` was not allocated with
+ * scap_linux_alloc_platform()
+ */
+struct scap_linux_platform* scap_linux_get_platform(struct scap_platform* platform);
+
+/**
+ * @brief Allocate a reader for scap_linux_read_thread() with the scan settings of
+ * `linux_platform` but its own cgroup cache, that never goes through the engine: the threads and
+ * their files are always read from /proc. Nothing is shared with `linux_platform`, so the reader
+ * can be used from another thread than the one using the platform.
+ * @param linux_platform the platform whose settings are copied
+ * @param error pointer to a buffer of SCAP_LASTERR_SIZE bytes for the error message (if any)
+ * @return the reader, to be freed with scap_linux_free_proc_reader(), or NULL on failure
+ */
+struct scap_linux_platform* scap_linux_alloc_proc_reader(
+        const struct scap_linux_platform* linux_platform,
+        char* error);
+
+/**
+ * @brief Free a reader allocated with scap_linux_alloc_proc_reader()
+ */
+void scap_linux_free_proc_reader(struct scap_linux_platform* reader);
+
+/**
+ * @brief Read a thread from /proc, along with its files if it's a main thread, and pass them to
+ * the callbacks of `proclist` instead of the ones of the platform. The cgroup cache of the
+ * platform is updated, and the engine may be asked for the files: from another thread than the
+ * one using the platform, pass a reader from scap_linux_alloc_proc_reader() instead.
+ * @param linux_platform the platform, or a reader
+ * @param proclist the process list receiving the thread and its files
+ * @param tid the thread to read
+ * @param scan_sockets whether sockets must be resolved through the socket tables
+ * @param error pointer to a buffer of SCAP_LASTERR_SIZE bytes for the error message (if any)
+ * @return SCAP_SUCCESS on success, any other SCAP_* failure code otherwise
+ */
+int32_t scap_linux_read_thread(struct scap_linux_platform* linux_platform,
+                               struct scap_proclist* proclist,
+                               int64_t tid,
+                               bool scan_sockets,
+                               char* error);
+
 /**
  * @brief A lightweight Linux platform that only collects static host information
  *
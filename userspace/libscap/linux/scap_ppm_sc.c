@@ -1031,6 +1031,10 @@ static const ppm_sc_code *g_events_to_sc_map[] = {
         [PPME_SYSCALL_CLOSE_RANGE_X] = (ppm_sc_code[]){PPM_SC_CLOSE_RANGE, -1},
         [PPME_SYSCALL_KEYCTL_E] = NULL,
         [PPME_SYSCALL_KEYCTL_X] = (ppm_sc_code[]){PPM_SC_KEYCTL, -1},
+        [PPME_IO_AGGREGATE_E] = NULL,
+        [PPME_IO_AGGREGATE_X] = NULL,
+        [PPME_RATE_LIMIT_DROPS_E] = NULL,
+        [PPME_RATE_LIMIT_DROPS_X] = NULL,
 };
 
 #if defined(__GNUC__) || (__STDC_VERSION__ >= 201112L)
@@ -34,6 +34,7 @@ limitations under the License.
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <fcntl.h>
+#include <pthread.h>
 
 #include <libscap/linux/unixid.h>
 #include <libscap/scap.h>
@@ -911,17 +912,19 @@ static int32_t linux_vtable_fetch_procs_files(const struct scap_linux_platform*
 }
 
 //
-// Add a process to the list by parsing its entry under /proc
+// Fill `tinfo` by parsing the entry of a thread under /proc. The process list is left untouched,
+// so this can run on several threads at once as long as `cgroups_mutex` is provided to serialize
+// the accesses to the cgroups cache.
 //
-static int32_t scap_proc_add_from_proc(struct scap_linux_platform* linux_platform,
-                                       struct scap_proclist* proclist,
-                                       uint32_t tid,
-                                       char* procdirname,
-                                       struct scap_ns_socket_list** sockets_by_ns,
-                                       uint64_t* num_fds_ret,
-                                       char* error) {
+static int32_t scap_proc_read_from_proc(struct scap_linux_platform* linux_platform,
+                                        uint32_t tid,
+                                        const char* procdirname,
+                                        pthread_mutex_t* cgroups_mutex,
+                                        struct scap_threadinfo* tinfo,
+                                        char* error) {
 	char dir_name[SCAP_MAX_PATH_SIZE];
 	snprintf(dir_name, sizeof(dir_name), "%s/%u/", procdirname, tid);
+	char lasterr[SCAP_LASTERR_SIZE] = "";
 
 	// Gather the command line.
 	char cmdline_buff[SCAP_MAX_ARGS_SIZE];
@@ -962,29 +965,28 @@ static int32_t scap_proc_add_from_proc(struct scap_linux_platform* linux_platfor
 		}
 	}
 
-	struct scap_threadinfo tinfo = {};
-	memset(&tinfo, 0, sizeof(scap_threadinfo));
+	memset(tinfo, 0, sizeof(scap_threadinfo));
 
-	tinfo.tid = tid;
-	tinfo.fdlist = NULL;
+	tinfo->tid = tid;
+	tinfo->fdlist = NULL;
 
 	// Set exepath.
-	snprintf(tinfo.exepath, sizeof(tinfo.exepath), "%s", target_name);
+	snprintf(tinfo->exepath, sizeof(tinfo->exepath), "%s", target_name);
 
 	// Gather and set the command name.
-	res = read_procfs_proc_pid_comm(dir_name, tinfo.comm, sizeof(tinfo.comm), error);
+	res = read_procfs_proc_pid_comm(dir_name, tinfo->comm, sizeof(tinfo->comm), error);
 	if(res == SCAP_FAILURE) {
 		return res;
 	}
 
 	// Set exe and args from command line.
-	set_tinfo_exe_and_args_from_cmdline(&tinfo, cmdline_buff, (uint16_t)cmdline_len);
+	set_tinfo_exe_and_args_from_cmdline(tinfo, cmdline_buff, (uint16_t)cmdline_len);
 
 	// Gather and set the environment.
 	res = read_procfs_proc_pid_environ(dir_name,
-	                                   tinfo.env,
-	                                   sizeof(tinfo.env),
-	                                   &tinfo.env_len,
+	                                   tinfo->env,
+	                                   sizeof(tinfo->env),
+	                                   &tinfo->env_len,
 	                                   error);
 	if(res == SCAP_FAILURE) {
 		return res;
@@ -993,7 +995,7 @@ static int32_t scap_proc_add_from_proc(struct scap_linux_platform* linux_platfor
 	//
 	// set the current working directory of the process
 	//
-	res = read_procfs_proc_pid_cwd(dir_name, tinfo.cwd, sizeof(tinfo.cwd), error);
+	res = read_procfs_proc_pid_cwd(dir_name, tinfo->cwd, sizeof(tinfo->cwd), error);
 	if(res == SCAP_FAILURE) {
 		return res;
 	}
@@ -1001,56 +1003,49 @@ static int32_t scap_proc_add_from_proc(struct scap_linux_platform* linux_platfor
 	//
 	// extract the user id and ppid from /proc/pid/status
 	//
-	if(SCAP_FAILURE ==
-	   scap_proc_fill_info_from_stats(linux_platform->m_lasterr, dir_name, &tinfo)) {
-		return scap_errprintf(error,
-		                      0,
-		                      "can't fill uid and pid for %s (%s)",
-		                      dir_name,
-		                      linux_platform->m_lasterr);
+	if(SCAP_FAILURE == scap_proc_fill_info_from_stats(lasterr, dir_name, tinfo)) {
+		return scap_errprintf(error, 0, "can't fill uid and pid for %s (%s)", dir_name, lasterr);
 	}
 
 	//
 	// Set the file limit
 	//
-	if(SCAP_FAILURE == scap_proc_fill_flimit(tinfo.tid, &tinfo)) {
-		return scap_errprintf(error,
-		                      0,
-		                      "can't fill flimit for %s (%s)",
-		                      dir_name,
-		                      linux_platform->m_lasterr);
+	if(SCAP_FAILURE == scap_proc_fill_flimit(tinfo->tid, tinfo)) {
+		return scap_errprintf(error, 0, "can't fill flimit for %s (%s)", dir_name, lasterr);
 	}
 
-	if(scap_cgroup_get_thread(&linux_platform->m_cgroups,
-	                          dir_name,
-	                          &tinfo.cgroups,
-	                          linux_platform->m_lasterr) == SCAP_FAILURE) {
-		return scap_errprintf(error,
-		                      0,
-		                      "can't fill cgroups for %s (%s)",
-		                      dir_name,
-		                      linux_platform->m_lasterr);
+	if(cgroups_mutex != NULL) {
+		pthread_mutex_lock(cgroups_mutex);
+	}
+	res = scap_cgroup_get_thread(&linux_platform->m_cgroups, dir_name, &tinfo->cgroups, lasterr);
+	if(cgroups_mutex != NULL) {
+		pthread_mutex_unlock(cgroups_mutex);
+	}
+	if(res == SCAP_FAILURE) {
+		return scap_errprintf(error, 0, "can't fill cgroups for %s (%s)", dir_name, lasterr);
 	}
 
-	if(scap_proc_fill_pidns_start_ts(linux_platform->m_lasterr, &tinfo, dir_name) == SCAP_FAILURE) {
+	if(scap_proc_fill_pidns_start_ts(lasterr, tinfo, dir_name) == SCAP_FAILURE) {
 		// ignore errors
 		// the thread may not have /proc visible so we shouldn't kill the scan if this fails
 	}
 
 	// These values should be read already from /status file, leave these
 	// fallback functions for older kernels < 4.1
-	if(tinfo.vtid == 0 && scap_get_vtid(linux_platform, tinfo.tid, &tinfo.vtid) == SCAP_FAILURE) {
-		tinfo.vtid = tinfo.tid;
+	if(tinfo->vtid == 0 &&
+	   scap_get_vtid(linux_platform, tinfo->tid, &tinfo->vtid) == SCAP_FAILURE) {
+		tinfo->vtid = tinfo->tid;
 	}
 
-	if(tinfo.vpid == 0 && scap_get_vpid(linux_platform, tinfo.tid, &tinfo.vpid) == SCAP_FAILURE) {
-		tinfo.vpid = tinfo.pid;
+	if(tinfo->vpid == 0 &&
+	   scap_get_vpid(linux_platform, tinfo->tid, &tinfo->vpid) == SCAP_FAILURE) {
+		tinfo->vpid = tinfo->pid;
 	}
 
 	//
 	// set the current root of the process
 	//
-	res = read_procfs_proc_pid_root(dir_name, tinfo.root, sizeof(tinfo.root), error);
+	res = read_procfs_proc_pid_root(dir_name, tinfo->root, sizeof(tinfo->root), error);
 	if(res == SCAP_FAILURE) {
 		return res;
 	}
@@ -1058,7 +1053,7 @@ static int32_t scap_proc_add_from_proc(struct scap_linux_platform* linux_platfor
 	//
 	// set the loginuid
 	//
-	res = parse_procfs_proc_pid_loginuid(dir_name, &tinfo, error);
+	res = parse_procfs_proc_pid_loginuid(dir_name, tinfo, error);
 	if(res == SCAP_FAILURE) {
 		return res;
 	}
@@ -1069,7 +1064,7 @@ static int32_t scap_proc_add_from_proc(struct scap_linux_platform* linux_platfor
 	char proc_cmdline[SCAP_MAX_PATH_SIZE];
 	snprintf(proc_cmdline, sizeof(proc_cmdline), "%scmdline", dir_name);
 	if(stat(proc_cmdline, &dirstat) == 0) {
-		tinfo.clone_ts = dirstat.st_ctim.tv_sec * SECOND_TO_NS + dirstat.st_ctim.tv_nsec;
+		tinfo->clone_ts = dirstat.st_ctim.tv_sec * SECOND_TO_NS + dirstat.st_ctim.tv_nsec;
 	}
 
 	// If tid is different from pid, assume this is a thread and that the FDs are shared, and set
@@ -1077,48 +1072,60 @@ static int32_t scap_proc_add_from_proc(struct scap_linux_platform* linux_platfor
 	// XXX we should see if the process creation flags are stored somewhere in /proc and handle this
 	// properly instead of making assumptions.
 	//
-	if(tinfo.tid == tinfo.pid) {
-		tinfo.flags = 0;
+	if(tinfo->tid == tinfo->pid) {
+		tinfo->flags = 0;
 	} else {
 		/* Probably we are doing this because `pthread_create` calls `clone()`
 		 * with `CLONE_FILES`, but this is just an assumption.
 		 * All threads populated by /proc scan will have `fdtable->size()==0`.
 		 */
-		tinfo.flags = PPM_CL_CLONE_THREAD | PPM_CL_CLONE_FILES;
+		tinfo->flags = PPM_CL_CLONE_THREAD | PPM_CL_CLONE_FILES;
 	}
 
-	if(SCAP_FAILURE == scap_proc_fill_exe_ino_ctime_mtime(linux_platform->m_lasterr,
-	                                                      &tinfo,
-	                                                      dir_name,
-	                                                      target_name)) {
+	if(SCAP_FAILURE ==
+	   scap_proc_fill_exe_ino_ctime_mtime(lasterr, tinfo, dir_name, target_name)) {
 		return scap_errprintf(error,
 		                      0,
 		                      "can't fill exe writable access for %s (%s)",
 		                      dir_name,
-		                      linux_platform->m_lasterr);
+		                      lasterr);
 	}
 
-	if(SCAP_FAILURE == scap_proc_fill_exe_writable(linux_platform->m_lasterr,
-	                                               &tinfo,
-	                                               tinfo.uid,
-	                                               tinfo.gid,
+	if(SCAP_FAILURE == scap_proc_fill_exe_writable(lasterr,
+	                                               tinfo,
+	                                               tinfo->uid,
+	                                               tinfo->gid,
 	                                               dir_name,
 	                                               target_name)) {
 		return scap_errprintf(error,
 		                      0,
 		                      "can't fill exe writable access for %s (%s)",
 		                      dir_name,
-		                      linux_platform->m_lasterr);
+		                      lasterr);
 	}
 
-	scap_threadinfo* new_tinfo = &tinfo;
-	//
-	// Done. Add the entry to the process table, or fire the notification callback
-	//
+	return SCAP_SUCCESS;
+}
+
+//
+// Add a thread read with `scap_proc_read_from_proc()` to the list, or fire the notification
+// callback, and scan its files if it's a main thread.
+//
+static int32_t scap_proc_add_thread(struct scap_linux_platform* linux_platform,
+                                    struct scap_proclist* proclist,
+                                    const char* procdirname,
+                                    struct scap_threadinfo* tinfo,
+                                    struct scap_ns_socket_list** sockets_by_ns,
+                                    uint64_t* num_fds_ret,
+                                    char* error) {
+	char dir_name[SCAP_MAX_PATH_SIZE];
+	snprintf(dir_name, sizeof(dir_name), "%s/%u/", procdirname, (uint32_t)tinfo->tid);
+
+	scap_threadinfo* new_tinfo = tinfo;
 	proclist->m_callbacks.m_proc_entry_cb(proclist->m_callbacks.m_callback_context,
 	                                      error,
-	                                      tinfo.tid,
-	                                      &tinfo,
+	                                      tinfo->tid,
+	                                      tinfo,
 	                                      NULL,
 	                                      &new_tinfo);
 
@@ -1128,12 +1135,12 @@ static int32_t scap_proc_add_from_proc(struct scap_linux_platform* linux_platfor
 	}
 
 	const bool must_fetch_sockets = *sockets_by_ns != (void*)-1;
-	res = linux_vtable_fetch_proc_files(linux_platform,
-	                                    proclist,
-	                                    new_tinfo,
-	                                    must_fetch_sockets,
-	                                    num_fds_ret,
-	                                    error);
+	const int32_t res = linux_vtable_fetch_proc_files(linux_platform,
+	                                                  proclist,
+	                                                  new_tinfo,
+	                                                  must_fetch_sockets,
+	                                                  num_fds_ret,
+	                                                  error);
 	if(res != SCAP_NOT_SUPPORTED) {
 		return res;
 	}
@@ -1148,6 +1155,172 @@ static int32_t scap_proc_add_from_proc(struct scap_linux_platform* linux_platfor
 	                           error);
 }
 
+//
+// Add a process to the list by parsing its entry under /proc
+//
+static int32_t scap_proc_add_from_proc(struct scap_linux_platform* linux_platform,
+                                       struct scap_proclist* proclist,
+                                       uint32_t tid,
+                                       char* procdirname,
+                                       struct scap_ns_socket_list** sockets_by_ns,
+                                       uint64_t* num_fds_ret,
+                                       char* error) {
+	struct scap_threadinfo tinfo;
+	const int32_t res =
+	        scap_proc_read_from_proc(linux_platform, tid, procdirname, NULL, &tinfo, error);
+	if(res != SCAP_SUCCESS) {
+		return res;
+	}
+	return scap_proc_add_thread(linux_platform,
+	                            proclist,
+	                            procdirname,
+	                            &tinfo,
+	                            sockets_by_ns,
+	                            num_fds_ret,
+	                            error);
+}
+
+//
+// Return true if the thread under `procdirname` has the same start time `snapshot_tinfo` had when
+// the snapshot was taken, so that it's still the same thread. Only reads /proc, so it's safe to
+// call from the scan workers.
+//
+static bool scap_proc_matches_snapshot(const struct scap_threadinfo* snapshot_tinfo,
+                                       const char* procdirname) {
+	// Same start time `scap_proc_read_from_proc()` stores in `clone_ts`.
+	char filename[SCAP_MAX_PATH_SIZE];
+	struct stat dirstat;
+	snprintf(filename,
+	         sizeof(filename),
+	         "%s/%u/cmdline",
+	         procdirname,
+	         (uint32_t)snapshot_tinfo->tid);
+	return stat(filename, &dirstat) == 0 &&
+	       (uint64_t)(dirstat.st_ctim.tv_sec * SECOND_TO_NS + dirstat.st_ctim.tv_nsec) ==
+	               snapshot_tinfo->clone_ts;
+}
+
+//
+// Return the snapshot entry of `tid` if the thread under `procdirname` is still the one of the
+// snapshot, see `scap_proc_matches_snapshot()`. Return NULL if the thread must be read from /proc.
+//
+static struct scap_threadinfo* scap_proc_find_in_snapshot(
+        struct scap_linux_platform* linux_platform,
+        uint64_t tid,
+        const char* procdirname) {
+	struct scap_threadinfo* snapshot_tinfo;
+	HASH_FIND_INT64(linux_platform->m_proc_snapshot.m_proclist, &tid, snapshot_tinfo);
+	if(snapshot_tinfo == NULL || !scap_proc_matches_snapshot(snapshot_tinfo, procdirname)) {
+		return NULL;
+	}
+	return snapshot_tinfo;
+}
+
+//
+// Return true if the files of the process under `procdirname` are still the ones in `fdlist`: the
+// same fd numbers, each one referring to the same inode.
+//
+static bool scap_proc_fds_match_snapshot(const char* procdirname,
+                                         uint64_t pid,
+                                         scap_fdinfo* fdlist) {
+	char fd_dir_name[SCAP_MAX_PATH_SIZE];
+	snprintf(fd_dir_name, sizeof(fd_dir_name), "%s/%u/fd", procdirname, (uint32_t)pid);
+	DIR* dir_p = opendir(fd_dir_name);
+	if(dir_p == NULL) {
+		return fdlist == NULL;
+	}
+
+	char f_name[SCAP_MAX_PATH_SIZE];
+	struct dirent* dir_entry_p;
+	struct stat sb;
+	uint32_t nfds = 0;
+	bool match = true;
+	while(match && (dir_entry_p = readdir(dir_p)) != NULL) {
+		int64_t fd;
+		if(1 != sscanf(dir_entry_p->d_name, "%" PRId64, &fd)) {
+			continue;
+		}
+
+		scap_fdinfo* fdi;
+		HASH_FIND_INT64(fdlist, &fd, fdi);
+		snprintf(f_name, sizeof(f_name), "%s/%s", fd_dir_name, dir_entry_p->d_name);
+		// Files opened during the capture may have been stored without their inode.
+		match = fdi != NULL && fdi->ino != 0 && stat(f_name, &sb) == 0 && sb.st_ino == fdi->ino;
+		nfds++;
+	}
+	closedir(dir_p);
+	return match && nfds == HASH_COUNT(fdlist);
+}
+
+//
+// Add a thread found with `scap_proc_find_in_snapshot()` to the list and remove it from the
+// snapshot. The files it had when the snapshot was taken are added too if they are still open,
+// otherwise they are read again from /proc like `scap_proc_add_thread()` does.
+//
+static int32_t scap_proc_add_from_snapshot(struct scap_linux_platform* linux_platform,
+                                           struct scap_proclist* proclist,
+                                           const char* procdirname,
+                                           struct scap_threadinfo* snapshot_tinfo,
+                                           struct scap_ns_socket_list** sockets_by_ns,
+                                           uint64_t* num_fds_ret,
+                                           char* error) {
+	struct scap_proclist* snapshot = &linux_platform->m_proc_snapshot;
+	HASH_DEL(snapshot->m_proclist, snapshot_tinfo);
+
+	scap_fdinfo* fdlist = snapshot_tinfo->fdlist;
+	snapshot_tinfo->fdlist = NULL;
+
+	scap_fdinfo* fdi;
+	scap_fdinfo* tfdi;
+	int32_t res;
+	if(snapshot_tinfo->tid == snapshot_tinfo->pid &&
+	   !scap_proc_fds_match_snapshot(procdirname, snapshot_tinfo->pid, fdlist)) {
+		HASH_ITER(hh, fdlist, fdi, tfdi) {
+			HASH_DEL(fdlist, fdi);
+			free(fdi);
+		}
+		res = scap_proc_add_thread(linux_platform,
+		                           proclist,
+		                           procdirname,
+		                           snapshot_tinfo,
+		                           sockets_by_ns,
+		                           num_fds_ret,
+		                           error);
+		free(snapshot_tinfo);
+		return res;
+	}
+
+	// The files are passed one by one, as if they were just read from /proc.
+	scap_threadinfo* new_tinfo = snapshot_tinfo;
+	res = proclist->m_callbacks.m_proc_entry_cb(proclist->m_callbacks.m_callback_context,
+	                                            error,
+	                                            snapshot_tinfo->tid,
+	                                            snapshot_tinfo,
+	                                            NULL,
+	                                            &new_tinfo);
+
+	uint64_t num_fds = 0;
+	HASH_ITER(hh, fdlist, fdi, tfdi) {
+		if(res == SCAP_SUCCESS) {
+			res = proclist->m_callbacks.m_proc_entry_cb(proclist->m_callbacks.m_callback_context,
+			                                            error,
+			                                            new_tinfo->tid,
+			                                            new_tinfo,
+			                                            fdi,
+			                                            NULL);
+			num_fds++;
+		}
+		HASH_DEL(fdlist, fdi);
+		free(fdi);
+	}
+	free(snapshot_tinfo);
+
+	if(num_fds_ret != NULL) {
+		*num_fds_ret = num_fds;
+	}
+	return res;
+}
+
 // Read a single thread from the provided proc dir.
 int32_t scap_proc_read_thread(struct scap_linux_platform* linux_platform,
                               struct scap_proclist* proclist,
@@ -1354,6 +1527,126 @@ static int32_t fetch_procfs_procs_files(struct scap_linux_platform* linux_platfo
 	return SCAP_SUCCESS;
 }
 
+// Progress of the initial /proc scan, used to log it and to cut it short once
+// `m_proc_scan_timeout_ms` expires.
+struct proc_scan_progress {
+	bool do_timing;
+	uint64_t monotonic_ts_context;
+	uint64_t start_ts_ms;
+	uint64_t last_log_ts_ms;
+	uint64_t last_proc_ts_ms;
+	uint64_t min_proc_time_ms;
+	uint64_t max_proc_time_ms;
+	uint64_t num_procs_processed;
+	uint64_t total_num_fds;
+	uint64_t last_tid_processed;
+};
+
+static void proc_scan_progress_start(const struct scap_linux_platform* linux_platform,
+                                     struct proc_scan_progress* progress) {
+	memset(progress, 0, sizeof(*progress));
+	progress->monotonic_ts_context = SCAP_GET_CUR_TS_MS_CONTEXT_INIT;
+	progress->min_proc_time_ms = UINT64_MAX;
+
+	// Do timing tracking only if one or both of the timing parameters is configured to non-zero.
+	progress->do_timing =
+	        (linux_platform->m_proc_scan_timeout_ms != SCAP_PROC_SCAN_TIMEOUT_NONE) ||
+	        (linux_platform->m_proc_scan_log_interval_ms != SCAP_PROC_SCAN_LOG_NONE);
+	if(progress->do_timing) {
+		progress->start_ts_ms = scap_get_monotonic_ts_ms(&progress->monotonic_ts_context);
+		progress->last_log_ts_ms = progress->start_ts_ms;
+		progress->last_proc_ts_ms = progress->start_ts_ms;
+	}
+}
+
+// Account for a process successfully added along with its tasks. Return true if the timeout
+// expired.
+static bool proc_scan_progress_update(struct scap_linux_platform* linux_platform,
+                                      struct proc_scan_progress* progress,
+                                      uint64_t tid,
+                                      uint64_t num_fds) {
+	progress->last_tid_processed = tid;
+	progress->num_procs_processed++;
+	progress->total_num_fds += num_fds;
+
+	if(!progress->do_timing) {
+		return false;
+	}
+
+	uint64_t cur_ts_ms = scap_get_monotonic_ts_ms(&progress->monotonic_ts_context);
+	uint64_t total_elapsed_time_ms = cur_ts_ms - progress->start_ts_ms;
+
+	uint64_t this_proc_elapsed_time_ms = cur_ts_ms - progress->last_proc_ts_ms;
+	progress->last_proc_ts_ms = cur_ts_ms;
+
+	if(this_proc_elapsed_time_ms < progress->min_proc_time_ms) {
+		progress->min_proc_time_ms = this_proc_elapsed_time_ms;
+	}
+	if(this_proc_elapsed_time_ms > progress->max_proc_time_ms) {
+		progress->max_proc_time_ms = this_proc_elapsed_time_ms;
+	}
+
+	if(linux_platform->m_proc_scan_log_interval_ms != SCAP_PROC_SCAN_LOG_NONE) {
+		uint64_t log_elapsed_time_ms = cur_ts_ms - progress->last_log_ts_ms;
+		if(log_elapsed_time_ms >= linux_platform->m_proc_scan_log_interval_ms) {
+			scap_debug_log(linux_platform,
+			               "scap_proc_scan: %ld proc in %ld ms, avg=%ld/min=%ld/max=%ld, "
+			               "last pid %ld, num_fds %ld",
+			               progress->num_procs_processed,
+			               total_elapsed_time_ms,
+			               (total_elapsed_time_ms / progress->num_procs_processed),
+			               progress->min_proc_time_ms,
+			               progress->max_proc_time_ms,
+			               progress->last_tid_processed,
+			               progress->total_num_fds);
+			progress->last_log_ts_ms = cur_ts_ms;
+		}
+	}
+
+	return linux_platform->m_proc_scan_timeout_ms != SCAP_PROC_SCAN_TIMEOUT_NONE &&
+	       total_elapsed_time_ms >= linux_platform->m_proc_scan_timeout_ms;
+}
+
+static void proc_scan_progress_end(struct scap_linux_platform* linux_platform,
+                                   struct proc_scan_progress* progress,
+                                   bool timeout_expired) {
+	if(!progress->do_timing) {
+		return;
+	}
+
+	uint64_t cur_ts_ms = scap_get_monotonic_ts_ms(&progress->monotonic_ts_context);
+	uint64_t total_elapsed_time_ms = cur_ts_ms - progress->start_ts_ms;
+	uint64_t avg_proc_time_ms = (progress->num_procs_processed != 0)
+	                                    ? (total_elapsed_time_ms / progress->num_procs_processed)
+	                                    : 0;
+
+	if(timeout_expired) {
+		scap_debug_log(linux_platform,
+		               "scap_proc_scan TIMEOUT (%ld ms): %ld proc in %ld ms, "
+		               "avg=%ld/min=%ld/max=%ld, last pid %ld, num_fds %ld",
+		               linux_platform->m_proc_scan_timeout_ms,
+		               progress->num_procs_processed,
+		               total_elapsed_time_ms,
+		               avg_proc_time_ms,
+		               progress->min_proc_time_ms,
+		               progress->max_proc_time_ms,
+		               progress->last_tid_processed,
+		               progress->total_num_fds);
+	} else if((linux_platform->m_proc_scan_log_interval_ms != SCAP_PROC_SCAN_LOG_NONE) &&
+	          (progress->num_procs_processed != 0)) {
+		scap_debug_log(linux_platform,
+		               "scap_proc_scan DONE: %ld proc in %ld ms, avg=%ld/min=%ld/max=%ld, last "
+		               "pid %ld, num_fds %ld",
+		               progress->num_procs_processed,
+		               total_elapsed_time_ms,
+		               avg_proc_time_ms,
+		               progress->min_proc_time_ms,
+		               progress->max_proc_time_ms,
+		               progress->last_tid_processed,
+		               progress->total_num_fds);
+	}
+}
+
 //
 // Scan a directory containing multiple processes under /proc
 //
@@ -1368,10 +1661,6 @@ static int32_t _scap_proc_scan_proc_dir_impl(struct scap_linux_platform* linux_p
 	uint64_t tid;
 	int32_t res = SCAP_SUCCESS;
 	char childdir[SCAP_MAX_PATH_SIZE];
-
-	uint64_t num_procs_processed = 0;
-	uint64_t total_num_fds = 0;
-	uint64_t last_tid_processed = 0;
 	struct scap_ns_socket_list* sockets_by_ns = NULL;
 
 	dir_p = opendir(procdirname);
@@ -1381,24 +1670,10 @@ static int32_t _scap_proc_scan_proc_dir_impl(struct scap_linux_platform* linux_p
 		return SCAP_NOTFOUND;
 	}
 
-	// Do timing tracking only if:
-	// - this is the top-level call (parenttid == -1)
-	// - one or both of the timing parameters is configured to non-zero
-	bool do_timing = (parenttid == -1) &&
-	                 ((linux_platform->m_proc_scan_timeout_ms != SCAP_PROC_SCAN_TIMEOUT_NONE) ||
-	                  (linux_platform->m_proc_scan_log_interval_ms != SCAP_PROC_SCAN_LOG_NONE));
-	uint64_t monotonic_ts_context = SCAP_GET_CUR_TS_MS_CONTEXT_INIT;
-	uint64_t start_ts_ms = 0;
-	uint64_t last_log_ts_ms = 0;
-	uint64_t last_proc_ts_ms = 0;
-	uint64_t cur_ts_ms = 0;
-	uint64_t min_proc_time_ms = UINT64_MAX;
-	uint64_t max_proc_time_ms = 0;
-
-	if(do_timing) {
-		start_ts_ms = scap_get_monotonic_ts_ms(&monotonic_ts_context);
-		last_log_ts_ms = start_ts_ms;
-		last_proc_ts_ms = start_ts_ms;
+	// Progress is tracked only by the top-level call (parenttid == -1).
+	struct proc_scan_progress progress = {};
+	if(parenttid == -1) {
+		proc_scan_progress_start(linux_platform, &progress);
 	}
 
 	bool timeout_expired = false;
@@ -1442,14 +1717,26 @@ static int32_t _scap_proc_scan_proc_dir_impl(struct scap_linux_platform* linux_p
 		//
 		// We have a process that needs to be explored
 		//
-		uint64_t num_fds_this_proc;
-		res = scap_proc_add_from_proc(linux_platform,
-		                              proclist,
-		                              tid,
-		                              procdirname,
-		                              &sockets_by_ns,
-		                              &num_fds_this_proc,
-		                              add_error);
+		uint64_t num_fds_this_proc = 0;
+		scap_threadinfo* snapshot_tinfo =
+		        scap_proc_find_in_snapshot(linux_platform, tid, procdirname);
+		if(snapshot_tinfo != NULL) {
+			res = scap_proc_add_from_snapshot(linux_platform,
+			                                  proclist,
+			                                  procdirname,
+			                                  snapshot_tinfo,
+			                                  &sockets_by_ns,
+			                                  &num_fds_this_proc,
+			                                  add_error);
+		} else {
+			res = scap_proc_add_from_proc(linux_platform,
+			                              proclist,
+			                              tid,
+			                              procdirname,
+			                              &sockets_by_ns,
+			                              &num_fds_this_proc,
+			                              add_error);
+		}
 		if(res != SCAP_SUCCESS) {
 			//
 			// When a /proc lookup fails (while scanning the whole directory,
@@ -1480,85 +1767,442 @@ static int32_t _scap_proc_scan_proc_dir_impl(struct scap_linux_platform* linux_p
 			}
 		}
 
-		// TID successfully processed.
-		last_tid_processed = tid;
-		num_procs_processed++;
-		total_num_fds += num_fds_this_proc;
+		// After successful processing of a process at the top level, track the progress.
+		if(parenttid == -1) {
+			timeout_expired =
+			        proc_scan_progress_update(linux_platform, &progress, tid, num_fds_this_proc);
+		}
+	}
 
-		// After successful processing of a process at the top level,
-		// perform timing processing if configured.
-		if(do_timing) {
-			cur_ts_ms = scap_get_monotonic_ts_ms(&monotonic_ts_context);
-			uint64_t total_elapsed_time_ms = cur_ts_ms - start_ts_ms;
+	if(parenttid == -1) {
+		proc_scan_progress_end(linux_platform, &progress, timeout_expired);
+	}
 
-			uint64_t this_proc_elapsed_time_ms = cur_ts_ms - last_proc_ts_ms;
-			last_proc_ts_ms = cur_ts_ms;
+	closedir(dir_p);
+	if(sockets_by_ns != NULL) {
+		scap_fd_free_ns_sockets_list(&sockets_by_ns);
+	}
+	return res;
+}
 
-			if(this_proc_elapsed_time_ms < min_proc_time_ms) {
-				min_proc_time_ms = this_proc_elapsed_time_ms;
-			}
-			if(this_proc_elapsed_time_ms > max_proc_time_ms) {
-				max_proc_time_ms = this_proc_elapsed_time_ms;
+// Upper bound for the automatically picked number of /proc scan workers.
+#define PROC_SCAN_MAX_DEFAULT_WORKERS 8
+
+// Threads read by every worker before the batch is merged into the process list. Every entry
+// takes about 20KB.
+#define PROC_SCAN_BATCH_ENTRIES_PER_WORKER 32
+
+// A thread to read from /proc, along with the outcome of the read.
+struct proc_scan_entry {
+	uint32_t tid;
+	uint32_t pid;  // Process the thread belongs to, equal to `tid` for main threads.
+	int32_t res;
+	struct scap_threadinfo* snapshot_tinfo;  // Entry of the snapshot to reuse, if any.
+	struct scap_threadinfo tinfo;
+};
+
+// Threads read by the workers and then merged into the process list, in the order they were
+// queued.
+struct proc_scan_batch {
+	struct scap_linux_platform* linux_platform;
+	const char* procdirname;
+	pthread_mutex_t* cgroups_mutex;
+	struct proc_scan_entry* entries;
+	uint32_t n_entries;
+	uint32_t capacity;
+	uint32_t next_entry;  // Next entry to read, shared by the workers.
+};
+
+// Workers kept for the whole scan. The calling thread queues a batch and merges the previous one
+// while the workers read it, so at most two batches are in flight.
+struct proc_scan_pool {
+	pthread_mutex_t mutex;
+	pthread_cond_t batch_queued;
+	pthread_cond_t batch_read;
+	struct proc_scan_batch* batch;  // Batch being read.
+	uint32_t generation;            // Bumped every time a batch is queued.
+	uint32_t busy;                  // Workers still reading `batch`.
+	bool stop;
+	pthread_t* threads;
+	uint32_t nthreads;
+};
+
+static uint32_t proc_scan_default_workers() {
+	const long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+	if(ncpus < 1) {
+		return 1;
+	}
+	return ncpus > PROC_SCAN_MAX_DEFAULT_WORKERS ? PROC_SCAN_MAX_DEFAULT_WORKERS : (uint32_t)ncpus;
+}
+
+// Directory under /proc holding the entry of the thread.
+static void proc_scan_entry_dir(const struct proc_scan_batch* batch,
+                                const struct proc_scan_entry* entry,
+                                char* dirname,
+                                size_t dirname_len) {
+	if(entry->tid == entry->pid) {
+		snprintf(dirname, dirname_len, "%s", batch->procdirname);
+	} else {
+		snprintf(dirname, dirname_len, "%s/%u/task", batch->procdirname, entry->pid);
+	}
+}
+
+static int32_t proc_scan_batch_push(struct proc_scan_batch* batch,
+                                    uint32_t tid,
+                                    uint32_t pid,
+                                    char* error) {
+	if(batch->n_entries == batch->capacity) {
+		const uint32_t capacity = batch->capacity * 2;
+		struct proc_scan_entry* entries = (struct proc_scan_entry*)realloc(
+		        batch->entries,
+		        capacity * sizeof(struct proc_scan_entry));
+		if(entries == NULL) {
+			return scap_errprintf(error, ENOMEM, "can't grow the /proc scan batch");
+		}
+		batch->entries = entries;
+		batch->capacity = capacity;
+	}
+
+	// The snapshot is looked up here, since the calling thread removes the entries it merges.
+	// Workers only check that the thread is still the same one.
+	const uint64_t tid64 = tid;
+	struct proc_scan_entry* entry = &batch->entries[batch->n_entries++];
+	entry->tid = tid;
+	entry->pid = pid;
+	entry->res = SCAP_FAILURE;
+	HASH_FIND_INT64(batch->linux_platform->m_proc_snapshot.m_proclist,
+	                &tid64,
+	                entry->snapshot_tinfo);
+	return SCAP_SUCCESS;
+}
+
+// Queue the next processes under `dir_p`, each one followed by its tasks, until the batch holds
+// at least `target` threads. The tasks of a process always end up in the same batch.
+static int32_t proc_scan_batch_fill(struct proc_scan_batch* batch,
+                                    DIR* dir_p,
+                                    uint32_t target,
+                                    bool* done,
+                                    char* error) {
+	char taskdir[SCAP_MAX_PATH_SIZE];
+	struct dirent* dir_entry_p;
+
+	batch->n_entries = 0;
+	batch->next_entry = 0;
+	while(batch->n_entries < target) {
+		dir_entry_p = readdir(dir_p);
+		if(dir_entry_p == NULL) {
+			*done = true;
+			break;
+		}
+
+		if(!is_xid_filename(dir_entry_p->d_name)) {
+			continue;
+		}
+
+		const uint32_t pid = (uint32_t)atoi(dir_entry_p->d_name);
+		if(proc_scan_batch_push(batch, pid, pid, error) != SCAP_SUCCESS) {
+			return SCAP_FAILURE;
+		}
+
+		if(batch->linux_platform->m_minimal_scan) {
+			continue;
+		}
+
+		// As in the serial scan, a task directory that can't be opened is not an error.
+		snprintf(taskdir, sizeof(taskdir), "%s/%u/task", batch->procdirname, pid);
+		DIR* task_dir_p = opendir(taskdir);
+		if(task_dir_p == NULL) {
+			continue;
+		}
+
+		while((dir_entry_p = readdir(task_dir_p)) != NULL) {
+			if(!is_xid_filename(dir_entry_p->d_name)) {
+				continue;
 			}
 
-			if(linux_platform->m_proc_scan_log_interval_ms != SCAP_PROC_SCAN_LOG_NONE) {
-				uint64_t log_elapsed_time_ms = cur_ts_ms - last_log_ts_ms;
-				if(log_elapsed_time_ms >= linux_platform->m_proc_scan_log_interval_ms) {
-					scap_debug_log(linux_platform,
-					               "scap_proc_scan: %ld proc in %ld ms, avg=%ld/min=%ld/max=%ld, "
-					               "last pid %ld, num_fds %ld",
-					               num_procs_processed,
-					               total_elapsed_time_ms,
-					               (total_elapsed_time_ms / (uint64_t)num_procs_processed),
-					               min_proc_time_ms,
-					               max_proc_time_ms,
-					               last_tid_processed,
-					               total_num_fds);
-					last_log_ts_ms = cur_ts_ms;
-				}
+			const uint32_t tid = (uint32_t)atoi(dir_entry_p->d_name);
+			if(tid == pid) {
+				continue;
 			}
 
-			if(linux_platform->m_proc_scan_timeout_ms != SCAP_PROC_SCAN_TIMEOUT_NONE) {
-				if(total_elapsed_time_ms >= linux_platform->m_proc_scan_timeout_ms) {
-					timeout_expired = true;
-				}
+			if(proc_scan_batch_push(batch, tid, pid, error) != SCAP_SUCCESS) {
+				closedir(task_dir_p);
+				return SCAP_FAILURE;
 			}
 		}
+		closedir(task_dir_p);
 	}
 
-	if(do_timing) {
-		cur_ts_ms = scap_get_monotonic_ts_ms(&monotonic_ts_context);
-		uint64_t total_elapsed_time_ms = cur_ts_ms - start_ts_ms;
-		uint64_t avg_proc_time_ms =
-		        (num_procs_processed != 0) ? (total_elapsed_time_ms / num_procs_processed) : 0;
+	return SCAP_SUCCESS;
+}
 
-		if(timeout_expired) {
-			scap_debug_log(linux_platform,
-			               "scap_proc_scan TIMEOUT (%ld ms): %ld proc in %ld ms, "
-			               "avg=%ld/min=%ld/max=%ld, last pid %ld, num_fds %ld",
-			               linux_platform->m_proc_scan_timeout_ms,
-			               num_procs_processed,
-			               total_elapsed_time_ms,
-			               avg_proc_time_ms,
-			               min_proc_time_ms,
-			               max_proc_time_ms,
-			               last_tid_processed,
-			               total_num_fds);
-		} else if((linux_platform->m_proc_scan_log_interval_ms != SCAP_PROC_SCAN_LOG_NONE) &&
-		          (num_procs_processed != 0)) {
-			scap_debug_log(linux_platform,
-			               "scap_proc_scan DONE: %ld proc in %ld ms, avg=%ld/min=%ld/max=%ld, last "
-			               "pid %ld, num_fds %ld",
-			               num_procs_processed,
-			               total_elapsed_time_ms,
-			               avg_proc_time_ms,
-			               min_proc_time_ms,
-			               max_proc_time_ms,
-			               last_tid_processed,
-			               total_num_fds);
+static void proc_scan_batch_read(struct proc_scan_batch* batch) {
+	char dirname[SCAP_MAX_PATH_SIZE];
+	char error[SCAP_LASTERR_SIZE];
+
+	uint32_t idx;
+	while((idx = __atomic_fetch_add(&batch->next_entry, 1, __ATOMIC_RELAXED)) < batch->n_entries) {
+		struct proc_scan_entry* entry = &batch->entries[idx];
+		proc_scan_entry_dir(batch, entry, dirname, sizeof(dirname));
+		if(entry->snapshot_tinfo != NULL &&
+		   scap_proc_matches_snapshot(entry->snapshot_tinfo, dirname)) {
+			entry->res = SCAP_SUCCESS;
+			continue;
+		}
+		entry->snapshot_tinfo = NULL;
+		entry->res = scap_proc_read_from_proc(batch->linux_platform,
+		                                      entry->tid,
+		                                      dirname,
+		                                      batch->cgroups_mutex,
+		                                      &entry->tinfo,
+		                                      error);
+	}
+}
+
+static void* proc_scan_worker(void* arg) {
+	struct proc_scan_pool* pool = (struct proc_scan_pool*)arg;
+	uint32_t generation = 0;
+
+	pthread_mutex_lock(&pool->mutex);
+	while(true) {
+		while(!pool->stop && pool->generation == generation) {
+			pthread_cond_wait(&pool->batch_queued, &pool->mutex);
+		}
+		if(pool->stop) {
+			break;
+		}
+		generation = pool->generation;
+		struct proc_scan_batch* batch = pool->batch;
+		pthread_mutex_unlock(&pool->mutex);
+
+		proc_scan_batch_read(batch);
+
+		pthread_mutex_lock(&pool->mutex);
+		if(--pool->busy == 0) {
+			pthread_cond_signal(&pool->batch_read);
+		}
+	}
+	pthread_mutex_unlock(&pool->mutex);
+	return NULL;
+}
+
+// Start up to `nthreads` workers. If none can be started, the batches are read by the calling
+// thread when they are queued.
+static int32_t proc_scan_pool_start(struct proc_scan_pool* pool, uint32_t nthreads) {
+	pool->threads = (pthread_t*)malloc(nthreads * sizeof(pthread_t));
+	if(pool->threads == NULL) {
+		return SCAP_FAILURE;
+	}
+	pthread_mutex_init(&pool->mutex, NULL);
+	pthread_cond_init(&pool->batch_queued, NULL);
+	pthread_cond_init(&pool->batch_read, NULL);
+	pool->batch = NULL;
+	pool->generation = 0;
+	pool->busy = 0;
+	pool->stop = false;
+	pool->nthreads = 0;
+	while(pool->nthreads < nthreads &&
+	      pthread_create(&pool->threads[pool->nthreads], NULL, proc_scan_worker, pool) == 0) {
+		pool->nthreads++;
+	}
+	return SCAP_SUCCESS;
+}
+
+// Wait until the workers are done with the batch queued last, if any.
+static void proc_scan_pool_wait(struct proc_scan_pool* pool) {
+	pthread_mutex_lock(&pool->mutex);
+	while(pool->busy > 0) {
+		pthread_cond_wait(&pool->batch_read, &pool->mutex);
+	}
+	pool->batch = NULL;
+	pthread_mutex_unlock(&pool->mutex);
+}
+
+// Hand `batch` to the workers. The previous batch must have been waited for.
+static void proc_scan_pool_queue(struct proc_scan_pool* pool, struct proc_scan_batch* batch) {
+	if(pool->nthreads == 0) {
+		proc_scan_batch_read(batch);
+		return;
+	}
+	pthread_mutex_lock(&pool->mutex);
+	pool->batch = batch;
+	pool->busy = pool->nthreads;
+	pool->generation++;
+	pthread_cond_broadcast(&pool->batch_queued);
+	pthread_mutex_unlock(&pool->mutex);
+}
+
+static void proc_scan_pool_stop(struct proc_scan_pool* pool) {
+	proc_scan_pool_wait(pool);
+	pthread_mutex_lock(&pool->mutex);
+	pool->stop = true;
+	pthread_cond_broadcast(&pool->batch_queued);
+	pthread_mutex_unlock(&pool->mutex);
+	for(uint32_t i = 0; i < pool->nthreads; i++) {
+		pthread_join(pool->threads[i], NULL);
+	}
+	pthread_cond_destroy(&pool->batch_read);
+	pthread_cond_destroy(&pool->batch_queued);
+	pthread_mutex_destroy(&pool->mutex);
+	free(pool->threads);
+}
+
+// Add the threads of the batch to the process list, following the same rules as the serial scan.
+// Files are scanned here, since the fd tables and the sockets list are not shared safely.
+static int32_t proc_scan_batch_merge(struct proc_scan_batch* batch,
+                                     struct scap_proclist* proclist,
+                                     struct scap_ns_socket_list** sockets_by_ns,
+                                     struct proc_scan_progress* progress,
+                                     bool* timeout_expired,
+                                     char* error) {
+	char dirname[SCAP_MAX_PATH_SIZE];
+	char add_error[SCAP_LASTERR_SIZE];
+	uint64_t num_fds_this_proc = 0;
+	bool proc_added = false;
+
+	for(uint32_t i = 0; i < batch->n_entries; i++) {
+		struct proc_scan_entry* entry = &batch->entries[i];
+		const bool main_thread = entry->tid == entry->pid;
+
+		// The tasks of a process that couldn't be added are dropped along with it.
+		if(!main_thread && !proc_added) {
+			continue;
+		}
+
+		uint64_t tid = entry->tid;
+		scap_threadinfo* tinfo;
+		HASH_FIND_INT64(proclist->m_proclist, &tid, tinfo);
+		if(tinfo != NULL) {
+			ASSERT(false);
+			return scap_errprintf(error, 0, "duplicate process %" PRIu64, tid);
+		}
+
+		uint64_t num_fds = 0;
+		proc_scan_entry_dir(batch, entry, dirname, sizeof(dirname));
+		if(entry->res == SCAP_SUCCESS && entry->snapshot_tinfo != NULL) {
+			entry->res = scap_proc_add_from_snapshot(batch->linux_platform,
+			                                         proclist,
+			                                         dirname,
+			                                         entry->snapshot_tinfo,
+			                                         sockets_by_ns,
+			                                         &num_fds,
+			                                         add_error);
+		} else if(entry->res == SCAP_SUCCESS) {
+			entry->res = scap_proc_add_thread(batch->linux_platform,
+			                                  proclist,
+			                                  dirname,
+			                                  &entry->tinfo,
+			                                  sockets_by_ns,
+			                                  &num_fds,
+			                                  add_error);
+		}
+
+		if(main_thread) {
+			proc_added = entry->res == SCAP_SUCCESS;
+			num_fds_this_proc = num_fds;
+		}
+
+		// The progress is tracked once the last task of the process is added.
+		const bool last_of_proc = i + 1 == batch->n_entries ||
+		                          batch->entries[i + 1].tid == batch->entries[i + 1].pid;
+		if(proc_added && last_of_proc &&
+		   proc_scan_progress_update(batch->linux_platform,
+		                             progress,
+		                             entry->pid,
+		                             num_fds_this_proc)) {
+			*timeout_expired = true;
+			break;
 		}
 	}
 
+	return SCAP_SUCCESS;
+}
+
+//
+// Scan all the processes under /proc like `_scap_proc_scan_proc_dir_impl()`, reading the
+// threads in batches on `workers - 1` threads while the calling one merges the previous batch
+//
+static int32_t scap_proc_scan_proc_dir_parallel(struct scap_linux_platform* linux_platform,
+                                                struct scap_proclist* proclist,
+                                                char* procdirname,
+                                                uint32_t workers,
+                                                char* error) {
+	DIR* dir_p = opendir(procdirname);
+	if(dir_p == NULL) {
+		scap_errprintf(error, errno, "error opening the %s directory", procdirname);
+		return SCAP_NOTFOUND;
+	}
+
+	pthread_mutex_t cgroups_mutex;
+	const uint32_t target = workers * PROC_SCAN_BATCH_ENTRIES_PER_WORKER;
+	struct proc_scan_batch batches[2];
+	for(int i = 0; i < 2; i++) {
+		batches[i] = (struct proc_scan_batch){
+		        .linux_platform = linux_platform,
+		        .procdirname = procdirname,
+		        .cgroups_mutex = &cgroups_mutex,
+		        .entries = (struct proc_scan_entry*)malloc(target *
+		                                                   sizeof(struct proc_scan_entry)),
+		        .capacity = target,
+		};
+	}
+	struct proc_scan_pool pool;
+	if(batches[0].entries == NULL || batches[1].entries == NULL ||
+	   proc_scan_pool_start(&pool, workers - 1) != SCAP_SUCCESS) {
+		free(batches[0].entries);
+		free(batches[1].entries);
+		closedir(dir_p);
+		return scap_errprintf(error, ENOMEM, "can't allocate the /proc scan batch");
+	}
+	pthread_mutex_init(&cgroups_mutex, NULL);
+
+	struct proc_scan_progress progress;
+	proc_scan_progress_start(linux_platform, &progress);
+
+	struct scap_ns_socket_list* sockets_by_ns = NULL;
+	bool done = false;
+	bool timeout_expired = false;
+	struct proc_scan_batch* reading = &batches[0];
+	struct proc_scan_batch* filling = &batches[1];
+	int32_t res = proc_scan_batch_fill(reading, dir_p, target, &done, error);
+	if(res == SCAP_SUCCESS) {
+		proc_scan_pool_queue(&pool, reading);
+	}
+	while(res == SCAP_SUCCESS) {
+		// Queue the next batch before merging this one, so that the workers keep reading.
+		filling->n_entries = 0;
+		if(!done) {
+			res = proc_scan_batch_fill(filling, dir_p, target, &done, error);
+		}
+		proc_scan_pool_wait(&pool);
+		if(res != SCAP_SUCCESS) {
+			break;
+		}
+		if(filling->n_entries > 0) {
+			proc_scan_pool_queue(&pool, filling);
+		}
+
+		res = proc_scan_batch_merge(reading,
+		                            proclist,
+		                            &sockets_by_ns,
+		                            &progress,
+		                            &timeout_expired,
+		                            error);
+		if(timeout_expired || filling->n_entries == 0) {
+			break;
+		}
+
+		struct proc_scan_batch* merged = reading;
+		reading = filling;
+		filling = merged;
+	}
+
+	proc_scan_progress_end(linux_platform, &progress, timeout_expired);
+
+	proc_scan_pool_stop(&pool);
+	pthread_mutex_destroy(&cgroups_mutex);
+	free(batches[0].entries);
+	free(batches[1].entries);
 	closedir(dir_p);
 	if(sockets_by_ns != NULL) {
 		scap_fd_free_ns_sockets_list(&sockets_by_ns);
@@ -1670,6 +2314,20 @@ int32_t scap_linux_proc_get(struct scap_platform* platform, int64_t tid, bool sc
 	return res;
 }
 
+int32_t scap_linux_read_thread(struct scap_linux_platform* linux_platform,
+                               struct scap_proclist* proclist,
+                               int64_t tid,
+                               bool scan_sockets,
+                               char* error) {
+	if(tid <= 0) {
+		return scap_errprintf(error, 0, "expected positive thread id, got: %ld", tid);
+	}
+
+	char proc_dir[SCAP_MAX_PATH_SIZE];
+	snprintf(proc_dir, sizeof(proc_dir), "%s/proc", scap_get_host_root());
+	return scap_proc_read_thread(linux_platform, proclist, proc_dir, tid, error, scan_sockets);
+}
+
 bool scap_linux_is_thread_alive(struct scap_platform* platform,
                                 int64_t pid,
                                 int64_t tid,
@@ -1718,13 +2376,37 @@ int32_t scap_linux_refresh_proc_table(struct scap_platform* platform,
 	scap_cgroup_enable_cache(&linux_platform->m_cgroups);
 	proclist->m_callbacks.m_refresh_start_cb(proclist->m_callbacks.m_callback_context);
 
+	// Time spent fetching through the linux vtable, then through /proc
+	struct scap_startup_stats* stats = linux_platform->m_startup_stats;
+	uint64_t start_ns = scap_get_monotonic_ts_ns();
+	// The threads reused from the snapshot are removed from it.
+	const uint64_t snapshot_len = HASH_COUNT(linux_platform->m_proc_snapshot.m_proclist);
+
 	// Try to fetch all threads leveraging linux vtable's API.
 	int32_t res = linux_vtable_fetch_threads(linux_platform, proclist, error);
 	if(res == SCAP_NOT_SUPPORTED) {
 		// Fall back to procfs processes lookup.
 		char procfs_dir_path[SCAP_MAX_PATH_SIZE];
 		snprintf(procfs_dir_path, sizeof(procfs_dir_path), "%s/proc", scap_get_host_root());
-		res = _scap_proc_scan_proc_dir_impl(linux_platform, proclist, procfs_dir_path, -1, error);
+		const uint32_t workers = linux_platform->m_proc_scan_workers != 0
+		                                 ? linux_platform->m_proc_scan_workers
+		                                 : proc_scan_default_workers();
+		if(workers > 1) {
+			res = scap_proc_scan_proc_dir_parallel(linux_platform,
+			                                       proclist,
+			                                       procfs_dir_path,
+			                                       workers,
+			                                       error);
+		} else {
+			res = _scap_proc_scan_proc_dir_impl(linux_platform,
+			                                    proclist,
+			                                    procfs_dir_path,
+			                                    -1,
+			                                    error);
+		}
+		if(stats) {
+			stats->proc_scan_ns = scap_get_monotonic_ts_ns() - start_ns;
+		}
 		goto cleanup;
 	}
 
@@ -1735,14 +2417,27 @@ int32_t scap_linux_refresh_proc_table(struct scap_platform* platform,
 
 	// Try to fetch all processes files leveraging linux vtable's API.
 	res = linux_vtable_fetch_procs_files(linux_platform, proclist, error);
+	if(stats) {
+		stats->iter_fetch_ns = scap_get_monotonic_ts_ns() - start_ns;
+	}
 	if(res == SCAP_NOT_SUPPORTED) {
 		// Fall back to procfs files lookup.
+		start_ns = scap_get_monotonic_ts_ns();
 		char procfs_dir_path[SCAP_MAX_PATH_SIZE];
 		snprintf(procfs_dir_path, sizeof(procfs_dir_path), "%s/proc", scap_get_host_root());
 		res = fetch_procfs_procs_files(linux_platform, proclist, procfs_dir_path, error);
+		if(stats) {
+			stats->proc_scan_ns = scap_get_monotonic_ts_ns() - start_ns;
+		}
 	}
 
 cleanup:
+	if(stats) {
+		stats->snapshot_threads =
+		        snapshot_len - HASH_COUNT(linux_platform->m_proc_snapshot.m_proclist);
+	}
+	// Threads of the snapshot that weren't reused are gone or have been replaced.
+	scap_proc_free_table(&linux_platform->m_proc_snapshot);
 	proclist->m_callbacks.m_refresh_end_cb(proclist->m_callbacks.m_callback_context);
 	scap_cgroup_clear_cache(&linux_platform->m_cgroups);
 	return res;
@@ -46,6 +46,12 @@ extern "C" {
 #define N_EVENTS_PER_DEVICE_PREFIX "n_evts_dev_"
 #define N_DROPS_PER_DEVICE_PREFIX "n_drops_dev_"
 
+//
+// Prefix name for syscall latency histograms (Used by modern ebpf), followed by
+// "<syscall>.<cgroup_id>.<count|sum_ns|lt_<bound>ns|lt_inf>"
+//
+#define SYSCALL_LATENCY_PREFIX "syscall_latency."
+
 //
 // metrics_v2 flags
 //
@@ -59,6 +65,8 @@ extern "C" {
 #define METRICS_V2_KERNEL_COUNTERS_PER_CPU \
 	(1 << 7)  // Requesting this does also silently enable METRICS_V2_KERNEL_COUNTERS
 #define METRICS_V2_KERNEL_ITER_COUNTERS (1 << 8)
+#define METRICS_V2_KERNEL_SYSCALL_LATENCY (1 << 9)
+#define METRICS_V2_STARTUP (1 << 10)
 
 typedef union metrics_v2_value {
 	uint32_t u32;
@@ -391,6 +391,78 @@ int32_t scap_set_ppm_sc(scap_t* handle, ppm_sc_code ppm_sc, bool enabled) {
 	return scap_err_opnotsup(handle->m_lasterr);
 }
 
+int32_t scap_set_cgroup_ppm_sc(scap_t* handle, uint64_t cgroup_id, const bool* ppm_sc_set) {
+	if(handle == NULL) {
+		return SCAP_FAILURE;
+	}
+
+	if(handle->m_vtable) {
+		return handle->m_vtable->configure(handle->m_engine,
+		                                   SCAP_CGROUP_PPM_SC_MASK,
+		                                   (unsigned long)cgroup_id,
+		                                   (unsigned long)ppm_sc_set);
+	}
+
+	return scap_err_opnotsup(handle->m_lasterr);
+}
+
+int32_t scap_set_io_aggregation(scap_t* handle, const scap_io_aggregation_params* params) {
+	if(handle == NULL) {
+		return SCAP_FAILURE;
+	}
+
+	if(handle->m_vtable) {
+		return handle->m_vtable->configure(handle->m_engine,
+		                                   SCAP_IO_AGGREGATION,
+		                                   (unsigned long)params,
+		                                   0);
+	}
+
+	return scap_err_opnotsup(handle->m_lasterr);
+}
+
+int32_t scap_set_rate_limit(scap_t* handle, const scap_rate_limit_params* params) {
+	if(handle == NULL || params == NULL) {
+		return SCAP_FAILURE;
+	}
+
+	if(handle->m_vtable) {
+		return handle->m_vtable->configure(handle->m_engine,
+		                                   SCAP_RATE_LIMIT,
+		                                   (unsigned long)params,
+		                                   0);
+	}
+
+	return scap_err_opnotsup(handle->m_lasterr);
+}
+
+int32_t scap_set_arg_filter(scap_t* handle, const scap_arg_filter_params* params) {
+	if(handle == NULL || params == NULL) {
+		return SCAP_FAILURE;
+	}
+
+	if(handle->m_vtable) {
+		return handle->m_vtable->configure(handle->m_engine,
+		                                   SCAP_ARG_FILTER,
+		                                   (unsigned long)params,
+		                                   0);
+	}
+
+	return scap_err_opnotsup(handle->m_lasterr);
+}
+
+int32_t scap_set_syscall_latency(scap_t* handle, bool enabled) {
+	if(handle == NULL) {
+		return SCAP_FAILURE;
+	}
+
+	if(handle->m_vtable) {
+		return handle->m_vtable->configure(handle->m_engine, SCAP_SYSCALL_LATENCY, enabled, 0);
+	}
+
+	return scap_err_opnotsup(handle->m_lasterr);
+}
+
 int32_t scap_set_dropfailed(scap_t* handle, bool enabled) {
 	if(!handle) {
 		return SCAP_FAILURE;
@@ -403,6 +475,33 @@ int32_t scap_set_dropfailed(scap_t* handle, bool enabled) {
 	return scap_err_opnotsup(handle->m_lasterr);
 }
 
+static int32_t scap_suppress(scap_t* handle,
+                             enum scap_setting setting,
+                             enum scap_suppress_op op,
+                             unsigned long arg) {
+	if(!handle) {
+		return SCAP_FAILURE;
+	}
+
+	if(handle->m_vtable) {
+		return handle->m_vtable->configure(handle->m_engine, setting, op, arg);
+	}
+
+	return scap_err_opnotsup(handle->m_lasterr);
+}
+
+int32_t scap_suppress_tid(scap_t* handle, enum scap_suppress_op op, int64_t tid) {
+	return scap_suppress(handle, SCAP_SUPPRESS_TID, op, (unsigned long)tid);
+}
+
+int32_t scap_suppress_comm(scap_t* handle, enum scap_suppress_op op, const char* comm) {
+	return scap_suppress(handle, SCAP_SUPPRESS_COMM, op, (unsigned long)comm);
+}
+
+int32_t scap_suppress_cgroup(scap_t* handle, enum scap_suppress_op op, uint64_t cgroup_id) {
+	return scap_suppress(handle, SCAP_SUPPRESS_CGROUP, op, (unsigned long)cgroup_id);
+}
+
 int32_t scap_enable_dynamic_snaplen(scap_t* handle) {
 	if(!handle) {
 		return SCAP_FAILURE;
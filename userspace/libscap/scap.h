@@ -80,6 +80,7 @@ struct scap_vtable;
 /* Include engine-specific params. */
 #include <libscap/engine/kmod/kmod_public.h>
 #include <libscap/engine/modern_bpf/modern_bpf_public.h>
+#include <libscap/engine/multi_savefile/multi_savefile_public.h>
 #include <libscap/engine/nodriver/nodriver_public.h>
 #include <libscap/engine/savefile/savefile_public.h>
 #include <libscap/engine/source_plugin/source_plugin_public.h>
@@ -423,6 +424,69 @@ typedef enum scap_dump_flags {
 	SCAP_DF_LARGE = (1 << 2)  ///< This event has large payload (up to UINT_MAX Bytes, ie 4GB)
 } scap_dump_flags;
 
+/*!
+  \brief Operations on the sets of threads, names and cgroups suppressed by the driver
+*/
+enum scap_suppress_op {
+	SCAP_SUPPRESS_ADD = 1,     ///< start suppressing an entry
+	SCAP_SUPPRESS_REMOVE = 2,  ///< stop suppressing an entry
+	SCAP_SUPPRESS_CLEAR = 3,   ///< stop suppressing all the entries
+};
+
+/*!
+  \brief Thresholds of the in-driver I/O aggregation, the first one hit flushes
+  the aggregate of a (thread, fd) pair
+*/
+typedef struct scap_io_aggregation_params {
+	uint32_t max_count;    ///< read/write syscalls per aggregate, 0 disables the aggregation
+	uint64_t max_bytes;    ///< bytes per aggregate
+	uint64_t interval_ns;  ///< maximum age of an aggregate, checked on each syscall of its thread
+} scap_io_aggregation_params;
+
+/*!
+  \brief Per-process token bucket applied by the driver to the syscalls of an
+  event category
+*/
+typedef struct scap_rate_limit_params {
+	uint8_t category;               ///< ppm_event_category of the exit events, I/O ones included
+	uint64_t rate;                  ///< events per second, 0 removes the limit
+	uint64_t burst;                 ///< maximum number of events in a burst, at least 1
+	uint64_t summary_interval_ns;   ///< minimum time between two drop summaries of a process,
+	                                ///< 0 keeps the current one
+} scap_rate_limit_params;
+
+/*!
+  \brief Kinds of argument filters applied by the driver before sending an event
+*/
+enum scap_arg_filter_type {
+	SCAP_ARG_FILTER_PATH = 1,   ///< absolute path prefix of the open family of syscalls
+	SCAP_ARG_FILTER_PORT = 2,   ///< remote port of connect, an allow-list once not empty
+	SCAP_ARG_FILTER_ADDR = 3,   ///< remote network of connect
+	SCAP_ARG_FILTER_CLEAR = 4,  ///< remove all the argument filters
+};
+
+/*!
+  \brief What the driver does with the events matching an argument filter, the
+  longest matching path prefix or network wins
+*/
+enum scap_arg_filter_action {
+	SCAP_ARG_FILTER_REMOVE = 0,  ///< remove the filter
+	SCAP_ARG_FILTER_KEEP = 1,    ///< keep the events, or add the port to the allow-list
+	SCAP_ARG_FILTER_DROP = 2,    ///< drop the events, not supported by port filters
+};
+
+/*!
+  \brief An argument filter, only the fields of its type are used
+*/
+typedef struct scap_arg_filter_params {
+	enum scap_arg_filter_type type;
+	enum scap_arg_filter_action action;
+	const char* path;    ///< absolute path prefix
+	uint16_t port;       ///< remote port, host byte order
+	uint8_t addr[16];    ///< IPv6 network, IPv4 ones are mapped as ::ffff:a.b.c.d
+	uint32_t prefixlen;  ///< network prefix length in bits, up to 128
+} scap_arg_filter_params;
+
 /*!
   \brief Structure used to pass a buffer and its size.
 */
@@ -809,6 +873,18 @@ int32_t scap_set_snaplen(scap_t* handle, uint32_t snaplen);
 */
 int32_t scap_set_ppm_sc(scap_t* handle, ppm_sc_code ppm_sc, bool enabled);
 
+/*!
+  \brief Restrict the syscalls collected for the tasks of a cgroup: only the
+  syscalls enabled both globally, with \ref scap_set_ppm_sc, and in the cgroup
+  set are collected. Tasks of other cgroups are not affected.
+
+  \param handle Handle to the capture instance.
+  \param cgroup_id cgroup v2 id
+  \param ppm_sc_set array of PPM_SC_MAX entries, NULL to remove the restriction
+  \note This function is only supported by the modern BPF engine.
+*/
+int32_t scap_set_cgroup_ppm_sc(scap_t* handle, uint64_t cgroup_id, const bool* ppm_sc_set);
+
 /*!
   \brief (Un)Set the drop failed feature of the drivers.
   When enabled, drivers will stop sending failed syscalls (exit) events.
@@ -819,6 +895,87 @@ int32_t scap_set_ppm_sc(scap_t* handle, ppm_sc_code ppm_sc, bool enabled);
 */
 int32_t scap_set_dropfailed(scap_t* handle, bool enabled);
 
+/*!
+  \brief Add, remove or clear the threads whose syscalls are dropped by the
+  driver itself, before they reach the ring buffers. Children of suppressed
+  threads are suppressed as well.
+
+  \param handle Handle to the capture instance.
+  \param op one of \ref scap_suppress_op
+  \param tid thread id, ignored by SCAP_SUPPRESS_CLEAR
+  \note This function is only supported by the modern BPF engine.
+*/
+int32_t scap_suppress_tid(scap_t* handle, enum scap_suppress_op op, int64_t tid);
+
+/*!
+  \brief Same as \ref scap_suppress_tid, for the processes with a given name.
+
+  \param handle Handle to the capture instance.
+  \param op one of \ref scap_suppress_op
+  \param comm process name, ignored by SCAP_SUPPRESS_CLEAR
+*/
+int32_t scap_suppress_comm(scap_t* handle, enum scap_suppress_op op, const char* comm);
+
+/*!
+  \brief Same as \ref scap_suppress_tid, for the processes in a cgroup.
+
+  \param handle Handle to the capture instance.
+  \param op one of \ref scap_suppress_op
+  \param cgroup_id cgroup v2 id, ignored by SCAP_SUPPRESS_CLEAR
+*/
+int32_t scap_suppress_cgroup(scap_t* handle, enum scap_suppress_op op, uint64_t cgroup_id);
+
+/*!
+  \brief Coalesce the successful read/write syscalls of each (thread, fd) pair
+  into PPME_IO_AGGREGATE_E events, instead of sending one event per syscall.
+  Pending aggregates are also flushed when the fd is closed, as long as close
+  is among the syscalls of interest, when the thread exits and on the first
+  syscall of the thread past the interval. Pending aggregates are discarded
+  when the aggregation is disabled.
+
+  \param handle Handle to the capture instance.
+  \param params thresholds, NULL to disable the aggregation
+  \note This function is only supported by the modern BPF engine.
+*/
+int32_t scap_set_io_aggregation(scap_t* handle, const scap_io_aggregation_params* params);
+
+/*!
+  \brief Limit in the driver the syscalls of every process in an event
+  category. The events above the rate are dropped and reported by periodic
+  PPME_RATE_LIMIT_DROPS_E summaries. Syscalls that the sampling logic never
+  drops are never limited. The drops not reported yet when the capture is
+  stopped are returned by scap_next() once the buffers are drained.
+
+  \param handle Handle to the capture instance.
+  \param params category and token bucket configuration
+  \note This function is only supported by the modern BPF engine.
+*/
+int32_t scap_set_rate_limit(scap_t* handle, const scap_rate_limit_params* params);
+
+/*!
+  \brief Add or remove a filter on the arguments of the open family of
+  syscalls and of connect. Matching events are dropped in the driver, before
+  reaching the ring buffer. Relative paths and non-IP sockets are never
+  filtered.
+
+  \param handle Handle to the capture instance.
+  \param params filter to add or remove
+  \note This function is only supported by the modern BPF engine.
+*/
+int32_t scap_set_arg_filter(scap_t* handle, const scap_arg_filter_params* params);
+
+/*!
+  \brief Compute in the driver a log2 latency histogram for every (cgroup,
+  syscall) pair. No event is sent, the histograms are reported by
+  scap_get_stats_v2 with the METRICS_V2_KERNEL_SYSCALL_LATENCY flag. The
+  histograms are discarded when disabled.
+
+  \param handle Handle to the capture instance.
+  \param enabled whether to compute the histograms
+  \note This function is only supported by the modern BPF engine.
+*/
+int32_t scap_set_syscall_latency(scap_t* handle, bool enabled);
+
 /*!
   \brief Get the root directory of the system. This usually changes
   if running in a container, so that all the information for the
@@ -37,6 +37,10 @@ extern const struct scap_vtable scap_source_plugin_engine;
 extern const struct scap_vtable scap_savefile_engine;
 #endif
 
+#ifdef HAS_ENGINE_MULTI_SAVEFILE
+extern const struct scap_vtable scap_multi_savefile_engine;
+#endif
+
 #ifdef HAS_ENGINE_KMOD
 extern const struct scap_vtable scap_kmod_engine;
 #endif
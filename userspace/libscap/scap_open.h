@@ -39,6 +39,19 @@ typedef struct {
 	bool ppm_sc[PPM_SC_MAX];
 } interesting_ppm_sc_set;
 
+/*!
+ * \brief Time spent, in nanoseconds, in the phases of scap_init() and scap_platform_init(),
+ * and the number of threads the /proc scan could skip. Phases that don't run are left untouched.
+ */
+typedef struct scap_startup_stats {
+	uint64_t bpf_load_ns;       ///< Loading and verification of the BPF programs
+	uint64_t iflist_ns;         ///< Network interfaces import
+	uint64_t userlist_ns;       ///< Users and groups import
+	uint64_t iter_fetch_ns;     ///< Threads and fds fetched through the engine, e.g. BPF iterators
+	uint64_t proc_scan_ns;      ///< Threads and fds read from /proc
+	uint64_t snapshot_threads;  ///< Threads taken from the state snapshot instead of /proc
+} scap_startup_stats;
+
 typedef struct scap_open_args {
 	bool import_users;  ///< true if the user list should be created when opening the capture.
 	interesting_ppm_sc_set ppm_sc_of_interest;  ///< syscalls of interest.
@@ -46,7 +59,11 @@ typedef struct scap_open_args {
 	uint64_t proc_scan_timeout_ms;  //< Timeout in msec, after which so-far-successful scan of /proc
 	                                // should be cut short with success return
 	uint64_t proc_scan_log_interval_ms;  //< Interval for logging progress messages from /proc scan
+	uint32_t proc_scan_workers;  //< Threads reading /proc during the initial scan: 0 picks them
+	                             // based on the number of CPUs, 1 disables the parallel scan
 	void* engine_params;                 ///< engine-specific params.
+	scap_startup_stats* startup_stats;   ///< If not NULL, filled in with the time spent in each
+	                                     ///< phase of the initialization
 } scap_open_args;
 
 #ifdef __cplusplus
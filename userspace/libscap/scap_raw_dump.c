@@ -0,0 +1,271 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2026 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <libscap/scap.h>
+#include <libscap/scap-int.h>
+#include <libscap/scap_savefile_api.h>
+#include <libscap/strl.h>
+#include <libscap/strerror.h>
+
+//
+// Raw dump: events go from the engine to the trace file without being parsed
+// by sinsp, so filtering and truncation only rely on the event header and on
+// the event table.
+//
+struct scap_raw_dumper {
+	scap_t *m_handle;
+	scap_dumper_t *m_dumper;
+	bool m_event_types[PPM_EVENT_MAX];
+	// Sorted, to be searched with bsearch().
+	int64_t *m_tids;
+	uint32_t m_tids_count;
+	bool m_filter_tids;
+	bool m_exclude_tids;
+	bool m_keep_state_events;
+	uint32_t m_snaplen;
+	// Destination of the events rewritten with truncated buffers.
+	uint8_t *m_scratch;
+	uint32_t m_scratch_len;
+	scap_raw_dump_stats m_stats;
+	char m_lasterr[SCAP_LASTERR_SIZE];
+};
+
+static int cmp_tid(const void *a, const void *b) {
+	int64_t ta = *(const int64_t *)a;
+	int64_t tb = *(const int64_t *)b;
+	return ta < tb ? -1 : (ta > tb ? 1 : 0);
+}
+
+scap_raw_dumper_t *scap_raw_dump_open(struct scap *handle,
+                                      struct scap_platform *platform,
+                                      const char *fname,
+                                      const scap_raw_dump_params *params,
+                                      char *lasterr) {
+	if(handle == NULL) {
+		scap_errprintf(lasterr, 0, "raw dump requires a capture instance");
+		return NULL;
+	}
+
+	struct scap_raw_dumper *d = calloc(1, sizeof(*d));
+	if(d == NULL) {
+		scap_errprintf(lasterr, 0, "error allocating the raw dumper");
+		return NULL;
+	}
+	d->m_handle = handle;
+
+	for(uint32_t j = 0; j < PPM_EVENT_MAX; j++) {
+		d->m_event_types[j] = params == NULL || params->event_types == NULL ||
+		                      params->event_types[j];
+	}
+
+	if(params != NULL) {
+		if(params->tids != NULL) {
+			d->m_filter_tids = true;
+			d->m_exclude_tids = params->exclude_tids;
+			d->m_tids_count = params->tids_count;
+			if(d->m_tids_count > 0) {
+				d->m_tids = malloc(sizeof(int64_t) * d->m_tids_count);
+				if(d->m_tids == NULL) {
+					scap_errprintf(lasterr, 0, "error allocating the raw dump tid filter");
+					free(d);
+					return NULL;
+				}
+				memcpy(d->m_tids, params->tids, sizeof(int64_t) * d->m_tids_count);
+				qsort(d->m_tids, d->m_tids_count, sizeof(int64_t), cmp_tid);
+			}
+		}
+		d->m_keep_state_events = params->keep_state_events;
+		d->m_snaplen = params->snaplen;
+	}
+
+	// The state blocks are written here, once.
+	d->m_dumper = scap_dump_open(platform,
+	                             fname,
+	                             params != NULL ? params->compress : SCAP_COMPRESSION_NONE,
+	                             lasterr);
+	if(d->m_dumper == NULL) {
+		free(d->m_tids);
+		free(d);
+		return NULL;
+	}
+
+	return d;
+}
+
+static bool has_large_payload(const scap_evt *e) {
+	return e->type < PPM_EVENT_MAX &&
+	       (scap_get_event_info_table()[e->type].flags & EF_LARGE_PAYLOAD) != 0;
+}
+
+static bool is_filtered_out(struct scap_raw_dumper *d, const scap_evt *e) {
+	if(e->type >= PPM_EVENT_MAX) {
+		return false;
+	}
+
+	const struct ppm_event_info *info = &scap_get_event_info_table()[e->type];
+	if(info->category & EC_INTERNAL) {
+		return false;
+	}
+
+	if(!d->m_event_types[e->type]) {
+		return true;
+	}
+
+	if(d->m_filter_tids && e->tid != (uint64_t)-1) {
+		int64_t tid = (int64_t)e->tid;
+		bool found = d->m_tids_count > 0 &&
+		             bsearch(&tid, d->m_tids, d->m_tids_count, sizeof(int64_t), cmp_tid) != NULL;
+		return found == d->m_exclude_tids;
+	}
+
+	return false;
+}
+
+//
+// If any data buffer of the event is longer than the snaplen, return a copy of
+// the event with the buffers truncated, otherwise the event itself.
+//
+static scap_evt *truncate_buffers(struct scap_raw_dumper *d, scap_evt *e, bool *truncated) {
+	struct scap_sized_buffer params[PPM_MAX_EVENT_PARAMS];
+	const struct ppm_event_info *info;
+	uint32_t nparams;
+	uint32_t j;
+
+	*truncated = false;
+	if(d->m_snaplen == 0 || e->type >= PPM_EVENT_MAX) {
+		return e;
+	}
+
+	info = &scap_get_event_info_table()[e->type];
+	nparams = scap_event_decode_params(e, params);
+	// Events with parameters unknown to this version are written as they are.
+	if(nparams != e->nparams) {
+		return e;
+	}
+
+	for(j = 0; j < nparams; j++) {
+		if(info->params[j].type == PT_BYTEBUF && params[j].size > d->m_snaplen) {
+			break;
+		}
+	}
+	if(j == nparams) {
+		return e;
+	}
+
+	// The truncated event is never larger than the original one.
+	if(d->m_scratch_len < e->len) {
+		uint8_t *scratch = realloc(d->m_scratch, e->len);
+		if(scratch == NULL) {
+			return NULL;
+		}
+		d->m_scratch = scratch;
+		d->m_scratch_len = e->len;
+	}
+
+	size_t len_size = has_large_payload(e) ? sizeof(uint32_t) : sizeof(uint16_t);
+	scap_evt *out = (scap_evt *)d->m_scratch;
+	uint8_t *lens = d->m_scratch + sizeof(scap_evt);
+	uint8_t *data = lens + len_size * nparams;
+
+	memcpy(out, e, sizeof(scap_evt));
+	for(j = 0; j < nparams; j++) {
+		uint32_t size = (uint32_t)params[j].size;
+		if(info->params[j].type == PT_BYTEBUF && size > d->m_snaplen) {
+			size = d->m_snaplen;
+		}
+
+		if(len_size == sizeof(uint32_t)) {
+			memcpy(lens + j * len_size, &size, sizeof(uint32_t));
+		} else {
+			uint16_t size16 = (uint16_t)size;
+			memcpy(lens + j * len_size, &size16, sizeof(uint16_t));
+		}
+		memcpy(data, params[j].buf, size);
+		data += size;
+	}
+	out->len = (uint32_t)(data - d->m_scratch);
+
+	*truncated = true;
+	return out;
+}
+
+int32_t scap_raw_dump_next(scap_raw_dumper_t *d) {
+	scap_evt *e = NULL;
+	uint16_t devid = 0;
+	uint32_t flags = 0;
+
+	int32_t res = scap_next(d->m_handle, &e, &devid, &flags);
+	if(res != SCAP_SUCCESS) {
+		if(res == SCAP_FAILURE) {
+			strlcpy(d->m_lasterr, scap_getlasterr(d->m_handle), sizeof(d->m_lasterr));
+		}
+		return res;
+	}
+	d->m_stats.n_evts++;
+
+	if(is_filtered_out(d, e)) {
+		if(!d->m_keep_state_events || !(scap_event_getinfo(e)->flags & EF_MODIFIES_STATE)) {
+			d->m_stats.n_filtered++;
+			return SCAP_FILTERED_EVENT;
+		}
+		flags |= SCAP_DF_STATE_ONLY;
+	}
+
+	bool truncated;
+	scap_evt *out = truncate_buffers(d, e, &truncated);
+	if(out == NULL) {
+		return scap_errprintf(d->m_lasterr, 0, "error allocating the truncated event");
+	}
+
+	if(has_large_payload(out)) {
+		flags |= SCAP_DF_LARGE;
+	}
+
+	if(scap_dump(d->m_dumper, out, devid, flags) != SCAP_SUCCESS) {
+		strlcpy(d->m_lasterr, scap_dump_getlasterr(d->m_dumper), sizeof(d->m_lasterr));
+		return SCAP_FAILURE;
+	}
+
+	d->m_stats.n_written++;
+	if(truncated) {
+		d->m_stats.n_truncated++;
+	}
+	return SCAP_SUCCESS;
+}
+
+void scap_raw_dump_get_stats(scap_raw_dumper_t *d, scap_raw_dump_stats *stats) {
+	*stats = d->m_stats;
+}
+
+const char *scap_raw_dump_getlasterr(scap_raw_dumper_t *d) {
+	return d ? d->m_lasterr : "null dumper";
+}
+
+void scap_raw_dump_close(scap_raw_dumper_t *d) {
+	if(d == NULL) {
+		return;
+	}
+
+	scap_dump_close(d->m_dumper);
+	free(d->m_scratch);
+	free(d->m_tids);
+	free(d);
+}
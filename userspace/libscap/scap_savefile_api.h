@@ -165,6 +165,77 @@ int32_t scap_dump(scap_dumper_t *d, scap_evt *e, uint16_t cpuid, uint32_t flags)
 */
 const char *scap_dump_getlasterr(scap_dumper_t *handle);
 
+struct scap;
+
+/*!
+  \brief Options of a raw dump, see \ref scap_raw_dump_open.
+*/
+typedef struct scap_raw_dump_params {
+	const bool *event_types;  ///< If not NULL, an array of PPM_EVENT_MAX entries: only the events
+	                          ///< whose type is set are written.
+	const int64_t *tids;      ///< Threads to filter, NULL to write the events of every thread.
+	uint32_t tids_count;      ///< Number of entries in tids.
+	bool exclude_tids;        ///< If true, the events of tids are dropped, otherwise they are the
+	                          ///< only ones written.
+	bool keep_state_events;   ///< If true, filtered out events that modify the thread state are
+	                          ///< written anyway, flagged with SCAP_DF_STATE_ONLY.
+	uint32_t snaplen;         ///< If not 0, data buffers longer than this are truncated.
+	compression_mode compress;
+} scap_raw_dump_params;
+
+/*!
+  \brief Counters of a raw dump, see \ref scap_raw_dump_get_stats.
+*/
+typedef struct scap_raw_dump_stats {
+	uint64_t n_evts;       ///< Events read from the engine.
+	uint64_t n_written;    ///< Events written to the file.
+	uint64_t n_filtered;   ///< Events dropped by the filters.
+	uint64_t n_truncated;  ///< Written events with at least one truncated data buffer.
+} scap_raw_dump_stats;
+
+typedef struct scap_raw_dumper scap_raw_dumper_t;
+
+/*!
+  \brief Open a trace file to be filled with the events of a capture, without any parsing.
+
+  The state blocks (machine info, interfaces, users, processes and fds) are
+  taken from the platform and written once, then \ref scap_raw_dump_next moves
+  the events from the engine to the file, applying the filters and the snaplen
+  of the params. Events not bound to a thread (tid -1) and internal events are
+  never filtered out.
+
+  \param handle Handle to the capture instance, already started.
+  \param platform The platform of the capture instance, can be NULL to skip the state blocks.
+  \param fname The name of the trace file.
+  \param params Filtering and truncation options, NULL to write every event untouched.
+  \param lasterr Buffer of at least SCAP_LASTERR_SIZE bytes, filled in case of error.
+
+  \return The raw dump handle, or NULL in case of error.
+*/
+scap_raw_dumper_t *scap_raw_dump_open(struct scap *handle,
+                                      struct scap_platform *platform,
+                                      const char *fname,
+                                      const scap_raw_dump_params *params,
+                                      char *lasterr);
+
+/*!
+  \brief Read the next event from the engine and write it to the file, if it isn't filtered out.
+
+  \return SCAP_SUCCESS if the event was written, SCAP_FILTERED_EVENT if it was dropped,
+   otherwise the result of \ref scap_next (e.g. SCAP_TIMEOUT, SCAP_EOF). On SCAP_FAILURE,
+   \ref scap_raw_dump_getlasterr returns the cause of the error.
+*/
+int32_t scap_raw_dump_next(scap_raw_dumper_t *d);
+
+void scap_raw_dump_get_stats(scap_raw_dumper_t *d, scap_raw_dump_stats *stats);
+
+const char *scap_raw_dump_getlasterr(scap_raw_dumper_t *d);
+
+/*!
+  \brief Flush and close the trace file. The capture instance is left untouched.
+*/
+void scap_raw_dump_close(scap_raw_dumper_t *d);
+
 #ifdef __cplusplus
 }
 #endif
@@ -81,6 +81,50 @@ enum scap_setting {
 	 * arg1: whether to enabled or disable the feature
 	 */
 	SCAP_DROP_FAILED,
+	/**
+	 * @brief drop in the driver the syscalls of a thread and of its children
+	 * arg1: scap_suppress_op
+	 * arg2: thread id
+	 */
+	SCAP_SUPPRESS_TID,
+	/**
+	 * @brief drop in the driver the syscalls of the processes with a given name
+	 * arg1: scap_suppress_op
+	 * arg2: pointer to the NUL-terminated process name
+	 */
+	SCAP_SUPPRESS_COMM,
+	/**
+	 * @brief drop in the driver the syscalls of the processes in a cgroup
+	 * arg1: scap_suppress_op
+	 * arg2: cgroup v2 id
+	 */
+	SCAP_SUPPRESS_CGROUP,
+	/**
+	 * @brief restrict the syscalls collected for the tasks of a cgroup
+	 * arg1: cgroup v2 id
+	 * arg2: pointer to an array of PPM_SC_MAX bools, NULL to remove the restriction
+	 */
+	SCAP_CGROUP_PPM_SC_MASK,
+	/**
+	 * @brief coalesce read/write syscalls per (thread, fd) in the driver
+	 * arg1: pointer to a scap_io_aggregation_params, NULL to disable the aggregation
+	 */
+	SCAP_IO_AGGREGATION,
+	/**
+	 * @brief rate limit in the driver the syscalls of every process in an event category
+	 * arg1: pointer to a scap_rate_limit_params
+	 */
+	SCAP_RATE_LIMIT,
+	/**
+	 * @brief drop in the driver the events whose arguments match a filter
+	 * arg1: pointer to a scap_arg_filter_params
+	 */
+	SCAP_ARG_FILTER,
+	/**
+	 * @brief compute in the driver the latency histograms of the syscalls
+	 * arg1: whether to enable them
+	 */
+	SCAP_SYSCALL_LATENCY,
 };
 
 struct scap_savefile_vtable {
@@ -0,0 +1,586 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2026 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <libsinsp/columnar_dumper.h>
+#include <libsinsp/filter.h>
+#include <libsinsp/filter/parser.h>
+#include <libsinsp/sinsp.h>
+
+#include <cstring>
+
+//
+// The file layout follows the Parquet specification
+// (https://github.com/apache/parquet-format): the "PAR1" magic, the column
+// chunks of each row group, the FileMetaData footer serialized with the Thrift
+// compact protocol, the footer length and the magic again. Every column chunk is
+// made of a single uncompressed, PLAIN-encoded data page (v1), with RLE-encoded
+// definition levels to represent null values.
+//
+namespace {
+
+constexpr char PARQUET_MAGIC[] = "PAR1";
+constexpr size_t PARQUET_MAGIC_LEN = 4;
+
+// parquet.thrift enums
+enum parquet_type : int32_t {
+	PQ_BOOLEAN = 0,
+	PQ_INT32 = 1,
+	PQ_INT64 = 2,
+	PQ_DOUBLE = 5,
+	PQ_BYTE_ARRAY = 6,
+};
+
+enum parquet_converted_type : int32_t {
+	PQ_CT_NONE = -1,
+	PQ_CT_UTF8 = 0,
+	PQ_CT_UINT_64 = 14,
+};
+
+constexpr int32_t PQ_REPETITION_OPTIONAL = 1;
+constexpr int32_t PQ_ENCODING_PLAIN = 0;
+constexpr int32_t PQ_ENCODING_RLE = 3;
+constexpr int32_t PQ_CODEC_UNCOMPRESSED = 0;
+constexpr int32_t PQ_PAGE_DATA = 0;
+
+//
+// Minimal writer for the Thrift compact protocol, supporting only what's
+// needed by the Parquet metadata structures.
+//
+class thrift_compact_writer {
+public:
+	enum type : uint8_t {
+		T_I32 = 5,
+		T_I64 = 6,
+		T_BINARY = 8,
+		T_LIST = 9,
+		T_STRUCT = 12,
+	};
+
+	void field_i32(int16_t id, int32_t v) {
+		field_header(id, T_I32);
+		varint(zigzag(v));
+	}
+
+	void field_i64(int16_t id, int64_t v) {
+		field_header(id, T_I64);
+		varint(zigzag(v));
+	}
+
+	void field_string(int16_t id, const std::string& v) {
+		field_header(id, T_BINARY);
+		binary(v);
+	}
+
+	void field_list(int16_t id, type elem_type, size_t size) {
+		field_header(id, T_LIST);
+		list_header(elem_type, size);
+	}
+
+	void field_struct(int16_t id) {
+		field_header(id, T_STRUCT);
+		begin_struct();
+	}
+
+	// For structs in lists, which have no field header.
+	void begin_struct() { m_last_ids.push_back(0); }
+
+	void end_struct() {
+		m_buf.push_back(0);  // STOP
+		m_last_ids.pop_back();
+	}
+
+	void elem_i32(int32_t v) { varint(zigzag(v)); }
+
+	void elem_string(const std::string& v) { binary(v); }
+
+	const std::string& data() const { return m_buf; }
+
+private:
+	static uint64_t zigzag(int64_t v) { return (static_cast<uint64_t>(v) << 1) ^ (v >> 63); }
+
+	void varint(uint64_t v) {
+		while(v >= 0x80) {
+			m_buf.push_back(static_cast<char>((v & 0x7f) | 0x80));
+			v >>= 7;
+		}
+		m_buf.push_back(static_cast<char>(v));
+	}
+
+	void binary(const std::string& v) {
+		varint(v.size());
+		m_buf.append(v);
+	}
+
+	void field_header(int16_t id, type t) {
+		int16_t& last = m_last_ids.back();
+		if(id > last && id - last <= 15) {
+			m_buf.push_back(static_cast<char>(((id - last) << 4) | t));
+		} else {
+			m_buf.push_back(static_cast<char>(t));
+			varint(zigzag(id));
+		}
+		last = id;
+	}
+
+	void list_header(type elem_type, size_t size) {
+		if(size < 15) {
+			m_buf.push_back(static_cast<char>((size << 4) | elem_type));
+		} else {
+			m_buf.push_back(static_cast<char>(0xf0 | elem_type));
+			varint(size);
+		}
+	}
+
+	std::string m_buf;
+	std::vector<int16_t> m_last_ids = {0};
+};
+
+template<typename T>
+void append_le(std::string& buf, T v) {
+	// Parquet is little-endian, as are all the platforms supported by sinsp.
+	buf.append(reinterpret_cast<const char*>(&v), sizeof(T));
+}
+
+uint64_t read_unsigned(const uint8_t* ptr, uint32_t len) {
+	switch(len) {
+	case 1:
+		return *ptr;
+	case 2: {
+		uint16_t v;
+		memcpy(&v, ptr, sizeof(v));
+		return v;
+	}
+	case 4: {
+		uint32_t v;
+		memcpy(&v, ptr, sizeof(v));
+		return v;
+	}
+	default: {
+		uint64_t v = 0;
+		memcpy(&v, ptr, len < sizeof(v) ? len : sizeof(v));
+		return v;
+	}
+	}
+}
+
+int64_t read_signed(const uint8_t* ptr, uint32_t len) {
+	switch(len) {
+	case 1:
+		return static_cast<int8_t>(*ptr);
+	case 2: {
+		int16_t v;
+		memcpy(&v, ptr, sizeof(v));
+		return v;
+	}
+	case 4: {
+		int32_t v;
+		memcpy(&v, ptr, sizeof(v));
+		return v;
+	}
+	default: {
+		int64_t v = 0;
+		memcpy(&v, ptr, len < sizeof(v) ? len : sizeof(v));
+		return v;
+	}
+	}
+}
+
+struct column_layout {
+	parquet_type type;
+	parquet_converted_type converted_type;
+	bool is_signed;
+	bool as_string;
+};
+
+column_layout get_column_layout(const filtercheck_field_info* info) {
+	if(info->is_list()) {
+		return {PQ_BYTE_ARRAY, PQ_CT_UTF8, false, true};
+	}
+
+	switch(info->m_type) {
+	case PT_INT8:
+	case PT_INT16:
+	case PT_INT32:
+		return {PQ_INT32, PQ_CT_NONE, true, false};
+	case PT_INT64:
+	case PT_ERRNO:
+	case PT_FD:
+	case PT_PID:
+		return {PQ_INT64, PQ_CT_NONE, true, false};
+	case PT_UINT8:
+	case PT_UINT16:
+	case PT_UINT32:
+	case PT_FLAGS8:
+	case PT_FLAGS16:
+	case PT_FLAGS32:
+	case PT_ENUMFLAGS8:
+	case PT_ENUMFLAGS16:
+	case PT_ENUMFLAGS32:
+	case PT_UID:
+	case PT_GID:
+	case PT_MODE:
+	case PT_PORT:
+	case PT_SIGTYPE:
+	case PT_SYSCALLID:
+	case PT_L4PROTO:
+	case PT_SOCKFAMILY:
+		// Zero-extended, so that the values always fit in a signed 64-bit column.
+		return {PQ_INT64, PQ_CT_NONE, false, false};
+	case PT_UINT64:
+	case PT_RELTIME:
+	case PT_ABSTIME:
+		return {PQ_INT64, PQ_CT_UINT_64, false, false};
+	case PT_BOOL:
+		return {PQ_BOOLEAN, PQ_CT_NONE, false, false};
+	case PT_DOUBLE:
+		return {PQ_DOUBLE, PQ_CT_NONE, false, false};
+	case PT_CHARBUF:
+	case PT_FSPATH:
+	case PT_FSRELPATH:
+		return {PQ_BYTE_ARRAY, PQ_CT_UTF8, false, false};
+	case PT_BYTEBUF:
+		return {PQ_BYTE_ARRAY, PQ_CT_NONE, false, false};
+	default:
+		return {PQ_BYTE_ARRAY, PQ_CT_UTF8, false, true};
+	}
+}
+
+}  // namespace
+
+struct sinsp_columnar_dumper::column_buffer {
+	column_layout layout;
+
+	// Definition levels (1 = value present), one bit per row.
+	std::vector<uint8_t> defs;
+	// PLAIN-encoded non-null values.
+	std::string values;
+	// Booleans are bit-packed in PLAIN encoding too.
+	uint32_t nbools = 0;
+	uint32_t nrows = 0;
+
+	void add_def(bool present) {
+		if(nrows % 8 == 0) {
+			defs.push_back(0);
+		}
+		if(present) {
+			defs.back() |= 1 << (nrows % 8);
+		}
+		nrows++;
+	}
+
+	void add_bool(bool v) {
+		if(nbools % 8 == 0) {
+			values.push_back(0);
+		}
+		if(v) {
+			values.back() |= static_cast<char>(1 << (nbools % 8));
+		}
+		nbools++;
+	}
+
+	void clear() {
+		defs.clear();
+		values.clear();
+		nbools = 0;
+		nrows = 0;
+	}
+};
+
+struct sinsp_columnar_dumper::row_group_meta {
+	struct chunk {
+		int64_t offset;
+		int64_t size;
+	};
+
+	int64_t num_rows;
+	int64_t total_size;
+	std::vector<chunk> chunks;
+};
+
+sinsp_columnar_dumper::sinsp_columnar_dumper(sinsp* inspector,
+                                             const std::vector<std::string>& fields,
+                                             filter_check_list& available_checks,
+                                             uint32_t row_group_size):
+        m_row_group_size(row_group_size ? row_group_size : DEFAULT_ROW_GROUP_SIZE) {
+	if(fields.empty()) {
+		throw sinsp_exception("columnar dumper: no fields to extract");
+	}
+
+	auto factory = std::make_shared<sinsp_filter_factory>(inspector, available_checks);
+	for(const auto& field : fields) {
+		libsinsp::filter::parser parser(field);
+		std::unique_ptr<libsinsp::filter::ast::expr> ast;
+		try {
+			ast = parser.parse_field_or_transformer();
+		} catch(const sinsp_exception& e) {
+			throw sinsp_exception("columnar dumper: invalid field '" + field + "': " + e.what());
+		}
+		if(parser.get_pos().idx != field.size()) {
+			throw sinsp_exception("columnar dumper: unexpected trailing characters in field '" +
+			                      field + "'");
+		}
+
+		sinsp_extractor_compiler compiler(factory, ast.get());
+		auto chk = compiler.compile();
+		auto layout = get_column_layout(chk->get_transformed_field_info());
+
+		m_columns.push_back({field, chk->get_transformed_field_info()->m_type, layout.as_string});
+		m_checks.push_back(std::move(chk));
+		m_buffers.push_back({});
+		m_buffers.back().layout = layout;
+	}
+}
+
+sinsp_columnar_dumper::~sinsp_columnar_dumper() {
+	if(is_open()) {
+		try {
+			close();
+		} catch(...) {
+		}
+	}
+}
+
+void sinsp_columnar_dumper::open(const std::string& filename) {
+	if(is_open()) {
+		throw sinsp_exception("columnar dumper: already open");
+	}
+
+	m_out.open(filename, std::ios::binary | std::ios::trunc);
+	if(!m_out.is_open()) {
+		throw sinsp_exception("columnar dumper: can't open '" + filename + "'");
+	}
+
+	m_offset = 0;
+	m_nrows = 0;
+	m_pending_rows = 0;
+	m_row_groups.clear();
+	for(auto& b : m_buffers) {
+		b.clear();
+	}
+	write(std::string(PARQUET_MAGIC, PARQUET_MAGIC_LEN));
+}
+
+void sinsp_columnar_dumper::dump(sinsp_evt* evt) {
+	if(!is_open()) {
+		throw sinsp_exception("columnar dumper: not open");
+	}
+
+	for(size_t i = 0; i < m_checks.size(); i++) {
+		auto& chk = m_checks[i];
+		auto& buf = m_buffers[i];
+
+		m_values.clear();
+		if(!chk->extract(evt, m_values) || m_values.empty() || m_values[0].ptr == nullptr) {
+			buf.add_def(false);
+			continue;
+		}
+		buf.add_def(true);
+
+		const auto& v = m_values[0];
+		if(buf.layout.as_string) {
+			auto ftype = chk->get_transformed_field_info()->m_type;
+			auto pformat = chk->get_field_info()->m_print_format;
+			std::string str;
+			if(chk->get_transformed_field_info()->is_list()) {
+				str = "(";
+				for(size_t j = 0; j < m_values.size(); j++) {
+					if(j > 0) {
+						str += ",";
+					}
+					const auto& val = m_values[j];
+					str += chk->rawval_to_string(val.ptr, ftype, pformat, val.len);
+				}
+				str += ")";
+			} else {
+				str = chk->rawval_to_string(v.ptr, ftype, pformat, v.len);
+			}
+			append_le<uint32_t>(buf.values, str.size());
+			buf.values.append(str);
+			continue;
+		}
+
+		switch(buf.layout.type) {
+		case PQ_INT32:
+			append_le<int32_t>(buf.values, static_cast<int32_t>(read_signed(v.ptr, v.len)));
+			break;
+		case PQ_INT64:
+			append_le<int64_t>(buf.values,
+			                   buf.layout.is_signed
+			                           ? read_signed(v.ptr, v.len)
+			                           : static_cast<int64_t>(read_unsigned(v.ptr, v.len)));
+			break;
+		case PQ_BOOLEAN:
+			buf.add_bool(read_unsigned(v.ptr, v.len) != 0);
+			break;
+		case PQ_DOUBLE: {
+			double d = 0;
+			memcpy(&d, v.ptr, v.len < sizeof(d) ? v.len : sizeof(d));
+			append_le<double>(buf.values, d);
+			break;
+		}
+		case PQ_BYTE_ARRAY: {
+			uint32_t len = v.len;
+			if(buf.layout.converted_type == PQ_CT_UTF8) {
+				// Extracted strings usually include the terminator.
+				len = strnlen(reinterpret_cast<const char*>(v.ptr), v.len);
+			}
+			append_le<uint32_t>(buf.values, len);
+			buf.values.append(reinterpret_cast<const char*>(v.ptr), len);
+			break;
+		}
+		}
+	}
+
+	m_nrows++;
+	if(++m_pending_rows >= m_row_group_size) {
+		flush();
+	}
+}
+
+void sinsp_columnar_dumper::flush() {
+	if(!is_open() || m_pending_rows == 0) {
+		return;
+	}
+
+	row_group_meta rg;
+	rg.num_rows = m_pending_rows;
+	rg.total_size = 0;
+
+	for(auto& buf : m_buffers) {
+		// Definition levels: a single bit-packed run of the RLE/bit-packing hybrid
+		// encoding, prefixed by its length.
+		std::string levels;
+		uint64_t header = (static_cast<uint64_t>(buf.defs.size()) << 1) | 1;
+		while(header >= 0x80) {
+			levels.push_back(static_cast<char>((header & 0x7f) | 0x80));
+			header >>= 7;
+		}
+		levels.push_back(static_cast<char>(header));
+		levels.append(reinterpret_cast<const char*>(buf.defs.data()), buf.defs.size());
+
+		std::string page;
+		append_le<uint32_t>(page, levels.size());
+		page.append(levels);
+		page.append(buf.values);
+
+		thrift_compact_writer ph;
+		ph.field_i32(1, PQ_PAGE_DATA);
+		ph.field_i32(2, static_cast<int32_t>(page.size()));
+		ph.field_i32(3, static_cast<int32_t>(page.size()));
+		ph.field_struct(5);
+		ph.field_i32(1, static_cast<int32_t>(buf.nrows));
+		ph.field_i32(2, PQ_ENCODING_PLAIN);
+		ph.field_i32(3, PQ_ENCODING_RLE);
+		ph.field_i32(4, PQ_ENCODING_RLE);
+		ph.end_struct();
+		ph.end_struct();
+
+		int64_t offset = m_offset;
+		write(ph.data());
+		write(page);
+
+		int64_t size = m_offset - offset;
+		rg.chunks.push_back({offset, size});
+		rg.total_size += size;
+		buf.clear();
+	}
+
+	m_row_groups.push_back(std::move(rg));
+	m_pending_rows = 0;
+	m_out.flush();
+}
+
+void sinsp_columnar_dumper::close() {
+	if(!is_open()) {
+		return;
+	}
+
+	flush();
+
+	thrift_compact_writer md;
+	md.field_i32(1, 1);  // version
+
+	// schema: a root element followed by one element per column
+	md.field_list(2, thrift_compact_writer::T_STRUCT, m_columns.size() + 1);
+	md.begin_struct();
+	md.field_string(4, "schema");
+	md.field_i32(5, static_cast<int32_t>(m_columns.size()));
+	md.end_struct();
+	for(size_t i = 0; i < m_columns.size(); i++) {
+		const auto& layout = m_buffers[i].layout;
+		md.begin_struct();
+		md.field_i32(1, layout.type);
+		md.field_i32(3, PQ_REPETITION_OPTIONAL);
+		md.field_string(4, m_columns[i].name);
+		if(layout.converted_type != PQ_CT_NONE) {
+			md.field_i32(6, layout.converted_type);
+		}
+		md.end_struct();
+	}
+
+	md.field_i64(3, static_cast<int64_t>(m_nrows));
+
+	md.field_list(4, thrift_compact_writer::T_STRUCT, m_row_groups.size());
+	for(const auto& rg : m_row_groups) {
+		md.begin_struct();
+		md.field_list(1, thrift_compact_writer::T_STRUCT, rg.chunks.size());
+		for(size_t i = 0; i < rg.chunks.size(); i++) {
+			const auto& chunk = rg.chunks[i];
+			md.begin_struct();
+			md.field_i64(2, chunk.offset);  // file_offset
+			md.field_struct(3);             // meta_data
+			md.field_i32(1, m_buffers[i].layout.type);
+			md.field_list(2, thrift_compact_writer::T_I32, 2);
+			md.elem_i32(PQ_ENCODING_PLAIN);
+			md.elem_i32(PQ_ENCODING_RLE);
+			md.field_list(3, thrift_compact_writer::T_BINARY, 1);
+			md.elem_string(m_columns[i].name);
+			md.field_i32(4, PQ_CODEC_UNCOMPRESSED);
+			md.field_i64(5, rg.num_rows);
+			md.field_i64(6, chunk.size);
+			md.field_i64(7, chunk.size);
+			md.field_i64(9, chunk.offset);  // data_page_offset
+			md.end_struct();
+			md.end_struct();
+		}
+		md.field_i64(2, rg.total_size);
+		md.field_i64(3, rg.num_rows);
+		md.end_struct();
+	}
+
+	md.field_string(6, "falcosecurity libsinsp");
+	md.end_struct();
+
+	std::string footer = md.data();
+	append_le<uint32_t>(footer, md.data().size());
+	footer.append(PARQUET_MAGIC, PARQUET_MAGIC_LEN);
+	write(footer);
+
+	m_out.close();
+	if(m_out.fail()) {
+		throw sinsp_exception("columnar dumper: error closing the file");
+	}
+}
+
+void sinsp_columnar_dumper::write(const std::string& data) {
+	m_out.write(data.data(), data.size());
+	if(!m_out) {
+		throw sinsp_exception("columnar dumper: error writing to the file");
+	}
+	m_offset += data.size();
+}
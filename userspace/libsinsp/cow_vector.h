@@ -0,0 +1,178 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2026 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace libsinsp {
+
+template<typename T>
+class cow_vector_pool;
+
+/**
+ * @brief Vector whose copies share the same immutable storage until one of them is modified.
+ * Reading goes through the const interface only, also on non-const objects, so that iterating
+ * doesn't copy the storage by mistake: the storage is copied only by the calls that modify it,
+ * and only if it's shared.
+ */
+template<typename T>
+class cow_vector {
+public:
+	using value_type = T;
+	using storage_t = std::vector<T>;
+	using const_iterator = typename storage_t::const_iterator;
+	using iterator = const_iterator;
+	using size_type = typename storage_t::size_type;
+
+	cow_vector() = default;
+	cow_vector(storage_t&& v): m_data(make(std::move(v))) {}
+	cow_vector(const storage_t& v): m_data(make(storage_t(v))) {}
+
+	inline const storage_t& get() const { return m_data ? *m_data : empty_storage(); }
+	inline operator const storage_t&() const { return get(); }
+
+	inline size_type size() const { return m_data ? m_data->size() : 0; }
+	inline bool empty() const { return size() == 0; }
+	inline const T& operator[](size_type i) const { return (*m_data)[i]; }
+	inline const_iterator begin() const { return get().begin(); }
+	inline const_iterator end() const { return get().end(); }
+
+	/**
+	 * @brief Returns true if both vectors use the same storage.
+	 */
+	inline bool shares_storage_with(const cow_vector& other) const {
+		return m_data != nullptr && m_data == other.m_data;
+	}
+
+	/**
+	 * @brief Returns the storage for writing, copying it first if other vectors share it or if
+	 * it comes from a pool.
+	 */
+	storage_t& mut() {
+		if(!m_data) {
+			m_data = make({});
+		} else if(m_pooled || m_data.use_count() > 1) {
+			m_data = make(storage_t(*m_data));
+			m_pooled = false;
+		}
+		// the storage is created non-const by make(), only the pooled one is really const
+		return const_cast<storage_t&>(*m_data);
+	}
+
+	inline void clear() {
+		m_data.reset();
+		m_pooled = false;
+	}
+	inline void push_back(const T& v) { mut().push_back(v); }
+	template<typename... Args>
+	inline void emplace_back(Args&&... args) {
+		mut().emplace_back(std::forward<Args>(args)...);
+	}
+
+	inline bool operator==(const cow_vector& other) const {
+		return m_data == other.m_data || get() == other.get();
+	}
+	inline bool operator!=(const cow_vector& other) const { return !(*this == other); }
+	inline bool operator==(const storage_t& other) const { return get() == other; }
+	inline bool operator!=(const storage_t& other) const { return get() != other; }
+
+private:
+	friend class cow_vector_pool<T>;
+
+	cow_vector(std::shared_ptr<const storage_t> data, bool pooled):
+	        m_data(std::move(data)),
+	        m_pooled(pooled) {}
+
+	static inline std::shared_ptr<const storage_t> make(storage_t&& v) {
+		return std::make_shared<storage_t>(std::move(v));
+	}
+
+	static inline const storage_t& empty_storage() {
+		static const storage_t s_empty;
+		return s_empty;
+	}
+
+	std::shared_ptr<const storage_t> m_data;
+	bool m_pooled = false;
+};
+
+/**
+ * @brief Interning pool for cow_vector: equal vectors looked up in the pool share the same
+ * storage as long as one of them is alive. The vectors are looked up by a hash provided by the
+ * caller, which usually comes from the raw data they are parsed from, so that a hit doesn't
+ * need to parse the data at all. Thread-safe.
+ */
+template<typename T>
+class cow_vector_pool {
+public:
+	using storage_t = typename cow_vector<T>::storage_t;
+
+	/**
+	 * @brief Returns the pooled vector with hash `hash` for which `eq` returns true, or the one
+	 * built by `make` and added to the pool if there's none.
+	 */
+	template<typename Eq, typename Make>
+	cow_vector<T> intern(size_t hash, Eq eq, Make make) {
+		std::lock_guard<std::mutex> lock(m_mtx);
+		auto range = m_entries.equal_range(hash);
+		for(auto it = range.first; it != range.second; ++it) {
+			if(auto data = it->second.lock(); data != nullptr && eq(*data)) {
+				return cow_vector<T>(std::move(data), true);
+			}
+		}
+
+		auto data = std::make_shared<const storage_t>(make());
+		m_entries.emplace(hash, data);
+		if(m_entries.size() >= m_next_purge_size) {
+			purge();
+		}
+		return cow_vector<T>(std::move(data), true);
+	}
+
+	size_t size() {
+		std::lock_guard<std::mutex> lock(m_mtx);
+		return m_entries.size();
+	}
+
+private:
+	// Drops the vectors not used anymore, next time the pool doubles in size.
+	void purge() {
+		for(auto it = m_entries.begin(); it != m_entries.end();) {
+			if(it->second.expired()) {
+				it = m_entries.erase(it);
+			} else {
+				++it;
+			}
+		}
+		m_next_purge_size = std::max(s_min_purge_size, m_entries.size() * 2);
+	}
+
+	static constexpr size_t s_min_purge_size = 1024;
+
+	std::mutex m_mtx;
+	std::unordered_multimap<size_t, std::weak_ptr<const storage_t>> m_entries;
+	size_t m_next_purge_size = s_min_purge_size;
+};
+
+}  // namespace libsinsp
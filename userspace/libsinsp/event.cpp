@@ -585,7 +585,7 @@ int sinsp_evt::render_fd_json(Json::Value *ret,
 			// Make sure we remove invalid characters from the resolved name
 			//
 			std::string sanitized_name_storage;
-			const auto sanitized_name = sanitize_string(fdinfo->m_name, sanitized_name_storage);
+			const auto sanitized_name = sanitize_string(fdinfo->m_name.str(), sanitized_name_storage);
 
 			(*ret)["typechar"] = typestr;
 			(*ret)["name"] = sanitized_name.data();
@@ -654,7 +654,7 @@ char *sinsp_evt::render_fd(const int64_t fd, const char ** /*resolved_str*/, con
 			// Make sure we remove invalid characters from the resolved name
 			//
 			std::string sanitized_name_storage;
-			const auto sanitized_name = sanitize_string(fdinfo->m_name, sanitized_name_storage);
+			const auto sanitized_name = sanitize_string(fdinfo->m_name.str(), sanitized_name_storage);
 
 			//
 			// Make sure the string will fit
@@ -835,7 +835,7 @@ const char *sinsp_evt::get_param_as_str(uint32_t id, const char **resolved_str,
 		sinsp_threadinfo *atinfo =
 		        m_inspector->m_thread_manager->find_thread(param->as<int64_t>(), true).get();
 		if(atinfo != nullptr) {
-			std::string &tcomm = atinfo->m_comm;
+			const std::string &tcomm = atinfo->m_comm;
 
 			//
 			// Make sure the string will fit
@@ -276,7 +276,7 @@ libsinsp::state::static_field_infos sinsp_fdinfo::get_static_fields() {
 
 std::string sinsp_fdinfo::tostring_clean() const {
 	std::string sanitized_name_storage;
-	const auto sanitized_name = sanitize_string(m_name, sanitized_name_storage);
+	const auto sanitized_name = sanitize_string(m_name.str(), sanitized_name_storage);
 	if(sanitized_name.data() == m_name.data()) {
 		return m_name;
 	}
@@ -288,7 +288,7 @@ void sinsp_fdinfo::add_filename_raw(std::string_view rawpath) {
 }
 
 void sinsp_fdinfo::add_filename(std::string_view fullpath) {
-	m_name = std::string(fullpath);
+	m_name = fullpath;
 }
 
 void sinsp_fdinfo::set_net_role_by_guessing(const sinsp_threadinfo& ptinfo, const bool incoming) {
@@ -21,6 +21,7 @@ limitations under the License.
 #include <libscap/scap.h>
 #include <libsinsp/tuples.h>
 #include <libsinsp/sinsp_public.h>
+#include <libsinsp/interned_string.h>
 #include <libsinsp/state/table.h>
 
 #include <unordered_map>
@@ -137,7 +138,9 @@ public:
 	/*!
 	  \brief Return true if this is a log device.
 	*/
-	inline bool is_syslog() const { return m_name.find("/dev/log") != std::string::npos; }
+	inline bool is_syslog() const {
+		return m_name.str().find("/dev/log") != std::string::npos;
+	}
 
 	/*!
 	  \brief Returns true if this is a unix socket.
@@ -287,6 +290,14 @@ public:
 
 	void add_filename(std::string_view fullpath);
 
+	/*!
+	  \brief Sets the name of a socket. Tuples and addresses are seldom shared by several fds, so
+	  they are kept out of the string pool.
+	*/
+	inline void set_socket_name(std::string_view name) {
+		m_name = libsinsp::interned_string::unpooled(name);
+	}
+
 	inline void set_role_server() { m_flags |= FLAGS_ROLE_SERVER; }
 
 	inline void set_role_client() { m_flags |= FLAGS_ROLE_CLIENT; }
@@ -366,13 +377,16 @@ public:
 	                           ///< See the PPM_O_* definitions in driver/ppm_events_public.h.
 	sinsp_sockinfo m_sockinfo =
 	        {};  ///< Socket-specific state. This is uninitialized (zero) for non-socket FDs.
-	std::string m_name;  ///< Human readable rendering of this FD. For files, this is the full file
-	                     ///< name. For sockets, this is the tuple. And so on.
+	libsinsp::interned_string m_name;  ///< Human readable rendering of this FD. For files, this is
+	                                   ///< the full file name. For sockets, this is the tuple. And
+	                                   ///< so on. Interned, since many FDs share the same name,
+	                                   ///< except for the sockets (see set_socket_name()).
 	std::string m_name_raw;  // Human readable rendering of this FD. See m_name, only used if fd is
 	                         // a file path. Path is kept "raw" with limited sanitization and
 	                         // without absolute path derivation.
-	std::string m_oldname;  // The name of this fd at the beginning of event parsing. Used to detect
-	                        // name changes that result from parsing an event.
+	libsinsp::interned_string m_oldname;  // The name of this fd at the beginning of event parsing.
+	                                      // Used to detect name changes that result from parsing
+	                                      // an event.
 	uint32_t m_flags = FLAGS_NONE;
 	uint32_t m_dev = 0;
 	uint32_t m_mount_id = 0;
@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2026 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <libsinsp/filter/path_prefixes.h>
+
+/**
+ * The bound of a node is computed as follows:
+ * - "and" nodes are bounded by the smallest bound of their children, since
+ *   every child must be true.
+ * - "or" nodes are bounded by the union of the bounds of their children, as
+ *   long as all of them are bounded.
+ * - "fd.name" checks with "=", "==", "startswith", "in" and "pmatch" are
+ *   bounded by their absolute values. "pmatch" values may contain
+ *   wildcards, so they are cut at the first one.
+ * - anything else, negations included, is unbounded.
+ */
+
+using prefix_set_t = std::set<std::string>;
+
+static bool is_absolute(const std::string& path) {
+	return !path.empty() && path[0] == '/';
+}
+
+struct fd_name_prefix_visitor : public libsinsp::filter::ast::const_expr_visitor {
+	std::optional<prefix_set_t> m_last_node_prefixes;
+
+	void visit(const libsinsp::filter::ast::and_expr* e) override {
+		std::optional<prefix_set_t> prefixes;
+		for(auto& c : e->children) {
+			c->accept(this);
+			if(m_last_node_prefixes.has_value() &&
+			   (!prefixes.has_value() || m_last_node_prefixes->size() < prefixes->size())) {
+				prefixes = std::move(m_last_node_prefixes);
+			}
+		}
+		m_last_node_prefixes = std::move(prefixes);
+	}
+
+	void visit(const libsinsp::filter::ast::or_expr* e) override {
+		prefix_set_t prefixes;
+		for(auto& c : e->children) {
+			c->accept(this);
+			if(!m_last_node_prefixes.has_value()) {
+				return;
+			}
+			prefixes.insert(m_last_node_prefixes->begin(), m_last_node_prefixes->end());
+		}
+		m_last_node_prefixes = std::move(prefixes);
+	}
+
+	void visit(const libsinsp::filter::ast::not_expr*) override {
+		m_last_node_prefixes.reset();
+	}
+
+	void visit(const libsinsp::filter::ast::identifier_expr*) override {
+		m_last_node_prefixes.reset();
+	}
+
+	void visit(const libsinsp::filter::ast::value_expr*) override {
+		m_last_node_prefixes.reset();
+	}
+
+	void visit(const libsinsp::filter::ast::list_expr*) override {
+		m_last_node_prefixes.reset();
+	}
+
+	void visit(const libsinsp::filter::ast::transformer_list_expr*) override {
+		m_last_node_prefixes.reset();
+	}
+
+	void visit(const libsinsp::filter::ast::unary_check_expr*) override {
+		m_last_node_prefixes.reset();
+	}
+
+	void visit(const libsinsp::filter::ast::binary_check_expr* e) override {
+		m_last_node_prefixes.reset();
+		auto field = dynamic_cast<const libsinsp::filter::ast::field_expr*>(e->left.get());
+		if(field == nullptr || field->field != "fd.name" || field->arg) {
+			return;
+		}
+
+		prefix_set_t prefixes;
+		if(e->op == "=" || e->op == "==" || e->op == "startswith") {
+			auto value = dynamic_cast<const libsinsp::filter::ast::value_expr*>(e->right.get());
+			if(value == nullptr || !is_absolute(value->value)) {
+				return;
+			}
+			prefixes.insert(value->value);
+		} else if(e->op == "in" || e->op == "pmatch") {
+			auto list = dynamic_cast<const libsinsp::filter::ast::list_expr*>(e->right.get());
+			if(list == nullptr) {
+				return;
+			}
+			for(const auto& v : list->values) {
+				if(!is_absolute(v)) {
+					return;
+				}
+				prefixes.insert(e->op == "pmatch" ? v.substr(0, v.find_first_of("*?[")) : v);
+			}
+		} else {
+			return;
+		}
+		m_last_node_prefixes = std::move(prefixes);
+	}
+
+	void visit(const libsinsp::filter::ast::field_expr*) override {
+		m_last_node_prefixes.reset();
+	}
+
+	void visit(const libsinsp::filter::ast::field_transformer_expr*) override {
+		m_last_node_prefixes.reset();
+	}
+};
+
+std::optional<prefix_set_t> libsinsp::filter::ast::fd_name_prefixes(const expr* e) {
+	fd_name_prefix_visitor v;
+	e->accept(&v);
+	return v.m_last_node_prefixes;
+}
@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2026 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <libsinsp/filter/ast.h>
+
+#include <optional>
+#include <set>
+#include <string>
+
+namespace libsinsp {
+namespace filter {
+namespace ast {
+
+/*!
+    \brief Visits a filter AST and returns a set of absolute path prefixes
+    such that the `fd.name` of every event for which the filter expression
+    can be evaluated as true starts with at least one of them. Returns
+    std::nullopt when no such bound can be derived. The result is meant to
+    feed the in-driver path filters of the open family of syscalls, so
+    the derivation is conservative: negations, transformers and unknown
+    operators are never bounded.
+    \param e The AST expression to be visited
+*/
+std::optional<std::set<std::string>> fd_name_prefixes(const expr* e);
+
+}  // namespace ast
+}  // namespace filter
+}  // namespace libsinsp
@@ -0,0 +1,107 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2026 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <libsinsp/interned_string.h>
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+using namespace libsinsp;
+
+namespace {
+struct string_pool {
+	std::mutex mtx;
+	// keys point to the string of their entry
+	std::unordered_map<std::string_view, std::unique_ptr<interned_string::entry>> entries;
+	std::vector<uint32_t> free_ids;
+	uint32_t next_id = 1;
+};
+
+// Never destroyed, since interned strings may outlive any other static object.
+// The same goes for the empty string entry below.
+string_pool& pool() {
+	static auto* p = new string_pool();
+	return *p;
+}
+}  // namespace
+
+interned_string::entry* interned_string::empty_entry() noexcept {
+	static auto* s_empty = new entry();
+	return s_empty;
+}
+
+interned_string::entry* interned_string::intern(std::string_view s) {
+	if(s.empty()) {
+		return empty_entry();
+	}
+
+	auto& p = pool();
+	std::lock_guard<std::mutex> lock(p.mtx);
+	auto it = p.entries.find(s);
+	if(it != p.entries.end()) {
+		it->second->refs.fetch_add(1, std::memory_order_relaxed);
+		return it->second.get();
+	}
+
+	auto e = std::make_unique<entry>();
+	e->str = s;
+	if(!p.free_ids.empty()) {
+		e->id = p.free_ids.back();
+		p.free_ids.pop_back();
+	} else {
+		e->id = p.next_id++;
+	}
+	auto* ret = e.get();
+	p.entries.emplace(std::string_view(ret->str), std::move(e));
+	return ret;
+}
+
+interned_string interned_string::unpooled(std::string_view s) {
+	if(s.empty()) {
+		return interned_string();
+	}
+
+	auto* e = new entry();
+	e->str = s;
+	e->id = UNPOOLED_ID;
+	return interned_string(e);
+}
+
+void interned_string::release(entry* e) noexcept {
+	if(e->id == UNPOOLED_ID) {
+		if(e->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			delete e;
+		}
+		return;
+	}
+
+	auto& p = pool();
+	std::lock_guard<std::mutex> lock(p.mtx);
+	if(e->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		p.free_ids.push_back(e->id);
+		p.entries.erase(p.entries.find(std::string_view(e->str)));
+	}
+}
+
+size_t interned_string::pool_size() {
+	auto& p = pool();
+	std::lock_guard<std::mutex> lock(p.mtx);
+	return p.entries.size();
+}
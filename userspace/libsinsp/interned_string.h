@@ -0,0 +1,193 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2026 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace libsinsp {
+
+/**
+ * @brief Immutable string stored once in a global pool: all the interned strings with the same
+ * value point to the same storage, which stays at the same address, and has the same id, for as
+ * long as one of them is alive. Comparing two interned strings is a pointer comparison.
+ *
+ * The pool is thread-safe. Copying an interned string doesn't lock it, assigning a new value does.
+ *
+ * Values unlikely to be shared, e.g. socket tuples, can be kept out of the pool with unpooled():
+ * the copies still share the storage, but it's allocated apart and freed without the pool lock.
+ */
+class interned_string {
+public:
+	interned_string() noexcept: m_entry(empty_entry()) {}
+	interned_string(std::string_view s): m_entry(intern(s)) {}
+	interned_string(const std::string& s): interned_string(std::string_view(s)) {}
+	interned_string(const char* s): interned_string(std::string_view(s)) {}
+	interned_string(const interned_string& o) noexcept: m_entry(o.m_entry) { ref(m_entry); }
+	interned_string(interned_string&& o) noexcept: m_entry(o.m_entry) {
+		o.m_entry = empty_entry();
+	}
+	~interned_string() { unref(m_entry); }
+
+	/**
+	 * @brief Returns a string with the value `s` that is not added to the pool.
+	 */
+	static interned_string unpooled(std::string_view s);
+
+	interned_string& operator=(const interned_string& o) noexcept {
+		ref(o.m_entry);
+		unref(m_entry);
+		m_entry = o.m_entry;
+		return *this;
+	}
+	interned_string& operator=(interned_string&& o) noexcept {
+		if(this != &o) {
+			unref(m_entry);
+			m_entry = o.m_entry;
+			o.m_entry = empty_entry();
+		}
+		return *this;
+	}
+	interned_string& operator=(std::string_view s) {
+		if(s != m_entry->str) {
+			entry* e = intern(s);
+			unref(m_entry);
+			m_entry = e;
+		}
+		return *this;
+	}
+	interned_string& operator=(const std::string& s) { return *this = std::string_view(s); }
+	interned_string& operator=(const char* s) { return *this = std::string_view(s); }
+
+	inline const std::string& str() const noexcept { return m_entry->str; }
+	inline operator const std::string&() const noexcept { return m_entry->str; }
+
+	inline const char* c_str() const noexcept { return m_entry->str.c_str(); }
+	inline const char* data() const noexcept { return m_entry->str.data(); }
+	inline size_t size() const noexcept { return m_entry->str.size(); }
+	inline size_t length() const noexcept { return m_entry->str.size(); }
+	inline bool empty() const noexcept { return m_entry->str.empty(); }
+	inline const char& operator[](size_t i) const noexcept { return m_entry->str[i]; }
+	inline const char& back() const noexcept { return m_entry->str.back(); }
+	inline void clear() noexcept {
+		unref(m_entry);
+		m_entry = empty_entry();
+	}
+
+	/**
+	 * @brief Returns the id of the string in the pool, 0 for the empty string and UNPOOLED_ID for
+	 * the strings not in the pool. Ids of strings no longer interned are reused.
+	 */
+	inline uint32_t id() const noexcept { return m_entry->id; }
+
+	static constexpr uint32_t UNPOOLED_ID = UINT32_MAX;
+
+	// Two pooled strings are equal only if they share the same entry.
+	inline bool operator==(const interned_string& o) const noexcept {
+		return m_entry == o.m_entry ||
+		       ((m_entry->id == UNPOOLED_ID || o.m_entry->id == UNPOOLED_ID) &&
+		        m_entry->str == o.m_entry->str);
+	}
+	inline bool operator!=(const interned_string& o) const noexcept { return !(*this == o); }
+	inline bool operator==(std::string_view s) const noexcept { return m_entry->str == s; }
+	inline bool operator!=(std::string_view s) const noexcept { return m_entry->str != s; }
+	inline bool operator==(const std::string& s) const noexcept { return m_entry->str == s; }
+	inline bool operator!=(const std::string& s) const noexcept { return m_entry->str != s; }
+	inline bool operator==(const char* s) const noexcept { return m_entry->str == s; }
+	inline bool operator!=(const char* s) const noexcept { return m_entry->str != s; }
+
+	/**
+	 * @brief Returns the number of distinct strings currently interned.
+	 */
+	static size_t pool_size();
+
+	struct entry {
+		std::string str;
+		std::atomic<uint32_t> refs{1};
+		uint32_t id = 0;
+	};
+
+private:
+	explicit interned_string(entry* e) noexcept: m_entry(e) {}
+
+	static entry* empty_entry() noexcept;
+	static entry* intern(std::string_view s);
+	static void release(entry* e) noexcept;
+
+	static inline void ref(entry* e) noexcept {
+		// the empty string is never released, no need to count its references
+		if(e->id != 0) {
+			e->refs.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+	static inline void unref(entry* e) noexcept {
+		if(e->id == 0) {
+			return;
+		}
+		// the last reference of a pooled string is dropped under the pool lock, so that the
+		// string can't be looked up again while it's being removed
+		uint32_t refs = e->refs.load(std::memory_order_relaxed);
+		while(refs > 1) {
+			if(e->refs.compare_exchange_weak(refs, refs - 1, std::memory_order_acq_rel)) {
+				return;
+			}
+		}
+		release(e);
+	}
+
+	entry* m_entry;
+};
+
+inline bool operator==(const std::string& s, const interned_string& i) noexcept {
+	return i == s;
+}
+inline bool operator!=(const std::string& s, const interned_string& i) noexcept {
+	return i != s;
+}
+inline bool operator==(const char* s, const interned_string& i) noexcept {
+	return i == s;
+}
+inline bool operator!=(const char* s, const interned_string& i) noexcept {
+	return i != s;
+}
+
+inline std::string operator+(const interned_string& i, const std::string& s) {
+	return i.str() + s;
+}
+inline std::string operator+(const std::string& s, const interned_string& i) {
+	return s + i.str();
+}
+inline std::string operator+(const interned_string& i, const char* s) {
+	return i.str() + s;
+}
+inline std::string operator+(const char* s, const interned_string& i) {
+	return s + i.str();
+}
+inline std::string operator+(const interned_string& i, char c) {
+	return i.str() + c;
+}
+
+inline std::ostream& operator<<(std::ostream& os, const interned_string& s) {
+	return os << s.str();
+}
+
+}  // namespace libsinsp
@@ -0,0 +1,250 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2026 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <libsinsp/linux/proc_rescan.h>
+#include <libscap/linux/scap_linux_platform.h>
+#include <libscap/scap_procs.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <mutex>
+
+// Threads read from /proc in each run of the routine, so that a rescan shares the thread pool
+// with the other routines and can be stopped quickly.
+static constexpr size_t PROC_RESCAN_BATCH_SIZE = 64;
+
+struct sinsp_proc_rescan::state {
+	// A procfs-only reader with its own cgroup cache, so that the routine never touches the
+	// platform used by the inspector thread, nor the engine.
+	scap_linux_platform* m_reader = nullptr;
+	bool m_scan_sockets = false;
+	std::unordered_set<int64_t> m_known_tids;
+
+	// Owned by the routine.
+	bool m_listed = false;
+	std::vector<int64_t> m_missing_tids;
+	size_t m_next_tid = 0;
+
+	// Held by the routine while it uses the reader.
+	std::mutex m_reader_mtx;
+	std::atomic<bool> m_stop{false};
+	std::atomic<bool> m_running{false};
+
+	std::mutex m_ready_mtx;
+	std::vector<entry> m_ready;
+	std::atomic<size_t> m_num_ready{0};
+
+	~state() { scap_linux_free_proc_reader(m_reader); }
+};
+
+static bool parse_tid(const std::filesystem::path& path, int64_t& tid) {
+	const std::string name = path.filename().string();
+	char* end = nullptr;
+	tid = strtoll(name.c_str(), &end, 10);
+	return !name.empty() && *end == '\0' && tid > 0;
+}
+
+// Lists the tids alive right now, i.e. the ones of each /proc/<pid>/task.
+static void list_live_tids(std::vector<int64_t>& tids) {
+	std::error_code ec;
+	const std::filesystem::path proc_dir = std::string(scap_get_host_root()) + "/proc";
+	for(const auto& proc_entry : std::filesystem::directory_iterator(proc_dir, ec)) {
+		int64_t pid;
+		if(!parse_tid(proc_entry.path(), pid)) {
+			continue;
+		}
+
+		std::error_code task_ec;
+		for(const auto& task_entry :
+		    std::filesystem::directory_iterator(proc_entry.path() / "task", task_ec)) {
+			int64_t tid;
+			if(parse_tid(task_entry.path(), tid)) {
+				tids.push_back(tid);
+			}
+		}
+	}
+}
+
+// Copies the threads and files read from /proc, as the scap structs only live until the
+// callback returns.
+static int32_t collect_proc_entry(void* context,
+                                  char* error,
+                                  int64_t tid,
+                                  scap_threadinfo* tinfo,
+                                  scap_fdinfo* fdinfo,
+                                  scap_threadinfo** new_tinfo) {
+	auto& entries = *static_cast<std::vector<sinsp_proc_rescan::entry>*>(context);
+
+	if(fdinfo == nullptr) {
+		entries.emplace_back();
+		entries.back().tinfo = *tinfo;
+		entries.back().tinfo.fdlist = nullptr;
+		if(new_tinfo != nullptr) {
+			*new_tinfo = tinfo;
+		}
+	} else if(!entries.empty() && static_cast<int64_t>(entries.back().tinfo.tid) == tid) {
+		entries.back().fds.push_back(*fdinfo);
+	}
+
+	return SCAP_SUCCESS;
+}
+
+sinsp_proc_rescan::sinsp_proc_rescan(const std::shared_ptr<sinsp_thread_pool>& tpool):
+        m_thread_pool(tpool) {}
+
+sinsp_proc_rescan::~sinsp_proc_rescan() {
+	stop();
+}
+
+bool sinsp_proc_rescan::start(scap_linux_platform* platform,
+                              std::unordered_set<int64_t> known_tids,
+                              bool scan_sockets) {
+	if(m_thread_pool == nullptr || platform == nullptr || busy()) {
+		return false;
+	}
+
+	// Each rescan has its own state, so that a routine left over by a stopped rescan can't
+	// mix its threads with the ones of the new rescan.
+	auto st = std::make_shared<state>();
+	char error[SCAP_LASTERR_SIZE];
+	st->m_reader = scap_linux_alloc_proc_reader(platform, error);
+	if(st->m_reader == nullptr) {
+		return false;
+	}
+	st->m_scan_sockets = scan_sockets;
+	st->m_known_tids = std::move(known_tids);
+	st->m_running = true;
+	m_state = st;
+	m_exited_tids.clear();
+
+	m_thread_pool->subscribe([st]() { return run(*st); });
+	return true;
+}
+
+void sinsp_proc_rescan::stop() {
+	if(m_state == nullptr) {
+		return;
+	}
+
+	m_state->m_stop = true;
+	// Wait for the batch being read, if any: the next runs of the routine return right away.
+	std::lock_guard<std::mutex> lock(m_state->m_reader_mtx);
+	m_state->m_running = false;
+	m_state.reset();
+	m_exited_tids.clear();
+}
+
+bool sinsp_proc_rescan::busy() const {
+	return m_state != nullptr && (m_state->m_running || m_state->m_num_ready > 0);
+}
+
+size_t sinsp_proc_rescan::consume(const std::function<void(entry&)>& apply) {
+	if(m_state == nullptr || m_state->m_num_ready == 0) {
+		return 0;
+	}
+
+	std::vector<entry> ready;
+	{
+		std::lock_guard<std::mutex> lock(m_state->m_ready_mtx);
+		ready.swap(m_state->m_ready);
+		m_state->m_num_ready = 0;
+	}
+
+	size_t applied = 0;
+	for(auto& e : ready) {
+		if(m_exited_tids.find(e.tinfo.tid) != m_exited_tids.end()) {
+			continue;
+		}
+		apply(e);
+		applied++;
+	}
+
+	if(!m_state->m_running && m_state->m_num_ready == 0) {
+		m_state.reset();
+		m_exited_tids.clear();
+	}
+	return applied;
+}
+
+void sinsp_proc_rescan::on_thread_exit(int64_t tid) {
+	if(busy()) {
+		m_exited_tids.insert(tid);
+	}
+}
+
+bool sinsp_proc_rescan::run(state& st) {
+	std::lock_guard<std::mutex> lock(st.m_reader_mtx);
+	if(st.m_stop) {
+		return false;
+	}
+
+	// The first run only diffs the live tids against the known ones, so that the listing is not
+	// delayed by reading the threads.
+	if(!st.m_listed) {
+		std::vector<int64_t> live_tids;
+		list_live_tids(live_tids);
+		for(const auto tid : live_tids) {
+			if(st.m_known_tids.find(tid) == st.m_known_tids.end()) {
+				st.m_missing_tids.push_back(tid);
+			}
+		}
+		st.m_known_tids.clear();
+		st.m_listed = true;
+		if(st.m_missing_tids.empty()) {
+			st.m_running = false;
+			return false;
+		}
+		return true;
+	}
+
+	std::vector<entry> entries;
+	scap_proclist proclist;
+	init_proclist(&proclist,
+	              {default_refresh_start_end_callback,
+	               default_refresh_start_end_callback,
+	               collect_proc_entry,
+	               &entries});
+
+	char error[SCAP_LASTERR_SIZE];
+	const size_t end = std::min(st.m_next_tid + PROC_RESCAN_BATCH_SIZE, st.m_missing_tids.size());
+	for(; st.m_next_tid < end && !st.m_stop; st.m_next_tid++) {
+		// The thread may be gone in the meantime, it's not an error.
+		scap_linux_read_thread(st.m_reader,
+		                       &proclist,
+		                       st.m_missing_tids[st.m_next_tid],
+		                       st.m_scan_sockets,
+		                       error);
+	}
+
+	if(!entries.empty()) {
+		std::lock_guard<std::mutex> ready_lock(st.m_ready_mtx);
+		for(auto& e : entries) {
+			st.m_ready.push_back(std::move(e));
+		}
+		st.m_num_ready = st.m_ready.size();
+	}
+
+	if(st.m_next_tid < st.m_missing_tids.size() && !st.m_stop) {
+		return true;
+	}
+
+	st.m_running = false;
+	return false;
+}
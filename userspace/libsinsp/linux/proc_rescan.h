@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2026 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#pragma once
+
+#include <libscap/scap.h>
+#include <libsinsp/sinsp_thread_pool.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+struct scap_linux_platform;
+
+/*!
+  \brief Recovers the threads missing from the thread table, e.g. after drops, by reading them
+  from /proc on the inspector thread pool. The threads are only handed to the inspector once they
+  are ready, so that event processing never blocks on procfs.
+*/
+class sinsp_proc_rescan {
+public:
+	/*!
+	  \brief A thread read from /proc, along with its files if it's a main thread.
+	*/
+	struct entry {
+		scap_threadinfo tinfo;
+		std::vector<scap_fdinfo> fds;
+	};
+
+	explicit sinsp_proc_rescan(const std::shared_ptr<sinsp_thread_pool>& tpool);
+
+	~sinsp_proc_rescan();
+
+	/*!
+	  \brief Starts reading from /proc the threads that are alive but not in `known_tids`. The
+	  settings of `platform` are copied, it's not used once this returns.
+	  \return false if a rescan is already in progress or it can't be started.
+	*/
+	bool start(scap_linux_platform* platform,
+	           std::unordered_set<int64_t> known_tids,
+	           bool scan_sockets);
+
+	/*!
+	  \brief Stops the rescan in progress, if any, and drops the threads not consumed yet. After it
+	  returns the thread pool doesn't read from /proc anymore.
+	*/
+	void stop();
+
+	/*!
+	  \brief Returns true if a rescan is in progress or some threads are waiting to be consumed.
+	*/
+	bool busy() const;
+
+	/*!
+	  \brief Passes the threads read so far to `apply`, on the calling thread.
+	  \return The number of threads passed to `apply`.
+	*/
+	size_t consume(const std::function<void(entry&)>& apply);
+
+	/*!
+	  \brief Records that the thread `tid` exited while a rescan is in progress, so that it's
+	  not passed to `consume` if it was read from /proc before exiting. Must be called on the
+	  thread calling `consume`.
+	*/
+	void on_thread_exit(int64_t tid);
+
+private:
+	struct state;
+
+	static bool run(state& st);
+
+	std::shared_ptr<sinsp_thread_pool> m_thread_pool;
+	std::shared_ptr<state> m_state;
+
+	// The threads that exited during the rescan in progress.
+	std::unordered_set<int64_t> m_exited_tids;
+};
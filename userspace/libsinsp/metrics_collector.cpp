@@ -380,6 +380,44 @@ std::vector<metrics_v2> libs_state_counters::to_metrics() {
 	return metrics;
 }
 
+std::vector<metrics_v2> libs_startup_metrics::to_metrics() {
+	const std::pair<const char*, uint64_t> durations[] = {
+	        {"startup_engine_load_ns", m_stats.m_engine_load_ns},
+	        {"startup_bpf_load_ns", m_stats.m_bpf_load_ns},
+	        {"startup_iter_fetch_ns", m_stats.m_iter_fetch_ns},
+	        {"startup_proc_scan_ns", m_stats.m_proc_scan_ns},
+	        {"startup_user_import_ns", m_stats.m_user_import_ns},
+	        {"startup_ifaddr_import_ns", m_stats.m_ifaddr_import_ns},
+	        {"startup_plugin_init_ns", m_stats.m_plugin_init_ns},
+	        {"startup_total_ns", m_stats.m_total_ns},
+	};
+	const std::pair<const char*, uint64_t> counts[] = {
+	        {"startup_n_threads", m_stats.m_n_threads},
+	        {"startup_n_fds", m_stats.m_n_fds},
+	        {"startup_n_sockets", m_stats.m_n_sockets},
+	        {"startup_n_snapshot_threads", m_stats.m_n_snapshot_threads},
+	};
+
+	std::vector<metrics_v2> metrics;
+	for(const auto& [name, val] : durations) {
+		metrics.emplace_back(new_metric(name,
+		                                METRICS_V2_STARTUP,
+		                                METRIC_VALUE_TYPE_U64,
+		                                METRIC_VALUE_UNIT_TIME_NS,
+		                                METRIC_VALUE_METRIC_TYPE_NON_MONOTONIC_CURRENT,
+		                                val));
+	}
+	for(const auto& [name, val] : counts) {
+		metrics.emplace_back(new_metric(name,
+		                                METRICS_V2_STARTUP,
+		                                METRIC_VALUE_TYPE_U64,
+		                                METRIC_VALUE_UNIT_COUNT,
+		                                METRIC_VALUE_METRIC_TYPE_NON_MONOTONIC_CURRENT,
+		                                val));
+	}
+	return metrics;
+}
+
 void libs_metrics_collector::snapshot() {
 	m_metrics.clear();
 	if(!m_inspector) {
@@ -393,7 +431,8 @@ void libs_metrics_collector::snapshot() {
 	if((m_metrics_flags & METRICS_V2_KERNEL_COUNTERS) ||
 	   (m_metrics_flags & METRICS_V2_LIBBPF_STATS) ||
 	   (m_metrics_flags & METRICS_V2_KERNEL_COUNTERS_PER_CPU) ||
-	   (m_metrics_flags & METRICS_V2_KERNEL_ITER_COUNTERS)) {
+	   (m_metrics_flags & METRICS_V2_KERNEL_ITER_COUNTERS) ||
+	   (m_metrics_flags & METRICS_V2_KERNEL_SYSCALL_LATENCY)) {
 		uint32_t nstats = 0;
 		int32_t rc = 0;
 		// libscap metrics: m_metrics_flags are pushed down from consumers' input,
@@ -428,6 +467,12 @@ void libs_metrics_collector::snapshot() {
 		m_metrics.insert(m_metrics.end(), sc_metrics.begin(), sc_metrics.end());
 	}
 
+	if((m_metrics_flags & METRICS_V2_STARTUP)) {
+		libs_startup_metrics startup_metrics(m_inspector->get_startup_stats());
+		std::vector<metrics_v2> st_metrics = startup_metrics.to_metrics();
+		m_metrics.insert(m_metrics.end(), st_metrics.begin(), st_metrics.end());
+	}
+
 	/*
 	 * plugins metrics
 	 */
@@ -55,6 +55,27 @@ struct sinsp_stats_v2 {
 	uint32_t m_n_drops_full_threadtable;  ///< Number of drops due to full threadtable, unit: count.
 };
 
+struct sinsp_startup_stats {
+	///@(
+	/** time spent in each phase of the last open of the inspector, unit: ns. */
+	uint64_t m_engine_load_ns;  ///< Engine initialization, BPF load included.
+	uint64_t m_bpf_load_ns;     ///< Loading and verification of the BPF programs.
+	uint64_t m_iter_fetch_ns;   ///< Initial threads and fds fetched through the engine.
+	uint64_t m_proc_scan_ns;    ///< Initial threads and fds read from /proc.
+	uint64_t m_user_import_ns;
+	uint64_t m_ifaddr_import_ns;
+	uint64_t m_plugin_init_ns;  ///< Async event handlers and capture_open() of the plugins.
+	uint64_t m_total_ns;
+	///@)
+	///@(
+	/** state right after the open, unit: count. */
+	uint64_t m_n_threads;
+	uint64_t m_n_fds;
+	uint64_t m_n_sockets;
+	uint64_t m_n_snapshot_threads;  ///< Threads taken from the state snapshot.
+	///@)
+};
+
 namespace libs::metrics {
 
 template<typename T>
@@ -308,6 +329,16 @@ private:
 	                       ///< table, unit: count.
 };
 
+class libs_startup_metrics : libsinsp_metrics {
+public:
+	explicit libs_startup_metrics(const sinsp_startup_stats& stats): m_stats(stats) {}
+
+	std::vector<metrics_v2> to_metrics() override;
+
+private:
+	sinsp_startup_stats m_stats;
+};
+
 class libs_metrics_collector {
 public:
 	libs_metrics_collector(sinsp* inspector, uint32_t flags);
@@ -132,6 +132,9 @@ void sinsp_parser::process_event(sinsp_evt &evt, sinsp_parser_verdict &verdict)
 	case PPME_SOCKET_SENDMMSG_X:
 		parse_write_exit(evt, verdict);
 		break;
+	case PPME_IO_AGGREGATE_E:
+		parse_io_aggregate(evt);
+		break;
 	case PPME_SYSCALL_SENDFILE_X:
 		parse_sendfile_exit(evt, verdict);
 		break;
@@ -2294,7 +2297,7 @@ void sinsp_parser::parse_bind_exit(sinsp_evt &evt, sinsp_parser_verdict &verdict
 	}
 	// Update the name of this socket.
 	const char *parstr;
-	evt.get_fd_info()->m_name = evt.get_param_as_str(1, &parstr, sinsp_evt::PF_SIMPLE);
+	evt.get_fd_info()->set_socket_name(evt.get_param_as_str(1, &parstr, sinsp_evt::PF_SIMPLE));
 
 	// If there's a listener, add a callback to later invoke it.
 	if(m_observer) {
@@ -2334,7 +2337,7 @@ void sinsp_parser::fill_client_socket_info_from_addr(sinsp_evt &evt, const uint8
 	default: {
 		// Add the friendly name to the fd info.
 		const char *parstr;
-		fdinfo->m_name = evt.get_param_as_str(1, &parstr, sinsp_evt::PF_SIMPLE);
+		fdinfo->set_socket_name(evt.get_param_as_str(1, &parstr, sinsp_evt::PF_SIMPLE));
 		break;
 	}
 	}
@@ -2525,7 +2528,7 @@ inline void sinsp_parser::fill_client_socket_info(sinsp_evt &evt,
 		                             evt.get_paramstr_storage().size(),
 		                             can_resolve_hostname_and_port);
 
-		evt.get_fd_info()->m_name = &evt.get_paramstr_storage()[0];
+		evt.get_fd_info()->set_socket_name(&evt.get_paramstr_storage()[0]);
 	} else {
 		if(!evt.get_fd_info()->is_unix_socket()) {
 			// This should happen only in case of a bug in our code, because I'm assuming that the
@@ -2542,7 +2545,7 @@ inline void sinsp_parser::fill_client_socket_info(sinsp_evt &evt,
 		evt.get_fd_info()->set_unix_info(exit_tuple_data);
 		const auto source = evt.get_fd_info()->m_sockinfo.m_unixinfo.m_fields.m_source;
 		const auto dest = evt.get_fd_info()->m_sockinfo.m_unixinfo.m_fields.m_dest;
-		evt.get_fd_info()->m_name = encode_unix_tuple_fd_name(evt, source, dest, dpath);
+		evt.get_fd_info()->set_socket_name(encode_unix_tuple_fd_name(evt, source, dest, dpath));
 	}
 
 	if(evt.get_fd_info()->is_role_none()) {
@@ -2700,7 +2703,7 @@ void sinsp_parser::parse_accept_exit(sinsp_evt &evt, sinsp_parser_verdict &verdi
 
 	const char *parstr;
 	uint32_t openflags = 0;
-	fdi->m_name = evt.get_param_as_str(1, &parstr, sinsp_evt::PF_SIMPLE);
+	fdi->set_socket_name(evt.get_param_as_str(1, &parstr, sinsp_evt::PF_SIMPLE));
 	if(evt.get_type() == PPME_SOCKET_ACCEPT4_6_X) {
 		auto flags = evt.get_param(5)->as<int32_t>();
 		openflags |= (flags & PPM_O_CLOEXEC);
@@ -3354,10 +3357,11 @@ void sinsp_parser::parse_read_exit(sinsp_evt &evt, sinsp_parser_verdict &verdict
 				                             str_storage_ptr,
 				                             str_storage_len,
 				                             m_hostname_and_port_resolution_enabled);
-				fdinfo.m_name = str_storage_ptr;
+				fdinfo.set_socket_name(str_storage_ptr);
 			} else {
 				const char *parstr;
-				fdinfo.m_name = evt.get_param_as_str(tupleparam, &parstr, sinsp_evt::PF_SIMPLE);
+				fdinfo.set_socket_name(
+				        evt.get_param_as_str(tupleparam, &parstr, sinsp_evt::PF_SIMPLE));
 			}
 		}
 	}
@@ -3409,6 +3413,19 @@ void sinsp_parser::parse_read_exit(sinsp_evt &evt, sinsp_parser_verdict &verdict
 #endif
 }
 
+// Aggregates only account for successful syscalls, and `reset()` already resolved the fd like
+// for any other enter event.
+void sinsp_parser::parse_io_aggregate(sinsp_evt &evt) const {
+	if(evt.get_fd_info() == nullptr) {
+		return;
+	}
+
+	auto &fdinfo = *evt.get_fd_info();
+	if(fdinfo.m_type == SCAP_FD_IPV4_SOCK || fdinfo.m_type == SCAP_FD_IPV6_SOCK) {
+		fdinfo.set_socket_connected();
+	}
+}
+
 void sinsp_parser::parse_write_exit(sinsp_evt &evt, sinsp_parser_verdict &verdict) const {
 	const auto etype = evt.get_scap_evt()->type;
 
@@ -3487,11 +3504,11 @@ void sinsp_parser::parse_write_exit(sinsp_evt &evt, sinsp_parser_verdict &verdic
 				                             str_storage_len,
 				                             m_hostname_and_port_resolution_enabled);
 
-				fdinfo.m_name = str_storage_ptr;
+				fdinfo.set_socket_name(str_storage_ptr);
 			} else {
 				const char *parstr;
-				fdinfo.m_name =
-				        evt.get_param_as_str(SOCKET_TUPLE_PARAM_ID, &parstr, sinsp_evt::PF_SIMPLE);
+				fdinfo.set_socket_name(
+				        evt.get_param_as_str(SOCKET_TUPLE_PARAM_ID, &parstr, sinsp_evt::PF_SIMPLE));
 			}
 		}
 	}
@@ -3575,7 +3592,7 @@ void sinsp_parser::parse_fchdir_exit(sinsp_evt &evt) {
 	// In case of success, if the event has thread and fd info, update the thread working directory.
 	if(evt.get_syscall_return_value() >= 0 && evt.get_fd_info() != nullptr &&
 	   evt.get_tinfo() != nullptr) {
-		evt.get_tinfo()->update_cwd(evt.get_fd_info()->m_name);
+		evt.get_tinfo()->update_cwd(evt.get_fd_info()->m_name.str());
 	}
 }
 
@@ -105,6 +105,7 @@ private:
 	void parse_pidfd_getfd_exit(sinsp_evt& evt) const;
 	inline void parse_read_exit(sinsp_evt& evt, sinsp_parser_verdict& verdict) const;
 	inline void parse_write_exit(sinsp_evt& evt, sinsp_parser_verdict& verdict) const;
+	void parse_io_aggregate(sinsp_evt& evt) const;
 	void parse_sendfile_exit(sinsp_evt& evt, sinsp_parser_verdict& verdict) const;
 	void parse_eventfd_eventfd2_exit(sinsp_evt& evt) const;
 	void parse_bind_exit(sinsp_evt& evt, sinsp_parser_verdict& verdict) const;
@@ -23,6 +23,8 @@ limitations under the License.
 #include <libsinsp/sinsp.h>
 #include <libsinsp/sinsp_int.h>
 #include <libsinsp/filter.h>
+#include <libsinsp/filter/path_prefixes.h>
+#include <libsinsp/sinsp_inet.h>
 #include <libsinsp/filterchecks.h>
 #include <libsinsp/dns_manager.h>
 #include <libsinsp/plugin.h>
@@ -32,12 +34,17 @@ limitations under the License.
 #include <libscap/strl.h>
 #include <libscap/scap-int.h>
 
+#ifdef __linux__
+#include <libsinsp/linux/proc_rescan.h>
+#endif
+
 #ifndef _WIN32
 #include <unistd.h>
 #include <poll.h>
 #include <sys/time.h>
 #endif  // _WIN32
 
+#include <chrono>
 #include <cinttypes>
 #include <cstdio>
 #include <cstdlib>
@@ -55,6 +62,12 @@ limitations under the License.
  */
 #define DEFAULT_ASYNC_EVENT_QUEUE_SIZE 4096
 
+/**
+ * Threads written to the state snapshot for every event, so that writing it
+ * never stalls the event loop for the whole thread table.
+ */
+#define STATE_SNAPSHOT_THREADS_PER_EVENT 32
+
 // Small sinsp event filter wrapper logic
 // that uses RAII to eventually filter out events.
 struct sinsp_evt_filter {
@@ -245,6 +258,8 @@ sinsp::sinsp(bool with_metrics):
 
 	m_proc_scan_timeout_ms = SCAP_PROC_SCAN_TIMEOUT_NONE;
 	m_proc_scan_log_interval_ms = SCAP_PROC_SCAN_LOG_NONE;
+	m_proc_scan_workers = 0;
+	m_savefile_header_workers = 0;
 
 	m_replay_scap_evt = nullptr;
 
@@ -330,6 +345,40 @@ void sinsp::consume_initialstate_events() {
 	}
 }
 
+static uint64_t ns_since(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+	                                                            start)
+	        .count();
+}
+
+static void count_startup_state(sinsp_thread_manager& thread_manager, sinsp_startup_stats& stats) {
+	stats.m_n_threads = thread_manager.get_thread_count();
+	thread_manager.get_threads()->loop([&stats](sinsp_threadinfo& tinfo) {
+		// the other threads share the fd table of their main thread
+		sinsp_fdtable* fdtable = tinfo.is_main_thread() ? tinfo.get_fd_table() : nullptr;
+		if(fdtable == nullptr) {
+			return true;
+		}
+		stats.m_n_fds += fdtable->size();
+		fdtable->const_loop([&stats](int64_t, const sinsp_fdinfo& fdinfo) {
+			switch(fdinfo.m_type) {
+			case SCAP_FD_IPV4_SOCK:
+			case SCAP_FD_IPV6_SOCK:
+			case SCAP_FD_IPV4_SERVSOCK:
+			case SCAP_FD_IPV6_SERVSOCK:
+			case SCAP_FD_UNIX_SOCK:
+			case SCAP_FD_NETLINK:
+				stats.m_n_sockets++;
+				break;
+			default:
+				break;
+			}
+			return true;
+		});
+		return true;
+	});
+}
+
 void sinsp::init() {
 	//
 	// Retrieve machine information
@@ -368,9 +417,13 @@ void sinsp::init() {
 		consume_initialstate_events();
 	}
 
+	auto phase_start = std::chrono::steady_clock::now();
 	import_ifaddr_list();
+	m_startup_stats.m_ifaddr_import_ns += ns_since(phase_start);
 
+	phase_start = std::chrono::steady_clock::now();
 	import_user_list();
+	m_startup_stats.m_user_import_ns += ns_since(phase_start);
 
 	//
 	// Scan the list to fix the direction of the sockets
@@ -417,6 +470,8 @@ void sinsp::init() {
 		set_statsd_port(m_statsd_port);
 	}
 
+	init_kernel_suppression();
+
 	if(is_live()) {
 		int32_t res = scap_getpid_global(get_scap_platform(), &m_self_pid);
 		ASSERT(res == SCAP_SUCCESS || res == SCAP_NOT_SUPPORTED);
@@ -447,6 +502,7 @@ void sinsp::try_open_common(scap_open_args* oargs,
 			scap_close(m_h);
 			m_h = nullptr;
 		}
+		unload_bpf_iterators();
 		throw;
 	}
 }
@@ -457,6 +513,17 @@ void sinsp::open_common(scap_open_args* oargs,
                         const sinsp_mode_t mode) {
 	libsinsp_logger()->log("Trying to open the right engine!");
 
+	const auto open_start = std::chrono::steady_clock::now();
+	m_startup_stats = {};
+	scap_startup_stats scap_stats{};
+	oargs->startup_stats = &scap_stats;
+	// The open args belong to the caller, they must not point to scap_stats once this returns,
+	// including when it throws.
+	struct startup_stats_guard {
+		scap_open_args* oargs;
+		~startup_stats_guard() { oargs->startup_stats = nullptr; }
+	} startup_stats_guard{oargs};
+
 	/* Reset the thread manager */
 	m_thread_manager->clear();
 
@@ -467,12 +534,14 @@ void sinsp::open_common(scap_open_args* oargs,
 	oargs->log_fn = &sinsp_scap_log_fn;
 	oargs->proc_scan_timeout_ms = m_proc_scan_timeout_ms;
 	oargs->proc_scan_log_interval_ms = m_proc_scan_log_interval_ms;
+	oargs->proc_scan_workers = m_proc_scan_workers;
 
 	m_h = scap_alloc();
 	if(m_h == nullptr) {
 		throw scap_open_exception("failed to allocate scap handle", SCAP_FAILURE);
 	}
 
+	auto phase_start = std::chrono::steady_clock::now();
 	int32_t scap_rc = scap_init(m_h, oargs, vtable);
 	if(scap_rc != SCAP_SUCCESS) {
 		std::string error = scap_getlasterr(m_h);
@@ -481,6 +550,7 @@ void sinsp::open_common(scap_open_args* oargs,
 		}
 		throw scap_open_exception(error, scap_rc);
 	}
+	m_startup_stats.m_engine_load_ns = ns_since(phase_start);
 
 	// Validate the schema version of the plugins in case the engine provides the event schema
 	// version it complies with
@@ -499,9 +569,17 @@ void sinsp::open_common(scap_open_args* oargs,
 	if(scap_rc != SCAP_SUCCESS) {
 		throw scap_open_exception(m_platform_lasterr, scap_rc);
 	}
+	m_startup_stats.m_bpf_load_ns = scap_stats.bpf_load_ns;
+	m_startup_stats.m_iter_fetch_ns = scap_stats.iter_fetch_ns;
+	m_startup_stats.m_proc_scan_ns = scap_stats.proc_scan_ns;
+	m_startup_stats.m_user_import_ns = scap_stats.userlist_ns;
+	m_startup_stats.m_ifaddr_import_ns = scap_stats.iflist_ns;
+	m_startup_stats.m_n_snapshot_threads = scap_stats.snapshot_threads;
 
 	init();
 
+	phase_start = std::chrono::steady_clock::now();
+
 	// enable generation of async meta-events for all loaded plugins supporting
 	// that capability. Meta-events are considered only during live captures,
 	// because offline captures will have the async events already encoded
@@ -531,6 +609,29 @@ void sinsp::open_common(scap_open_args* oargs,
 			}
 		}
 	}
+	m_startup_stats.m_plugin_init_ns = ns_since(phase_start);
+
+	count_startup_state(*m_thread_manager, m_startup_stats);
+	m_startup_stats.m_total_ns = ns_since(open_start);
+
+	const auto ms = [](uint64_t ns) { return ns / 1e6; };
+	libsinsp_logger()->format(sinsp_logger::SEV_INFO,
+	                          "startup: engine_load_ms=%.3f bpf_load_ms=%.3f iter_fetch_ms=%.3f "
+	                          "proc_scan_ms=%.3f user_import_ms=%.3f ifaddr_import_ms=%.3f "
+	                          "plugin_init_ms=%.3f total_ms=%.3f threads=%" PRIu64
+	                          " fds=%" PRIu64 " sockets=%" PRIu64 " snapshot_threads=%" PRIu64,
+	                          ms(m_startup_stats.m_engine_load_ns),
+	                          ms(m_startup_stats.m_bpf_load_ns),
+	                          ms(m_startup_stats.m_iter_fetch_ns),
+	                          ms(m_startup_stats.m_proc_scan_ns),
+	                          ms(m_startup_stats.m_user_import_ns),
+	                          ms(m_startup_stats.m_ifaddr_import_ns),
+	                          ms(m_startup_stats.m_plugin_init_ns),
+	                          ms(m_startup_stats.m_total_ns),
+	                          m_startup_stats.m_n_threads,
+	                          m_startup_stats.m_n_fds,
+	                          m_startup_stats.m_n_sockets,
+	                          m_startup_stats.m_n_snapshot_threads);
 }
 
 void sinsp::mark_ppm_sc_of_interest(ppm_sc_code ppm_sc, bool enable) {
@@ -547,6 +648,30 @@ void sinsp::mark_ppm_sc_of_interest(ppm_sc_code ppm_sc, bool enable) {
 	}
 }
 
+void sinsp::set_cgroup_ppm_sc_of_interest(uint64_t cgroup_id,
+                                          const libsinsp::events::set<ppm_sc_code>& ppm_sc) {
+	/* This API must be used only after the initialization phase. */
+	if(!m_inited) {
+		throw sinsp_exception("you cannot use this method before opening the inspector!");
+	}
+	bool ppm_sc_set[PPM_SC_MAX] = {};
+	for(auto sc : ppm_sc) {
+		ppm_sc_set[sc] = true;
+	}
+	if(scap_set_cgroup_ppm_sc(m_h, cgroup_id, ppm_sc_set) != SCAP_SUCCESS) {
+		throw sinsp_exception(scap_getlasterr(m_h));
+	}
+}
+
+void sinsp::clear_cgroup_ppm_sc_of_interest(uint64_t cgroup_id) {
+	if(!m_inited) {
+		throw sinsp_exception("you cannot use this method before opening the inspector!");
+	}
+	if(scap_set_cgroup_ppm_sc(m_h, cgroup_id, nullptr) != SCAP_SUCCESS) {
+		throw sinsp_exception(scap_getlasterr(m_h));
+	}
+}
+
 #if defined(HAS_ENGINE_KMOD) || defined(HAS_ENGINE_MODERN_BPF)
 static void fill_ppm_sc_of_interest(scap_open_args* oargs,
                                     const libsinsp::events::set<ppm_sc_code>& ppm_sc_of_interest) {
@@ -580,8 +705,9 @@ void sinsp::open_kmod(unsigned long driver_buffer_bytes_dim,
 	                                                     this});
 	if(platform) {
 		auto linux_plat = (scap_linux_platform*)platform;
-		linux_plat->m_linux_vtable = &scap_kmod_linux_vtable;
+		linux_plat->m_linux_vtable = load_bpf_iterators(&scap_kmod_linux_vtable);
 	}
+	import_state_snapshot(platform);
 
 	try_open_common(&oargs, &scap_kmod_engine, platform, SINSP_MODE_LIVE);
 #else
@@ -601,7 +727,11 @@ void sinsp::open_nodriver(bool full_proc_scan) {
 			auto linux_plat = (scap_linux_platform*)platform;
 			linux_plat->m_fd_lookup_limit = SCAP_NODRIVER_MAX_FD_LOOKUP;
 			linux_plat->m_minimal_scan = true;
+		} else {
+			auto linux_plat = (scap_linux_platform*)platform;
+			linux_plat->m_linux_vtable = load_bpf_iterators(linux_plat->m_linux_vtable);
 		}
+		import_state_snapshot(platform);
 	} else {
 		platform = scap_generic_alloc_platform({::on_proc_table_refresh_start,
 		                                        ::on_proc_table_refresh_end,
@@ -647,6 +777,7 @@ void sinsp::open_savefile(const std::string& filename, int fd) {
 
 	params.start_offset = 0;
 	params.fbuffer_size = 0;
+	params.header_workers = m_savefile_header_workers;
 	oargs.engine_params = &params;
 
 	scap_platform* platform = scap_savefile_alloc_platform({::on_proc_table_refresh_start,
@@ -660,6 +791,47 @@ void sinsp::open_savefile(const std::string& filename, int fd) {
 #endif
 }
 
+void sinsp::open_savefiles(const std::vector<std::string>& filenames) {
+#ifdef HAS_ENGINE_MULTI_SAVEFILE
+	scap_open_args oargs{};
+	scap_multi_savefile_engine_params params{};
+
+	if(filenames.empty()) {
+		throw sinsp_exception(
+		        "When you use the 'multi_savefile' engine you need to provide at least one file.");
+	}
+
+	m_input_filename = filenames.front();
+	m_input_fd = 0;
+	m_filesize = 0;
+
+	std::vector<const char*> fnames;
+	fnames.reserve(filenames.size());
+	for(const auto& filename : filenames) {
+		char error[SCAP_LASTERR_SIZE]{};
+		int64_t filesize = get_file_size(filename, error);
+		if(filesize < 0) {
+			throw sinsp_exception(filename + ": " + error);
+		}
+		m_filesize += filesize;
+		fnames.push_back(filename.c_str());
+	}
+
+	params.fnames = fnames.data();
+	params.num_fnames = fnames.size();
+	oargs.engine_params = &params;
+
+	scap_platform* platform = scap_savefile_alloc_platform({::on_proc_table_refresh_start,
+	                                                        ::on_proc_table_refresh_end,
+	                                                        ::on_new_entry_from_proc,
+	                                                        this});
+	params.platform = platform;
+	try_open_common(&oargs, &scap_multi_savefile_engine, platform, SINSP_MODE_CAPTURE);
+#else
+	throw sinsp_exception("MULTI_SAVEFILE engine is not supported in this build");
+#endif
+}
+
 void sinsp::open_plugin(const std::string& plugin_name,
                         const std::string& plugin_open_params,
                         sinsp_plugin_platform platform_type) {
@@ -706,7 +878,8 @@ void sinsp::open_modern_bpf(unsigned long driver_buffer_bytes_dim,
                             uint16_t cpus_for_each_buffer,
                             bool online_only,
                             const libsinsp::events::set<ppm_sc_code>& ppm_sc_of_interest,
-                            bool disable_iterators) {
+                            bool disable_iterators,
+                            const std::string& shared_probe_path) {
 #ifdef HAS_ENGINE_MODERN_BPF
 	scap_open_args oargs{};
 
@@ -714,11 +887,12 @@ void sinsp::open_modern_bpf(unsigned long driver_buffer_bytes_dim,
 	fill_ppm_sc_of_interest(&oargs, ppm_sc_of_interest);
 
 	/* Engine-specific args. */
-	scap_modern_bpf_engine_params params;
+	scap_modern_bpf_engine_params params{};
 	params.buffer_bytes_dim = driver_buffer_bytes_dim;
 	params.cpus_for_each_buffer = cpus_for_each_buffer;
 	params.allocate_online_only = online_only;
 	params.disable_iterators = disable_iterators;
+	params.shared_probe_path = shared_probe_path.empty() ? nullptr : shared_probe_path.c_str();
 	oargs.engine_params = &params;
 
 	scap_platform* platform = scap_linux_alloc_platform({::on_proc_table_refresh_start,
@@ -729,6 +903,7 @@ void sinsp::open_modern_bpf(unsigned long driver_buffer_bytes_dim,
 		auto* const linux_platform = reinterpret_cast<scap_linux_platform*>(platform);
 		linux_platform->m_linux_vtable = &scap_modern_bpf_linux_vtable;
 	}
+	import_state_snapshot(platform);
 
 	try_open_common(&oargs, &scap_modern_bpf_engine, platform, SINSP_MODE_LIVE);
 #else
@@ -844,6 +1019,17 @@ std::string sinsp::get_error_desc(const std::string& msg) {
 }
 
 void sinsp::close() {
+	abort_state_snapshot();
+
+#ifdef __linux__
+	// The rescan reads /proc through the platform from the thread pool.
+	if(m_proc_rescan) {
+		m_proc_rescan->stop();
+	}
+#endif
+	m_next_proc_rescan_ts = 0;
+	m_proc_rescan_last_drops = 0;
+
 	if(m_platform) {
 		scap_platform_close(m_platform);
 		scap_platform_free(m_platform);
@@ -855,7 +1041,10 @@ void sinsp::close() {
 		m_h = nullptr;
 	}
 
+	unload_bpf_iterators();
+
 	m_is_dumping = false;
+	m_kernel_suppression = false;
 
 	deinit_state();
 
@@ -897,6 +1086,7 @@ void sinsp::close() {
 	if(m_thread_pool) {
 		m_thread_pool->purge();
 	}
+	m_usergroup_manager->cancel_loads();
 
 	m_mode = SINSP_MODE_NONE;
 }
@@ -1457,6 +1647,29 @@ int32_t sinsp::next(sinsp_evt** puevt) {
 		}
 	}
 
+	if(m_state_snapshot_interval_ns != 0 && (is_live() || is_nodriver())) {
+		try {
+			if(m_state_snapshot_dump) {
+				continue_state_snapshot(STATE_SNAPSHOT_THREADS_PER_EVENT);
+			} else if(ts > m_next_state_snapshot_ts) {
+				if(m_next_state_snapshot_ts) {
+					start_state_snapshot();
+				}
+
+				m_next_state_snapshot_ts = ts + m_state_snapshot_interval_ns;
+			}
+		} catch(const sinsp_exception& e) {
+			libsinsp_logger()->log(e.what(), sinsp_logger::SEV_WARNING);
+		}
+	}
+
+	if(m_proc_rescan_interval_ns != 0 && is_live()) {
+		update_proc_rescan(ts);
+	}
+
+	// Apply the container users and groups loaded in the background
+	m_usergroup_manager->update();
+
 	//
 	// Delayed removal of the fd, so that
 	// things like exit() or close() can be parsed.
@@ -1501,6 +1714,13 @@ int32_t sinsp::next(sinsp_evt** puevt) {
 			m_parser->process_event(*evt, m_parser_verdict);
 		}
 
+#ifdef __linux__
+		// The thread may have been read from /proc before it exited
+		if(m_proc_rescan && evt->get_type() == PPME_PROCEXIT_1_E) {
+			m_proc_rescan->on_thread_exit(evt->get_tid());
+		}
+#endif
+
 		// run plugin-implemented parsers
 		// note: we run the parsers even if the event has been filtered out,
 		// because we have no guarantee that the plugin parsers will not use a given
@@ -1570,20 +1790,84 @@ uint64_t sinsp::get_num_events() const {
 
 bool sinsp::suppress_events_comm(const std::string& comm) {
 	m_suppress.suppress_comm(comm);
+	if(m_kernel_suppression) {
+		check_kernel_suppression_res(scap_suppress_comm(m_h, SCAP_SUPPRESS_ADD, comm.c_str()));
+	}
 	return true;
 }
 
 bool sinsp::suppress_events_tid(int64_t tid) {
 	m_suppress.suppress_tid(tid);
+	if(m_kernel_suppression) {
+		check_kernel_suppression_res(scap_suppress_tid(m_h, SCAP_SUPPRESS_ADD, tid));
+	}
+	return true;
+}
+
+bool sinsp::suppress_events_cgroup_id(uint64_t cgroup_id) {
+	m_suppress.suppress_cgroup_id(cgroup_id);
+	if(m_kernel_suppression) {
+		check_kernel_suppression_res(scap_suppress_cgroup(m_h, SCAP_SUPPRESS_ADD, cgroup_id));
+	}
 	return true;
 }
 
 void sinsp::clear_suppress_events_comm() {
 	m_suppress.clear_suppress_comm();
+	if(m_kernel_suppression) {
+		check_kernel_suppression_res(scap_suppress_comm(m_h, SCAP_SUPPRESS_CLEAR, nullptr));
+	}
 }
 
 void sinsp::clear_suppress_events_tid() {
 	m_suppress.clear_suppress_tid();
+	if(m_kernel_suppression) {
+		check_kernel_suppression_res(scap_suppress_tid(m_h, SCAP_SUPPRESS_CLEAR, 0));
+	}
+}
+
+void sinsp::clear_suppress_events_cgroup_id() {
+	m_suppress.clear_suppress_cgroup_id();
+	if(m_kernel_suppression) {
+		check_kernel_suppression_res(scap_suppress_cgroup(m_h, SCAP_SUPPRESS_CLEAR, 0));
+	}
+}
+
+void sinsp::init_kernel_suppression() {
+	//
+	// Engines not supporting in-kernel suppression reject the setting,
+	// in that case the events are only suppressed in userspace.
+	//
+	m_kernel_suppression =
+	        is_live() && scap_suppress_tid(m_h, SCAP_SUPPRESS_CLEAR, 0) == SCAP_SUCCESS;
+	if(!m_kernel_suppression) {
+		if(!m_suppress.get_suppressed_cgroup_ids().empty()) {
+			libsinsp_logger()->log("cgroup suppression is not supported by the current engine",
+			                       sinsp_logger::SEV_WARNING);
+		}
+		return;
+	}
+
+	// The tids also include the ones found during the /proc scan.
+	for(const auto& comm : m_suppress.get_suppressed_comms()) {
+		check_kernel_suppression_res(scap_suppress_comm(m_h, SCAP_SUPPRESS_ADD, comm.c_str()));
+	}
+	for(auto tid : m_suppress.get_suppressed_tids()) {
+		check_kernel_suppression_res(scap_suppress_tid(m_h, SCAP_SUPPRESS_ADD, tid));
+	}
+	for(auto cgroup_id : m_suppress.get_suppressed_cgroup_ids()) {
+		check_kernel_suppression_res(scap_suppress_cgroup(m_h, SCAP_SUPPRESS_ADD, cgroup_id));
+	}
+}
+
+void sinsp::check_kernel_suppression_res(int32_t res) {
+	// Not fatal: the events that are not dropped in the kernel are still
+	// suppressed in userspace (except for cgroups).
+	if(res != SCAP_SUCCESS) {
+		libsinsp_logger()->format(sinsp_logger::SEV_WARNING,
+		                          "unable to update in-kernel suppression: %s",
+		                          scap_getlasterr(m_h));
+	}
 }
 
 bool sinsp::check_suppressed(int64_t tid) const {
@@ -1611,6 +1895,135 @@ void sinsp::set_dropfailed(bool dropfailed) {
 	}
 }
 
+void sinsp::set_io_aggregation(uint32_t max_count, uint64_t max_bytes, uint64_t interval_ns) {
+	if(!is_live()) {
+		throw sinsp_exception("set_io_aggregation called on a trace file, plugin, or test engine");
+	}
+
+	scap_io_aggregation_params params = {max_count, max_bytes, interval_ns};
+	if(scap_set_io_aggregation(m_h, max_count != 0 ? &params : nullptr) != SCAP_SUCCESS) {
+		throw sinsp_exception(scap_getlasterr(m_h));
+	}
+}
+
+void sinsp::set_rate_limit(ppm_event_category category,
+                           uint64_t rate,
+                           uint64_t burst,
+                           uint64_t summary_interval_ns) {
+	if(!is_live()) {
+		throw sinsp_exception("set_rate_limit called on a trace file, plugin, or test engine");
+	}
+
+	scap_rate_limit_params params = {
+	        (uint8_t)(category & (EC_IO_BASE | (EC_IO_BASE - 1))),
+	        rate,
+	        burst,
+	        summary_interval_ns,
+	};
+	if(scap_set_rate_limit(m_h, &params) != SCAP_SUCCESS) {
+		throw sinsp_exception(scap_getlasterr(m_h));
+	}
+}
+
+static void set_arg_filter(scap_t* h, const scap_arg_filter_params& params) {
+	if(scap_set_arg_filter(h, &params) != SCAP_SUCCESS) {
+		throw sinsp_exception(scap_getlasterr(h));
+	}
+}
+
+void sinsp::set_path_filter(const std::string& prefix, scap_arg_filter_action action) {
+	if(!is_live()) {
+		throw sinsp_exception("set_path_filter called on a trace file, plugin, or test engine");
+	}
+
+	scap_arg_filter_params params = {};
+	params.type = SCAP_ARG_FILTER_PATH;
+	params.action = action;
+	params.path = prefix.c_str();
+	set_arg_filter(m_h, params);
+}
+
+bool sinsp::set_path_filters(const libsinsp::filter::ast::expr* e) {
+	auto prefixes = libsinsp::filter::ast::fd_name_prefixes(e);
+	if(!prefixes.has_value()) {
+		return false;
+	}
+
+	set_path_filter("/", SCAP_ARG_FILTER_DROP);
+	for(const auto& prefix : *prefixes) {
+		set_path_filter(prefix, SCAP_ARG_FILTER_KEEP);
+	}
+	return true;
+}
+
+void sinsp::set_port_filter(uint16_t port, bool interesting) {
+	if(!is_live()) {
+		throw sinsp_exception("set_port_filter called on a trace file, plugin, or test engine");
+	}
+
+	scap_arg_filter_params params = {};
+	params.type = SCAP_ARG_FILTER_PORT;
+	params.action = interesting ? SCAP_ARG_FILTER_KEEP : SCAP_ARG_FILTER_REMOVE;
+	params.port = port;
+	set_arg_filter(m_h, params);
+}
+
+void sinsp::set_addr_filter(const std::string& network, scap_arg_filter_action action) {
+	if(!is_live()) {
+		throw sinsp_exception("set_addr_filter called on a trace file, plugin, or test engine");
+	}
+
+	scap_arg_filter_params params = {};
+	params.type = SCAP_ARG_FILTER_ADDR;
+	params.action = action;
+
+	const auto slash = network.find('/');
+	const std::string ip = network.substr(0, slash);
+	uint32_t max_prefixlen = 128;
+	if(ip.find(':') != std::string::npos) {
+		if(inet_pton(AF_INET6, ip.c_str(), params.addr) != 1) {
+			throw sinsp_exception("unrecognized IPv6 address " + network);
+		}
+	} else {
+		// IPv4 networks are matched as IPv4-mapped IPv6 ones.
+		params.addr[10] = 0xff;
+		params.addr[11] = 0xff;
+		if(inet_pton(AF_INET, ip.c_str(), &params.addr[12]) != 1) {
+			throw sinsp_exception("unrecognized IPv4 address " + network);
+		}
+		max_prefixlen = 32;
+	}
+
+	uint32_t prefixlen = max_prefixlen;
+	if(slash != std::string::npos &&
+	   (!sinsp_numparser::tryparseu32(network.substr(slash + 1), &prefixlen) ||
+	    prefixlen > max_prefixlen)) {
+		throw sinsp_exception("invalid prefix length in " + network);
+	}
+	params.prefixlen = prefixlen + (128 - max_prefixlen);
+	set_arg_filter(m_h, params);
+}
+
+void sinsp::clear_arg_filters() {
+	if(!is_live()) {
+		throw sinsp_exception("clear_arg_filters called on a trace file, plugin, or test engine");
+	}
+
+	scap_arg_filter_params params = {};
+	params.type = SCAP_ARG_FILTER_CLEAR;
+	set_arg_filter(m_h, params);
+}
+
+void sinsp::set_syscall_latency(bool enable) {
+	if(!is_live()) {
+		throw sinsp_exception("set_syscall_latency called on a trace file, plugin, or test engine");
+	}
+
+	if(scap_set_syscall_latency(m_h, enable) != SCAP_SUCCESS) {
+		throw sinsp_exception(scap_getlasterr(m_h));
+	}
+}
+
 void sinsp::set_fullcapture_port_range(uint16_t range_start, uint16_t range_end) {
 	//
 	// If set_fullcapture_port_range is called before opening of the inspector,
@@ -2002,6 +2415,252 @@ void sinsp::set_proc_scan_log_interval_ms(uint64_t val) {
 	m_proc_scan_log_interval_ms = val;
 }
 
+void sinsp::set_proc_scan_workers(uint32_t val) {
+	m_proc_scan_workers = val;
+}
+
+void sinsp::set_state_snapshot(const std::string& path, uint32_t interval_s) {
+	abort_state_snapshot();
+	m_state_snapshot_path = path;
+	m_state_snapshot_interval_ns = (uint64_t)interval_s * ONE_SECOND_IN_NS;
+	m_next_state_snapshot_ts = 0;
+}
+
+void sinsp::set_proc_rescan_interval_s(uint32_t interval_s) {
+	m_proc_rescan_interval_ns = (uint64_t)interval_s * ONE_SECOND_IN_NS;
+	m_next_proc_rescan_ts = 0;
+}
+
+void sinsp::set_bpf_iterators_for_proc_scan(bool enable) {
+	m_bpf_iterators_for_proc_scan = enable;
+}
+
+const scap_linux_vtable* sinsp::load_bpf_iterators(const scap_linux_vtable* base) {
+#ifdef HAS_ENGINE_MODERN_BPF
+	if(!m_bpf_iterators_for_proc_scan || m_bpf_iterators_loaded) {
+		return base;
+	}
+
+	char error[SCAP_LASTERR_SIZE] = {};
+	const scap_linux_vtable* vtable =
+	        scap_modern_bpf_load_iterators(&sinsp_scap_log_fn, base, error);
+	if(vtable == nullptr) {
+		libsinsp_logger()->format(sinsp_logger::SEV_INFO,
+		                          "BPF iterators not available, scanning /proc: %s",
+		                          error);
+		return base;
+	}
+	m_bpf_iterators_loaded = true;
+	return vtable;
+#else
+	return base;
+#endif
+}
+
+void sinsp::unload_bpf_iterators() {
+#ifdef HAS_ENGINE_MODERN_BPF
+	if(m_bpf_iterators_loaded) {
+		scap_modern_bpf_unload_iterators();
+		m_bpf_iterators_loaded = false;
+	}
+#endif
+}
+
+void sinsp::update_proc_rescan(uint64_t ts) {
+#ifdef __linux__
+	if(m_proc_rescan) {
+		m_proc_rescan->consume([this](sinsp_proc_rescan::entry& e) {
+			// The events may have added the thread in the meantime, and they are more recent
+			// than /proc.
+			const auto& tinfo = m_thread_manager->find_thread(e.tinfo.tid, true);
+			if(tinfo && !tinfo->is_invalid()) {
+				return;
+			}
+
+			on_new_entry_from_proc(this, e.tinfo.tid, &e.tinfo, nullptr);
+			for(auto& fdinfo : e.fds) {
+				on_new_entry_from_proc(this, e.tinfo.tid, &e.tinfo, &fdinfo);
+			}
+		});
+	}
+
+	if(ts <= m_next_proc_rescan_ts) {
+		return;
+	}
+
+	const bool first_check = m_next_proc_rescan_ts == 0;
+	m_next_proc_rescan_ts = ts + m_proc_rescan_interval_ns;
+
+	scap_stats stats = {};
+	get_capture_stats(&stats);
+	const bool dropped = stats.n_drops > m_proc_rescan_last_drops;
+	m_proc_rescan_last_drops = stats.n_drops;
+	if(first_check || !dropped || m_thread_pool == nullptr) {
+		return;
+	}
+
+	scap_linux_platform* linux_platform = scap_linux_get_platform(m_platform);
+	if(linux_platform == nullptr) {
+		return;
+	}
+
+	if(!m_proc_rescan) {
+		m_proc_rescan = std::make_unique<sinsp_proc_rescan>(m_thread_pool);
+	} else if(m_proc_rescan->busy()) {
+		return;
+	}
+
+	// The invalid threads are the ones whose lookup failed, they can be read again.
+	std::unordered_set<int64_t> known_tids;
+	m_thread_manager->get_threads()->loop([&known_tids](sinsp_threadinfo& tinfo) {
+		if(!tinfo.is_invalid()) {
+			known_tids.insert(tinfo.m_tid);
+		}
+		return true;
+	});
+
+	if(m_proc_rescan->start(linux_platform, std::move(known_tids), true)) {
+		libsinsp_logger()->format(sinsp_logger::SEV_DEBUG,
+		                          "%" PRIu64 " events dropped, rescanning /proc for lost threads",
+		                          stats.n_drops);
+	}
+#endif
+}
+
+void sinsp::save_state_snapshot() {
+	abort_state_snapshot();
+	start_state_snapshot();
+	// The threads and their files are written in two passes.
+	while(!continue_state_snapshot(std::numeric_limits<uint32_t>::max())) {
+	}
+}
+
+void sinsp::start_state_snapshot() {
+	if(m_state_snapshot_path.empty()) {
+		throw sinsp_exception("no state snapshot path set");
+	}
+	if(m_h == nullptr) {
+		throw sinsp_exception("can't write the state snapshot, inspector not opened yet");
+	}
+
+	// Written aside and then renamed, a crash can't leave a truncated snapshot behind. Only the
+	// thread table is read back, so the machine info and the user list are not written.
+	char error[SCAP_LASTERR_SIZE];
+	const std::string tmp_path = m_state_snapshot_path + ".tmp";
+	m_state_snapshot_dumper =
+	        scap_dump_open(nullptr, tmp_path.c_str(), SCAP_COMPRESSION_NONE, error);
+	if(m_state_snapshot_dumper == nullptr) {
+		throw sinsp_exception(error);
+	}
+	m_state_snapshot_dump =
+	        std::make_unique<sinsp_thread_manager::threads_dump>(*m_thread_manager,
+	                                                             m_state_snapshot_dumper);
+}
+
+bool sinsp::continue_state_snapshot(uint32_t max_threads) {
+	try {
+		if(!m_state_snapshot_dump->step(max_threads)) {
+			return false;
+		}
+		write_state_snapshot_marker();
+	} catch(...) {
+		abort_state_snapshot();
+		throw;
+	}
+
+	m_state_snapshot_dump.reset();
+	scap_dump_close(m_state_snapshot_dumper);
+	m_state_snapshot_dumper = nullptr;
+	const std::string tmp_path = m_state_snapshot_path + ".tmp";
+	if(rename(tmp_path.c_str(), m_state_snapshot_path.c_str()) != 0) {
+		throw sinsp_exception("can't write the state snapshot " + m_state_snapshot_path + ": " +
+		                      strerror(errno));
+	}
+	return true;
+}
+
+void sinsp::write_state_snapshot_marker() {
+	// The savefile engine can't open a capture without events, the snapshot ends with a
+	// notification that is never read back.
+	char error[SCAP_LASTERR_SIZE];
+	scap_evt* marker = scap_create_event(error,
+	                                     sinsp_utils::get_current_time_ns(),
+	                                     m_self_pid,
+	                                     PPME_NOTIFICATION_E,
+	                                     2,
+	                                     "state_snapshot",
+	                                     "");
+	if(marker == nullptr) {
+		throw sinsp_exception(std::string("can't write the state snapshot: ") + error);
+	}
+	const int32_t res = scap_dump(m_state_snapshot_dumper, marker, 0, 0);
+	free(marker);
+	if(res != SCAP_SUCCESS) {
+		throw sinsp_exception(scap_dump_getlasterr(m_state_snapshot_dumper));
+	}
+}
+
+void sinsp::abort_state_snapshot() {
+	if(!m_state_snapshot_dump) {
+		return;
+	}
+	m_state_snapshot_dump.reset();
+	scap_dump_close(m_state_snapshot_dumper);
+	m_state_snapshot_dumper = nullptr;
+	unlink((m_state_snapshot_path + ".tmp").c_str());
+}
+
+void sinsp::import_state_snapshot(scap_platform* platform) {
+#ifdef HAS_ENGINE_SAVEFILE
+	if(m_state_snapshot_path.empty() || platform == nullptr ||
+	   access(m_state_snapshot_path.c_str(), R_OK) != 0) {
+		return;
+	}
+
+	// The snapshot is read like any capture file, then its thread table is handed over to the
+	// linux platform, which owns it from now on.
+	scap_platform* snapshot_platform = scap_savefile_alloc_platform(
+	        {default_refresh_start_end_callback,
+	         default_refresh_start_end_callback,
+	         nullptr,
+	         nullptr});
+	scap_t* h = scap_alloc();
+	if(snapshot_platform == nullptr || h == nullptr) {
+		scap_platform_free(snapshot_platform);
+		scap_close(h);
+		return;
+	}
+
+	scap_open_args oargs{};
+	scap_savefile_engine_params params{};
+	params.fname = m_state_snapshot_path.c_str();
+	params.header_workers = m_savefile_header_workers;
+	params.platform = snapshot_platform;
+	oargs.engine_params = &params;
+	if(scap_init(h, &oargs, &scap_savefile_engine) == SCAP_SUCCESS) {
+		auto* const linux_platform = reinterpret_cast<scap_linux_platform*>(platform);
+		linux_platform->m_proc_snapshot.m_proclist = snapshot_platform->m_proclist.m_proclist;
+		snapshot_platform->m_proclist.m_proclist = nullptr;
+		libsinsp_logger()->format(sinsp_logger::SEV_INFO,
+		                          "Loaded the state snapshot %s",
+		                          m_state_snapshot_path.c_str());
+	} else {
+		libsinsp_logger()->format(sinsp_logger::SEV_WARNING,
+		                          "Ignoring the state snapshot %s: %s",
+		                          m_state_snapshot_path.c_str(),
+		                          scap_getlasterr(h));
+	}
+
+	scap_platform_close(snapshot_platform);
+	scap_platform_free(snapshot_platform);
+	scap_close(h);
+#endif
+}
+
+void sinsp::set_savefile_header_workers(uint32_t val) {
+	m_savefile_header_workers = val;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Note: this is defined here so we can inline it in sinso::next
 ///////////////////////////////////////////////////////////////////////////////
@@ -97,6 +97,7 @@ class sinsp_plugin;
 class sinsp_plugin_manager;
 class sinsp_observer;
 class sinsp_usergroup_manager;
+class sinsp_proc_rescan;
 
 /*!
   \brief The user agent string to use for any libsinsp connection, can be changed at compile time
@@ -144,6 +145,14 @@ public:
 	                       const libsinsp::events::set<ppm_sc_code>& ppm_sc_of_interest = {});
 	virtual void open_nodriver(bool full_proc_scan = false);
 	virtual void open_savefile(const std::string& filename, int fd = 0);
+	/*!
+	  \brief Opens several capture files at once (e.g. the chunks written by a
+	  sinsp_cycledumper, or captures taken on different hosts). Each file is read
+	  and decoded on its own thread and the events are merged by timestamp into a
+	  single stream. The thread and fd tables of all the files are merged as well.
+	  Concatenated capture files are not supported.
+	*/
+	virtual void open_savefiles(const std::vector<std::string>& filenames);
 	virtual void open_plugin(const std::string& plugin_name,
 	                         const std::string& plugin_open_params,
 	                         sinsp_plugin_platform platform_type);
@@ -152,14 +161,17 @@ public:
 	 * the 2 experimental params. The first one allows associating more than one CPU to a single
 	 * ring buffer. The last one allows allocating ring buffers only for online CPUs and not for all
 	 * system-available CPUs. `disable_iterators` disables the BPF iterator support for synchronous
-	 * information fetching, letting scap falling back to the procfs lookups.
+	 * information fetching, letting scap falling back to the procfs lookups. `shared_probe_path`
+	 * is a bpffs directory used to share the probe with other processes, see
+	 * `scap_modern_bpf_engine_params`; empty doesn't share the probe.
 	 */
 	virtual void open_modern_bpf(
 	        unsigned long driver_buffer_bytes_dim = DEFAULT_DRIVER_BUFFER_BYTES_DIM,
 	        uint16_t cpus_for_each_buffer = DEFAULT_CPU_FOR_EACH_BUFFER,
 	        bool online_only = true,
 	        const libsinsp::events::set<ppm_sc_code>& ppm_sc_of_interest = {},
-	        bool disable_iterators = false);
+	        bool disable_iterators = false,
+	        const std::string& shared_probe_path = "");
 	virtual void open_test_input(scap_test_input_data* data, sinsp_mode_t mode = SINSP_MODE_TEST);
 
 	void fseek(uint64_t filepos) { scap_fseek(m_h, filepos); }
@@ -226,6 +238,100 @@ public:
 	 */
 	void set_dropfailed(bool dropfailed);
 
+	/*!
+	 * \brief Coalesce in the driver the successful read/write syscalls of each
+	    (thread, fd) pair into `io_aggregate` events, carrying the number of
+	    syscalls, the bytes and the time range. The aggregate of a pair is sent
+	    when one of the thresholds is hit, when the fd is closed or when the
+	    thread exits.
+	    Only supported by the modern eBPF engine.
+
+	 * @param max_count syscalls per aggregate, 0 disables the aggregation
+	 * @param max_bytes bytes per aggregate
+	 * @param interval_ns maximum age of an aggregate
+	 */
+	void set_io_aggregation(uint32_t max_count, uint64_t max_bytes, uint64_t interval_ns);
+
+	/*!
+	 * \brief Rate limit in the driver the syscalls of every process in an
+	    event category with a token bucket, so that a single runaway process
+	    can't flood the buffers. Dropped events are reported by periodic
+	    `rate_limit_drops` events. The drops not reported yet when the capture
+	    is stopped are returned by next() after stop_capture(). Only supported
+	    by the modern eBPF engine.
+
+	 * @param category event category of the exit events, e.g. EC_FILE or EC_IO_READ
+	 * @param rate events per second, 0 removes the limit
+	 * @param burst maximum number of events in a burst
+	 * @param summary_interval_ns minimum time between two drop summaries of a
+	    process, 0 keeps the current one (one second by default)
+	 */
+	void set_rate_limit(ppm_event_category category,
+	                    uint64_t rate,
+	                    uint64_t burst,
+	                    uint64_t summary_interval_ns = 0);
+
+	/*!
+	 * \brief Add or remove an absolute path prefix from the filters applied
+	    in the driver to the open family of syscalls. The longest matching
+	    prefix wins, so a `SCAP_ARG_FILTER_KEEP` prefix can carve an
+	    exception out of a shorter `SCAP_ARG_FILTER_DROP` one. Relative and
+	    non-normalized paths are never dropped. The fds of dropped files
+	    are unknown to the inspector. Only supported by the modern eBPF engine.
+
+	 * @param prefix absolute path prefix
+	 * @param action one of `scap_arg_filter_action`
+	 */
+	void set_path_filter(const std::string& prefix, scap_arg_filter_action action);
+
+	/*!
+	 * \brief Keep in the driver only the prefixes that can match a filter,
+	    dropping all the other absolute paths opened by the open family of
+	    syscalls. Nothing changes if the filter doesn't bound `fd.name`, see
+	    `libsinsp::filter::ast::fd_name_prefixes`. To be safe the filter must
+	    be the disjunction of all the conditions that will be evaluated.
+
+	 * @param e AST of the filter
+	 * @return true if the path filters were set
+	 */
+	bool set_path_filters(const libsinsp::filter::ast::expr* e);
+
+	/*!
+	 * \brief Add or remove a remote port from the ports of interest of
+	    connect. Once at least one port is set, the driver drops the IPv4
+	    and IPv6 connections to the other ports. Only supported by the
+	    modern eBPF engine.
+
+	 * @param port remote port
+	 * @param interesting true to add the port, false to remove it
+	 */
+	void set_port_filter(uint16_t port, bool interesting);
+
+	/*!
+	 * \brief Add or remove a remote network from the filters applied in the
+	    driver to connect. The longest matching network wins. Only supported
+	    by the modern eBPF engine.
+
+	 * @param network IPv4 or IPv6 address, optionally followed by a `/len` prefix length
+	 * @param action one of `scap_arg_filter_action`
+	 */
+	void set_addr_filter(const std::string& network, scap_arg_filter_action action);
+
+	/*!
+	 * \brief Remove all the path, port and address filters.
+	 */
+	void clear_arg_filters();
+
+	/*!
+	 * \brief Compute in the driver a log2 latency histogram for every
+	    (cgroup, syscall) pair, without sending any event. The histograms
+	    are reported by the `METRICS_V2_KERNEL_SYSCALL_LATENCY` metrics and
+	    discarded when disabled. Only supported by the modern eBPF engine.
+
+	 * @param enable whether to compute the histograms
+	 */
+	void set_syscall_latency(bool enable);
+
 	/*!
 	  \brief Determine if this inspector is going to load user tables on
 	  startup.
@@ -366,6 +472,55 @@ public:
 	 */
 	void set_proc_scan_log_interval_ms(uint64_t val);
 
+	/*!
+	 * \brief sets the number of threads reading /proc during the initial scan of the
+	 *        kmod and nodriver engines. Value of 0 (default) picks it based on the number
+	 *        of CPUs, 1 disables the parallel scan.
+	 */
+	void set_proc_scan_workers(uint32_t val);
+
+	/*!
+	 * \brief Keeps a snapshot of the thread and fd tables in `path`, written every
+	 *        `interval_s` seconds of live capture. The tables are written a few threads
+	 *        per event, so a snapshot spans many events and is not a consistent view of
+	 *        a single instant. When a kmod, modern eBPF or nodriver capture is opened, the
+	 *        initial /proc scan reuses the snapshot for the threads that still have the
+	 *        same start time, and their files if they still refer to the same inodes, and
+	 *        reads only the other ones. The snapshot is a capture file without events.
+	 *        An empty `path` (default) disables it, an `interval_s` of 0 only reuses it
+	 *        at open time.
+	 */
+	void set_state_snapshot(const std::string& path, uint32_t interval_s);
+
+	/*!
+	 * \brief Writes the whole state snapshot set with set_state_snapshot() right away.
+	 */
+	void save_state_snapshot();
+
+	/*!
+	 * \brief Checks every `interval_s` seconds of live capture whether the driver dropped
+	 *        events since the last check and, if so, reads in the background from /proc the
+	 *        threads missing from the thread table, adding them once they are ready. It runs
+	 *        on the thread pool, so it needs one. Value of 0 (default) disables it.
+	 */
+	void set_proc_rescan_interval_s(uint32_t interval_s);
+
+	/*!
+	 * \brief [EXPERIMENTAL] Fetches the initial state of the kmod engine, and of the nodriver
+	 *        one with a full /proc scan, with the BPF iterators of the modern eBPF probe,
+	 *        loaded on their own without capturing events, instead of reading /proc. Falls
+	 *        back to /proc if they can't be loaded. Disabled by default.
+	 */
+	void set_bpf_iterators_for_proc_scan(bool enable);
+
+	/*!
+	 * \brief sets the number of threads decoding the thread and fd tables stored in the
+	 *        headers of a capture file opened with open_savefile().
+	 *        Value of 0 (default) picks it based on the number of CPUs, 1 disables
+	 *        parallel decoding.
+	 */
+	void set_savefile_header_workers(uint32_t val);
+
 	/*!
 	  \brief Returns a new instance of a filtercheck supporting fields for
 	  a generic event source (e.g. evt.num, evt.time, evt.pluginname...)
@@ -401,6 +556,12 @@ public:
 		return m_sinsp_stats_v2;
 	}
 
+	/*!
+	  \brief Return the time spent in each phase of the last open of the inspector, and the size
+	  of the state right after it.
+	*/
+	inline const sinsp_startup_stats& get_startup_stats() const { return m_startup_stats; }
+
 	/*!
 	  \brief Fill the given structure with statistics about the currently
 	   open capture.
@@ -692,6 +853,26 @@ public:
 	*/
 	void mark_ppm_sc_of_interest(ppm_sc_code ppm_sc, bool enabled = true);
 
+	/*!
+	    \brief Restrict the syscalls collected for the processes of a cgroup v2, given its id:
+	    only the syscalls both of interest and in `ppm_sc` are collected for them, while the
+	    other cgroups keep the full selection. As an example, low priority workloads can be
+	    restricted to `libsinsp::events::sinsp_state_sc_set()`.
+
+	    Please note that this method must be called when the inspector is already open, and
+	    that it is only supported by the modern eBPF engine.
+
+	    WARNING: leaving state-changing syscalls out of `ppm_sc` breaks the `libsinsp` state
+	    of the processes of the cgroup.
+	*/
+	void set_cgroup_ppm_sc_of_interest(uint64_t cgroup_id,
+	                                   const libsinsp::events::set<ppm_sc_code>& ppm_sc);
+
+	/*!
+	    \brief Remove the restriction set with `set_cgroup_ppm_sc_of_interest`.
+	*/
+	void clear_cgroup_ppm_sc_of_interest(uint64_t cgroup_id);
+
 	/*=============================== PPM_SC set related (ppm_sc.cpp)
 	 * ===============================*/
 
@@ -723,10 +904,18 @@ public:
 
 	bool suppress_events_tid(int64_t tid);
 
+	// Suppress the processes of a cgroup v2, given its id. This is only
+	// enforced by drivers supporting in-kernel suppression (modern eBPF),
+	// which also receive the comms and tids above and drop the events of
+	// suppressed processes before they reach the ring buffers.
+	bool suppress_events_cgroup_id(uint64_t cgroup_id);
+
 	void clear_suppress_events_comm();
 
 	void clear_suppress_events_tid();
 
+	void clear_suppress_events_cgroup_id();
+
 	bool check_suppressed(int64_t tid) const;
 
 	void set_fullcapture_port_range(uint16_t range_start, uint16_t range_end);
@@ -824,6 +1013,14 @@ private:
 	static bool is_initialstate_event(const scap_evt& pevent);
 	void import_ifaddr_list();
 	void import_user_list();
+	void import_state_snapshot(scap_platform* platform);
+	void start_state_snapshot();
+	bool continue_state_snapshot(uint32_t max_threads);
+	void write_state_snapshot_marker();
+	void abort_state_snapshot();
+	const scap_linux_vtable* load_bpf_iterators(const scap_linux_vtable* base);
+	void unload_bpf_iterators();
+	void update_proc_rescan(uint64_t ts);
 	int32_t fetch_next_event(sinsp_evt*& evt);
 
 	//
@@ -863,6 +1060,7 @@ private:
 	bool must_notify_thread_group_update() const { return m_mode.is_live() || is_syscall_plugin(); }
 
 	std::shared_ptr<sinsp_stats_v2> m_sinsp_stats_v2;
+	sinsp_startup_stats m_startup_stats{};
 	scap_t* m_h;
 	struct scap_platform* m_platform{};
 	char m_platform_lasterr[SCAP_LASTERR_SIZE];
@@ -1055,8 +1253,40 @@ public:
 	//
 	uint64_t m_proc_scan_timeout_ms;
 	uint64_t m_proc_scan_log_interval_ms;
+	uint32_t m_proc_scan_workers;
+
+	//
+	// Warm-start state snapshot
+	//
+	std::string m_state_snapshot_path;
+	uint64_t m_state_snapshot_interval_ns = 0;
+	uint64_t m_next_state_snapshot_ts = 0;
+	scap_dumper_t* m_state_snapshot_dumper = nullptr;
+	std::unique_ptr<sinsp_thread_manager::threads_dump> m_state_snapshot_dump;
+
+	//
+	// Background /proc rescan after drops
+	//
+#ifdef __linux__
+	std::unique_ptr<sinsp_proc_rescan> m_proc_rescan;
+#endif
+	uint64_t m_proc_rescan_interval_ns = 0;
+	uint64_t m_next_proc_rescan_ts = 0;
+	uint64_t m_proc_rescan_last_drops = 0;
+
+	//
+	// BPF iterators fetching the initial state for other engines
+	//
+	bool m_bpf_iterators_for_proc_scan = false;
+	bool m_bpf_iterators_loaded = false;
+
+	uint32_t m_savefile_header_workers;
 
 	libsinsp::sinsp_suppress m_suppress;
+	// Whether the engine drops the events of suppressed processes in the kernel.
+	bool m_kernel_suppression = false;
+	void init_kernel_suppression();
+	void check_kernel_suppression_res(int32_t res);
 
 	//
 	// Internal manager for plugins
@@ -2075,8 +2075,55 @@ bool sinsp_filter_check_thread::compare_full_aenv(sinsp_evt* evt) {
 	return found;
 }
 
+void sinsp_filter_check_thread::add_filter_value(const char* str, uint32_t len, uint32_t i) {
+	sinsp_filter_check::add_filter_value(str, len, i);
+
+	if(m_field_id == TYPE_NAME || m_field_id == TYPE_EXE || m_field_id == TYPE_EXEPATH) {
+		if(i >= m_interned_vals.size()) {
+			m_interned_vals.resize(i + 1);
+		}
+		// compared like the parsed value, which stops at the first null character
+		m_interned_vals[i] = std::string_view(str, strnlen(str, len));
+	}
+}
+
+bool sinsp_filter_check_thread::compare_interned(sinsp_evt* evt) {
+	sinsp_threadinfo* tinfo = evt->get_thread_info();
+	if(tinfo == NULL) {
+		return false;
+	}
+
+	const libsinsp::interned_string* lhs;
+	switch(m_field_id) {
+	case TYPE_NAME:
+		lhs = &tinfo->m_comm;
+		break;
+	case TYPE_EXE:
+		lhs = &tinfo->m_exe;
+		break;
+	default:
+		lhs = &tinfo->m_exepath;
+		break;
+	}
+
+	for(const auto& val : m_interned_vals) {
+		if(*lhs == val) {
+			return true;
+		}
+	}
+	return false;
+}
+
 bool sinsp_filter_check_thread::compare_nocache(sinsp_evt* evt) {
-	if(m_field_id == TYPE_APID) {
+	if(m_field_id == TYPE_NAME || m_field_id == TYPE_EXE || m_field_id == TYPE_EXEPATH) {
+		// Equality with constant values doesn't need to extract the field: interned strings are
+		// equal only if they are the same. Long `in` lists are better served by the hash lookup.
+		if((m_cmp.op == CO_EQ || (m_cmp.op == CO_IN && m_interned_vals.size() <= 32)) &&
+		   m_cmp.mod == CMPOP_MOD_NONE && !has_transformers() && !has_filtercheck_value() &&
+		   !m_interned_vals.empty()) {
+			return compare_interned(evt);
+		}
+	} else if(m_field_id == TYPE_APID) {
 		if(m_argid == -1) {
 			return compare_full_apid(evt);
 		}
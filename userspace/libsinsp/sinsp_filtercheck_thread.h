@@ -18,6 +18,7 @@ limitations under the License.
 
 #pragma once
 
+#include <libsinsp/interned_string.h>
 #include <libsinsp/sinsp_filtercheck.h>
 #include <libsinsp/state/dynamic_struct.h>
 
@@ -126,6 +127,9 @@ public:
 
 	int32_t get_argid() const;
 
+	using sinsp_filter_check::add_filter_value;
+	void add_filter_value(const char *str, uint32_t len, uint32_t i = 0) override;
+
 protected:
 	uint8_t *extract_single(sinsp_evt *, uint32_t *len, bool sanitize_strings = true) override;
 	bool compare_nocache(sinsp_evt *) override;
@@ -144,6 +148,7 @@ private:
 	bool compare_full_aexepath(sinsp_evt *evt);
 	bool compare_full_acmdline(sinsp_evt *evt);
 	bool compare_full_aenv(sinsp_evt *evt);
+	bool compare_interned(sinsp_evt *evt);
 
 	int32_t m_argid;
 	std::string m_argname;
@@ -155,5 +160,8 @@ private:
 		double d;
 	} m_val;
 	std::vector<uint64_t> m_last_proc_switch_times;
+	// The values compared to proc.name, proc.exe and proc.exepath, interned like the thread fields
+	// so that equality is a pointer comparison.
+	std::vector<libsinsp::interned_string> m_interned_vals;
 	libsinsp::state::accessor::typed_ptr<uint64_t> m_thread_dyn_field_accessor;
 };
@@ -33,6 +33,10 @@ void libsinsp::sinsp_suppress::suppress_tid(uint64_t tid) {
 	m_suppressed_tids.emplace(tid);
 }
 
+void libsinsp::sinsp_suppress::suppress_cgroup_id(uint64_t cgroup_id) {
+	m_suppressed_cgroup_ids.emplace(cgroup_id);
+}
+
 void libsinsp::sinsp_suppress::clear_suppress_comm() {
 	m_suppressed_comms.clear();
 }
@@ -41,6 +45,10 @@ void libsinsp::sinsp_suppress::clear_suppress_tid() {
 	m_suppressed_tids.clear();
 }
 
+void libsinsp::sinsp_suppress::clear_suppress_cgroup_id() {
+	m_suppressed_cgroup_ids.clear();
+}
+
 bool libsinsp::sinsp_suppress::check_suppressed_comm(uint64_t tid,
                                                      uint64_t parent_tid,
                                                      const std::string &comm) {
@@ -37,10 +37,16 @@ public:
 
 	void suppress_tid(uint64_t tid);
 
+	// Cgroup ids can only be suppressed by drivers that drop the
+	// events in the kernel, events never carry them.
+	void suppress_cgroup_id(uint64_t cgroup_id);
+
 	void clear_suppress_comm();
 
 	void clear_suppress_tid();
 
+	void clear_suppress_cgroup_id();
+
 	bool check_suppressed_comm(uint64_t tid, uint64_t parent_tid, const std::string& comm);
 
 	int32_t process_event(scap_evt* e);
@@ -51,6 +57,16 @@ public:
 
 	uint64_t get_num_suppressed_tids() const { return m_suppressed_tids.size(); }
 
+	const std::unordered_set<std::string>& get_suppressed_comms() const {
+		return m_suppressed_comms;
+	}
+
+	const std::unordered_set<uint64_t>& get_suppressed_tids() const { return m_suppressed_tids; }
+
+	const std::unordered_set<uint64_t>& get_suppressed_cgroup_ids() const {
+		return m_suppressed_cgroup_ids;
+	}
+
 	void initialize();
 
 	void finalize();
@@ -58,6 +74,7 @@ public:
 protected:
 	std::unordered_set<std::string> m_suppressed_comms;
 	std::unordered_set<uint64_t> m_suppressed_tids;
+	std::unordered_set<uint64_t> m_suppressed_cgroup_ids;
 
 	uint64_t m_num_suppressed_events = 0;
 
@@ -110,6 +110,12 @@ inline void borrowed_state_data::borrow_from<SS_PLUGIN_ST_STRING, std::string>(
 	m_data.str = value.c_str();
 }
 
+template<>
+inline void borrowed_state_data::borrow_from<SS_PLUGIN_ST_STRING, libsinsp::interned_string>(
+        const libsinsp::interned_string& value) {
+	m_data.str = value.c_str();
+}
+
 template<>
 inline void borrowed_state_data::borrow_from<SS_PLUGIN_ST_TABLE, base_table*>(
         base_table* const& value) {
@@ -131,6 +137,16 @@ inline void borrowed_state_data::borrow_to<SS_PLUGIN_ST_STRING, std::string>(
 	}
 }
 
+template<>
+inline void borrowed_state_data::borrow_to<SS_PLUGIN_ST_STRING, libsinsp::interned_string>(
+        libsinsp::interned_string& out) const {
+	if(m_data.str == nullptr) {
+		out.clear();
+	} else {
+		out = m_data.str;
+	}
+}
+
 template<>
 void borrowed_state_data::copy_to<SS_PLUGIN_ST_STRING, const char*>(const char*& out) const =
         delete;
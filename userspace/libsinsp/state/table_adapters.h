@@ -15,12 +15,31 @@ limitations under the License.
 #pragma once
 
 #include <libsinsp/state/table.h>
+#include <libsinsp/cow_vector.h>
+
 #include <cstring>
 #include <deque>
+#include <type_traits>
 
 namespace libsinsp {
 namespace state {
 
+/**
+ * @brief The table of the values wrapped by a value_table_entry_adapter, when they live in a
+ * storage shared with other containers: the entry only reads the value in place, and asks the
+ * table for a private copy before writing it.
+ */
+template<typename T>
+class value_table_entry_owner {
+public:
+	virtual ~value_table_entry_owner() = default;
+
+	/**
+	 * @brief Returns the value at `key` in a storage that can be written.
+	 */
+	virtual T* writable_value(uint64_t key) = 0;
+};
+
 /**
  * @brief An adapter for the libsinsp::state::table_entry interface
  * that wraps a non-owning pointer of arbitrary type T. The underlying pointer
@@ -40,7 +59,19 @@ public:
 
 	inline const T* value() const { return m_value; }
 
-	inline void set_value(T* v) { m_value = v; }
+	inline void set_value(T* v) {
+		m_value = v;
+		m_owner = nullptr;
+	}
+
+	// Wraps the value at `key` of a shared storage, which `owner` copies before a write.
+	inline void set_value(const T* v, value_table_entry_owner<T>* owner, uint64_t key) {
+		m_value = const_cast<T*>(v);
+		m_owner = owner;
+		m_key = key;
+	}
+
+	inline uint64_t key() const { return m_key; }
 
 	static void list_fields(std::vector<ss_plugin_table_fieldinfo>& out) {
 		ss_plugin_table_fieldinfo value = {"value", type_id_of<T>(), false};
@@ -66,7 +97,14 @@ private:
 
 	static void write_value(void* obj, size_t, const borrowed_state_data& in) {
 		auto* v = static_cast<value_table_entry_adapter*>(obj);
-		in.copy_to<type_id_of<T>(), T>(*v->m_value);
+		in.copy_to<type_id_of<T>(), T>(*v->writable());
+	}
+
+	inline T* writable() {
+		if(m_owner != nullptr) {
+			m_value = m_owner->writable_value(m_key);
+		}
+		return m_value;
 	}
 
 	inline static const accessor s_value_accessor{"value",
@@ -77,6 +115,8 @@ private:
 	                                              false};
 
 	T* m_value;
+	value_table_entry_owner<T>* m_owner = nullptr;
+	uint64_t m_key = 0;
 };
 
 /**
@@ -94,7 +134,21 @@ public:
 
 	inline std::pair<Tfirst, Tsecond>* value() { return m_value; }
 	inline const std::pair<Tfirst, Tsecond>* value() const { return m_value; }
-	inline void set_value(std::pair<Tfirst, Tsecond>* v) { m_value = v; }
+	inline void set_value(std::pair<Tfirst, Tsecond>* v) {
+		m_value = v;
+		m_owner = nullptr;
+	}
+
+	// Wraps the value at `key` of a shared storage, which `owner` copies before a write.
+	inline void set_value(const std::pair<Tfirst, Tsecond>* v,
+	                      value_table_entry_owner<std::pair<Tfirst, Tsecond>>* owner,
+	                      uint64_t key) {
+		m_value = const_cast<std::pair<Tfirst, Tsecond>*>(v);
+		m_owner = owner;
+		m_key = key;
+	}
+
+	inline uint64_t key() const { return m_key; }
 
 	static void list_fields(std::vector<ss_plugin_table_fieldinfo>& out) {
 		ss_plugin_table_fieldinfo first = {"first", type_id_of<Tfirst>(), false};
@@ -133,11 +187,18 @@ private:
 
 	static void write_key(void* obj, size_t, const borrowed_state_data& in) {
 		auto* v = static_cast<value_table_entry_adapter*>(obj);
-		in.copy_to<type_id_of<Tfirst>(), Tfirst>(v->m_value->first);
+		in.copy_to<type_id_of<Tfirst>(), Tfirst>(v->writable()->first);
 	}
 	static void write_value(void* obj, size_t, const borrowed_state_data& in) {
 		auto* v = static_cast<value_table_entry_adapter*>(obj);
-		in.copy_to<type_id_of<Tsecond>(), Tsecond>(v->m_value->second);
+		in.copy_to<type_id_of<Tsecond>(), Tsecond>(v->writable()->second);
+	}
+
+	inline std::pair<Tfirst, Tsecond>* writable() {
+		if(m_owner != nullptr) {
+			m_value = m_owner->writable_value(m_key);
+		}
+		return m_value;
 	}
 
 	inline static const accessor s_first_accessor{"first",
@@ -154,8 +215,27 @@ private:
 	                                               false};
 
 	std::pair<Tfirst, Tsecond>* m_value;
+	value_table_entry_owner<std::pair<Tfirst, Tsecond>>* m_owner = nullptr;
+	uint64_t m_key = 0;
 };
 
+// The containers are written in place, cow_vector ones need their own copy of the storage first.
+template<typename T>
+inline T& mutable_container(T& c) {
+	return c;
+}
+
+template<typename T>
+inline std::vector<T>& mutable_container(libsinsp::cow_vector<T>& c) {
+	return c.mut();
+}
+
+template<typename T>
+struct is_cow_vector : std::false_type {};
+
+template<typename T>
+struct is_cow_vector<libsinsp::cow_vector<T>> : std::true_type {};
+
 /**
  * @brief A template that helps converting STL container types (e.g.
  * std::vector, std::list, etc) into tables compatible with the libsinsp
@@ -167,7 +247,8 @@ private:
  * can lead to expensive sparse array operations or results.
  */
 template<typename T>
-class stl_container_table_adapter : public libsinsp::state::built_in_table<uint64_t> {
+class stl_container_table_adapter : public libsinsp::state::built_in_table<uint64_t>,
+                                    public value_table_entry_owner<typename T::value_type> {
 public:
 	using wrapper_t = value_table_entry_adapter<typename T::value_type>;
 
@@ -197,11 +278,28 @@ public:
 	}
 
 	bool foreach_entry(std::function<bool(libsinsp::state::table_entry& e)> pred) override {
-		wrapper_t w;
-		for(auto& v : m_container) {
-			w.set_value(&v);
-			if(!pred(w)) {
-				return false;
+		if constexpr(is_cow_vector<T>::value) {
+			if(m_container.empty()) {
+				return true;
+			}
+
+			// the entry is one of the wrappers, so that it follows the storage if another entry
+			// copies it, and the storage is looked up again after each entry for the same reason
+			auto entry = wrap_value(&m_container[0], 0);
+			auto& w = static_cast<wrapper_t&>(*entry);
+			for(uint64_t i = 0; i < m_container.size(); i++) {
+				w.set_value(&m_container[i], this, i);
+				if(!pred(w)) {
+					return false;
+				}
+			}
+		} else {
+			wrapper_t w;
+			for(auto& v : m_container) {
+				w.set_value(&v);
+				if(!pred(w)) {
+					return false;
+				}
 			}
 		}
 		return true;
@@ -211,7 +309,29 @@ public:
 		if(key >= m_container.size()) {
 			return nullptr;
 		}
-		return wrap_value(&m_container[key]);
+		if constexpr(is_cow_vector<T>::value) {
+			return wrap_value(&m_container[key], key);
+		} else {
+			return wrap_value(&m_container[key]);
+		}
+	}
+
+	typename T::value_type* writable_value(uint64_t key) override {
+		if constexpr(is_cow_vector<T>::value) {
+			const auto* shared = m_container.get().data();
+			auto& container = m_container.mut();
+			if(container.data() != shared) {
+				// the storage was copied, the other entries must not use the shared one anymore
+				for(auto& w : m_wrappers) {
+					if(w.value() != nullptr) {
+						w.set_value(&container[w.key()], this, w.key());
+					}
+				}
+			}
+			return &container[key];
+		} else {
+			return &m_container[key];
+		}
 	}
 
 	std::shared_ptr<libsinsp::state::table_entry> add_entry(
@@ -232,15 +352,21 @@ public:
 			                      std::string(this->name()));
 		}
 
-		m_container.resize(key + 1);
-		return wrap_value(&m_container[key]);
+		auto& container = mutable_container(m_container);
+		container.resize(key + 1);
+		if constexpr(is_cow_vector<T>::value) {
+			return wrap_value(&container[key], key);
+		} else {
+			return wrap_value(&container[key]);
+		}
 	}
 
 	bool erase_entry(const uint64_t& key) override {
 		if(key >= m_container.size()) {
 			return false;
 		}
-		m_container.erase(m_container.begin() + key);
+		auto& container = mutable_container(m_container);
+		container.erase(container.begin() + key);
 		return true;
 	}
 
@@ -251,17 +377,29 @@ private:
 	// only if we need them. Wrappers are reused for multiple entries, and
 	// we leverage shared_ptrs to automatically release them once not anymore used
 	inline std::shared_ptr<libsinsp::state::table_entry> wrap_value(typename T::value_type* v) {
+		auto& w = free_wrapper();
+		w.set_value(v);
+		return std::shared_ptr<libsinsp::state::table_entry>(&w, wrap_deleter);
+	}
+
+	// wraps the value at `key` of a shared storage, copied only if the entry is written
+	inline std::shared_ptr<libsinsp::state::table_entry> wrap_value(
+	        const typename T::value_type* v,
+	        uint64_t key) {
+		auto& w = free_wrapper();
+		w.set_value(v, this, key);
+		return std::shared_ptr<libsinsp::state::table_entry>(&w, wrap_deleter);
+	}
+
+	inline wrapper_t& free_wrapper() {
 		for(auto& w : m_wrappers) {
 			if(w.value() == nullptr) {
-				w.set_value(v);
-				return std::shared_ptr<libsinsp::state::table_entry>(&w, wrap_deleter);
+				return w;
 			}
 		}
 
 		// no wrapper is free among the allocated ones so add an extra one
-		auto& w = m_wrappers.emplace_back();
-		w.set_value(v);
-		return std::shared_ptr<libsinsp::state::table_entry>(&w, wrap_deleter);
+		return m_wrappers.emplace_back();
 	}
 
 	T& m_container;
@@ -17,6 +17,7 @@ limitations under the License.
 */
 #pragma once
 
+#include <libsinsp/interned_string.h>
 #include <libsinsp/sinsp_exception.h>
 #include <plugin/plugin_types.h>
 
@@ -70,6 +71,10 @@ inline constexpr ss_plugin_state_type type_id_of<std::string>() {
 	return SS_PLUGIN_ST_STRING;
 }
 template<>
+inline constexpr ss_plugin_state_type type_id_of<libsinsp::interned_string>() {
+	return SS_PLUGIN_ST_STRING;
+}
+template<>
 inline constexpr ss_plugin_state_type type_id_of<base_table*>() {
 	return SS_PLUGIN_ST_TABLE;
 }
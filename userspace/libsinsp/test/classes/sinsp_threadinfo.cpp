@@ -190,3 +190,47 @@ TEST(sinsp_threadinfo, set_exepath) {
 		ASSERT_EQ(tinfo->get_exepath(), "a ");
 	}
 }
+
+TEST(sinsp_threadinfo, shared_args_env_cgroups) {
+	const sinsp inspector;
+	const auto& threadinfo_factory = inspector.get_threadinfo_factory();
+	const auto tinfo1 = threadinfo_factory.create_shared();
+	const auto tinfo2 = threadinfo_factory.create_shared();
+
+	const char args[] = "-jar\0app.jar";
+	const char env[] = "HOME=/root\0PATH=/bin";
+	const char cgroups[] = "cpu=/a\0mem=/b";
+	for(const auto& tinfo : {tinfo1, tinfo2}) {
+		tinfo->set_args(args, sizeof(args));
+		tinfo->set_env(env, sizeof(env), false);
+		tinfo->set_cgroups(cgroups, sizeof(cgroups));
+	}
+
+	ASSERT_EQ(tinfo1->m_args, std::vector<std::string>({"-jar", "app.jar"}));
+	ASSERT_EQ(tinfo1->m_env, std::vector<std::string>({"HOME=/root", "PATH=/bin"}));
+	ASSERT_EQ(tinfo1->cgroups(),
+	          sinsp_threadinfo::cgroups_t({{"cpu", "/a"}, {"memory", "/b"}}));
+	ASSERT_TRUE(tinfo1->m_args.shares_storage_with(tinfo2->m_args));
+	ASSERT_TRUE(tinfo1->m_env.shares_storage_with(tinfo2->m_env));
+	ASSERT_TRUE(tinfo1->m_cgroups.shares_storage_with(tinfo2->m_cgroups));
+
+	// Invalid cgroups are rejected, also when the valid part of them is pooled
+	const char invalid_cgroups[] = "cpu=/a\0mem";
+	tinfo2->set_cgroups(invalid_cgroups, sizeof(invalid_cgroups));
+	ASSERT_TRUE(tinfo1->m_cgroups.shares_storage_with(tinfo2->m_cgroups));
+	const char alias_cgroups[] = "cpu_cgroup=/a\0memory=/b";
+	tinfo2->set_cgroups(alias_cgroups, sizeof(alias_cgroups));
+	ASSERT_EQ(tinfo2->cgroups(),
+	          sinsp_threadinfo::cgroups_t({{"cpu", "/a"}, {"memory", "/b"}}));
+
+	// Same strings, split differently
+	const char other_args[] = "-jar\0app\0jar";
+	tinfo2->set_args(other_args, sizeof(other_args) - 1);
+	ASSERT_FALSE(tinfo1->m_args.shares_storage_with(tinfo2->m_args));
+	ASSERT_EQ(tinfo2->m_args.size(), 3);
+
+	// Writing doesn't affect the other threads
+	tinfo2->m_env.push_back("LANG=C");
+	ASSERT_EQ(tinfo1->m_env.size(), 2);
+	ASSERT_EQ(tinfo2->m_env.size(), 3);
+}
@@ -0,0 +1,348 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2026 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <libsinsp/columnar_dumper.h>
+
+#include <gtest/gtest.h>
+
+#include <sinsp_with_test_input.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <variant>
+
+static std::string read_file(const std::string& path) {
+	std::ifstream in(path, std::ios::binary);
+	return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+//
+// Minimal reader for the Thrift compact protocol, decoding a struct into a
+// tree of its fields so that the Parquet metadata can be checked.
+//
+struct thrift_value;
+using thrift_struct = std::map<int16_t, thrift_value>;
+using thrift_list = std::vector<thrift_value>;
+
+struct thrift_value {
+	std::variant<int64_t, std::string, thrift_list, thrift_struct> v;
+
+	int64_t i() const { return std::get<int64_t>(v); }
+	const std::string& str() const { return std::get<std::string>(v); }
+	const thrift_list& list() const { return std::get<thrift_list>(v); }
+	const thrift_value& operator[](int16_t id) const { return std::get<thrift_struct>(v).at(id); }
+	bool has(int16_t id) const { return std::get<thrift_struct>(v).count(id) != 0; }
+};
+
+class thrift_compact_reader {
+public:
+	thrift_compact_reader(const std::string& data, size_t pos): m_data(data), m_pos(pos) {}
+
+	thrift_value read_struct() {
+		thrift_struct s;
+		int16_t last = 0;
+		while(true) {
+			uint8_t b = byte();
+			if(b == 0) {
+				return {s};
+			}
+			uint8_t delta = b >> 4;
+			int16_t id = delta ? last + delta : static_cast<int16_t>(zigzag(varint()));
+			s[id] = read_value(b & 0x0f);
+			last = id;
+		}
+	}
+
+	size_t pos() const { return m_pos; }
+
+private:
+	thrift_value read_value(uint8_t type) {
+		switch(type) {
+		case 1:  // BOOLEAN_TRUE
+			return {int64_t(1)};
+		case 2:  // BOOLEAN_FALSE
+			return {int64_t(0)};
+		case 5:  // I32
+		case 6:  // I64
+			return {zigzag(varint())};
+		case 8: {  // BINARY
+			uint64_t len = varint();
+			std::string str = m_data.substr(m_pos, len);
+			m_pos += len;
+			return {str};
+		}
+		case 9: {  // LIST
+			uint8_t b = byte();
+			uint64_t size = b >> 4;
+			if(size == 15) {
+				size = varint();
+			}
+			thrift_list l;
+			for(uint64_t i = 0; i < size; i++) {
+				l.push_back((b & 0x0f) == 12 ? read_struct() : read_value(b & 0x0f));
+			}
+			return {l};
+		}
+		case 12:  // STRUCT
+			return read_struct();
+		default:
+			throw std::runtime_error("unexpected thrift type " + std::to_string(type));
+		}
+	}
+
+	uint8_t byte() { return static_cast<uint8_t>(m_data.at(m_pos++)); }
+
+	uint64_t varint() {
+		uint64_t v = 0;
+		for(int shift = 0;; shift += 7) {
+			uint8_t b = byte();
+			v |= static_cast<uint64_t>(b & 0x7f) << shift;
+			if(!(b & 0x80)) {
+				return v;
+			}
+		}
+	}
+
+	static int64_t zigzag(uint64_t v) { return static_cast<int64_t>(v >> 1) ^ -(int64_t)(v & 1); }
+
+	const std::string& m_data;
+	size_t m_pos;
+};
+
+using parquet_cell = std::optional<std::variant<int64_t, double, std::string>>;
+
+//
+// Decodes the columns of a file written by sinsp_columnar_dumper, checking the
+// metadata along the way. Returns one vector of cells per column.
+//
+static std::vector<std::vector<parquet_cell>> read_parquet(const std::string& data,
+                                                           std::vector<std::string>& names) {
+	uint32_t footer_len;
+	memcpy(&footer_len, data.data() + data.size() - 8, sizeof(footer_len));
+	thrift_compact_reader footer(data, data.size() - 8 - footer_len);
+	thrift_value md = footer.read_struct();
+	EXPECT_EQ(footer.pos(), data.size() - 8);
+
+	const auto& schema = md[2].list();
+	EXPECT_EQ(schema[0][5].i(), (int64_t)schema.size() - 1);
+	names.clear();
+	std::vector<int64_t> types;
+	for(size_t i = 1; i < schema.size(); i++) {
+		names.push_back(schema[i][4].str());
+		types.push_back(schema[i][1].i());
+		EXPECT_EQ(schema[i][3].i(), 1);  // OPTIONAL
+	}
+
+	std::vector<std::vector<parquet_cell>> columns(names.size());
+	int64_t total_rows = 0;
+	for(const auto& rg : md[4].list()) {
+		const auto& chunks = rg[1].list();
+		EXPECT_EQ(chunks.size(), names.size());
+		for(size_t c = 0; c < chunks.size(); c++) {
+			const auto& cmd = chunks[c][3];
+			EXPECT_EQ(cmd[1].i(), types[c]);
+			EXPECT_EQ(cmd[3].list()[0].str(), names[c]);
+			EXPECT_EQ(cmd[5].i(), rg[3].i());
+
+			thrift_compact_reader ph_reader(data, cmd[9].i());
+			thrift_value ph = ph_reader.read_struct();
+			EXPECT_EQ(ph[1].i(), 0);  // DATA_PAGE
+			int64_t nvalues = ph[5][1].i();
+			EXPECT_EQ(nvalues, rg[3].i());
+			size_t pos = ph_reader.pos();
+			EXPECT_EQ(pos + ph[2].i() - cmd[9].i(), (size_t)cmd[7].i());
+
+			// Definition levels: a single bit-packed run, prefixed by its length
+			uint32_t levels_len;
+			memcpy(&levels_len, data.data() + pos, sizeof(levels_len));
+			pos += sizeof(levels_len);
+			size_t ngroups = 0;
+			for(int shift = 0;; shift += 7) {
+				uint8_t b = static_cast<uint8_t>(data[pos++]);
+				ngroups |= static_cast<size_t>(b & 0x7f) << shift;
+				if(!(b & 0x80)) {
+					break;
+				}
+			}
+			EXPECT_EQ(ngroups & 1, 1);
+			ngroups >>= 1;
+			const uint8_t* defs = reinterpret_cast<const uint8_t*>(data.data() + pos);
+			pos += ngroups;
+
+			size_t nbools = 0;
+			for(int64_t r = 0; r < nvalues; r++) {
+				if(!(defs[r / 8] & (1 << (r % 8)))) {
+					columns[c].emplace_back(std::nullopt);
+					continue;
+				}
+				switch(types[c]) {
+				case 0:  // BOOLEAN
+					columns[c].emplace_back(
+					        int64_t((data[pos + nbools / 8] >> (nbools % 8)) & 1));
+					nbools++;
+					break;
+				case 2: {  // INT64
+					int64_t v;
+					memcpy(&v, data.data() + pos, sizeof(v));
+					pos += sizeof(v);
+					columns[c].emplace_back(v);
+					break;
+				}
+				case 6: {  // BYTE_ARRAY
+					uint32_t len;
+					memcpy(&len, data.data() + pos, sizeof(len));
+					pos += sizeof(len);
+					columns[c].emplace_back(data.substr(pos, len));
+					pos += len;
+					break;
+				}
+				default:
+					ADD_FAILURE() << "unexpected column type " << types[c];
+					return {};
+				}
+			}
+			pos += (nbools + 7) / 8;
+			EXPECT_EQ(pos, (size_t)(cmd[9].i() + cmd[7].i()));
+		}
+		total_rows += rg[3].i();
+	}
+	EXPECT_EQ(md[3].i(), total_rows);
+	return columns;
+}
+
+TEST_F(sinsp_with_test_input, columnar_dumper_columns) {
+	add_default_init_thread();
+	open_inspector();
+
+	sinsp_columnar_dumper dumper(&m_inspector,
+	                             {"evt.num", "proc.name", "toupper(proc.name)", "fd.name"},
+	                             m_default_filterlist);
+	const auto& columns = dumper.columns();
+	ASSERT_EQ(columns.size(), 4);
+	ASSERT_EQ(columns[0].name, "evt.num");
+	ASSERT_EQ(columns[0].field_type, PT_UINT64);
+	ASSERT_FALSE(columns[0].as_string);
+	ASSERT_EQ(columns[1].field_type, PT_CHARBUF);
+	ASSERT_FALSE(columns[1].as_string);
+	ASSERT_EQ(columns[2].name, "toupper(proc.name)");
+
+	ASSERT_THROW(sinsp_columnar_dumper(&m_inspector, {"proc.nonexistent"}, m_default_filterlist),
+	             sinsp_exception);
+	ASSERT_THROW(sinsp_columnar_dumper(&m_inspector, {}, m_default_filterlist), sinsp_exception);
+}
+
+TEST_F(sinsp_with_test_input, columnar_dumper_file_layout) {
+	add_default_init_thread();
+	open_inspector();
+
+	std::string path = (std::filesystem::temp_directory_path() / "columnar_dumper.parquet").string();
+	sinsp_columnar_dumper dumper(&m_inspector,
+	                             {"evt.num", "proc.name", "thread.tid", "fd.name", "evt.is_io"},
+	                             m_default_filterlist,
+	                             2);
+	dumper.open(path);
+	for(int i = 0; i < 5; i++) {
+		dumper.dump(generate_getcwd_failed_entry_event());
+	}
+	ASSERT_EQ(dumper.written_events(), 5);
+	dumper.close();
+	ASSERT_FALSE(dumper.is_open());
+
+	std::string data = read_file(path);
+	ASSERT_EQ(data.size(), dumper.written_bytes());
+	ASSERT_GT(data.size(), 12);
+	ASSERT_EQ(data.substr(0, 4), "PAR1");
+	ASSERT_EQ(data.substr(data.size() - 4), "PAR1");
+
+	uint32_t footer_len;
+	memcpy(&footer_len, data.data() + data.size() - 8, sizeof(footer_len));
+	ASSERT_LT(footer_len, data.size() - 12);
+
+	// The column names are stored in the footer, the values in the pages.
+	std::string footer = data.substr(data.size() - 8 - footer_len, footer_len);
+	ASSERT_NE(footer.find("proc.name"), std::string::npos);
+	ASSERT_NE(footer.find("evt.is_io"), std::string::npos);
+	std::string pages = data.substr(4, data.size() - 12 - footer_len);
+	ASSERT_NE(pages.find("init"), std::string::npos);
+
+	std::filesystem::remove(path);
+}
+
+TEST_F(sinsp_with_test_input, columnar_dumper_round_trip) {
+	add_default_init_thread();
+	open_inspector();
+
+	std::vector<std::string> fields = {"evt.num",
+	                                   "proc.name",
+	                                   "thread.tid",
+	                                   "fd.name",
+	                                   "evt.is_io",
+	                                   "fd.types"};
+	std::string path =
+	        (std::filesystem::temp_directory_path() / "columnar_round_trip.parquet").string();
+	sinsp_columnar_dumper dumper(&m_inspector, fields, m_default_filterlist, 2);
+	dumper.open(path);
+
+	std::vector<int64_t> nums;
+	for(int i = 0; i < 5; i++) {
+		sinsp_evt* evt;
+		if(i % 2 == 0) {
+			evt = generate_getcwd_failed_entry_event();
+		} else {
+			sinsp_test_input::open_params params;
+			params.fd = 3 + i;
+			params.path = i == 1 ? "/tmp/a" : "/tmp/b";
+			evt = generate_open_x_event(params);
+		}
+		nums.push_back(evt->get_num());
+		dumper.dump(evt);
+	}
+	dumper.close();
+
+	std::vector<std::string> names;
+	auto columns = read_parquet(read_file(path), names);
+	std::filesystem::remove(path);
+	ASSERT_EQ(names, fields);
+	ASSERT_EQ(columns.size(), fields.size());
+	for(const auto& col : columns) {
+		ASSERT_EQ(col.size(), 5);
+	}
+
+	for(size_t r = 0; r < 5; r++) {
+		ASSERT_EQ(columns[0][r], parquet_cell(nums[r]));
+		ASSERT_EQ(columns[1][r], parquet_cell(std::string("init")));
+		ASSERT_EQ(columns[2][r], parquet_cell(int64_t(INIT_TID)));
+		ASSERT_EQ(columns[4][r], parquet_cell(int64_t(0)));
+	}
+
+	// Only the opens have an fd
+	ASSERT_EQ(columns[3][0], parquet_cell());
+	ASSERT_EQ(columns[3][1], parquet_cell(std::string("/tmp/a")));
+	ASSERT_EQ(columns[3][2], parquet_cell());
+	ASSERT_EQ(columns[3][3], parquet_cell(std::string("/tmp/b")));
+	ASSERT_EQ(columns[3][4], parquet_cell());
+
+	// Lists are stored as their string rendering, and are only extracted for fd events
+	ASSERT_EQ(columns[5][0], parquet_cell());
+	ASSERT_EQ(columns[5][1], parquet_cell(std::string("(file)")));
+	ASSERT_EQ(columns[5][3], parquet_cell(std::string("(file)")));
+}
@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2026 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <libsinsp/cow_vector.h>
+#include <gtest/gtest.h>
+
+#include <string>
+
+using strvec = libsinsp::cow_vector<std::string>;
+
+TEST(cow_vector, copy_on_write) {
+	strvec a(std::vector<std::string>{"x", "y"});
+	strvec b = a;
+	ASSERT_TRUE(a.shares_storage_with(b));
+
+	// reading through a non-const object doesn't copy
+	size_t len = 0;
+	for(const auto& s : b) {
+		len += s.size();
+	}
+	ASSERT_EQ(len, 2);
+	ASSERT_TRUE(a.shares_storage_with(b));
+
+	b.push_back("z");
+	ASSERT_FALSE(a.shares_storage_with(b));
+	ASSERT_EQ(a, std::vector<std::string>({"x", "y"}));
+	ASSERT_EQ(b, std::vector<std::string>({"x", "y", "z"}));
+
+	// a is not shared anymore, so it's written in place
+	const auto* storage = &a.get();
+	a.mut()[0] = "w";
+	ASSERT_EQ(&a.get(), storage);
+
+	b.clear();
+	ASSERT_TRUE(b.empty());
+	ASSERT_EQ(b, strvec());
+}
+
+TEST(cow_vector, pool) {
+	libsinsp::cow_vector_pool<std::string> pool;
+	int made = 0;
+	auto make = [&made]() {
+		made++;
+		return std::vector<std::string>{"x"};
+	};
+	auto is_x = [](const std::vector<std::string>& v) { return v.size() == 1 && v[0] == "x"; };
+	auto never = [](const std::vector<std::string>&) { return false; };
+
+	strvec a = pool.intern(1, is_x, make);
+	strvec b = pool.intern(1, is_x, make);
+	ASSERT_EQ(made, 1);
+	ASSERT_TRUE(a.shares_storage_with(b));
+
+	// hash collision with a different value
+	strvec c = pool.intern(1, never, make);
+	ASSERT_EQ(made, 2);
+	ASSERT_FALSE(a.shares_storage_with(c));
+
+	// pooled values are copied before being written, even if not shared
+	c.push_back("y");
+	strvec d = pool.intern(1, never, make);
+	ASSERT_EQ(d.size(), 1);
+
+	// values are dropped from the pool once unused
+	a.clear();
+	b.clear();
+	d.clear();
+	strvec e = pool.intern(1, is_x, make);
+	ASSERT_EQ(made, 4);
+}
@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2026 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+#include <libsinsp/filter/parser.h>
+#include <libsinsp/filter/path_prefixes.h>
+
+using prefix_set_t = std::set<std::string>;
+
+static std::optional<prefix_set_t> prefixes(const std::string& filter) {
+	return libsinsp::filter::ast::fd_name_prefixes(libsinsp::filter::parser(filter).parse().get());
+}
+
+TEST(filter_path_prefixes, bounded) {
+	ASSERT_EQ(prefixes("fd.name startswith /etc/"), prefix_set_t({"/etc/"}));
+	ASSERT_EQ(prefixes("fd.name = /etc/shadow"), prefix_set_t({"/etc/shadow"}));
+	ASSERT_EQ(prefixes("fd.name in (/etc/shadow, /etc/passwd)"),
+	          prefix_set_t({"/etc/passwd", "/etc/shadow"}));
+	ASSERT_EQ(prefixes("fd.name pmatch (/etc, /root)"), prefix_set_t({"/etc", "/root"}));
+	ASSERT_EQ(prefixes("fd.name pmatch (/var/*/log, /home/user?, /tmp/[ab])"),
+	          prefix_set_t({"/var/", "/home/user", "/tmp/"}));
+	// wildcards are only special for pmatch
+	ASSERT_EQ(prefixes("fd.name in (/tmp/*)"), prefix_set_t({"/tmp/*"}));
+	ASSERT_EQ(prefixes("evt.type = open and proc.name = cat and fd.name startswith /etc"),
+	          prefix_set_t({"/etc"}));
+	ASSERT_EQ(prefixes("fd.name startswith /etc or fd.name startswith /root"),
+	          prefix_set_t({"/etc", "/root"}));
+
+	// the smallest bound of a conjunction is picked
+	ASSERT_EQ(prefixes("fd.name in (/a, /b) and fd.name startswith /a"), prefix_set_t({"/a"}));
+}
+
+TEST(filter_path_prefixes, unbounded) {
+	ASSERT_FALSE(prefixes("proc.name = cat").has_value());
+	ASSERT_FALSE(prefixes("not fd.name startswith /etc").has_value());
+	ASSERT_FALSE(prefixes("fd.name contains /etc").has_value());
+	ASSERT_FALSE(prefixes("fd.name startswith etc").has_value());
+	ASSERT_FALSE(prefixes("fd.name in (/etc, etc)").has_value());
+	ASSERT_FALSE(prefixes("fd.name pmatch (/etc, */etc)").has_value());
+	ASSERT_FALSE(prefixes("fd.name glob /etc/*").has_value());
+	ASSERT_FALSE(prefixes("tolower(fd.name) startswith /etc").has_value());
+	ASSERT_FALSE(prefixes("fd.name startswith /etc or proc.name = cat").has_value());
+}
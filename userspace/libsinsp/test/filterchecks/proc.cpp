@@ -80,6 +80,16 @@ TEST_F(sinsp_with_test_input, PROC_FILTER_exepath) {
 
 	ASSERT_EQ(get_field_as_string(evt, "proc.exepath"), "/usr/bin/bad-exe");
 	ASSERT_EQ(get_field_as_string(evt, "proc.name"), "good-exe");
+
+	// equality with constant values compares the interned strings
+	EXPECT_TRUE(eval_filter(evt, "proc.name = good-exe"));
+	EXPECT_TRUE(eval_filter(evt, "proc.name in (bash, good-exe)"));
+	EXPECT_TRUE(eval_filter(evt, "proc.exepath = /usr/bin/bad-exe"));
+	EXPECT_TRUE(eval_filter(evt, "toupper(proc.name) = GOOD-EXE"));
+	EXPECT_TRUE(eval_filter(evt, "proc.name != bash"));
+	EXPECT_FALSE(eval_filter(evt, "proc.name = good"));
+	EXPECT_FALSE(eval_filter(evt, "proc.name in (bash, good)"));
+	EXPECT_FALSE(eval_filter(evt, "proc.exepath = \"/usr/bin/bad-exe (deleted)\""));
 }
 
 TEST_F(sinsp_with_test_input, PROC_FILTER_pexepath_aexepath) {
@@ -0,0 +1,115 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2026 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <libsinsp/interned_string.h>
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using libsinsp::interned_string;
+
+TEST(interned_string, sharing) {
+	const size_t pool_size = interned_string::pool_size();
+
+	interned_string a("interned_string_test");
+	interned_string b(std::string("interned_string_test"));
+	ASSERT_EQ(a, b);
+	ASSERT_EQ(a.c_str(), b.c_str());
+	ASSERT_EQ(a.id(), b.id());
+	ASSERT_EQ(interned_string::pool_size(), pool_size + 1);
+
+	ASSERT_EQ(a, "interned_string_test");
+	ASSERT_EQ("interned_string_test", a);
+	ASSERT_EQ(a, std::string("interned_string_test"));
+	ASSERT_EQ(a.size(), 20);
+
+	b = "interned_string_other";
+	ASSERT_NE(a, b);
+	ASSERT_NE(a.id(), b.id());
+	ASSERT_EQ(interned_string::pool_size(), pool_size + 2);
+
+	// strings are dropped from the pool once unused
+	a.clear();
+	b = std::string();
+	ASSERT_TRUE(a.empty());
+	ASSERT_EQ(a, b);
+	ASSERT_EQ(a.id(), 0);
+	ASSERT_EQ(interned_string::pool_size(), pool_size);
+}
+
+TEST(interned_string, copies) {
+	const size_t pool_size = interned_string::pool_size();
+	{
+		interned_string a("interned_string_test");
+		std::vector<interned_string> v(10, a);
+		interned_string b(std::move(v[0]));
+		ASSERT_TRUE(v[0].empty());
+		ASSERT_EQ(b, a);
+		v.clear();
+		a = b;
+		ASSERT_EQ(interned_string::pool_size(), pool_size + 1);
+	}
+	ASSERT_EQ(interned_string::pool_size(), pool_size);
+}
+
+TEST(interned_string, concurrency) {
+	const size_t pool_size = interned_string::pool_size();
+	std::vector<std::thread> threads;
+	for(int t = 0; t < 4; t++) {
+		threads.emplace_back([]() {
+			interned_string s;
+			for(int i = 0; i < 10000; i++) {
+				s = "interned_string_" + std::to_string(i % 7);
+				interned_string copy = s;
+				ASSERT_EQ(copy, s);
+			}
+		});
+	}
+	for(auto& t : threads) {
+		t.join();
+	}
+	ASSERT_EQ(interned_string::pool_size(), pool_size);
+}
+
+TEST(interned_string, unpooled) {
+	const size_t pool_size = interned_string::pool_size();
+	{
+		interned_string pooled("interned_string_test");
+		interned_string a = interned_string::unpooled("interned_string_test");
+		interned_string b = interned_string::unpooled("interned_string_test");
+		ASSERT_EQ(interned_string::pool_size(), pool_size + 1);
+		ASSERT_EQ(a.id(), interned_string::UNPOOLED_ID);
+		ASSERT_NE(a.c_str(), b.c_str());
+		ASSERT_EQ(a, b);
+		ASSERT_EQ(a, pooled);
+		ASSERT_EQ(pooled, b);
+
+		// copies share the storage
+		interned_string copy = a;
+		ASSERT_EQ(copy.c_str(), a.c_str());
+		a = "interned_string_other";
+		ASSERT_NE(a, copy);
+		ASSERT_EQ(copy, "interned_string_test");
+
+		ASSERT_TRUE(interned_string::unpooled("").empty());
+		ASSERT_EQ(interned_string::unpooled("").id(), 0);
+	}
+	ASSERT_EQ(interned_string::pool_size(), pool_size);
+}
@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2026 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <sinsp_with_test_input.h>
+#include <libsinsp/dumper.h>
+#include <libscap/scap_engines.h>
+
+#include <filesystem>
+
+#ifdef HAS_ENGINE_MULTI_SAVEFILE
+
+// Splits a single event stream into two capture files (even and odd events) and
+// checks that replaying them together gives back the original stream.
+TEST_F(sinsp_with_test_input, multi_savefile_ordered_merge) {
+	add_default_init_thread();
+	open_inspector();
+
+	// The users and groups written when opening the files take the timestamp of the last event, or
+	// the current time if there's none yet, which would sort them after the generated events.
+	generate_getcwd_failed_entry_event();
+
+	auto tmp_dir = std::filesystem::temp_directory_path();
+	std::string even_path = (tmp_dir / "multi_savefile_even.scap").string();
+	std::string odd_path = (tmp_dir / "multi_savefile_odd.scap").string();
+
+	sinsp_dumper even;
+	sinsp_dumper odd;
+	even.open(&m_inspector, even_path, false);
+	odd.open(&m_inspector, odd_path, false);
+
+	constexpr int num_events = 1000;
+	std::vector<uint64_t> expected_ts;
+	for(int i = 0; i < num_events; i++) {
+		auto evt = generate_getcwd_failed_entry_event();
+		expected_ts.push_back(evt->get_ts());
+		(i % 2 == 0 ? even : odd).dump(evt);
+	}
+	even.close();
+	odd.close();
+	m_inspector.close();
+
+	sinsp replay;
+	// The odd file comes first to make sure the merge doesn't depend on the order of the files.
+	replay.open_savefiles({odd_path, even_path});
+	ASSERT_TRUE(replay.is_capture());
+	ASSERT_NE(replay.m_thread_manager->find_thread(INIT_TID, true), nullptr);
+
+	std::vector<uint64_t> actual_ts;
+	sinsp_evt* evt = nullptr;
+	int32_t res;
+	while((res = replay.next(&evt)) != SCAP_EOF) {
+		ASSERT_NE(res, SCAP_FAILURE) << replay.getlasterr();
+		if(res == SCAP_SUCCESS && evt->get_type() == PPME_SYSCALL_GETCWD_X) {
+			actual_ts.push_back(evt->get_ts());
+		}
+	}
+	ASSERT_EQ(actual_ts, expected_ts);
+	replay.close();
+
+	std::filesystem::remove(even_path);
+	std::filesystem::remove(odd_path);
+}
+
+TEST(sinsp_multi_savefile, missing_file) {
+	sinsp inspector;
+	ASSERT_THROW(inspector.open_savefiles({}), sinsp_exception);
+	ASSERT_THROW(inspector.open_savefiles({"/this/file/does/not/exist.scap"}), sinsp_exception);
+}
+
+#endif
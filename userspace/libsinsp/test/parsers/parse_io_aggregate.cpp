@@ -0,0 +1,83 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2026 The Falco Authors.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <sinsp_with_test_input.h>
+
+TEST_F(sinsp_with_test_input, parse_io_aggregate) {
+	add_default_init_thread();
+	open_inspector();
+
+	auto evt = generate_open_x_event();
+	ASSERT_TRUE(evt->get_fd_info());
+
+	evt = add_event_advance_ts(increasing_ts(),
+	                           INIT_TID,
+	                           PPME_IO_AGGREGATE_E,
+	                           7,
+	                           sinsp_test_input::open_params::default_fd,
+	                           (uint64_t)3,
+	                           (uint64_t)300,
+	                           (uint64_t)2,
+	                           (uint64_t)20,
+	                           (uint64_t)1000,
+	                           (uint64_t)2000);
+
+	// assert_fd_fields() expects an exit event carrying the fd as return value.
+	ASSERT_TRUE(evt->get_fd_info());
+	ASSERT_EQ(get_field_as_string(evt, "fd.num"),
+	          std::to_string(sinsp_test_input::open_params::default_fd));
+	ASSERT_EQ(get_field_as_string(evt, "fd.name"), sinsp_test_input::open_params::default_path);
+	ASSERT_EQ(get_field_as_string(evt, "fd.directory"),
+	          sinsp_test_input::open_params::default_directory);
+	ASSERT_EQ(get_field_as_string(evt, "fd.filename"),
+	          sinsp_test_input::open_params::default_filename);
+
+	ASSERT_EQ(get_field_as_string(evt, "evt.type"), "io_aggregate");
+	ASSERT_EQ(get_field_as_string(evt, "evt.rawarg.rcount"), "3");
+	ASSERT_EQ(get_field_as_string(evt, "evt.rawarg.rbytes"), "300");
+	ASSERT_EQ(get_field_as_string(evt, "evt.rawarg.wcount"), "2");
+	ASSERT_EQ(get_field_as_string(evt, "evt.rawarg.wbytes"), "20");
+
+	// The aggregate must not leak its fd into the following syscalls.
+	std::string data = "hello";
+	uint32_t size = data.size();
+	evt = add_event_advance_ts(increasing_ts(),
+	                           INIT_TID,
+	                           PPME_SYSCALL_READ_X,
+	                           4,
+	                           (int64_t)size,
+	                           scap_const_sized_buffer{data.c_str(), size},
+	                           (int64_t)-1,
+	                           size);
+	ASSERT_FALSE(evt->get_fd_info());
+}
+
+TEST_F(sinsp_with_test_input, parse_io_aggregate_unknown_fd) {
+	add_default_init_thread();
+	open_inspector();
+
+	auto evt = add_event_advance_ts(increasing_ts(),
+	                                INIT_TID,
+	                                PPME_IO_AGGREGATE_E,
+	                                7,
+	                                (int64_t)42,
+	                                (uint64_t)1,
+	                                (uint64_t)10,
+	                                (uint64_t)0,
+	                                (uint64_t)0,
+	                                (uint64_t)1000,
+	                                (uint64_t)1000);
+	ASSERT_FALSE(evt->get_fd_info());
+	ASSERT_EQ(get_field_as_string(evt, "evt.rawarg.rbytes"), "10");
+}
@@ -0,0 +1,217 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2026 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <gtest/gtest.h>
+#include <libsinsp/linux/proc_rescan.h>
+#include <libscap/linux/scap_linux_platform.h>
+#include <libscap/scap_procs.h>
+
+#include <filesystem>
+#include <future>
+#include <thread>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+// Runs the routines only when asked, so that the tests control when the rescan reads /proc.
+class manual_thread_pool : public sinsp_thread_pool {
+public:
+	routine_id_t subscribe(const std::function<bool()>& func) override {
+		m_routines.push_back(func);
+		return m_routines.size();
+	}
+
+	bool unsubscribe(routine_id_t id) override { return false; }
+
+	void purge() override { m_routines.clear(); }
+
+	size_t routines_num() override { return m_routines.size(); }
+
+	// Runs each routine once, and drops the ones that are done.
+	void run_once() {
+		for(auto it = m_routines.begin(); it != m_routines.end();) {
+			it = (*it)() ? std::next(it) : m_routines.erase(it);
+		}
+	}
+
+	void run_all() {
+		while(!m_routines.empty()) {
+			run_once();
+		}
+	}
+
+private:
+	std::list<std::function<bool()>> m_routines;
+};
+
+// A thread of this process that the rescan can find, alive until the test lets it go.
+class helper_thread {
+public:
+	helper_thread() {
+		std::promise<int64_t> tid;
+		auto tid_future = tid.get_future();
+		m_thread = std::thread([this, &tid]() {
+			tid.set_value(syscall(SYS_gettid));
+			m_exit.get_future().wait();
+		});
+		m_tid = tid_future.get();
+	}
+
+	~helper_thread() {
+		m_exit.set_value();
+		m_thread.join();
+	}
+
+	int64_t tid() const { return m_tid; }
+
+private:
+	std::thread m_thread;
+	std::promise<void> m_exit;
+	int64_t m_tid = 0;
+};
+
+// All the tids alive in /proc except `tid`.
+std::unordered_set<int64_t> tids_except(int64_t tid) {
+	std::unordered_set<int64_t> tids;
+	std::error_code ec;
+	for(const auto& proc_entry : std::filesystem::directory_iterator("/proc", ec)) {
+		std::error_code task_ec;
+		for(const auto& task_entry :
+		    std::filesystem::directory_iterator(proc_entry.path() / "task", task_ec)) {
+			const int64_t task_tid = atoll(task_entry.path().filename().c_str());
+			if(task_tid > 0 && task_tid != tid) {
+				tids.insert(task_tid);
+			}
+		}
+	}
+	return tids;
+}
+
+std::vector<int64_t> consume_tids(sinsp_proc_rescan& rescan) {
+	std::vector<int64_t> tids;
+	rescan.consume([&tids](sinsp_proc_rescan::entry& e) { tids.push_back(e.tinfo.tid); });
+	return tids;
+}
+
+bool contains(const std::vector<int64_t>& tids, int64_t tid) {
+	return std::find(tids.begin(), tids.end(), tid) != tids.end();
+}
+
+// Whether the threads of this process can be read from /proc at all: the reader needs the host
+// cgroup filesystem, which some sandboxes deny.
+bool can_read_threads(scap_linux_platform& platform) {
+	char error[SCAP_LASTERR_SIZE];
+	scap_linux_platform* reader = scap_linux_alloc_proc_reader(&platform, error);
+	if(reader == nullptr) {
+		return false;
+	}
+
+	scap_proclist proclist;
+	init_proclist(&proclist,
+	              {default_refresh_start_end_callback,
+	               default_refresh_start_end_callback,
+	               [](void*, char*, int64_t, scap_threadinfo*, scap_fdinfo*, scap_threadinfo**) {
+		               return int32_t(SCAP_SUCCESS);
+	               },
+	               nullptr});
+	const bool res =
+	        scap_linux_read_thread(reader, &proclist, syscall(SYS_gettid), false, error) ==
+	        SCAP_SUCCESS;
+	scap_linux_free_proc_reader(reader);
+	return res;
+}
+
+}  // namespace
+
+TEST(proc_rescan, reads_missing_threads) {
+	auto tpool = std::make_shared<manual_thread_pool>();
+	sinsp_proc_rescan rescan(tpool);
+	scap_linux_platform platform = {};
+	if(!can_read_threads(platform)) {
+		GTEST_SKIP() << "the threads can't be read from /proc";
+	}
+	helper_thread helper;
+
+	const auto known_tids = tids_except(helper.tid());
+	ASSERT_TRUE(rescan.start(&platform, known_tids, false));
+	ASSERT_FALSE(rescan.start(&platform, known_tids, false));
+
+	// Nothing is handed over before the threads are read.
+	tpool->run_once();
+	ASSERT_TRUE(rescan.busy());
+	ASSERT_TRUE(consume_tids(rescan).empty());
+
+	tpool->run_all();
+	const auto tids = consume_tids(rescan);
+	ASSERT_TRUE(contains(tids, helper.tid()));
+	for(const auto tid : tids) {
+		ASSERT_EQ(known_tids.count(tid), 0);
+	}
+	ASSERT_FALSE(rescan.busy());
+}
+
+TEST(proc_rescan, drops_threads_exited_during_rescan) {
+	auto tpool = std::make_shared<manual_thread_pool>();
+	sinsp_proc_rescan rescan(tpool);
+	scap_linux_platform platform = {};
+	if(!can_read_threads(platform)) {
+		GTEST_SKIP() << "the threads can't be read from /proc";
+	}
+	helper_thread helper;
+
+	ASSERT_TRUE(rescan.start(&platform, tids_except(helper.tid()), false));
+	tpool->run_all();
+
+	// The thread was read from /proc, then its exit was parsed before the rescan was consumed.
+	rescan.on_thread_exit(helper.tid());
+	ASSERT_FALSE(contains(consume_tids(rescan), helper.tid()));
+	ASSERT_FALSE(rescan.busy());
+}
+
+TEST(proc_rescan, ignores_exits_before_rescan) {
+	auto tpool = std::make_shared<manual_thread_pool>();
+	sinsp_proc_rescan rescan(tpool);
+	scap_linux_platform platform = {};
+	if(!can_read_threads(platform)) {
+		GTEST_SKIP() << "the threads can't be read from /proc";
+	}
+	helper_thread helper;
+
+	// An exit parsed before the rescan started is about a previous thread with the same tid.
+	rescan.on_thread_exit(helper.tid());
+	ASSERT_TRUE(rescan.start(&platform, tids_except(helper.tid()), false));
+	tpool->run_all();
+	ASSERT_TRUE(contains(consume_tids(rescan), helper.tid()));
+}
+
+TEST(proc_rescan, stop_drops_pending_threads) {
+	auto tpool = std::make_shared<manual_thread_pool>();
+	sinsp_proc_rescan rescan(tpool);
+	scap_linux_platform platform = {};
+	helper_thread helper;
+
+	ASSERT_TRUE(rescan.start(&platform, tids_except(helper.tid()), false));
+	tpool->run_once();
+	rescan.stop();
+	ASSERT_FALSE(rescan.busy());
+
+	// The routine left over returns right away, without reading anything.
+	tpool->run_all();
+	ASSERT_TRUE(consume_tids(rescan).empty());
+}
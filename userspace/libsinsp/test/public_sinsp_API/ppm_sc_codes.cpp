@@ -178,6 +178,8 @@ const libsinsp::events::set<ppm_event_code> expected_sinsp_state_event_set = {
         PPME_CONTAINER_E,
         PPME_PROCINFO_E,
         PPME_CPU_HOTPLUG_E,
+        PPME_IO_AGGREGATE_E,
+        PPME_RATE_LIMIT_DROPS_E,
         PPME_K8S_E,
         PPME_TRACER_E,
         PPME_MESOS_E,
@@ -328,6 +330,8 @@ const libsinsp::events::set<ppm_event_code> expected_unknown_event_set = {
         PPME_ITER_TASK_FILE_ANON_INODE_X,
         PPME_SYSCALL_CLOSE_RANGE_E,
         PPME_SYSCALL_KEYCTL_E,
+        PPME_IO_AGGREGATE_X,
+        PPME_RATE_LIMIT_DROPS_X,
 };
 
 /// todo(@Andreagit97): here we miss static sets for io, proc, net groups
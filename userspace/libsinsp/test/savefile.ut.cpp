@@ -0,0 +1,212 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2026 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <sinsp_with_test_input.h>
+#include <libsinsp/dumper.h>
+#include <libscap/scap_engines.h>
+
+#include <filesystem>
+#include <map>
+
+#ifdef HAS_ENGINE_SAVEFILE
+
+// Loads the same capture with serial and parallel header decoding and checks
+// that the resulting thread and fd tables are identical.
+TEST_F(sinsp_with_test_input, savefile_parallel_header_load) {
+	add_default_init_thread();
+	// Enough threads to split the process list block in several tasks.
+	constexpr int64_t num_threads = 300;
+	for(int64_t tid = 2; tid <= num_threads; tid++) {
+		scap_threadinfo tinfo = create_threadinfo(tid,
+		                                          tid,
+		                                          1,
+		                                          tid,
+		                                          tid,
+		                                          tid,
+		                                          "worker-" + std::to_string(tid),
+		                                          "/usr/bin/worker",
+		                                          "/usr/bin/worker",
+		                                          increasing_ts(),
+		                                          0,
+		                                          0,
+		                                          {"worker", std::to_string(tid)},
+		                                          0,
+		                                          {"HOME=/root"},
+		                                          "/srv/");
+		std::vector<scap_fdinfo> fdinfos;
+		for(int64_t fd = 0; fd < tid % 5; fd++) {
+			scap_fdinfo fdinfo = {};
+			fdinfo.fd = fd;
+			fdinfo.ino = tid * 10 + fd;
+			fdinfo.type = SCAP_FD_FILE_V2;
+			snprintf(fdinfo.info.regularinfo.fname,
+			         sizeof(fdinfo.info.regularinfo.fname),
+			         "/tmp/%ld-%ld",
+			         (long)tid,
+			         (long)fd);
+			fdinfos.push_back(fdinfo);
+		}
+		add_thread(tinfo, fdinfos);
+	}
+	open_inspector();
+
+	std::string path =
+	        (std::filesystem::temp_directory_path() / "savefile_parallel_header_load.scap").string();
+	sinsp_dumper dumper;
+	dumper.open(&m_inspector, path, false);
+	dumper.dump(generate_getcwd_failed_entry_event());
+	dumper.close();
+	m_inspector.close();
+
+	auto load = [&](uint32_t workers) {
+		std::map<int64_t, std::string> table;
+		sinsp inspector;
+		inspector.set_savefile_header_workers(workers);
+		inspector.open_savefile(path);
+		inspector.m_thread_manager->get_threads()->loop([&](sinsp_threadinfo& tinfo) {
+			std::map<int64_t, std::string> fds;
+			tinfo.get_fd_table()->loop([&](int64_t fd, sinsp_fdinfo& fdinfo) {
+				fds[fd] = fdinfo.m_name;
+				return true;
+			});
+			std::string desc = tinfo.get_comm() + " " + tinfo.get_exe() + " " +
+			                   std::to_string(tinfo.m_args.size()) + " " + tinfo.get_cwd();
+			for(const auto& [fd, name] : fds) {
+				desc += " " + std::to_string(fd) + ":" + name;
+			}
+			table[tinfo.m_tid] = desc;
+			return true;
+		});
+		inspector.close();
+		return table;
+	};
+
+	auto serial = load(1);
+	ASSERT_EQ(serial.size(), num_threads);
+	ASSERT_EQ(serial[42], "worker-42 /usr/bin/worker 2 /srv/ 0:/tmp/42-0 1:/tmp/42-1");
+	ASSERT_EQ(load(4), serial);
+	ASSERT_EQ(load(0), serial);
+
+	std::filesystem::remove(path);
+}
+
+// Writes the thread table a few threads at a time, like the state snapshot does, and checks that
+// it loads like a regular capture without the threads removed in the meantime.
+TEST_F(sinsp_with_test_input, savefile_incremental_threads_dump) {
+	add_default_init_thread();
+	constexpr int64_t num_threads = 100;
+	for(int64_t tid = 2; tid <= num_threads; tid++) {
+		scap_threadinfo tinfo = create_threadinfo(tid,
+		                                          tid,
+		                                          1,
+		                                          tid,
+		                                          tid,
+		                                          tid,
+		                                          "worker-" + std::to_string(tid),
+		                                          "/usr/bin/worker",
+		                                          "/usr/bin/worker",
+		                                          increasing_ts(),
+		                                          0,
+		                                          0,
+		                                          {"worker", std::to_string(tid)},
+		                                          0,
+		                                          {"HOME=/root"},
+		                                          "/srv/");
+		std::vector<scap_fdinfo> fdinfos;
+		for(int64_t fd = 0; fd < tid % 5; fd++) {
+			scap_fdinfo fdinfo = {};
+			fdinfo.fd = fd;
+			fdinfo.ino = tid * 10 + fd;
+			fdinfo.type = SCAP_FD_FILE_V2;
+			snprintf(fdinfo.info.regularinfo.fname,
+			         sizeof(fdinfo.info.regularinfo.fname),
+			         "/tmp/%ld-%ld",
+			         (long)tid,
+			         (long)fd);
+			fdinfos.push_back(fdinfo);
+		}
+		add_thread(tinfo, fdinfos);
+	}
+	open_inspector();
+
+	std::string path =
+	        (std::filesystem::temp_directory_path() / "savefile_incremental_threads_dump.scap")
+	                .string();
+	char error[SCAP_LASTERR_SIZE];
+	scap_dumper_t* dumper = scap_dump_open(nullptr, path.c_str(), SCAP_COMPRESSION_NONE, error);
+	ASSERT_NE(dumper, nullptr) << error;
+	uint32_t steps = 1;
+	{
+		sinsp_thread_manager::threads_dump dump(*m_inspector.m_thread_manager, dumper);
+		m_inspector.m_thread_manager->remove_thread(50);
+		while(!dump.step(7)) {
+			steps++;
+		}
+	}
+	// A capture can't be opened without events.
+	sinsp_evt* evt = generate_getcwd_failed_entry_event();
+	ASSERT_EQ(scap_dump(dumper, evt->get_scap_evt(), evt->get_cpuid(), 0), SCAP_SUCCESS);
+	scap_dump_close(dumper);
+	m_inspector.close();
+
+	// Two passes over the threads, 7 at a time.
+	ASSERT_GE(steps, 2 * (num_threads - 1) / 7);
+
+	std::map<int64_t, std::string> table;
+	sinsp inspector;
+	inspector.open_savefile(path);
+	inspector.m_thread_manager->get_threads()->loop([&](sinsp_threadinfo& tinfo) {
+		std::string desc = tinfo.get_comm();
+		tinfo.get_fd_table()->loop([&](int64_t fd, sinsp_fdinfo& fdinfo) {
+			desc += " " + std::to_string(fd) + ":" + fdinfo.m_name;
+			return true;
+		});
+		table[tinfo.m_tid] = desc;
+		return true;
+	});
+	inspector.close();
+
+	ASSERT_EQ(table.size(), num_threads - 1);
+	ASSERT_EQ(table.count(50), 0);
+	ASSERT_EQ(table[43], "worker-43 0:/tmp/43-0 1:/tmp/43-1 2:/tmp/43-2");
+
+	std::filesystem::remove(path);
+}
+
+// The state snapshot holds no event of the capture, it must still open as a capture file.
+TEST_F(sinsp_with_test_input, savefile_state_snapshot_loads) {
+	add_default_init_thread();
+	open_inspector();
+
+	std::string path =
+	        (std::filesystem::temp_directory_path() / "savefile_state_snapshot_loads.scap").string();
+	m_inspector.set_state_snapshot(path, 0);
+	m_inspector.save_state_snapshot();
+	m_inspector.close();
+
+	sinsp inspector;
+	inspector.open_savefile(path);
+	const auto& tinfo = inspector.m_thread_manager->find_thread(INIT_TID, true);
+	ASSERT_NE(tinfo, nullptr);
+	ASSERT_EQ(tinfo->get_comm(), "init");
+	inspector.close();
+
+	std::filesystem::remove(path);
+}
+
+#endif
@@ -381,6 +381,61 @@ TEST_F(sinsp_with_test_input, sinsp_libs_metrics_collector_output_rule) {
 	ASSERT_EQ(metrics_snapshot.size(), 26);
 }
 
+TEST_F(sinsp_with_test_input, sinsp_libs_metrics_collector_startup) {
+	add_default_init_thread();
+	scap_threadinfo tinfo = create_threadinfo(2,
+	                                          2,
+	                                          1,
+	                                          2,
+	                                          2,
+	                                          2,
+	                                          "server",
+	                                          "/usr/bin/server",
+	                                          "/usr/bin/server",
+	                                          increasing_ts(),
+	                                          0,
+	                                          0,
+	                                          {},
+	                                          0,
+	                                          {},
+	                                          "/");
+	scap_fdinfo fdinfo = {};
+	fdinfo.fd = 3;
+	fdinfo.ino = 10;
+	fdinfo.type = SCAP_FD_UNIX_SOCK;
+	scap_fdinfo fdinfo2 = {};
+	fdinfo2.fd = 4;
+	fdinfo2.ino = 11;
+	fdinfo2.type = SCAP_FD_FILE_V2;
+	strlcpy(fdinfo2.info.regularinfo.fname,
+	        "/var/log/server.log",
+	        sizeof(fdinfo2.info.regularinfo.fname));
+	add_thread(tinfo, {fdinfo, fdinfo2});
+	open_inspector();
+
+	const auto& stats = m_inspector.get_startup_stats();
+	ASSERT_EQ(stats.m_n_threads, 2);
+	ASSERT_EQ(stats.m_n_fds, 3);
+	ASSERT_EQ(stats.m_n_sockets, 1);
+	ASSERT_GE(stats.m_total_ns, stats.m_engine_load_ns + stats.m_plugin_init_ns);
+
+	libs::metrics::libs_metrics_collector libs_metrics_collector(&m_inspector, METRICS_V2_STARTUP);
+	libs_metrics_collector.snapshot();
+	auto metrics_snapshot = libs_metrics_collector.get_metrics();
+	ASSERT_EQ(metrics_snapshot.size(), 12);
+
+	std::map<std::string, uint64_t> values;
+	for(const auto& metric : metrics_snapshot) {
+		ASSERT_EQ(metric.flags, METRICS_V2_STARTUP);
+		values[metric.name] = metric.value.u64;
+	}
+	ASSERT_EQ(values.at("startup_total_ns"), stats.m_total_ns);
+	ASSERT_EQ(values.at("startup_n_threads"), 2);
+	ASSERT_EQ(values.at("startup_n_fds"), 3);
+	ASSERT_EQ(values.at("startup_n_sockets"), 1);
+	ASSERT_EQ(values.at("startup_n_snapshot_threads"), 0);
+}
+
 TEST(sinsp_libs_metrics, sinsp_libs_metrics_convert_units) {
 	/* Test public libs::metrics::convert_memory method */
 	double converted_memory = libs::metrics::convert_memory(METRIC_VALUE_UNIT_MEMORY_BYTES,
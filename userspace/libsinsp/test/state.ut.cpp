@@ -645,9 +645,8 @@ TEST(thread_manager, env_vars_access) {
 
 	// getting the "env" tables from the newly created threads
 	auto subtable_acc = field->second.into<libsinsp::state::base_table*>();
-	auto subtable =
-	        dynamic_cast<libsinsp::state::stl_container_table_adapter<std::vector<std::string>>*>(
-	                entry->read_field(subtable_acc));
+	auto subtable = dynamic_cast<libsinsp::state::stl_container_table_adapter<
+	        libsinsp::cow_vector<std::string>>*>(entry->read_field(subtable_acc));
 	ASSERT_NE(subtable, nullptr);
 	EXPECT_EQ(subtable->name(), std::string("env"));
 	EXPECT_EQ(subtable->entries_count(), 0);
@@ -750,6 +749,46 @@ TEST(thread_manager, env_vars_access) {
 	EXPECT_EQ(tinfo->m_env.size(), 0);
 }
 
+TEST(stl_container_table_adapter, cow_vector_copied_on_write) {
+	libsinsp::cow_vector<std::string> shared(std::vector<std::string>{"a", "b", "c"});
+	auto container = shared;
+	libsinsp::state::stl_container_table_adapter<decltype(container)> table("test", container);
+	auto fieldacc = table.get_field("value", SS_PLUGIN_ST_STRING).as<std::string>();
+
+	// Reading doesn't copy the storage
+	auto first = table.get_entry(0);
+	auto last = table.get_entry(2);
+	std::string tmpstr;
+	first->read_field(fieldacc, tmpstr);
+	ASSERT_EQ(tmpstr, "a");
+	std::vector<std::string> values;
+	ASSERT_TRUE(table.foreach_entry([&](libsinsp::state::table_entry& e) {
+		e.read_field(fieldacc, tmpstr);
+		values.push_back(tmpstr);
+		return true;
+	}));
+	ASSERT_EQ(values, std::vector<std::string>({"a", "b", "c"}));
+	ASSERT_TRUE(container.shares_storage_with(shared));
+
+	// Writing copies it, and the other entries follow the copy
+	first->write_field(fieldacc, std::string("x"));
+	ASSERT_FALSE(container.shares_storage_with(shared));
+	ASSERT_EQ(shared, std::vector<std::string>({"a", "b", "c"}));
+	ASSERT_EQ(container, std::vector<std::string>({"x", "b", "c"}));
+	last->write_field(fieldacc, std::string("z"));
+	ASSERT_EQ(shared, std::vector<std::string>({"a", "b", "c"}));
+	ASSERT_EQ(container, std::vector<std::string>({"x", "b", "z"}));
+
+	// The same goes for the entries written while iterating
+	auto copy = container;
+	ASSERT_TRUE(table.foreach_entry([&](libsinsp::state::table_entry& e) {
+		e.write_field(fieldacc, std::string("y"));
+		return true;
+	}));
+	ASSERT_EQ(copy, std::vector<std::string>({"x", "b", "z"}));
+	ASSERT_EQ(container, std::vector<std::string>({"y", "y", "y"}));
+}
+
 // Regression test for commit 890dacf: the thread_local std::string scratch
 // buffer in extensible_struct::raw_read_field is shared across ALL string field
 // reads.  Reading a second, longer string field causes the thread_local string
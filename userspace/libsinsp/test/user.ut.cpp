@@ -16,6 +16,7 @@ limitations under the License.
 
 */
 
+#include <filesystem>
 #include <fstream>
 #include <gtest/gtest.h>
 #include <sys/stat.h>
@@ -23,6 +24,7 @@ limitations under the License.
 
 #include <sinsp_with_test_input.h>
 #include <libsinsp/user.h>
+#include <libsinsp/usergroup_loader.h>
 
 using namespace libsinsp;
 
@@ -385,4 +387,186 @@ TEST_F(usergroup_manager_host_root_parsing_test, short_lines_are_skipped) {
 	mgr.add_group(container_id, -1, 999, std::string_view{});
 	ASSERT_EQ(mgr.get_group(container_id, 999), nullptr);
 }
+
+// Fixture with a host root holding the /proc entries of a process running in a container, to
+// exercise the loading of the container users and groups.
+class usergroup_manager_container_test : public sinsp_with_test_input {
+protected:
+	void SetUp() override {
+		char pwd_buf[SCAP_MAX_PATH_SIZE];
+		auto pwd = getcwd(pwd_buf, SCAP_MAX_PATH_SIZE);
+		ASSERT_NE(pwd, nullptr);
+		m_host_root = pwd_buf;
+		m_host_root += "/host_container";
+		m_inspector.set_host_root(m_host_root);
+
+		m_proc_dir = m_host_root + "/proc/42";
+		std::filesystem::create_directories(m_host_root + "/proc/1/root");
+		std::filesystem::create_directories(m_proc_dir + "/root/etc");
+		std::filesystem::create_directories(m_proc_dir + "/ns");
+		std::ofstream(m_proc_dir + "/ns/mnt");
+
+		write_passwd(
+		        "root:x:0:0:root:/root:/bin/sh\n"
+		        "alice:x:1000:1000:alice:/home/alice:/bin/bash\n");
+		write_group(
+		        "root:x:0:\n"
+		        "staff:x:1000:alice\n");
+	}
+
+	void TearDown() override { std::filesystem::remove_all(m_host_root); }
+
+	void write_passwd(const std::string& content) {
+		std::ofstream ofs(m_proc_dir + "/root/etc/passwd");
+		ofs << content;
+	}
+
+	void write_group(const std::string& content) {
+		std::ofstream ofs(m_proc_dir + "/root/etc/group");
+		ofs << content;
+	}
+
+	// The files are loaded in the background if the inspector has a thread pool.
+	static void wait_loaded(sinsp_usergroup_manager& mgr) {
+		for(int i = 0; i < 500 && mgr.pending_loads() > 0; i++) {
+			mgr.update();
+			usleep(10000);
+		}
+		ASSERT_EQ(mgr.pending_loads(), 0);
+	}
+
+	std::string m_host_root;
+	std::string m_proc_dir;
+};
+
+// Runs the routines only when asked to.
+class manual_thread_pool : public sinsp_thread_pool {
+public:
+	routine_id_t subscribe(const std::function<bool()>& func) override {
+		m_routines.push_back(func);
+		return m_routines.size();
+	}
+	bool unsubscribe(routine_id_t id) override { return false; }
+	void purge() override { m_routines.clear(); }
+	size_t routines_num() override { return m_routines.size(); }
+
+	void run() {
+		auto routines = std::move(m_routines);
+		for(auto& r : routines) {
+			while(r()) {
+			}
+		}
+	}
+
+private:
+	std::vector<std::function<bool()>> m_routines;
+};
+
+TEST_F(usergroup_manager_container_test, container_lookup) {
+	const std::string container_id{"c1"};
+	const timestamper timestamper{0};
+	sinsp_usergroup_manager mgr{&m_inspector, timestamper};
+
+	ASSERT_NE(mgr.add_group(container_id, 42, 1000), nullptr);
+	ASSERT_NE(mgr.add_user(container_id, 42, 1000, 1000), nullptr);
+	wait_loaded(mgr);
+
+	auto* user = mgr.get_user(container_id, 1000);
+	ASSERT_NE(user, nullptr);
+	ASSERT_EQ(user->gid, 1000);
+	ASSERT_STREQ(user->name, "alice");
+	ASSERT_STREQ(user->homedir, "/home/alice");
+	ASSERT_STREQ(user->shell, "/bin/bash");
+	auto* group = mgr.get_group(container_id, 1000);
+	ASSERT_NE(group, nullptr);
+	ASSERT_STREQ(group->name, "staff");
+
+	// All the users and groups of the container are loaded at once.
+	ASSERT_EQ(mgr.get_userlist(container_id)->size(), 2);
+	ASSERT_EQ(mgr.get_grouplist(container_id)->size(), 2);
+
+	// Users missing from the container files are not added.
+	mgr.add_user(container_id, 42, 2000, 2000);
+	wait_loaded(mgr);
+	ASSERT_EQ(mgr.get_user(container_id, 2000), nullptr);
+
+	mgr.delete_container(container_id);
+	ASSERT_EQ(mgr.get_userlist(container_id), nullptr);
+}
+
+TEST_F(usergroup_manager_container_test, files_cached) {
+	sinsp_usergroup_loader loader(2);
+
+	auto first = loader.load("c1", m_proc_dir);
+	ASSERT_NE(first.users, nullptr);
+	ASSERT_NE(first.groups, nullptr);
+	ASSERT_EQ(first.users->size(), 2);
+	ASSERT_EQ(first.groups->size(), 2);
+	ASSERT_EQ(loader.cached_files(), 2);
+
+	// The same files are parsed once, whatever the container.
+	auto second = loader.load("c2", m_proc_dir);
+	ASSERT_EQ(second.container_id, "c2");
+	ASSERT_EQ(second.users, first.users);
+	ASSERT_EQ(second.groups, first.groups);
+
+	// The files of another container with the same content are shared too.
+	const std::string other_proc_dir = m_host_root + "/proc/43";
+	std::filesystem::create_directories(other_proc_dir + "/root/etc");
+	std::filesystem::copy_file(m_proc_dir + "/root/etc/passwd",
+	                           other_proc_dir + "/root/etc/passwd");
+	std::filesystem::copy_file(m_proc_dir + "/root/etc/group", other_proc_dir + "/root/etc/group");
+	auto other = loader.load("c3", other_proc_dir);
+	ASSERT_EQ(other.users, first.users);
+	ASSERT_EQ(other.groups, first.groups);
+	ASSERT_EQ(loader.cached_files(), 2);
+
+	// A modified file is parsed again, and the least recently used one is dropped.
+	write_passwd("root:x:0:0:root:/root:/bin/sh\n");
+	auto third = loader.load("c1", m_proc_dir);
+	ASSERT_NE(third.users, first.users);
+	ASSERT_EQ(third.users->size(), 1);
+	ASSERT_EQ(third.groups, first.groups);
+	ASSERT_EQ(loader.cached_files(), 2);
+
+	// Missing files are not an error.
+	auto none = loader.load("c3", m_host_root + "/proc/1");
+	ASSERT_EQ(none.users, nullptr);
+	ASSERT_EQ(none.groups, nullptr);
+}
+
+TEST_F(usergroup_manager_container_test, files_loaded_async) {
+	auto tpool = std::make_shared<manual_thread_pool>();
+	sinsp_usergroup_loader loader;
+	ASSERT_FALSE(loader.load_async(nullptr, "c1", m_proc_dir));
+
+	ASSERT_TRUE(loader.load_async(tpool, "c1", m_proc_dir));
+	ASSERT_TRUE(loader.load_async(tpool, "c2", m_proc_dir));
+	ASSERT_EQ(tpool->routines_num(), 1);
+	ASSERT_EQ(loader.consume([](auto&) { FAIL(); }), 0);
+
+	tpool->run();
+	std::vector<std::string> loaded;
+	ASSERT_EQ(loader.consume([&loaded](sinsp_usergroup_loader::result& res) {
+		ASSERT_NE(res.users, nullptr);
+		ASSERT_EQ(res.users->size(), 2);
+		loaded.push_back(res.container_id);
+	}),
+	          2);
+	ASSERT_EQ(loaded, (std::vector<std::string>{"c1", "c2"}));
+	ASSERT_EQ(loader.cached_files(), 2);
+
+	// The jobs go to the pool they are queued with, e.g. after the inspector pool is replaced
+	// with a routine still subscribed to the old one.
+	ASSERT_TRUE(loader.load_async(tpool, "c3", m_proc_dir));
+	auto new_tpool = std::make_shared<manual_thread_pool>();
+	ASSERT_TRUE(loader.load_async(new_tpool, "c4", m_proc_dir));
+	ASSERT_EQ(new_tpool->routines_num(), 1);
+	new_tpool->run();
+	loaded.clear();
+	loader.consume([&loaded](sinsp_usergroup_loader::result& res) {
+		loaded.push_back(res.container_id);
+	});
+	ASSERT_EQ(loaded, (std::vector<std::string>{"c3", "c4"}));
+}
 #endif
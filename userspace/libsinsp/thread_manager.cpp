@@ -746,6 +746,117 @@ std::string sinsp_thread_manager::get_ancestor_field_as_string(
 	return "";
 }
 
+void sinsp_thread_manager::write_proclist_entry(scap_dumper_t* proclist_dumper,
+                                                sinsp_threadinfo& tinfo,
+                                                uint32_t& totlen) {
+	scap_threadinfo sctinfo{};
+	struct iovec *args_iov, *envs_iov, *cgroups_iov;
+	int argscnt, envscnt, cgroupscnt;
+	std::string argsrem, envsrem, cgroupsrem;
+	uint32_t entrylen = 0;
+	const auto& cg = tinfo.cgroups();
+
+	memset(&sctinfo, 0, sizeof(scap_threadinfo));
+
+	thread_to_scap(tinfo, &sctinfo);
+	tinfo.args_to_iovec(&args_iov, &argscnt, argsrem);
+	tinfo.env_to_iovec(&envs_iov, &envscnt, envsrem);
+	tinfo.cgroups_to_iovec(&cgroups_iov, &cgroupscnt, cgroupsrem, cg);
+
+	if(scap_write_proclist_entry_bufs(proclist_dumper,
+	                                  &sctinfo,
+	                                  &entrylen,
+	                                  tinfo.m_comm.c_str(),
+	                                  tinfo.m_exe.c_str(),
+	                                  tinfo.m_exepath.c_str(),
+	                                  args_iov,
+	                                  argscnt,
+	                                  envs_iov,
+	                                  envscnt,
+	                                  (tinfo.get_cwd() == "" ? "/" : tinfo.get_cwd().c_str()),
+	                                  cgroups_iov,
+	                                  cgroupscnt,
+	                                  tinfo.m_root.c_str()) != SCAP_SUCCESS) {
+		free(args_iov);
+		free(envs_iov);
+		free(cgroups_iov);
+		throw sinsp_exception(scap_dump_getlasterr(proclist_dumper));
+	}
+
+	totlen += entrylen;
+
+	free(args_iov);
+	free(envs_iov);
+	free(cgroups_iov);
+}
+
+bool sinsp_thread_manager::write_thread_fds(scap_dumper_t* dumper, sinsp_threadinfo& tinfo) {
+	scap_threadinfo sctinfo{};
+
+	memset(&sctinfo, 0, sizeof(scap_threadinfo));
+
+	// Note: as scap_fd_add/scap_write_proc_fds do not use
+	// any of the array-based fields like comm, etc. a
+	// shallow copy is safe
+	thread_to_scap(tinfo, &sctinfo);
+
+	if(tinfo.is_main_thread()) {
+		//
+		// Add the FDs
+		//
+		sinsp_fdtable* fd_table_ptr = tinfo.get_fd_table();
+		if(fd_table_ptr == NULL) {
+			return false;
+		}
+
+		bool should_exit = false;
+		fd_table_ptr->loop([&](int64_t fd, sinsp_fdinfo& info) {
+			//
+			// Allocate the scap fd info
+			//
+			scap_fdinfo* scfdinfo = (scap_fdinfo*)malloc(sizeof(scap_fdinfo));
+			if(scfdinfo == NULL) {
+				scap_fd_free_proc_fd_table(&sctinfo);
+				should_exit = true;
+				return false;
+			}
+
+			//
+			// Populate the fd info
+			//
+			fd_to_scap(*scfdinfo, info);
+
+			//
+			// Add the new fd to the scap table.
+			//
+			if(scap_fd_add(&sctinfo, scfdinfo) != SCAP_SUCCESS) {
+				scap_fd_free_proc_fd_table(&sctinfo);
+				throw sinsp_exception("Failed to add fd to hash table");
+			}
+
+			return true;
+		});
+
+		if(should_exit) {
+			return false;
+		}
+	}
+
+	//
+	// Dump the thread to disk
+	//
+	if(scap_write_proc_fds(dumper, &sctinfo) != SCAP_SUCCESS) {
+		scap_fd_free_proc_fd_table(&sctinfo);
+		throw sinsp_exception(
+		        "error calling scap_write_proc_fds in "
+		        "sinsp_thread_manager::dump_threads_to_file (" +
+		        std::string(scap_dump_getlasterr(dumper)) + ")");
+	}
+
+	scap_fd_free_proc_fd_table(&sctinfo);
+	return true;
+}
+
 void sinsp_thread_manager::dump_threads_to_file(scap_dumper_t* dumper) {
 	if(m_threadtable.size() == 0) {
 		return;
@@ -757,52 +868,17 @@ void sinsp_thread_manager::dump_threads_to_file(scap_dumper_t* dumper) {
 	}
 
 	uint32_t totlen = 0;
-	m_threadtable.loop([&](sinsp_threadinfo& tinfo) {
-		if(tinfo.m_filtered_out) {
+	try {
+		m_threadtable.loop([&](sinsp_threadinfo& tinfo) {
+			if(!tinfo.m_filtered_out) {
+				write_proclist_entry(proclist_dumper, tinfo, totlen);
+			}
 			return true;
-		}
-
-		scap_threadinfo sctinfo{};
-		struct iovec *args_iov, *envs_iov, *cgroups_iov;
-		int argscnt, envscnt, cgroupscnt;
-		std::string argsrem, envsrem, cgroupsrem;
-		uint32_t entrylen = 0;
-		const auto& cg = tinfo.cgroups();
-
-		memset(&sctinfo, 0, sizeof(scap_threadinfo));
-
-		thread_to_scap(tinfo, &sctinfo);
-		tinfo.args_to_iovec(&args_iov, &argscnt, argsrem);
-		tinfo.env_to_iovec(&envs_iov, &envscnt, envsrem);
-		tinfo.cgroups_to_iovec(&cgroups_iov, &cgroupscnt, cgroupsrem, cg);
-
-		if(scap_write_proclist_entry_bufs(proclist_dumper,
-		                                  &sctinfo,
-		                                  &entrylen,
-		                                  tinfo.m_comm.c_str(),
-		                                  tinfo.m_exe.c_str(),
-		                                  tinfo.m_exepath.c_str(),
-		                                  args_iov,
-		                                  argscnt,
-		                                  envs_iov,
-		                                  envscnt,
-		                                  (tinfo.get_cwd() == "" ? "/" : tinfo.get_cwd().c_str()),
-		                                  cgroups_iov,
-		                                  cgroupscnt,
-		                                  tinfo.m_root.c_str()) != SCAP_SUCCESS) {
-			sinsp_exception exc(scap_dump_getlasterr(proclist_dumper));
-			scap_dump_close(proclist_dumper);
-			throw exc;
-		}
-
-		totlen += entrylen;
-
-		free(args_iov);
-		free(envs_iov);
-		free(cgroups_iov);
-
-		return true;
-	});
+		});
+	} catch(...) {
+		scap_dump_close(proclist_dumper);
+		throw;
+	}
 
 	if(scap_write_proclist_end(dumper, proclist_dumper, totlen) != SCAP_SUCCESS) {
 		throw sinsp_exception(scap_dump_getlasterr(dumper));
@@ -816,71 +892,77 @@ void sinsp_thread_manager::dump_threads_to_file(scap_dumper_t* dumper) {
 		if(tinfo.m_filtered_out) {
 			return true;
 		}
+		return write_thread_fds(dumper, tinfo);
+	});
+}
 
-		scap_threadinfo sctinfo{};
-
-		memset(&sctinfo, 0, sizeof(scap_threadinfo));
-
-		// Note: as scap_fd_add/scap_write_proc_fds do not use
-		// any of the array-based fields like comm, etc. a
-		// shallow copy is safe
-		thread_to_scap(tinfo, &sctinfo);
-
-		if(tinfo.is_main_thread()) {
-			//
-			// Add the FDs
-			//
-			sinsp_fdtable* fd_table_ptr = tinfo.get_fd_table();
-			if(fd_table_ptr == NULL) {
-				return false;
-			}
-
-			bool should_exit = false;
-			fd_table_ptr->loop([&](int64_t fd, sinsp_fdinfo& info) {
-				//
-				// Allocate the scap fd info
-				//
-				scap_fdinfo* scfdinfo = (scap_fdinfo*)malloc(sizeof(scap_fdinfo));
-				if(scfdinfo == NULL) {
-					scap_fd_free_proc_fd_table(&sctinfo);
-					should_exit = true;
-					return false;
-				}
+sinsp_thread_manager::threads_dump::threads_dump(sinsp_thread_manager& manager,
+                                                 scap_dumper_t* dumper):
+        m_manager(manager),
+        m_dumper(dumper) {
+	m_tids.reserve(manager.m_threadtable.size());
+	manager.m_threadtable.loop([&](sinsp_threadinfo& tinfo) {
+		m_tids.push_back(tinfo.m_tid);
+		return true;
+	});
+}
 
-				//
-				// Populate the fd info
-				//
-				fd_to_scap(*scfdinfo, info);
-
-				//
-				// Add the new fd to the scap table.
-				//
-				if(scap_fd_add(&sctinfo, scfdinfo) != SCAP_SUCCESS) {
-					scap_fd_free_proc_fd_table(&sctinfo);
-					throw sinsp_exception("Failed to add fd to hash table");
-				}
+sinsp_thread_manager::threads_dump::~threads_dump() {
+	if(m_proclist_dumper != nullptr) {
+		scap_dump_close(m_proclist_dumper);
+	}
+}
 
-				return true;
-			});
+bool sinsp_thread_manager::threads_dump::step(uint32_t max_threads) {
+	if(m_tids.empty()) {
+		return true;
+	}
 
-			if(should_exit) {
-				return false;
-			}
+	// The thread table is written in two passes over the same tids, like
+	// dump_threads_to_file(): all the threads, then the files of the main threads.
+	if(m_proclist_dumper == nullptr && !m_proclist_done) {
+		m_proclist_dumper = scap_write_proclist_begin();
+		if(m_proclist_dumper == nullptr) {
+			throw sinsp_exception("Failed to create proclist dumper");
 		}
+	}
 
-		//
-		// Dump the thread to disk
-		//
-		if(scap_write_proc_fds(dumper, &sctinfo) != SCAP_SUCCESS) {
-			throw sinsp_exception(
-			        "error calling scap_write_proc_fds in "
-			        "sinsp_thread_manager::dump_threads_to_file (" +
-			        std::string(scap_dump_getlasterr(dumper)) + ")");
+	for(uint32_t n = 0; n < max_threads && m_next < m_tids.size(); n++, m_next++) {
+		const auto& tinfo = m_manager.find_thread(m_tids[m_next], true);
+		if(tinfo == nullptr || tinfo->m_filtered_out) {
+			continue;
 		}
+		if(!m_proclist_done) {
+			m_manager.write_proclist_entry(m_proclist_dumper, *tinfo, m_proclist_len);
+		} else if(!m_manager.write_thread_fds(m_dumper, *tinfo)) {
+			return true;
+		}
+	}
 
-		scap_fd_free_proc_fd_table(&sctinfo);
+	if(m_next < m_tids.size()) {
+		return false;
+	}
+
+	if(m_proclist_done) {
 		return true;
-	});
+	}
+
+	if(m_proclist_len == 0) {
+		// Every thread is gone, there is nothing to write.
+		scap_dump_close(m_proclist_dumper);
+		m_proclist_dumper = nullptr;
+		return true;
+	}
+
+	const int32_t res = scap_write_proclist_end(m_dumper, m_proclist_dumper, m_proclist_len);
+	// The proclist dumper is closed by scap_write_proclist_end().
+	m_proclist_dumper = nullptr;
+	if(res != SCAP_SUCCESS) {
+		throw sinsp_exception(scap_dump_getlasterr(m_dumper));
+	}
+	m_proclist_done = true;
+	m_next = 0;
+	return false;
 }
 
 const threadinfo_map_t::ptr_t& sinsp_thread_manager::get_thread(const int64_t tid,
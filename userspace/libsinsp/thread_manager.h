@@ -151,6 +151,35 @@ public:
 
 	void dump_threads_to_file(scap_dumper_t* dumper);
 
+	/*!
+	  \brief Writes the thread and fd tables like dump_threads_to_file(), a few
+	  threads at a time, so that a large table can be written across many events.
+	  Threads created after the dump started are not written, the ones removed in
+	  the meantime are skipped.
+	*/
+	class threads_dump {
+	public:
+		threads_dump(sinsp_thread_manager& manager, scap_dumper_t* dumper);
+		~threads_dump();
+		threads_dump(const threads_dump&) = delete;
+		threads_dump& operator=(const threads_dump&) = delete;
+
+		/*!
+		  \brief Writes up to `max_threads` more threads, returns true once the
+		  tables are written.
+		*/
+		bool step(uint32_t max_threads);
+
+	private:
+		sinsp_thread_manager& m_manager;
+		scap_dumper_t* m_dumper;
+		scap_dumper_t* m_proclist_dumper = nullptr;
+		std::vector<int64_t> m_tids;
+		size_t m_next = 0;
+		uint32_t m_proclist_len = 0;
+		bool m_proclist_done = false;
+	};
+
 	uint32_t get_thread_count() { return (uint32_t)m_threadtable.size(); }
 
 	threadinfo_map_t* get_threads() { return &m_threadtable; }
@@ -253,6 +282,10 @@ public:
 	void create_thread_dependencies(const std::shared_ptr<sinsp_threadinfo>& tinfo);
 
 	void thread_to_scap(sinsp_threadinfo& tinfo, scap_threadinfo* sctinfo);
+	void write_proclist_entry(scap_dumper_t* proclist_dumper,
+	                          sinsp_threadinfo& tinfo,
+	                          uint32_t& totlen);
+	bool write_thread_fds(scap_dumper_t* dumper, sinsp_threadinfo& tinfo);
 
 	void maybe_log_max_lookup(int64_t tid, bool scan_sockets, uint64_t period);
 
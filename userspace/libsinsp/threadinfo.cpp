@@ -213,7 +213,7 @@ void sinsp_threadinfo::fix_sockets_coming_from_proc(const std::set<uint16_t>& ip
 		ipv4_tuple_fields.m_dip = tip;
 		ipv4_tuple_fields.m_sport = ipv4_tuple_fields.m_dport;
 		ipv4_tuple_fields.m_dport = tport;
-		fdi.m_name = ipv4tuple_to_string(ipv4_tuple, resolve_hostname_and_port);
+		fdi.set_socket_name(ipv4tuple_to_string(ipv4_tuple, resolve_hostname_and_port));
 		fdi.set_role_server();
 		return true;
 	});
@@ -241,15 +241,15 @@ sinsp_fdinfo* sinsp_threadinfo::add_fd_from_scap(const scap_fdinfo& fdi,
 			newfdi->m_flags |= sinsp_fdinfo::FLAGS_SOCKET_CONNECTED;
 		}
 		m_params->network_interfaces.update_fd(*newfdi);
-		newfdi->m_name =
-		        ipv4tuple_to_string(newfdi->m_sockinfo.m_ipv4info, resolve_hostname_and_port);
+		newfdi->set_socket_name(
+		        ipv4tuple_to_string(newfdi->m_sockinfo.m_ipv4info, resolve_hostname_and_port));
 		break;
 	case SCAP_FD_IPV4_SERVSOCK:
 		newfdi->m_sockinfo.m_ipv4serverinfo.m_ip = fdi.info.ipv4serverinfo.ip;
 		newfdi->m_sockinfo.m_ipv4serverinfo.m_port = fdi.info.ipv4serverinfo.port;
 		newfdi->m_sockinfo.m_ipv4serverinfo.m_l4proto = fdi.info.ipv4serverinfo.l4proto;
-		newfdi->m_name = ipv4serveraddr_to_string(newfdi->m_sockinfo.m_ipv4serverinfo,
-		                                          resolve_hostname_and_port);
+		newfdi->set_socket_name(ipv4serveraddr_to_string(newfdi->m_sockinfo.m_ipv4serverinfo,
+		                                                 resolve_hostname_and_port));
 		break;
 	case SCAP_FD_IPV6_SOCK:
 		if(sinsp_utils::is_ipv4_mapped_ipv6((uint8_t*)&fdi.info.ipv6info.sip) &&
@@ -269,8 +269,8 @@ sinsp_fdinfo* sinsp_threadinfo::add_fd_from_scap(const scap_fdinfo& fdi,
 				newfdi->m_flags |= sinsp_fdinfo::FLAGS_SOCKET_CONNECTED;
 			}
 			m_params->network_interfaces.update_fd(*newfdi);
-			newfdi->m_name =
-			        ipv4tuple_to_string(newfdi->m_sockinfo.m_ipv4info, resolve_hostname_and_port);
+			newfdi->set_socket_name(
+			        ipv4tuple_to_string(newfdi->m_sockinfo.m_ipv4info, resolve_hostname_and_port));
 		} else {
 			copy_ipv6_address(newfdi->m_sockinfo.m_ipv6info.m_fields.m_sip.m_b,
 			                  fdi.info.ipv6info.sip);
@@ -282,16 +282,16 @@ sinsp_fdinfo* sinsp_threadinfo::add_fd_from_scap(const scap_fdinfo& fdi,
 			if(fdi.info.ipv6info.l4proto == SCAP_L4_TCP) {
 				newfdi->m_flags |= sinsp_fdinfo::FLAGS_SOCKET_CONNECTED;
 			}
-			newfdi->m_name =
-			        ipv6tuple_to_string(newfdi->m_sockinfo.m_ipv6info, resolve_hostname_and_port);
+			newfdi->set_socket_name(
+			        ipv6tuple_to_string(newfdi->m_sockinfo.m_ipv6info, resolve_hostname_and_port));
 		}
 		break;
 	case SCAP_FD_IPV6_SERVSOCK:
 		copy_ipv6_address(newfdi->m_sockinfo.m_ipv6serverinfo.m_ip.m_b, fdi.info.ipv6serverinfo.ip);
 		newfdi->m_sockinfo.m_ipv6serverinfo.m_port = fdi.info.ipv6serverinfo.port;
 		newfdi->m_sockinfo.m_ipv6serverinfo.m_l4proto = fdi.info.ipv6serverinfo.l4proto;
-		newfdi->m_name = ipv6serveraddr_to_string(newfdi->m_sockinfo.m_ipv6serverinfo,
-		                                          resolve_hostname_and_port);
+		newfdi->set_socket_name(ipv6serveraddr_to_string(newfdi->m_sockinfo.m_ipv6serverinfo,
+		                                                 resolve_hostname_and_port));
 		break;
 	case SCAP_FD_UNIX_SOCK:
 		newfdi->m_sockinfo.m_unixinfo.m_fields.m_source = fdi.info.unix_socket_info.source;
@@ -416,16 +416,55 @@ std::string sinsp_threadinfo::get_exepath() const {
 	return m_exepath;
 }
 
+// Pools of the args, env and cgroups of all the threads, looked up with the raw event or /proc
+// data so that the threads sharing them don't even need to parse them.
+static libsinsp::cow_vector_pool<std::string> s_strvec_pool;
+static libsinsp::cow_vector_pool<sinsp_threadinfo::cgroups_t::value_type> s_cgroups_pool;
+
+// Does `raw`, a list of NUL-separated strings, hold the same strings as `strs`?
+static bool strvec_equals(std::string_view raw, const std::vector<std::string>& strs) {
+	if(raw.empty()) {
+		return strs.empty();
+	}
+
+	size_t pos = 0;
+	for(size_t i = 0; i < strs.size(); i++) {
+		if(i > 0) {
+			if(pos >= raw.size() || raw[pos] != '\0') {
+				return false;
+			}
+			pos++;
+		}
+		if(raw.compare(pos, strs[i].size(), strs[i]) != 0) {
+			return false;
+		}
+		pos += strs[i].size();
+	}
+	return pos == raw.size();
+}
+
+static libsinsp::cow_vector<std::string> intern_strvec(std::string_view raw) {
+	return s_strvec_pool.intern(
+	        std::hash<std::string_view>{}(raw),
+	        [raw](const std::vector<std::string>& strs) { return strvec_equals(raw, strs); },
+	        [raw]() { return sinsp_split(raw, '\0'); });
+}
+
 void sinsp_threadinfo::set_args(const char* args, size_t len) {
 	if(len > 0 && args[len - 1] == '\0') {
 		len--;
 	}
 
-	set_args(sinsp_split({args, len}, '\0'));
+	m_args = intern_strvec({args, len});
+	update_cmd_line();
 }
 
 void sinsp_threadinfo::set_args(const std::vector<std::string>& args) {
 	m_args = args;
+	update_cmd_line();
+}
+
+void sinsp_threadinfo::update_cmd_line() {
 	m_cmd_line = get_comm();
 	if(!m_cmd_line.empty()) {
 		for(const auto& arg : m_args) {
@@ -459,7 +498,7 @@ void sinsp_threadinfo::set_env(const char* const env, size_t len, const bool can
 		len--;
 	}
 
-	m_env = sinsp_split({env, len}, '\0');
+	m_env = intern_strvec({env, len});
 }
 
 bool sinsp_threadinfo::set_env_from_proc() {
@@ -472,15 +511,16 @@ bool sinsp_threadinfo::set_env_from_proc() {
 		return false;
 	}
 
-	m_env.clear();
+	std::vector<std::string> envs;
 	while(environment) {
 		std::string env;
 		getline(environment, env, '\0');
 		if(!env.empty()) {
-			m_env.emplace_back(env);
+			envs.emplace_back(env);
 		}
 	}
 
+	m_env = std::move(envs);
 	return true;
 }
 
@@ -534,46 +574,97 @@ std::string sinsp_threadinfo::concatenate_all_env() {
 	return concatenate_env;
 }
 
+// Returns the name used by sinsp for the cgroup subsystem `subsys`.
+static std::string normalize_cgroup_subsys(std::string_view subsys) {
+	std::string res(subsys);
+	size_t pos = res.find("_cgroup");
+	if(pos != std::string::npos) {
+		res.erase(pos, sizeof("_cgroup") - 1);
+	}
+
+	if(res == "perf") {
+		res = "perf_event";
+	} else if(res == "mem") {
+		res = "memory";
+	} else if(res == "io") {
+		// blkio has been renamed just `io`
+		// in kernel space:
+		// https://github.com/torvalds/linux/commit/c165b3e3c7bb68c2ed55a5ac2623f030d01d9567
+		res = "blkio";
+	}
+	return res;
+}
+
+// Does `raw`, a list of NUL-separated subsys=cgroup strings, parse to `cgroups`? The subsystem
+// names are short enough not to allocate, so a pool hit doesn't cost a parse of the whole list.
+static bool cgroups_equal(std::string_view raw, const sinsp_threadinfo::cgroups_t& cgroups) {
+	if(raw.empty()) {
+		return cgroups.empty();
+	}
+
+	size_t i = 0;
+	size_t start = 0;
+	while(true) {
+		const size_t end = std::min(raw.find('\0', start), raw.size());
+
+		const std::string_view def = raw.substr(start, end - start);
+		const size_t eq_pos = def.find('=');
+		if(i >= cgroups.size() || eq_pos == std::string_view::npos ||
+		   def.substr(eq_pos + 1) != cgroups[i].second ||
+		   normalize_cgroup_subsys(def.substr(0, eq_pos)) != cgroups[i].first) {
+			return false;
+		}
+		i++;
+		if(end == raw.size()) {
+			return i == cgroups.size();
+		}
+		start = end + 1;
+	}
+}
+
 void sinsp_threadinfo::set_cgroups(const char* cgroups, size_t len) {
 	if(len > 0 && cgroups[len - 1] == '\0') {
 		len--;
 	}
 
-	set_cgroups(sinsp_split({cgroups, len}, '\0'));
+	// The pool is looked up first, the data is only parsed if it's not there yet. Invalid data
+	// never matches a pooled entry, so it's parsed each time to be rejected.
+	const std::string_view raw(cgroups, len);
+	bool valid = true;
+	auto interned = s_cgroups_pool.intern(
+	        std::hash<std::string_view>{}(raw),
+	        [raw](const cgroups_t& pooled) { return cgroups_equal(raw, pooled); },
+	        [raw, &valid]() {
+		        cgroups_t parsed;
+		        valid = parse_cgroups(sinsp_split(raw, '\0'), parsed);
+		        return parsed;
+	        });
+	if(valid) {
+		m_cgroups = std::move(interned);
+	}
 }
 
 void sinsp_threadinfo::set_cgroups(const std::vector<std::string>& cgroups) {
-	cgroups_t tmp_cgroups;
+	cgroups_t parsed;
+	if(parse_cgroups(cgroups, parsed)) {
+		m_cgroups = std::move(parsed);
+	}
+}
+
+bool sinsp_threadinfo::parse_cgroups(const std::vector<std::string>& cgroups,
+                                     cgroups_t& tmp_cgroups) {
 
 	for(const auto& def : cgroups) {
 		std::string::size_type eq_pos = def.find("=");
 		if(eq_pos == std::string::npos) {
-			return;
-		}
-
-		std::string subsys = def.substr(0, eq_pos);
-		std::string cgroup = def.substr(eq_pos + 1);
-
-		size_t pos = subsys.find("_cgroup");
-		if(pos != std::string::npos) {
-			subsys.erase(pos, sizeof("_cgroup") - 1);
+			return false;
 		}
 
-		if(subsys == "perf") {
-			subsys = "perf_event";
-		} else if(subsys == "mem") {
-			subsys = "memory";
-		} else if(subsys == "io") {
-			// blkio has been renamed just `io`
-			// in kernel space:
-			// https://github.com/torvalds/linux/commit/c165b3e3c7bb68c2ed55a5ac2623f030d01d9567
-			subsys = "blkio";
-		}
-
-		tmp_cgroups.emplace_back(subsys, cgroup);
+		tmp_cgroups.emplace_back(normalize_cgroup_subsys(std::string_view(def).substr(0, eq_pos)),
+		                         def.substr(eq_pos + 1));
 	}
 
-	m_cgroups = tmp_cgroups;
+	return true;
 }
 
 void sinsp_threadinfo::set_cgroups(const cgroups_t& cgroups) {
@@ -845,7 +936,7 @@ void sinsp_threadinfo::populate_args(std::string& args, const sinsp_threadinfo*
 
 std::string sinsp_threadinfo::get_path_for_dir_fd(int64_t dir_fd) {
 	if(const auto* dir_fdinfo = get_fd(dir_fd); dir_fdinfo && !dir_fdinfo->m_name.empty()) {
-		const auto& name = dir_fdinfo->m_name;
+		const std::string& name = dir_fdinfo->m_name;
 		if(name.back() == '/') {
 			std::string sanitized_name_storage;
 			const auto sanitized_name = sanitize_string(name, sanitized_name_storage);
@@ -1017,9 +1108,9 @@ void sinsp_threadinfo::set_exepath(std::string&& exepath) {
 	constexpr char suffix[] = " (deleted)";
 	constexpr size_t suffix_len = sizeof(suffix) - 1;  // Exclude null terminator
 
-	m_exepath = exepath;
-	if(m_exepath.size() > suffix_len &&
-	   m_exepath.compare(m_exepath.size() - suffix_len, suffix_len, suffix) == 0) {
-		m_exepath.resize(m_exepath.size() - suffix_len);
+	if(exepath.size() > suffix_len &&
+	   exepath.compare(exepath.size() - suffix_len, suffix_len, suffix) == 0) {
+		exepath.resize(exepath.size() - suffix_len);
 	}
+	m_exepath = exepath;
 }
@@ -31,6 +31,8 @@ struct iovec {
 
 #include <functional>
 #include <memory>
+#include <libsinsp/cow_vector.h>
+#include <libsinsp/interned_string.h>
 #include <libsinsp/sinsp_fdtable_factory.h>
 #include <libsinsp/fdtable.h>
 #include <libsinsp/thread_group_info.h>
@@ -362,17 +364,23 @@ public:
 	int64_t m_ptid;  ///< The id of the process that started this thread.
 	int64_t m_reaper_tid;   ///< The id of the reaper for this thread
 	int64_t m_sid;          ///< The session id of the process containing this thread.
-	std::string m_comm;     ///< Command name (e.g. "top")
-	std::string m_exe;      ///< argv[0] (e.g. "sshd: user@pts/4")
-	std::string m_exepath;  ///< full executable path
+	// These are interned: the same few values are shared by most of the threads.
+	libsinsp::interned_string m_comm;     ///< Command name (e.g. "top")
+	libsinsp::interned_string m_exe;      ///< argv[0] (e.g. "sshd: user@pts/4")
+	libsinsp::interned_string m_exepath;  ///< full executable path
 	bool m_exe_writable;
 	bool m_exe_upper_layer;  ///< True if the executable file belongs to upper layer in overlayfs
 	bool m_exe_lower_layer;  ///< True if the executable file belongs to lower layer in overlayfs
 	bool m_exe_from_memfd;   ///< True if the executable is stored in fileless memory referenced by
 	                         ///< memfd
-	std::vector<std::string> m_args;  ///< Command line arguments (e.g. "-d1")
-	std::vector<std::string> m_env;   ///< Environment variables
-	cgroups_t m_cgroups;              ///< subsystem-cgroup pairs
+	// The args, env and cgroups are shared by all the threads with the same values, e.g. the
+	// threads of a process or the workers spawned by the same parent, until they are modified.
+	// Note: these members used to be std::vector. They still convert to a const std::vector& and
+	// can be assigned one, but they can only be written in place through mut(), push_back() or
+	// emplace_back(), which give the thread its own copy first.
+	libsinsp::cow_vector<std::string> m_args;  ///< Command line arguments (e.g. "-d1")
+	libsinsp::cow_vector<std::string> m_env;   ///< Environment variables
+	libsinsp::cow_vector<cgroups_t::value_type> m_cgroups;  ///< subsystem-cgroup pairs
 	uint32_t m_flags;   ///< The thread flags. See the PPM_CL_* declarations in ppm_events_public.h.
 	int64_t m_fdlimit;  ///< The maximum number of FDs this thread can open
 	uint32_t m_uid;     ///< uid
@@ -521,6 +529,8 @@ protected:
 private:
 	sinsp_threadinfo* get_cwd_root();
 	bool set_env_from_proc();
+	void update_cmd_line();
+	static bool parse_cgroups(const std::vector<std::string>& cgroups, cgroups_t& tmp_cgroups);
 	size_t strvec_len(const std::vector<std::string>& strs) const;
 	void strvec_to_iovec(const std::vector<std::string>& strs,
 	                     struct iovec** iov,
@@ -17,13 +17,14 @@ limitations under the License.
 */
 
 #include <libsinsp/user.h>
+#include <libsinsp/usergroup_loader.h>
 #include <libsinsp/procfs_utils.h>
 #include <libsinsp/utils.h>
 #include <libsinsp/logger.h>
 #include <libsinsp/sinsp.h>
 #include <libscap/strl.h>
 #include <sys/types.h>
-#include <charconv>
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
 #include <fstream>
@@ -38,50 +39,6 @@ limitations under the License.
 #include <grp.h>
 #endif
 
-namespace {
-
-// Splits `line` into up to `max` colon-separated fields, storing each into
-// `out` (which must have room for at least `max` entries). Returns the number
-// of fields found; the final field captures the remainder of the line,
-// including any further colons.
-//
-// We parse /etc/passwd and /etc/group ourselves instead of relying on
-// fgetpwent_r()/fgetgrent_r(): those require the *entire* line to fit in a
-// fixed-size buffer and return ERANGE otherwise. A group with a large member
-// list can exceed any such buffer, and the previous "continue on error" loops
-// then spun forever, re-reading the same oversized line without ever advancing
-// or reaching EOF. We only need the leading fixed fields (name, uid/gid), so
-// reading whole lines with std::getline and parsing the prefix sidesteps the
-// overflow entirely.
-size_t split_fields(std::string_view line, std::string_view *out, size_t max) {
-	size_t n = 0;
-	size_t start = 0;
-	while(n < max) {
-		size_t pos = line.find(':', start);
-		if(pos == std::string_view::npos) {
-			out[n++] = line.substr(start);
-			break;
-		}
-		out[n++] = line.substr(start, pos - start);
-		start = pos + 1;
-	}
-	return n;
-}
-
-// Parses `s` as a base-10 uint32_t, requiring the *entire* field to be a valid
-// number. Returns false (without touching `out`) on empty input, non-numeric
-// characters, trailing garbage, or overflow. This matters because getpwent/
-// getgrent-style files are untrusted: a malformed id field must be rejected,
-// not silently coerced to 0 (which would alias to root's uid/gid).
-bool parse_uint32(std::string_view s, uint32_t &out) {
-	const char *begin = s.data();
-	const char *end = s.data() + s.size();
-	auto res = std::from_chars(begin, end, out);
-	return res.ec == std::errc{} && res.ptr == end;
-}
-
-}  // namespace
-
 #ifdef HAVE_PWD_H
 static struct passwd *__getpwuid(uint32_t uid,
                                  const std::string &host_root,
@@ -103,24 +60,14 @@ static struct passwd *__getpwuid(uint32_t uid,
 
 	// With a host root set, read /etc/passwd directly. We parse each line
 	// ourselves (rather than fgetpwent_r) so an over-long line cannot overflow
-	// the fixed-size buffer; see split_fields().
+	// the fixed-size buffer; see sinsp_usergroup_loader::parse_passwd().
 	std::ifstream f(host_root + "/etc/passwd");
-	std::string line;
-	while(std::getline(f, line)) {
-		// name:passwd:uid:gid:gecos:home:shell
-		std::string_view fields[7];
-		if(split_fields(line, fields, 7) < 7) {
-			continue;  // skip malformed lines
-		}
-		uint32_t entry_uid;
-		uint32_t entry_gid;
-		if(!parse_uint32(fields[2], entry_uid) || !parse_uint32(fields[3], entry_gid)) {
-			continue;  // skip lines with a non-numeric uid/gid
+	struct passwd *ret = nullptr;
+	sinsp_usergroup_loader::parse_passwd(f, [&](const sinsp_usergroup_loader::passwd_entry &e) {
+		if(uid != e.uid) {
+			return true;
 		}
-		if(uid != entry_uid) {
-			continue;
-		}
-		// `line` does not outlive this call, so copy the fields we keep into
+		// The entry does not outlive this call, so copy the fields we keep into
 		// the caller-owned buffer and point the result at them.
 		char *w = buf;
 		char *bufend = buf + buflen;
@@ -134,20 +81,21 @@ static struct passwd *__getpwuid(uint32_t uid,
 			*w++ = '\0';
 			return dst;
 		};
-		char *name = stash(fields[0]);
-		char *home = stash(fields[5]);
-		char *shell = stash(fields[6]);
+		char *name = stash(e.name);
+		char *home = stash(e.home);
+		char *shell = stash(e.shell);
 		if(!name || !home || !shell) {
-			continue;  // does not fit (not expected for these fields)
+			return true;  // does not fit (not expected for these fields)
 		}
 		pwd->pw_name = name;
-		pwd->pw_uid = entry_uid;
-		pwd->pw_gid = entry_gid;
+		pwd->pw_uid = e.uid;
+		pwd->pw_gid = e.gid;
 		pwd->pw_dir = home;
 		pwd->pw_shell = shell;
-		return pwd;
-	}
-	return nullptr;
+		ret = pwd;
+		return false;
+	});
+	return ret;
 }
 #endif
 
@@ -172,36 +120,27 @@ static struct group *__getgrgid(uint32_t gid,
 
 	// With a host root set, read /etc/group directly. We parse each line
 	// ourselves (rather than fgetgrent_r) so a large member list cannot
-	// overflow the fixed-size buffer; see split_fields().
+	// overflow the fixed-size buffer; see sinsp_usergroup_loader::parse_group().
 	std::ifstream f(host_root + "/etc/group");
-	std::string line;
-	while(std::getline(f, line)) {
-		// name:passwd:gid:members
-		std::string_view fields[3];
-		if(split_fields(line, fields, 3) < 3) {
-			continue;  // skip malformed lines
-		}
-		uint32_t entry_gid;
-		if(!parse_uint32(fields[2], entry_gid)) {
-			continue;  // skip lines with a non-numeric gid
-		}
-		if(gid != entry_gid) {
-			continue;
+	struct group *ret = nullptr;
+	sinsp_usergroup_loader::parse_group(f, [&](const sinsp_usergroup_loader::group_entry &e) {
+		if(gid != e.gid) {
+			return true;
 		}
-		// `line` does not outlive this call, so copy the name we keep into the
+		// The entry does not outlive this call, so copy the name we keep into the
 		// caller-owned buffer and point the result at it.
-		std::string_view name = fields[0];
-		if(name.size() + 1 > buflen) {
-			return nullptr;
+		if(e.name.size() + 1 > buflen) {
+			return false;
 		}
-		memcpy(buf, name.data(), name.size());
-		buf[name.size()] = '\0';
+		memcpy(buf, e.name.data(), e.name.size());
+		buf[e.name.size()] = '\0';
 		grp->gr_name = buf;
 		grp->gr_gid = gid;
 		grp->gr_mem = nullptr;
-		return grp;
-	}
-	return nullptr;
+		ret = grp;
+		return false;
+	});
+	return ret;
 }
 #endif
 
@@ -275,6 +214,7 @@ void sinsp_usergroup_manager::delete_container(const std::string &container_id)
 
 	m_userlist.erase(container_id);
 	m_grouplist.erase(container_id);
+	m_pending_loads.erase(container_id);
 }
 
 scap_userinfo *sinsp_usergroup_manager::userinfo_map_insert(userinfo_map &map,
@@ -350,7 +290,7 @@ scap_userinfo *sinsp_usergroup_manager::add_user(const std::string &container_id
 	if(container_id.empty()) {
 		return add_host_user(uid, gid, name, home, shell, notify);
 	}
-	return add_container_user(container_id, pid, uid, notify);
+	return add_container_user(container_id, pid, uid, gid, name, home, shell, notify);
 }
 
 scap_groupinfo *sinsp_usergroup_manager::add_group(const std::string &container_id,
@@ -411,6 +351,10 @@ scap_userinfo *sinsp_usergroup_manager::add_host_user(uint32_t uid,
 scap_userinfo *sinsp_usergroup_manager::add_container_user(const std::string &container_id,
                                                            int64_t pid,
                                                            uint32_t uid,
+                                                           uint32_t gid,
+                                                           std::string_view name,
+                                                           std::string_view home,
+                                                           std::string_view shell,
                                                            bool notify) {
 	libsinsp_logger()->format(sinsp_logger::SEV_DEBUG,
 	                          "adding container [%s] user %d",
@@ -420,39 +364,13 @@ scap_userinfo *sinsp_usergroup_manager::add_container_user(const std::string &co
 	scap_userinfo *retval{nullptr};
 
 #if defined(__linux__) && defined HAVE_PWD_H
-	if(!m_ns_helper->in_own_ns_mnt(pid)) {
-		return retval;
-	}
-
-	std::string path = m_ns_helper->get_pid_root(pid) + "/etc/passwd";
-	std::ifstream pwd_file(path);
-	if(pwd_file) {
-		auto &userlist = m_userlist[container_id];
-		std::string line;
-		while(std::getline(pwd_file, line)) {
-			// name:passwd:uid:gid:gecos:home:shell
-			std::string_view fields[7];
-			if(split_fields(line, fields, 7) < 7) {
-				continue;  // skip malformed lines
-			}
-			uint32_t u_uid;
-			uint32_t u_gid;
-			if(!parse_uint32(fields[2], u_uid) || !parse_uint32(fields[3], u_gid)) {
-				continue;  // skip lines with a non-numeric uid/gid
-			}
-			// Here we cache all container users
-			auto *usr =
-			        userinfo_map_insert(userlist, u_uid, u_gid, fields[0], fields[5], fields[6]);
-
-			if(notify) {
-				notify_user_changed(usr, container_id);
-			}
-
-			if(uid == u_uid) {
-				retval = usr;
-			}
-		}
+	if(!load_container(container_id, pid, notify, false)) {
+		return get_user(container_id, uid);
 	}
+
+	// Filled in, or removed if the container doesn't have it, once loaded.
+	retval = userinfo_map_insert(m_userlist[container_id], uid, gid, name, home, shell);
+	m_pending_loads[container_id].uids.push_back(uid);
 #endif
 
 	return retval;
@@ -506,7 +424,7 @@ scap_groupinfo *sinsp_usergroup_manager::add_group(const string &container_id,
 	if(container_id.empty()) {
 		return add_host_group(gid, name, notify);
 	}
-	return add_container_group(container_id, pid, gid, notify);
+	return add_container_group(container_id, pid, gid, name, notify);
 }
 
 scap_groupinfo *sinsp_usergroup_manager::add_host_group(uint32_t gid,
@@ -541,6 +459,7 @@ scap_groupinfo *sinsp_usergroup_manager::add_host_group(uint32_t gid,
 scap_groupinfo *sinsp_usergroup_manager::add_container_group(const std::string &container_id,
                                                              int64_t pid,
                                                              uint32_t gid,
+                                                             std::string_view name,
                                                              bool notify) {
 	libsinsp_logger()->format(sinsp_logger::SEV_DEBUG,
 	                          "adding container [%s] group: %d",
@@ -550,40 +469,117 @@ scap_groupinfo *sinsp_usergroup_manager::add_container_group(const std::string &
 	scap_groupinfo *retval{nullptr};
 
 #if defined(__linux__) && defined HAVE_GRP_H
-	if(!m_ns_helper->in_own_ns_mnt(pid)) {
-		return retval;
-	}
-
-	std::string path = m_ns_helper->get_pid_root(pid) + "/etc/group";
-	std::ifstream group_file(path);
-	if(group_file) {
-		auto &grouplist = m_grouplist[container_id];
-		std::string line;
-		while(std::getline(group_file, line)) {
-			// name:passwd:gid:members
-			std::string_view fields[3];
-			if(split_fields(line, fields, 3) < 3) {
-				continue;  // skip malformed lines
-			}
-			uint32_t g_gid;
-			if(!parse_uint32(fields[2], g_gid)) {
-				continue;  // skip lines with a non-numeric gid
-			}
-			// Here we cache all container groups
-			auto *gr = groupinfo_map_insert(grouplist, g_gid, fields[0]);
+	if(!load_container(container_id, pid, false, notify)) {
+		return get_group(container_id, gid);
+	}
+
+	// Filled in, or removed if the container doesn't have it, once loaded.
+	retval = groupinfo_map_insert(m_grouplist[container_id], gid, name);
+	m_pending_loads[container_id].gids.push_back(gid);
+#endif
+
+	return retval;
+}
 
-			if(notify) {
-				notify_group_changed(gr, container_id, true);
+bool sinsp_usergroup_manager::load_container(const std::string &container_id,
+                                             int64_t pid,
+                                             bool notify_users,
+                                             bool notify_groups) {
+	if(auto it = m_pending_loads.find(container_id); it != m_pending_loads.end()) {
+		it->second.notify_users |= notify_users;
+		it->second.notify_groups |= notify_groups;
+		return true;
+	}
+
+	if(m_ns_helper == nullptr || !m_ns_helper->in_own_ns_mnt(pid)) {
+		return false;
+	}
+
+	if(m_loader == nullptr) {
+		m_loader = std::make_unique<sinsp_usergroup_loader>();
+	}
+
+	// The pool is looked up for each container, as it can be set after the first lookup.
+	const std::string proc_dir = m_host_root + "/proc/" + std::to_string(pid);
+	if(!m_loader->load_async(m_inspector->get_thread_pool(), container_id, proc_dir)) {
+		auto res = m_loader->load(container_id, proc_dir);
+		apply_loaded(res, notify_users, notify_groups);
+		return false;
+	}
+
+	auto &pending = m_pending_loads[container_id];
+	pending.notify_users = notify_users;
+	pending.notify_groups = notify_groups;
+	return true;
+}
+
+void sinsp_usergroup_manager::apply_loaded(const sinsp_usergroup_loader::result &res,
+                                           bool notify_users,
+                                           bool notify_groups) {
+	// Here we cache all container users and groups
+	if(res.users) {
+		auto &userlist = m_userlist[res.container_id];
+		for(const auto &u : *res.users) {
+			auto *usr = userinfo_map_insert(userlist, u.uid, u.gid, u.name, u.home, u.shell);
+			if(notify_users) {
+				notify_user_changed(usr, res.container_id);
 			}
+		}
+	}
 
-			if(gid == g_gid) {
-				retval = gr;
+	if(res.groups) {
+		auto &grouplist = m_grouplist[res.container_id];
+		for(const auto &g : *res.groups) {
+			auto *gr = groupinfo_map_insert(grouplist, g.gid, g.name);
+			if(notify_groups) {
+				notify_group_changed(gr, res.container_id, true);
 			}
 		}
 	}
-#endif
+}
 
-	return retval;
+void sinsp_usergroup_manager::update() {
+	if(m_loader == nullptr) {
+		return;
+	}
+
+	m_loader->consume([this](sinsp_usergroup_loader::result &res) {
+		// The container may be gone in the meantime.
+		auto it = m_pending_loads.find(res.container_id);
+		if(it == m_pending_loads.end()) {
+			return;
+		}
+		const auto pending = std::move(it->second);
+		m_pending_loads.erase(it);
+
+		apply_loaded(res, pending.notify_users, pending.notify_groups);
+
+		// The placeholders the container doesn't have are dropped, as if they were looked up
+		// synchronously.
+		for(const auto uid : pending.uids) {
+			if(!res.users || std::none_of(res.users->begin(),
+			                              res.users->end(),
+			                              [uid](const auto &u) { return u.uid == uid; })) {
+				m_userlist[res.container_id].erase(uid);
+			}
+		}
+		for(const auto gid : pending.gids) {
+			if(!res.groups || std::none_of(res.groups->begin(),
+			                               res.groups->end(),
+			                               [gid](const auto &g) { return g.gid == gid; })) {
+				m_grouplist[res.container_id].erase(gid);
+			}
+		}
+	});
+}
+
+size_t sinsp_usergroup_manager::pending_loads() const {
+	return m_pending_loads.size();
+}
+
+void sinsp_usergroup_manager::cancel_loads() {
+	m_loader.reset();
+	m_pending_loads.clear();
 }
 
 bool sinsp_usergroup_manager::rm_group(const string &container_id, uint32_t gid, bool notify) {
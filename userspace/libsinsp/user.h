@@ -24,6 +24,7 @@ limitations under the License.
 #include <memory>
 #include <libsinsp/procfs_utils.h>
 #include <libsinsp/sinsp.h>
+#include <libsinsp/usergroup_loader.h>
 
 class sinsp;
 namespace libsinsp {
@@ -45,6 +46,9 @@ class ns_helper;
  * key, without additional info (ie: username, homedir etc etc will be left "<NA>") because they
  * cannot be retrieved from a container. Then, a PPME_{USER,GROUP}_ADDED event is emitted, to allow
  * capture files to rebuild the state.
+ * 		If the inspector has a thread pool, the container /etc/passwd and /etc/group are read
+ * in the background instead: until they are, the user and group fields of its threads (e.g.
+ * user.name, user.homedir, group.name) show "<NA>", and they are filled in by update().
  *
  * * on PPME_{USER,GROUP}_ADDED, the new user/group is stored in the
  * m_{user,group}_list<container_id>, if not present.
@@ -117,6 +121,8 @@ public:
 
 	// Note: pid is an unused parameter when container_id is an empty string
 	// ie: it is only used when adding users/groups from containers.
+	// With a thread pool, the users and groups of a container returned before its files are
+	// loaded are placeholders whose name, home and shell are "<NA>".
 	scap_userinfo *add_user(const std::string &container_id,
 	                        int64_t pid,
 	                        uint32_t uid,
@@ -145,6 +151,23 @@ public:
 
 	void delete_container(const std::string &container_id);
 
+	/*!
+	  \brief Fills in the users and groups of the containers loaded in the background since the
+	   last call, see add_user() and add_group(). Called by the inspector on each event.
+	*/
+	void update();
+
+	/*!
+	  \brief Returns the number of containers whose users and groups are being loaded.
+	*/
+	size_t pending_loads() const;
+
+	/*!
+	  \brief Drops the users and groups being loaded, e.g. when the thread pool is purged. The
+	   placeholders added for them are kept.
+	*/
+	void cancel_loads();
+
 	//
 	// User and group tables
 	//
@@ -160,14 +183,29 @@ private:
 	scap_userinfo *add_container_user(const std::string &container_id,
 	                                  int64_t pid,
 	                                  uint32_t uid,
+	                                  uint32_t gid,
+	                                  std::string_view name,
+	                                  std::string_view home,
+	                                  std::string_view shell,
 	                                  bool notify);
 
 	scap_groupinfo *add_host_group(uint32_t gid, std::string_view name, bool notify);
 	scap_groupinfo *add_container_group(const std::string &container_id,
 	                                    int64_t pid,
 	                                    uint32_t gid,
+	                                    std::string_view name,
 	                                    bool notify);
 
+	// Returns true if the users and groups of the container are being loaded in the background,
+	// after loading them right away if there's no thread pool.
+	bool load_container(const std::string &container_id,
+	                    int64_t pid,
+	                    bool notify_users,
+	                    bool notify_groups);
+	void apply_loaded(const sinsp_usergroup_loader::result &res,
+	                  bool notify_users,
+	                  bool notify_groups);
+
 	bool user_to_sinsp_event(const scap_userinfo *user,
 	                         sinsp_evt *evt,
 	                         const std::string &container_id,
@@ -207,6 +245,17 @@ private:
 
 	const std::string &m_host_root;
 	std::unique_ptr<libsinsp::procfs_utils::ns_helper> m_ns_helper;
+
+	// Container files, loaded in the background when the inspector has a thread pool. Until they
+	// are, the users and groups looked up are placeholders.
+	struct pending_load {
+		bool notify_users = false;
+		bool notify_groups = false;
+		std::vector<uint32_t> uids;
+		std::vector<uint32_t> gids;
+	};
+	std::unique_ptr<sinsp_usergroup_loader> m_loader;
+	std::unordered_map<std::string, pending_load> m_pending_loads;
 };
 
 // RAII struct to manage threadinfos automatic user/group refresh
@@ -0,0 +1,347 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2026 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <libsinsp/usergroup_loader.h>
+
+#include <atomic>
+#include <charconv>
+#include <deque>
+#include <fstream>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <sstream>
+#include <type_traits>
+#include <unordered_map>
+
+namespace {
+
+// Splits `line` into up to `max` colon-separated fields, storing each into
+// `out` (which must have room for at least `max` entries). Returns the number
+// of fields found; the final field captures the remainder of the line,
+// including any further colons.
+//
+// We parse /etc/passwd and /etc/group ourselves instead of relying on
+// fgetpwent_r()/fgetgrent_r(): those require the *entire* line to fit in a
+// fixed-size buffer and return ERANGE otherwise. A group with a large member
+// list can exceed any such buffer, and the previous "continue on error" loops
+// then spun forever, re-reading the same oversized line without ever advancing
+// or reaching EOF. We only need the leading fixed fields (name, uid/gid), so
+// reading whole lines with std::getline and parsing the prefix sidesteps the
+// overflow entirely.
+size_t split_fields(std::string_view line, std::string_view *out, size_t max) {
+	size_t n = 0;
+	size_t start = 0;
+	while(n < max) {
+		size_t pos = line.find(':', start);
+		if(pos == std::string_view::npos) {
+			out[n++] = line.substr(start);
+			break;
+		}
+		out[n++] = line.substr(start, pos - start);
+		start = pos + 1;
+	}
+	return n;
+}
+
+// Parses `s` as a base-10 uint32_t, requiring the *entire* field to be a valid
+// number. Returns false (without touching `out`) on empty input, non-numeric
+// characters, trailing garbage, or overflow. This matters because getpwent/
+// getgrent-style files are untrusted: a malformed id field must be rejected,
+// not silently coerced to 0 (which would alias to root's uid/gid).
+bool parse_uint32(std::string_view s, uint32_t &out) {
+	const char *begin = s.data();
+	const char *end = s.data() + s.size();
+	auto res = std::from_chars(begin, end, out);
+	return res.ec == std::errc{} && res.ptr == end;
+}
+
+// Reads the whole file at `path` into `content`.
+bool read_file(const std::string &path, std::string &content) {
+	std::ifstream f(path, std::ios::binary);
+	if(!f) {
+		return false;
+	}
+	content.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+	return !f.bad();
+}
+
+}  // namespace
+
+struct sinsp_usergroup_loader::state {
+	explicit state(size_t max_cached_files): m_max_cached_files(max_cached_files) {}
+
+	// A parsed file, found by the hash of its content and then compared byte by byte, so that
+	// the containers built from the same image share it.
+	struct cached_file {
+		size_t hash;
+		bool is_group;
+		std::string content;
+		std::shared_ptr<const user_list> users;
+		std::shared_ptr<const group_list> groups;
+	};
+
+	// Least recently used files at the back.
+	mutable std::mutex m_cache_mtx;
+	const size_t m_max_cached_files;
+	std::list<cached_file> m_lru;
+	std::unordered_multimap<size_t, std::list<cached_file>::iterator> m_cache;
+
+	struct job {
+		std::string container_id;
+		std::string proc_dir;
+	};
+
+	// The routine is subscribed only while there are jobs, to the pool of the job that started
+	// it.
+	std::mutex m_jobs_mtx;
+	std::deque<job> m_jobs;
+	bool m_running = false;
+	std::weak_ptr<sinsp_thread_pool> m_routine_pool;
+
+	std::mutex m_ready_mtx;
+	std::vector<result> m_ready;
+	std::atomic<size_t> m_num_ready{0};
+
+	template<typename T>
+	std::shared_ptr<const T> load_file(const std::string &path);
+	result load(const std::string &container_id, const std::string &proc_dir);
+
+	// Must be called with `m_cache_mtx` held.
+	template<typename T>
+	std::shared_ptr<const T> find_cached(size_t hash, const std::string &content);
+};
+
+template<typename T>
+std::shared_ptr<const T> sinsp_usergroup_loader::state::find_cached(size_t hash,
+                                                                   const std::string &content) {
+	constexpr bool is_group = std::is_same_v<T, group_list>;
+	auto range = m_cache.equal_range(hash);
+	for(auto it = range.first; it != range.second; ++it) {
+		auto &cached = *it->second;
+		if(cached.is_group != is_group || cached.content != content) {
+			continue;
+		}
+
+		m_lru.splice(m_lru.begin(), m_lru, it->second);
+		if constexpr(is_group) {
+			return cached.groups;
+		} else {
+			return cached.users;
+		}
+	}
+	return nullptr;
+}
+
+template<typename T>
+std::shared_ptr<const T> sinsp_usergroup_loader::state::load_file(const std::string &path) {
+	constexpr bool is_group = std::is_same_v<T, group_list>;
+	std::string content;
+	if(!read_file(path, content)) {
+		return nullptr;
+	}
+
+	const size_t hash = std::hash<std::string>()(content) * 31 + is_group;
+	{
+		std::lock_guard<std::mutex> lock(m_cache_mtx);
+		if(auto cached = find_cached<T>(hash, content); cached != nullptr) {
+			return cached;
+		}
+	}
+
+	std::istringstream f(content);
+	auto list = std::make_shared<T>();
+	if constexpr(std::is_same_v<T, group_list>) {
+		parse_group(f, [&list](const group_entry &e) {
+			list->push_back({e.gid, std::string(e.name)});
+			return true;
+		});
+	} else {
+		parse_passwd(f, [&list](const passwd_entry &e) {
+			list->push_back({e.uid,
+			                 e.gid,
+			                 std::string(e.name),
+			                 std::string(e.home),
+			                 std::string(e.shell)});
+			return true;
+		});
+	}
+
+	if(m_max_cached_files == 0) {
+		return list;
+	}
+
+	std::lock_guard<std::mutex> lock(m_cache_mtx);
+	// Another thread may have parsed the same file in the meantime.
+	if(auto cached = find_cached<T>(hash, content); cached != nullptr) {
+		return cached;
+	}
+
+	auto &entry = m_lru.emplace_front();
+	entry.hash = hash;
+	entry.is_group = is_group;
+	entry.content = std::move(content);
+	if constexpr(is_group) {
+		entry.groups = list;
+	} else {
+		entry.users = list;
+	}
+	m_cache.emplace(hash, m_lru.begin());
+
+	while(m_lru.size() > m_max_cached_files) {
+		const auto &oldest = m_lru.back();
+		auto range = m_cache.equal_range(oldest.hash);
+		for(auto it = range.first; it != range.second; ++it) {
+			if(&*it->second == &oldest) {
+				m_cache.erase(it);
+				break;
+			}
+		}
+		m_lru.pop_back();
+	}
+	return list;
+}
+
+sinsp_usergroup_loader::result sinsp_usergroup_loader::state::load(
+        const std::string &container_id,
+        const std::string &proc_dir) {
+	result res;
+	res.container_id = container_id;
+	res.users = load_file<user_list>(proc_dir + "/root/etc/passwd");
+	res.groups = load_file<group_list>(proc_dir + "/root/etc/group");
+	return res;
+}
+
+sinsp_usergroup_loader::sinsp_usergroup_loader(size_t max_cached_files):
+        m_state(std::make_shared<state>(max_cached_files)) {}
+
+sinsp_usergroup_loader::~sinsp_usergroup_loader() {
+	// The routine keeps the state alive until it's done with the job in progress.
+	std::lock_guard<std::mutex> lock(m_state->m_jobs_mtx);
+	m_state->m_jobs.clear();
+}
+
+sinsp_usergroup_loader::result sinsp_usergroup_loader::load(const std::string &container_id,
+                                                            const std::string &proc_dir) {
+	return m_state->load(container_id, proc_dir);
+}
+
+bool sinsp_usergroup_loader::load_async(const std::shared_ptr<sinsp_thread_pool> &tpool,
+                                        const std::string &container_id,
+                                        const std::string &proc_dir) {
+	if(tpool == nullptr) {
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(m_state->m_jobs_mtx);
+	m_state->m_jobs.push_back({container_id, proc_dir});
+	// The pool may have been replaced since the routine was started, and the routine lost with
+	// the old one: the jobs are then picked up by a routine on the new pool.
+	if(!m_state->m_running || m_state->m_routine_pool.lock() != tpool) {
+		m_state->m_running = true;
+		m_state->m_routine_pool = tpool;
+		auto st = m_state;
+		tpool->subscribe([st]() { return run(*st); });
+	}
+	return true;
+}
+
+size_t sinsp_usergroup_loader::consume(const std::function<void(result &)> &apply) {
+	if(m_state->m_num_ready == 0) {
+		return 0;
+	}
+
+	std::vector<result> ready;
+	{
+		std::lock_guard<std::mutex> lock(m_state->m_ready_mtx);
+		ready.swap(m_state->m_ready);
+		m_state->m_num_ready = 0;
+	}
+
+	for(auto &r : ready) {
+		apply(r);
+	}
+	return ready.size();
+}
+
+size_t sinsp_usergroup_loader::cached_files() const {
+	std::lock_guard<std::mutex> lock(m_state->m_cache_mtx);
+	return m_state->m_lru.size();
+}
+
+bool sinsp_usergroup_loader::run(state &st) {
+	state::job j;
+	{
+		std::lock_guard<std::mutex> lock(st.m_jobs_mtx);
+		if(st.m_jobs.empty()) {
+			st.m_running = false;
+			return false;
+		}
+		j = std::move(st.m_jobs.front());
+		st.m_jobs.pop_front();
+	}
+
+	auto res = st.load(j.container_id, j.proc_dir);
+
+	std::lock_guard<std::mutex> lock(st.m_ready_mtx);
+	st.m_ready.push_back(std::move(res));
+	st.m_num_ready = st.m_ready.size();
+	return true;
+}
+
+void sinsp_usergroup_loader::parse_passwd(std::istream &in,
+                                          const std::function<bool(const passwd_entry &)> &visit) {
+	std::string line;
+	while(std::getline(in, line)) {
+		// name:passwd:uid:gid:gecos:home:shell
+		std::string_view fields[7];
+		if(split_fields(line, fields, 7) < 7) {
+			continue;  // skip malformed lines
+		}
+		passwd_entry e;
+		if(!parse_uint32(fields[2], e.uid) || !parse_uint32(fields[3], e.gid)) {
+			continue;  // skip lines with a non-numeric uid/gid
+		}
+		e.name = fields[0];
+		e.home = fields[5];
+		e.shell = fields[6];
+		if(!visit(e)) {
+			return;
+		}
+	}
+}
+
+void sinsp_usergroup_loader::parse_group(std::istream &in,
+                                         const std::function<bool(const group_entry &)> &visit) {
+	std::string line;
+	while(std::getline(in, line)) {
+		// name:passwd:gid:members
+		std::string_view fields[3];
+		if(split_fields(line, fields, 3) < 3) {
+			continue;  // skip malformed lines
+		}
+		group_entry e;
+		if(!parse_uint32(fields[2], e.gid)) {
+			continue;  // skip lines with a non-numeric gid
+		}
+		e.name = fields[0];
+		if(!visit(e)) {
+			return;
+		}
+	}
+}
@@ -0,0 +1,128 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+Copyright (C) 2026 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#pragma once
+
+#include <libsinsp/sinsp_thread_pool.h>
+
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*!
+  \brief Loads the users and groups of the containers from their /etc/passwd and /etc/group.
+  Each distinct file content is parsed once, line by line, and kept in a cache shared by all the
+  containers, e.g. the ones built from the same image, that drops the least recently used files
+  past a maximum number. With a thread pool the files are loaded in the background and handed
+  over by consume(), so that event processing never waits for them.
+*/
+class sinsp_usergroup_loader {
+public:
+	struct user {
+		uint32_t uid;
+		uint32_t gid;
+		std::string name;
+		std::string home;
+		std::string shell;
+	};
+
+	struct group {
+		uint32_t gid;
+		std::string name;
+	};
+
+	using user_list = std::vector<user>;
+	using group_list = std::vector<group>;
+
+	/*!
+	  \brief The users and groups of a container, null if the file can't be read.
+	*/
+	struct result {
+		std::string container_id;
+		std::shared_ptr<const user_list> users;
+		std::shared_ptr<const group_list> groups;
+	};
+
+	static constexpr size_t DEFAULT_MAX_CACHED_FILES = 512;
+
+	explicit sinsp_usergroup_loader(size_t max_cached_files = DEFAULT_MAX_CACHED_FILES);
+
+	~sinsp_usergroup_loader();
+
+	/*!
+	  \brief Loads the files of a container on the calling thread. `proc_dir` is the /proc
+	  directory of one of its processes.
+	*/
+	result load(const std::string& container_id, const std::string& proc_dir);
+
+	/*!
+	  \brief Queues the loading of the files of a container on `tpool`.
+	  \return false if `tpool` is null.
+	*/
+	bool load_async(const std::shared_ptr<sinsp_thread_pool>& tpool,
+	                const std::string& container_id,
+	                const std::string& proc_dir);
+
+	/*!
+	  \brief Passes the containers loaded so far to `apply`, on the calling thread.
+	  \return The number of containers passed to `apply`.
+	*/
+	size_t consume(const std::function<void(result&)>& apply);
+
+	/*!
+	  \brief Returns the number of files in the cache.
+	*/
+	size_t cached_files() const;
+
+	struct passwd_entry {
+		uint32_t uid;
+		uint32_t gid;
+		std::string_view name;
+		std::string_view home;
+		std::string_view shell;
+	};
+
+	struct group_entry {
+		uint32_t gid;
+		std::string_view name;
+	};
+
+	/*!
+	  \brief Passes each valid line of a passwd file to `visit`, until it returns false. The
+	  entries only live until `visit` returns.
+	*/
+	static void parse_passwd(std::istream& in,
+	                         const std::function<bool(const passwd_entry&)>& visit);
+
+	/*!
+	  \brief Passes each valid line of a group file to `visit`, until it returns false. The
+	  entries only live until `visit` returns.
+	*/
+	static void parse_group(std::istream& in, const std::function<bool(const group_entry&)>& visit);
+
+private:
+	struct state;
+
+	static bool run(state& st);
+
+	std::shared_ptr<state> m_state;
+};